@@ -30,6 +30,9 @@ extern "C" {
 #define PUBSUB_PUBLISHERMOCK_LOCAL_MSG_TYPE_ID_FOR_MSG_TYPE_METHOD "pubsub__publisherMock_localMsgTypeIdForMsgType"
 #define PUBSUB_PUBLISHERMOCK_SEND_METHOD "pubsub__publisherMock_send"
 #define PUBSUB_PUBLISHERMOCK_SEND_MULTIPART_METHOD "pubsub__publisherMock_sendMultipart"
+#define PUBSUB_PUBLISHERMOCK_LOAN_METHOD "pubsub__publisherMock_loan"
+#define PUBSUB_PUBLISHERMOCK_COMMIT_METHOD "pubsub__publisherMock_commit"
+#define PUBSUB_PUBLISHERMOCK_DISCARD_METHOD "pubsub__publisherMock_discard"
 
 
 /*============================================================================
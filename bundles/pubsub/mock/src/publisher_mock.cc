@@ -45,6 +45,42 @@ static int pubsub__publisherMock_send(void *handle, unsigned int msgTypeId, cons
         .returnIntValue();
 }
 
+/*============================================================================
+  MOCK - mock function for pubsub_publisher->loan
+  ============================================================================*/
+static int pubsub__publisherMock_loan(void *handle, unsigned int msgTypeId, size_t size, void **buffer) {
+    return mock(PUBSUB_PUBLISHERMOCK_SCOPE)
+        .actualCall(PUBSUB_PUBLISHERMOCK_LOAN_METHOD)
+        .withPointerParameter("handle", handle)
+        .withParameter("msgTypeId", msgTypeId)
+        .withUnsignedLongIntParameter("size", size)
+        .withOutputParameter("buffer", buffer)
+        .returnIntValue();
+}
+
+/*============================================================================
+  MOCK - mock function for pubsub_publisher->commit
+  ============================================================================*/
+static int pubsub__publisherMock_commit(void *handle, unsigned int msgTypeId, void *buffer, size_t size) {
+    return mock(PUBSUB_PUBLISHERMOCK_SCOPE)
+        .actualCall(PUBSUB_PUBLISHERMOCK_COMMIT_METHOD)
+        .withPointerParameter("handle", handle)
+        .withParameter("msgTypeId", msgTypeId)
+        .withPointerParameter("buffer", buffer)
+        .withUnsignedLongIntParameter("size", size)
+        .returnIntValue();
+}
+
+/*============================================================================
+  MOCK - mock function for pubsub_publisher->discard
+  ============================================================================*/
+static void pubsub__publisherMock_discard(void *handle, void *buffer) {
+    mock(PUBSUB_PUBLISHERMOCK_SCOPE)
+        .actualCall(PUBSUB_PUBLISHERMOCK_DISCARD_METHOD)
+        .withPointerParameter("handle", handle)
+        .withPointerParameter("buffer", buffer);
+}
+
 /*============================================================================
   MOCK - mock setup for publisher service
   ============================================================================*/
@@ -52,4 +88,7 @@ void pubsub_publisherMock_init(pubsub_publisher_t* srv, void* handle) {
     srv->handle = handle;
     srv->localMsgTypeIdForMsgType = pubsub__publisherMock_localMsgTypeIdForMsgType;
     srv->send = pubsub__publisherMock_send;
+    srv->loan = pubsub__publisherMock_loan;
+    srv->commit = pubsub__publisherMock_commit;
+    srv->discard = pubsub__publisherMock_discard;
 }
@@ -75,3 +75,27 @@ TEST(pubsubmock, publishermock) {
 
 }
 
+TEST(pubsubmock, publishermockLoan) {
+    unsigned int msgId = 11;
+    char loanedBuffer[16];
+    void *mockBuffer = loanedBuffer;
+
+    mock(PUBSUB_PUBLISHERMOCK_SCOPE).expectOneCall(PUBSUB_PUBLISHERMOCK_LOAN_METHOD)
+        .withParameter("handle", mockHandle)
+        .withParameter("msgTypeId", msgId)
+        .withParameter("size", (unsigned long)sizeof(loanedBuffer))
+        .withOutputParameterReturning("buffer", &mockBuffer, sizeof(mockBuffer));
+
+    mock(PUBSUB_PUBLISHERMOCK_SCOPE).expectOneCall(PUBSUB_PUBLISHERMOCK_COMMIT_METHOD)
+        .withParameter("handle", mockHandle)
+        .withParameter("msgTypeId", msgId)
+        .withParameter("buffer", mockBuffer)
+        .withParameter("size", (unsigned long)4);
+
+    pubsub_publisher_t* srv = &mockSrv;
+    void *buffer = NULL;
+    srv->loan(srv->handle, msgId, sizeof(loanedBuffer), &buffer);
+    CHECK(buffer == mockBuffer);
+    memcpy(buffer, "msg", 4);
+    srv->commit(srv->handle, msgId, buffer, 4);
+}
@@ -0,0 +1,333 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "celix_api.h"
+#include "celix_framework_factory.h"
+extern "C" {
+#include "pubsub_tcp_handler.h"
+}
+
+namespace {
+    constexpr int NR_OF_MSGS = 1000;
+    constexpr unsigned int BENCHMARK_BASE_PORT = 48100;
+
+    /**
+     * A tcp handler with a thread running the epoll loop of the handler.
+     */
+    struct HandlerThread {
+        explicit HandlerThread(log_helper_t *logHelper) : handler{pubsub_tcpHandler_create(logHelper)} {
+            pubsub_tcpHandler_setTimeout(handler, 100);
+            pubsub_tcpHandler_setBlockingWrite(handler, false);
+            pubsub_tcpHandler_setSendQueueSize(handler, 64u * 1024u * 1024u);
+        }
+
+        ~HandlerThread() {
+            stop();
+            pubsub_tcpHandler_destroy(handler);
+        }
+
+        void start() {
+            thread = std::thread{[this]{
+                while (running.load()) {
+                    pubsub_tcpHandler_handler(handler);
+                }
+            }};
+        }
+
+        void stop() {
+            running = false;
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+
+        pubsub_tcpHandler_t *handler;
+        std::atomic<bool> running{true};
+        std::thread thread{};
+    };
+
+    void countMsg(void *handle, const pubsub_tcp_msg_header_t *, const unsigned char *, size_t, struct timespec *) {
+        static_cast<std::atomic<long>*>(handle)->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void countAndTouchMsg(void *handle, const pubsub_tcp_msg_header_t *, const unsigned char *buffer, size_t size, struct timespec *) {
+        //touches the payload, as a deserializer would do
+        unsigned int sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+            sum += buffer[i];
+        }
+        benchmark::DoNotOptimize(sum);
+        static_cast<std::atomic<long>*>(handle)->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void countConnection(void *handle, const char *, bool) {
+        static_cast<std::atomic<long>*>(handle)->fetch_add(1);
+    }
+
+    void ignoreDisconnect(void *, const char *, bool) {
+    }
+
+    template<typename P>
+    bool waitFor(P predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+}
+
+/**
+ * Publishes NR_OF_MSGS msgs of range(0) bytes per iteration from one tcp handler to range(1) connected tcp handlers
+ * (over loopback) and waits until all msgs are received.
+ */
+static void BM_TcpHandlerPublish(benchmark::State &state) {
+    static unsigned int port = BENCHMARK_BASE_PORT;
+    auto msgSize = (unsigned int)state.range(0);
+    auto nrOfSubscribers = (int)state.range(1);
+
+    celix_properties_t *config = celix_properties_create();
+    celix_properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    celix_properties_set(config, "org.osgi.framework.storage", ".cacheTcpHandlerBenchmark");
+    celix_framework_t *fw = celix_frameworkFactory_createFramework(config);
+    celix_bundle_context_t *ctx = celix_framework_getFrameworkContext(fw);
+    log_helper_t *logHelper = nullptr;
+    logHelper_create(ctx, &logHelper);
+    logHelper_start(logHelper);
+
+    std::string url = std::string{"tcp://127.0.0.1:"} + std::to_string(port++);
+    std::atomic<long> connections{0};
+    auto publisher = std::unique_ptr<HandlerThread>{new HandlerThread{logHelper}};
+    pubsub_tcpHandler_addConnectionCallback(publisher->handler, &connections, countConnection, ignoreDisconnect);
+    if (pubsub_tcpHandler_listen(publisher->handler, (char*)url.c_str()) < 0) {
+        state.SkipWithError("Cannot listen on loopback");
+    }
+    publisher->start();
+
+    std::atomic<long> count{0};
+    std::vector<std::unique_ptr<HandlerThread>> subscribers{};
+    for (int i = 0; i < nrOfSubscribers; ++i) {
+        subscribers.emplace_back(new HandlerThread{logHelper});
+        pubsub_tcpHandler_addMessageHandler(subscribers.back()->handler, &count, countMsg);
+        pubsub_tcpHandler_connect(subscribers.back()->handler, (char*)url.c_str());
+        subscribers.back()->start();
+    }
+    if (!waitFor([&]{ return connections.load() >= nrOfSubscribers; })) {
+        state.SkipWithError("Subscribers not connected");
+    }
+
+    std::vector<char> payload(msgSize, 'x');
+    long expected = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < NR_OF_MSGS; ++i) {
+            pubsub_tcp_msg_header_t header{};
+            header.type = 1;
+            header.seqNr = (uint32_t)i;
+            pubsub_tcpHandler_write(publisher->handler, &header, payload.data(), msgSize, 0);
+        }
+        expected += (long)NR_OF_MSGS * nrOfSubscribers;
+        if (!waitFor([&]{ return count.load() >= expected; })) {
+            state.SkipWithError("Not all msgs received");
+            break;
+        }
+    }
+    state.SetItemsProcessed(count.load());
+    state.SetBytesProcessed(count.load() * (int64_t)msgSize);
+
+    subscribers.clear();
+    publisher.reset();
+    logHelper_stop(logHelper);
+    logHelper_destroy(&logHelper);
+    celix_frameworkFactory_destroyFramework(fw);
+}
+BENCHMARK(BM_TcpHandlerPublish)
+    ->Args({64, 1})->Args({64, 4})->Args({64, 16})
+    ->Args({4096, 1})->Args({4096, 4})->Args({4096, 16})
+    ->Args({65536, 1})->Args({65536, 4})
+    ->UseRealTime();
+
+/**
+ * Publishes NR_OF_MSGS msgs of 4096 bytes per iteration from each of range(0) tcp handlers to one connected tcp handler
+ * with range(1) receive threads and range(2) dispatch threads, and waits until all msgs are received.
+ */
+static void BM_TcpHandlerReceive(benchmark::State &state) {
+    static unsigned int port = BENCHMARK_BASE_PORT + 100;
+    constexpr unsigned int msgSize = 4096;
+    auto nrOfPublishers = (int)state.range(0);
+    auto nrOfReceiveThreads = (unsigned int)state.range(1);
+    auto nrOfDispatchThreads = (unsigned int)state.range(2);
+
+    celix_properties_t *config = celix_properties_create();
+    celix_properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    celix_properties_set(config, "org.osgi.framework.storage", ".cacheTcpHandlerBenchmark");
+    celix_framework_t *fw = celix_frameworkFactory_createFramework(config);
+    celix_bundle_context_t *ctx = celix_framework_getFrameworkContext(fw);
+    log_helper_t *logHelper = nullptr;
+    logHelper_create(ctx, &logHelper);
+    logHelper_start(logHelper);
+
+    std::atomic<long> count{0};
+    auto subscriber = std::unique_ptr<HandlerThread>{new HandlerThread{logHelper}};
+    pubsub_tcpHandler_createReceiveBufferStore(subscriber->handler, 1, 65 * 1024); //as the topic receiver does by default
+    pubsub_tcpHandler_setReceiveThreads(subscriber->handler, nrOfReceiveThreads);
+    pubsub_tcpHandler_setDispatchThreads(subscriber->handler, nrOfDispatchThreads, 0);
+    pubsub_tcpHandler_addMessageHandler(subscriber->handler, &count, countAndTouchMsg);
+
+    std::atomic<long> connections{0};
+    std::vector<std::unique_ptr<HandlerThread>> publishers{};
+    for (int i = 0; i < nrOfPublishers; ++i) {
+        std::string url = std::string{"tcp://127.0.0.1:"} + std::to_string(port++);
+        publishers.emplace_back(new HandlerThread{logHelper});
+        pubsub_tcpHandler_addConnectionCallback(publishers.back()->handler, &connections, countConnection, ignoreDisconnect);
+        if (pubsub_tcpHandler_listen(publishers.back()->handler, (char*)url.c_str()) < 0) {
+            state.SkipWithError("Cannot listen on loopback");
+        }
+        publishers.back()->start();
+        pubsub_tcpHandler_connect(subscriber->handler, (char*)url.c_str());
+    }
+    subscriber->start();
+    if (!waitFor([&]{ return connections.load() >= nrOfPublishers; })) {
+        state.SkipWithError("Publishers not connected");
+    }
+
+    std::vector<char> payload(msgSize, 'x');
+    long expected = 0;
+    for (auto _ : state) {
+        std::vector<std::thread> threads{};
+        for (auto &publisher : publishers) {
+            threads.emplace_back([&payload, &publisher]{
+                for (int i = 0; i < NR_OF_MSGS; ++i) {
+                    pubsub_tcp_msg_header_t header{};
+                    header.type = 1;
+                    header.seqNr = (uint32_t)i;
+                    pubsub_tcpHandler_write(publisher->handler, &header, payload.data(), msgSize, 0);
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        expected += (long)NR_OF_MSGS * nrOfPublishers;
+        if (!waitFor([&]{ return count.load() >= expected; })) {
+            state.SkipWithError("Not all msgs received");
+            break;
+        }
+    }
+    state.SetItemsProcessed(count.load());
+    state.SetBytesProcessed(count.load() * (int64_t)msgSize);
+
+    subscriber.reset();
+    publishers.clear();
+    logHelper_stop(logHelper);
+    logHelper_destroy(&logHelper);
+    celix_frameworkFactory_destroyFramework(fw);
+}
+BENCHMARK(BM_TcpHandlerReceive)
+    ->Args({4, 1, 0})->Args({4, 2, 0})->Args({4, 4, 0})
+    ->Args({4, 1, 2})->Args({4, 4, 4})
+    ->UseRealTime();
+
+/**
+ * Sends NR_OF_MSGS msgs of 4096 bytes per iteration from each of range(0) connecting tcp handlers to one listening tcp
+ * handler with range(1) receive threads, so that the listen fd is added to the epoll fd of every receive thread.
+ */
+static void BM_TcpHandlerListenWithReceiveThreads(benchmark::State &state) {
+    static unsigned int port = BENCHMARK_BASE_PORT + 200;
+    constexpr unsigned int msgSize = 4096;
+    auto nrOfSenders = (int)state.range(0);
+    auto nrOfReceiveThreads = (unsigned int)state.range(1);
+
+    celix_properties_t *config = celix_properties_create();
+    celix_properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    celix_properties_set(config, "org.osgi.framework.storage", ".cacheTcpHandlerBenchmark");
+    celix_framework_t *fw = celix_frameworkFactory_createFramework(config);
+    celix_bundle_context_t *ctx = celix_framework_getFrameworkContext(fw);
+    log_helper_t *logHelper = nullptr;
+    logHelper_create(ctx, &logHelper);
+    logHelper_start(logHelper);
+
+    std::string url = std::string{"tcp://127.0.0.1:"} + std::to_string(port++);
+    std::atomic<long> count{0};
+    std::atomic<long> connections{0};
+    auto listener = std::unique_ptr<HandlerThread>{new HandlerThread{logHelper}};
+    pubsub_tcpHandler_setReceiveThreads(listener->handler, nrOfReceiveThreads);
+    pubsub_tcpHandler_addMessageHandler(listener->handler, &count, countAndTouchMsg);
+    pubsub_tcpHandler_addConnectionCallback(listener->handler, &connections, countConnection, ignoreDisconnect);
+    if (pubsub_tcpHandler_listen(listener->handler, (char*)url.c_str()) < 0) {
+        state.SkipWithError("Cannot listen on loopback with receive threads");
+    }
+    listener->start();
+
+    std::vector<std::unique_ptr<HandlerThread>> senders{};
+    for (int i = 0; i < nrOfSenders; ++i) {
+        senders.emplace_back(new HandlerThread{logHelper});
+        pubsub_tcpHandler_connect(senders.back()->handler, (char*)url.c_str());
+        senders.back()->start();
+    }
+    if (!waitFor([&]{ return connections.load() >= nrOfSenders; })) {
+        state.SkipWithError("Senders not connected");
+    }
+
+    std::vector<char> payload(msgSize, 'x');
+    long expected = 0;
+    for (auto _ : state) {
+        std::vector<std::thread> threads{};
+        for (auto &sender : senders) {
+            threads.emplace_back([&payload, &sender]{
+                for (int i = 0; i < NR_OF_MSGS; ++i) {
+                    pubsub_tcp_msg_header_t header{};
+                    header.type = 1;
+                    header.seqNr = (uint32_t)i;
+                    pubsub_tcpHandler_write(sender->handler, &header, payload.data(), msgSize, 0);
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        expected += (long)NR_OF_MSGS * nrOfSenders;
+        if (!waitFor([&]{ return count.load() >= expected; })) {
+            state.SkipWithError("Not all msgs received");
+            break;
+        }
+    }
+    state.SetItemsProcessed(count.load());
+    state.SetBytesProcessed(count.load() * (int64_t)msgSize);
+
+    senders.clear();
+    listener.reset();
+    logHelper_stop(logHelper);
+    logHelper_destroy(&logHelper);
+    celix_frameworkFactory_destroyFramework(fw);
+}
+BENCHMARK(BM_TcpHandlerListenWithReceiveThreads)
+    ->Args({4, 0})->Args({4, 2})->Args({4, 4})
+    ->UseRealTime();
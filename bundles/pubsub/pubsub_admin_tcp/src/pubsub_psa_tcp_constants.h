@@ -26,6 +26,7 @@
 #define PSA_TCP_MAX_RECV_SESSIONS               "PSA_TCP_MAX_RECV_SESSIONS"
 #define PSA_TCP_RECV_BUFFER_SIZE                "PSA_TCP_RECV_BUFFER_SIZE"
 #define PSA_TCP_TIMEOUT                         "PSA_TCP_TIMEOUT"
+#define PSA_TCP_MAX_RECV_MSG_SIZE               "PSA_TCP_MAX_RECV_MSG_SIZE"
 
 #define PSA_TCP_DEFAULT_BASE_PORT               5501
 #define PSA_TCP_DEFAULT_MAX_PORT                6000
@@ -34,6 +35,7 @@
 
 #define PSA_TCP_DEFAULT_RECV_BUFFER_SIZE        65 * 1024
 #define PSA_TCP_DEFAULT_TIMEOUT                 2000
+#define PSA_TCP_DEFAULT_MAX_RECV_MSG_SIZE       64 * 1024 * 1024
 
 #define PSA_TCP_DEFAULT_QOS_SAMPLE_SCORE        30
 #define PSA_TCP_DEFAULT_QOS_CONTROL_SCORE       70
@@ -47,12 +49,48 @@
 #define PSA_TCP_METRICS_ENABLED                 "PSA_TCP_METRICS_ENABLED"
 #define PSA_TCP_DEFAULT_METRICS_ENABLED         true
 
+/**
+ * Whether a received msg is deserialized once and shared between the subscribers of a topic receiver, instead of
+ * deserialized for every subscriber. Subscribers must handle a shared msg as immutable.
+ * See pubsub_shared_msg.h
+ */
+#define PSA_TCP_SHARED_MSG_ENABLED              "PSA_TCP_SHARED_MSG_ENABLED"
+#define PSA_TCP_DEFAULT_SHARED_MSG_ENABLED      false
+
+/**
+ * The nr of threads which read the connections of a topic receiver. The connections to the topic senders are divided
+ * over the receive threads, a connection is always read by the same thread.
+ * Note that with more than 1 receive thread -or with dispatch threads- the subscribers of a topic can be called
+ * concurrently for msgs of different connections.
+ */
+#define PSA_TCP_RECV_THREADS                    "PSA_TCP_RECV_THREADS"
+#define PSA_TCP_DEFAULT_RECV_THREADS            1
+
+/**
+ * The nr of threads which process (deserialize and deliver) the received msgs of a topic receiver, so that the
+ * connections are read further while the msgs are processed. 0 means that the msgs are processed by the receive
+ * threads. The msgs of a connection are processed in order.
+ * PSA_TCP_DISPATCH_QUEUE_SIZE is the max nr of msgs queued per dispatch thread, before the receive threads wait.
+ */
+#define PSA_TCP_DISPATCH_THREADS                "PSA_TCP_DISPATCH_THREADS"
+#define PSA_TCP_DEFAULT_DISPATCH_THREADS        0
+#define PSA_TCP_DISPATCH_QUEUE_SIZE             "PSA_TCP_DISPATCH_QUEUE_SIZE"
+#define PSA_TCP_DEFAULT_DISPATCH_QUEUE_SIZE     1024
+
 #define PUBSUB_TCP_VERBOSE_KEY                  "PSA_TCP_VERBOSE"
 #define PUBSUB_TCP_VERBOSE_DEFAULT              true
 
 #define PUBSUB_TCP_PUBLISHER_BLOCKING_KEY       "PUBSUB_TCP_PUBLISHER_BLOCKING"
 #define PUBSUB_TCP_PUBLISHER_BLOCKING_DEFAULT   true
 
+/**
+ * The max nr of bytes queued per connection, for msgs which cannot be written directly because the socket buffer of
+ * the connection is full (e.g. a slow subscriber). The queued msgs are written by the send thread of the topic
+ * sender. When the send queue of a connection is full, msgs for that connection are dropped.
+ */
+#define PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE_KEY      "PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE"
+#define PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE_DEFAULT  (1024 * 1024)
+
 #define PUBSUB_TCP_SUBSCRIBER_BLOCKING_KEY      "PUBSUB_TCP_SUBSCRIBER_BLOCKING"
 #define PUBSUB_TCP_SUBSCRIBER_BLOCKING_DEFAULT   true
 
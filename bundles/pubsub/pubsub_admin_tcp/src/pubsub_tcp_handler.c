@@ -41,6 +41,7 @@
 #include <netinet/tcp.h>
 #include "hash_map.h"
 #include "utils.h"
+#include "pubsub_buffer_pool.h"
 #include "pubsub_tcp_handler.h"
 
 #define IP_HEADER_SIZE  20
@@ -48,6 +49,9 @@
 #define MAX_EPOLL_EVENTS   64
 #define MAX_MSG_VECTOR_LEN 64
 #define MAX_DEFAULT_BUFFER_SIZE 4u
+#define MAX_DEFAULT_SEND_QUEUE_SIZE (1024u * 1024u)
+#define MAX_DEFAULT_RECV_MSG_SIZE (64u * 1024u * 1024u)
+#define MAX_DEFAULT_DISPATCH_QUEUE_SIZE 1024u
 
 
 #define READ_STATE_INIT   0u
@@ -66,23 +70,81 @@
     logHelper_log(handle->logHelper, OSGI_LOGSERVICE_ERROR, __VA_ARGS__)
 
 
+//
+// A (part of a) msg which could not be written directly and is queued for the epoll thread.
+// The data of the msg directly follows the struct.
+//
+typedef struct psa_tcp_queued_msg {
+    struct psa_tcp_queued_msg *next;
+    size_t size;
+} psa_tcp_queued_msg_t;
+
 typedef struct psa_tcp_connection_entry {
     char *url;
     int fd;
+    int efd; //the epoll fd of the receive thread which handles the connection
     struct sockaddr_in addr;
     socklen_t len;
     bool connected;
+    celix_thread_mutex_t readMutex; //protects the read administration below
     unsigned int bufferSize;
-    char *buffer;
+    char *buffer; //read buffer, taken from the receive buffer pool of the handler
+    bool largeBuffer; //true if the read buffer is grown for a large msg
     int bufferReadSize;
     int expectedReadSize;
     int readState;
+    unsigned int readSeqNr;
     pubsub_tcp_msg_header_t header;
-
+    struct {
+        celix_thread_mutex_t mutex; //protects the send queue and the writes on the fd
+        psa_tcp_queued_msg_t *head;
+        psa_tcp_queued_msg_t *tail;
+        size_t offset; //nr of bytes of the head msg which are already written
+        size_t size; //nr of queued bytes
+        bool pollOut; //whether EPOLLOUT is registered for the fd
+    } sendQueue;
 } psa_tcp_connection_entry_t;
 
+//
+// An additional receive thread, with its own epoll fd. The connections are divided over the receive threads,
+// so that a connection is always handled by the same thread.
+//
+typedef struct psa_tcp_receive_thread {
+    pubsub_tcpHandler_t *handle;
+    celix_thread_t thread;
+    int efd;
+} psa_tcp_receive_thread_t;
+
+//
+// A received msg queued for a dispatch thread.
+// The buffer with the payload -the read buffer of the connection or a copy of a small msg- directly follows the struct.
+//
+typedef struct psa_tcp_dispatch_msg {
+    struct psa_tcp_dispatch_msg *next;
+    pubsub_tcp_msg_header_t header;
+    const unsigned char *payload;
+    size_t size;
+    struct timespec receiveTime;
+} psa_tcp_dispatch_msg_t;
+
+//
+// The read buffers are taken from the receive buffer pool with room for a dispatch msg in front of the read buffer,
+// so that a read msg can be handed over to a dispatch thread without a copy.
+//
+#define READ_BUFFER_PREFIX_SIZE ((sizeof(psa_tcp_dispatch_msg_t) + 15u) & ~((size_t) 15u))
+
+typedef struct psa_tcp_dispatch_thread {
+    pubsub_tcpHandler_t *handle;
+    celix_thread_t thread;
+    celix_thread_mutex_t mutex; //protects below
+    celix_thread_cond_t cond; //signalled when a msg is queued or taken from the queue
+    bool running;
+    psa_tcp_dispatch_msg_t *head;
+    psa_tcp_dispatch_msg_t *tail;
+    size_t size; //nr of queued msgs
+} psa_tcp_dispatch_thread_t;
+
 struct pubsub_tcpHandler {
-  unsigned int readSeqNr;
   unsigned int msgIdOffset;
   unsigned int msgIdSize;
   bool bypassHeader;
@@ -101,6 +163,22 @@ struct pubsub_tcpHandler {
   log_helper_t *logHelper;
   unsigned int bufferSize;
   unsigned int maxNofBuffer;
+  size_t maxSendQueueSize;
+  unsigned int maxRecvMsgSize;
+  pubsub_buffer_pool_t *sendQueuePool;
+  pubsub_buffer_pool_t *receivePool;
+  struct {
+      celix_thread_mutex_t mutex; //protects running and next
+      bool running;
+      unsigned int next; //the receive thread for the next connection, 0 is the thread calling pubsub_tcpHandler_handler
+      unsigned int nofThreads; //nr of additional receive threads
+      psa_tcp_receive_thread_t *threads;
+  } receiveThreads;
+  struct {
+      unsigned int nofThreads;
+      size_t maxQueueSize; //max nr of queued msgs per dispatch thread
+      psa_tcp_dispatch_thread_t *threads;
+  } dispatchThreads;
   psa_tcp_connection_entry_t own;
 };
 
@@ -109,8 +187,18 @@ static inline int pubsub_tcpHandler_setInAddr(pubsub_tcpHandler_t *handle, const
 static inline int pubsub_tcpHandler_closeConnectionEntry(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, bool lock);
 static inline int pubsub_tcpHandler_closeConnection(pubsub_tcpHandler_t *handle, int fd);
 static inline int pubsub_tcpHandler_makeNonBlocking(pubsub_tcpHandler_t *handle, int fd);
-static inline void pubsub_tcpHandler_setupEntry(psa_tcp_connection_entry_t* entry, int fd, char *url, unsigned int bufferSize);
+static inline void pubsub_tcpHandler_setupEntry(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t* entry, int fd, char *url, unsigned int bufferSize);
 static inline void pubsub_tcpHandler_freeEntry(psa_tcp_connection_entry_t* entry);
+static inline void pubsub_tcpHandler_initEntry(psa_tcp_connection_entry_t* entry);
+static inline void pubsub_tcpHandler_deinitEntry(psa_tcp_connection_entry_t* entry);
+static inline psa_tcp_connection_entry_t* pubsub_tcpHandler_createEntry(pubsub_tcpHandler_t *handle, int fd, char *url, unsigned int bufferSize);
+static inline void pubsub_tcpHandler_destroyEntry(psa_tcp_connection_entry_t* entry);
+static inline int pubsub_tcpHandler_efdOf(pubsub_tcpHandler_t *handle, unsigned int index);
+static inline int pubsub_tcpHandler_nextEfd(pubsub_tcpHandler_t *handle);
+static void pubsub_tcpHandler_drainSendQueue(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry);
+static int pubsub_tcpHandler_handleEvents(pubsub_tcpHandler_t *handle, int efd);
+static void pubsub_tcpHandler_stopReceiveThreads(pubsub_tcpHandler_t *handle);
+static void pubsub_tcpHandler_stopDispatchThreads(pubsub_tcpHandler_t *handle);
 
 
 //
@@ -128,9 +216,17 @@ pubsub_tcpHandler_t *pubsub_tcpHandler_create(log_helper_t *logHelper) {
         handle->msgIdSize = 4;
         handle->bypassHeader = false;
         handle->bufferSize = MAX_DEFAULT_BUFFER_SIZE;
-        handle->maxNofBuffer = 1; // Reserved for future Use;
+        handle->maxNofBuffer = PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS;
         handle->useBlockingWrite = true;
-        pubsub_tcpHandler_setupEntry(&handle->own, -1, NULL, MAX_DEFAULT_BUFFER_SIZE);
+        handle->maxSendQueueSize = MAX_DEFAULT_SEND_QUEUE_SIZE;
+        handle->maxRecvMsgSize = MAX_DEFAULT_RECV_MSG_SIZE;
+        handle->sendQueuePool = pubsub_bufferPool_create(PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS);
+        handle->receivePool = pubsub_bufferPool_create(PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS);
+        handle->receiveThreads.running = true;
+        handle->dispatchThreads.maxQueueSize = MAX_DEFAULT_DISPATCH_QUEUE_SIZE;
+        celixThreadMutex_create(&handle->receiveThreads.mutex, NULL);
+        pubsub_tcpHandler_initEntry(&handle->own);
+        pubsub_tcpHandler_setupEntry(handle, &handle->own, -1, NULL, MAX_DEFAULT_BUFFER_SIZE);
         celixThreadRwlock_create(&handle->dbLock, 0);
         //signal(SIGPIPE, SIG_IGN);
     }
@@ -144,6 +240,9 @@ pubsub_tcpHandler_t *pubsub_tcpHandler_create(log_helper_t *logHelper) {
 void pubsub_tcpHandler_destroy(pubsub_tcpHandler_t *handle) {
     printf("### Destroying BufferHandler TCP\n");
     if (handle != NULL) {
+        // Stop the threads before the connections are closed
+        pubsub_tcpHandler_stopReceiveThreads(handle);
+        pubsub_tcpHandler_stopDispatchThreads(handle);
         celixThreadRwlock_writeLock(&handle->dbLock);
         pubsub_tcpHandler_close(handle);
         hash_map_iterator_t iter = hashMapIterator_construct(handle->url_map);
@@ -155,11 +254,19 @@ void pubsub_tcpHandler_destroy(pubsub_tcpHandler_t *handle) {
         }
 
         if (handle->efd >= 0) close(handle->efd);
+        for (unsigned int i = 0; i < handle->receiveThreads.nofThreads; i++) {
+            if (handle->receiveThreads.threads[i].efd >= 0) close(handle->receiveThreads.threads[i].efd);
+        }
+        free(handle->receiveThreads.threads);
         pubsub_tcpHandler_freeEntry(&handle->own);
+        pubsub_tcpHandler_deinitEntry(&handle->own);
         hashMap_destroy(handle->url_map, false, false);
         hashMap_destroy(handle->fd_map, false, false);
+        pubsub_bufferPool_destroy(handle->sendQueuePool);
+        pubsub_bufferPool_destroy(handle->receivePool);
         celixThreadRwlock_unlock(&handle->dbLock);
         celixThreadRwlock_destroy(&handle->dbLock);
+        celixThreadMutex_destroy(&handle->receiveThreads.mutex);
         free(handle);
     }
 }
@@ -212,10 +319,14 @@ int pubsub_tcpHandler_close(pubsub_tcpHandler_t *handle) {
     int rc = 0;
     if (handle != NULL) {
         celixThreadRwlock_writeLock(&handle->dbLock);
-        if ((handle->efd >= 0) && (handle->own.fd >= 0)) {
+        for (unsigned int i = 0; (handle->own.fd >= 0) && (i <= handle->receiveThreads.nofThreads); i++) {
+            int efd = pubsub_tcpHandler_efdOf(handle, i);
+            if (efd < 0) {
+                continue;
+            }
             struct epoll_event event;
             bzero(&event, sizeof(struct epoll_event)); // zero the struct
-            rc = epoll_ctl(handle->efd, EPOLL_CTL_DEL, handle->own.fd, &event);
+            rc = epoll_ctl(efd, EPOLL_CTL_DEL, handle->own.fd, &event);
             if (rc < 0) {
                 L_ERROR("[PSA TCP] Error disconnecting %s\n", strerror(errno));
             }
@@ -226,14 +337,36 @@ int pubsub_tcpHandler_close(pubsub_tcpHandler_t *handle) {
     return rc;
 }
 
+//
+// Takes a read buffer of at least size bytes from the receive buffer pool
+//
+static inline char *pubsub_tcpHandler_takeReadBuffer(pubsub_tcpHandler_t *handle, unsigned int size, unsigned int *bufferSize) {
+    if (size < sizeof(pubsub_tcp_msg_header_t)) {
+        size = sizeof(pubsub_tcp_msg_header_t); // every read starts with a header
+    }
+    char *buffer = pubsub_bufferPool_take(handle->receivePool, READ_BUFFER_PREFIX_SIZE + size);
+    if (buffer == NULL) {
+        *bufferSize = 0;
+        return NULL;
+    }
+    *bufferSize = (unsigned int) (pubsub_bufferPool_capacity(buffer) - READ_BUFFER_PREFIX_SIZE);
+    return buffer + READ_BUFFER_PREFIX_SIZE;
+}
+
+static inline void pubsub_tcpHandler_releaseReadBuffer(char *buffer) {
+    if (buffer != NULL) {
+        pubsub_bufferPool_release(buffer - READ_BUFFER_PREFIX_SIZE);
+    }
+}
+
 static inline
-void pubsub_tcpHandler_setupEntry(psa_tcp_connection_entry_t* entry, int fd, char *url, unsigned int bufferSize) {
+void pubsub_tcpHandler_setupEntry(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t* entry, int fd, char *url, unsigned int bufferSize) {
     entry->fd = fd;
+    entry->efd = handle->efd;
     if  (url) entry->url = strndup(url, 1024 * 1024);
     if ((bufferSize > entry->bufferSize)&&(bufferSize)) {
-        entry->bufferSize = bufferSize;
-        if (entry->buffer) free(entry->buffer);
-        entry->buffer = calloc(sizeof(char), entry->bufferSize);
+        pubsub_tcpHandler_releaseReadBuffer(entry->buffer);
+        entry->buffer = pubsub_tcpHandler_takeReadBuffer(handle, bufferSize, &entry->bufferSize);
     }
     entry->connected = true;
 }
@@ -249,13 +382,52 @@ void pubsub_tcpHandler_freeEntry(psa_tcp_connection_entry_t* entry) {
         entry->fd = -1;
     }
     if (entry->buffer) {
-        free(entry->buffer);
+        pubsub_tcpHandler_releaseReadBuffer(entry->buffer);
         entry->buffer = NULL;
         entry->bufferSize = 0;
     }
+    psa_tcp_queued_msg_t *msg = entry->sendQueue.head;
+    while (msg != NULL) {
+        psa_tcp_queued_msg_t *next = msg->next;
+        pubsub_bufferPool_release(msg);
+        msg = next;
+    }
+    entry->sendQueue.head = NULL;
+    entry->sendQueue.tail = NULL;
+    entry->sendQueue.offset = 0;
+    entry->sendQueue.size = 0;
     entry->connected = false;
 }
 
+static inline
+void pubsub_tcpHandler_initEntry(psa_tcp_connection_entry_t* entry) {
+    celixThreadMutex_create(&entry->readMutex, NULL);
+    celixThreadMutex_create(&entry->sendQueue.mutex, NULL);
+}
+
+static inline
+void pubsub_tcpHandler_deinitEntry(psa_tcp_connection_entry_t* entry) {
+    celixThreadMutex_destroy(&entry->readMutex);
+    celixThreadMutex_destroy(&entry->sendQueue.mutex);
+}
+
+static inline
+psa_tcp_connection_entry_t* pubsub_tcpHandler_createEntry(pubsub_tcpHandler_t *handle, int fd, char *url, unsigned int bufferSize) {
+    psa_tcp_connection_entry_t *entry = calloc(1, sizeof(*entry));
+    pubsub_tcpHandler_initEntry(entry);
+    pubsub_tcpHandler_setupEntry(handle, entry, fd, url, bufferSize);
+    entry->efd = pubsub_tcpHandler_nextEfd(handle);
+    entry->sendQueue.pollOut = true; //a connection is registered for EPOLLOUT until it is connected
+    return entry;
+}
+
+static inline
+void pubsub_tcpHandler_destroyEntry(psa_tcp_connection_entry_t* entry) {
+    pubsub_tcpHandler_freeEntry(entry);
+    pubsub_tcpHandler_deinitEntry(entry);
+    free(entry);
+}
+
 int pubsub_tcpHandler_connect(pubsub_tcpHandler_t *handle, char *url) {
     int rc = 0;
     psa_tcp_connection_entry_t *entry = hashMap_get(handle->url_map, (void *) (intptr_t) url);
@@ -288,8 +460,7 @@ int pubsub_tcpHandler_connect(pubsub_tcpHandler_t *handle, char *url) {
             } else {
                 struct sockaddr_in sin;
                 socklen_t len = sizeof(sin);
-                entry = calloc(1, sizeof(*entry));
-                pubsub_tcpHandler_setupEntry(entry, fd, url, handle->bufferSize);
+                entry = pubsub_tcpHandler_createEntry(handle, fd, url, handle->bufferSize);
                 entry->connected = false; // Wait till epoll event, to report connected.
                 rc = getsockname(fd, (struct sockaddr *) &sin, &len);
                 if (rc < 0) {
@@ -308,10 +479,9 @@ int pubsub_tcpHandler_connect(pubsub_tcpHandler_t *handle, char *url) {
             bzero(&event, sizeof(struct epoll_event)); // zero the struct
             event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLOUT;
             event.data.fd = entry->fd;
-            rc = epoll_ctl(handle->efd, EPOLL_CTL_ADD, entry->fd, &event);
+            rc = epoll_ctl(entry->efd, EPOLL_CTL_ADD, entry->fd, &event);
             if (rc < 0) {
-                pubsub_tcpHandler_freeEntry(entry);
-                free(entry);
+                pubsub_tcpHandler_destroyEntry(entry);
                 L_ERROR("[TCP Socket] Cannot create epoll %s\n", strerror(errno));
                 errno = 0;
                 entry = NULL;
@@ -349,10 +519,10 @@ static inline int pubsub_tcpHandler_closeConnectionEntry(pubsub_tcpHandler_t *ha
     if (handle != NULL && entry != NULL) {
         fprintf(stdout, "[TCP Socket] Close connection to url: %s: \n", entry->url);
         hashMap_remove(handle->fd_map, (void *) (intptr_t) entry->fd);
-        if ((handle->efd >= 0)) {
+        if ((entry->efd >= 0)) {
             struct epoll_event event;
             bzero(&event, sizeof(struct epoll_event)); // zero the struct
-            rc = epoll_ctl(handle->efd, EPOLL_CTL_DEL, entry->fd, &event);
+            rc = epoll_ctl(entry->efd, EPOLL_CTL_DEL, entry->fd, &event);
             if (rc < 0) {
                 L_ERROR("[PSA TCP] Error disconnecting %s\n", strerror(errno));
                 errno = 0;
@@ -361,8 +531,7 @@ static inline int pubsub_tcpHandler_closeConnectionEntry(pubsub_tcpHandler_t *ha
         if (entry->fd >= 0) {
             if (handle->disconnectMessageCallback)
                 handle->disconnectMessageCallback(handle->connectPayload, entry->url, lock);
-            pubsub_tcpHandler_freeEntry(entry);
-            free(entry);
+            pubsub_tcpHandler_destroyEntry(entry);
         }
     }
     return rc;
@@ -413,7 +582,7 @@ int pubsub_tcpHandler_makeNonBlocking(pubsub_tcpHandler_t *handle, int fd) {
 int pubsub_tcpHandler_listen(pubsub_tcpHandler_t *handle, char *url) {
     int fd = pubsub_tcpHandler_open(handle, url);
     // Make handler fd entry
-    pubsub_tcpHandler_setupEntry(&handle->own, fd, url, MAX_DEFAULT_BUFFER_SIZE);
+    pubsub_tcpHandler_setupEntry(handle, &handle->own, fd, url, MAX_DEFAULT_BUFFER_SIZE);
     int rc = fd;
     celixThreadRwlock_writeLock(&handle->dbLock);
     if (rc >= 0) {
@@ -431,12 +600,24 @@ int pubsub_tcpHandler_listen(pubsub_tcpHandler_t *handle, char *url) {
         }
     }
 
-    if ((rc >= 0) && (handle->efd >= 0)) {
+    // The listen fd is added to the epoll fd of every receive thread, so that an idle receive thread accepts
+    // the new connections. EPOLLEXCLUSIVE ensures that only one of the receive threads is woken up.
+    for (unsigned int i = 0; (rc >= 0) && (i <= handle->receiveThreads.nofThreads); i++) {
+        int efd = pubsub_tcpHandler_efdOf(handle, i);
+        if (efd < 0) {
+            continue;
+        }
         struct epoll_event event;
         bzero(&event, sizeof(event)); // zero the struct
         event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR;
+#ifdef EPOLLEXCLUSIVE
+        if (handle->receiveThreads.nofThreads > 0) {
+            // note epoll_ctl fails with EINVAL for EPOLLRDHUP in combination with EPOLLEXCLUSIVE
+            event.events = (event.events & ~((uint32_t) EPOLLRDHUP)) | EPOLLEXCLUSIVE;
+        }
+#endif
         event.data.fd = fd;
-        rc = epoll_ctl(handle->efd, EPOLL_CTL_ADD, fd, &event);
+        rc = epoll_ctl(efd, EPOLL_CTL_ADD, fd, &event);
         if (rc < 0) {
             L_ERROR("[TCP Socket] Cannot create epoll: %s\n",strerror(errno));
             errno = 0;
@@ -510,13 +691,20 @@ void pubsub_tcpHandler_free_setUrlInfo(pubsub_tcpHandler_url_t *url_info) {
 }
 
 
+//
+// Configures the receive buffer pool, which is shared by all connections of the handler. Up to maxNofBuffers
+// buffers are cached per size class. Buffers still taken from the previous pool are freed on release.
+//
 int pubsub_tcpHandler_createReceiveBufferStore(pubsub_tcpHandler_t *handle,
-                                               unsigned int maxNofBuffers __attribute__ ((__unused__)),
+                                               unsigned int maxNofBuffers,
                                                unsigned int bufferSize) {
     if (handle != NULL) {
         celixThreadRwlock_writeLock(&handle->dbLock);
         handle->bufferSize = bufferSize;
         handle->maxNofBuffer = maxNofBuffers;
+        pubsub_bufferPool_destroy(handle->receivePool);
+        handle->receivePool = pubsub_bufferPool_create((maxNofBuffers > PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS) ?
+                                                       maxNofBuffers : PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS);
         celixThreadRwlock_unlock(&handle->dbLock);
     }
     return 0;
@@ -549,6 +737,22 @@ void pubsub_tcpHandler_setBlockingWrite(pubsub_tcpHandler_t *handle, bool blocki
     }
 }
 
+void pubsub_tcpHandler_setSendQueueSize(pubsub_tcpHandler_t *handle, size_t size) {
+    if (handle != NULL) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        handle->maxSendQueueSize = size;
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
+void pubsub_tcpHandler_setMaxReceiveMsgSize(pubsub_tcpHandler_t *handle, unsigned int size) {
+    if (handle != NULL) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        handle->maxRecvMsgSize = size;
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
 void pubsub_tcpHandler_setBlockingRead(pubsub_tcpHandler_t *handle, bool blocking) {
     if (handle != NULL) {
         celixThreadRwlock_writeLock(&handle->dbLock);
@@ -557,12 +761,42 @@ void pubsub_tcpHandler_setBlockingRead(pubsub_tcpHandler_t *handle, bool blockin
     }
 }
 
+//
+// Ensures that the read buffer of a connection can hold size bytes. If not, a larger buffer is taken from the receive
+// buffer pool (instead of a realloc) and the already read data is copied to it. The larger buffer is returned to the
+// pool when the msg is processed, see pubsub_tcpHandler_releaseLargeBuffer.
+// If no larger buffer can be taken, the current buffer is kept and -1 is returned.
+// Note the read lock of the entry must be locked.
+//
+static inline int pubsub_tcpHandler_ensureBufferSize(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, unsigned int size) {
+    if (size > entry->bufferSize) {
+        unsigned int bufferSize = 0;
+        char *buffer = pubsub_tcpHandler_takeReadBuffer(handle, size, &bufferSize);
+        if (buffer == NULL) {
+            L_ERROR("[TCP Socket: %d, url: %s] Cannot grow read buffer to %u bytes\n", entry->fd, entry->url, size);
+            return -1;
+        }
+        if (entry->bufferReadSize > 0) {
+            memcpy(buffer, entry->buffer, (size_t) entry->bufferReadSize);
+        }
+        pubsub_tcpHandler_releaseReadBuffer(entry->buffer);
+        entry->buffer = buffer;
+        entry->bufferSize = bufferSize;
+        entry->largeBuffer = true;
+        L_DEBUG("[TCP Socket: %d, url: %s,  grow read buffer: (%u, %u) \n", entry->fd, entry->url,
+                entry->bufferSize, size);
+    }
+    return 0;
+}
+
 //
 // Reads data from the filedescriptor which has date (determined by epoll()) and stores it in the internal structure
 // If the message is completely reassembled true is returned and the index and size have valid values
 //
 int pubsub_tcpHandler_dataAvailable(pubsub_tcpHandler_t *handle, int fd, unsigned int *index, unsigned int *size) {
-    celixThreadRwlock_writeLock(&handle->dbLock);
+    // Note the handler lock only protects the connection administration, the read administration
+    // is protected by the (per connection) read lock of the entry.
+    celixThreadRwlock_readLock(&handle->dbLock);
     *index = 0;
     *size = 0;
     psa_tcp_connection_entry_t *entry = NULL;
@@ -578,6 +812,7 @@ int pubsub_tcpHandler_dataAvailable(pubsub_tcpHandler_t *handle, int fd, unsigne
         celixThreadRwlock_unlock(&handle->dbLock);
         return -1;
     }
+    celixThreadMutex_lock(&entry->readMutex);
 
     // In init state
     if (!entry->readState) {
@@ -586,14 +821,12 @@ int pubsub_tcpHandler_dataAvailable(pubsub_tcpHandler_t *handle, int fd, unsigne
             // First start looking for header
             entry->readState = READ_STATE_HEADER;
             entry->expectedReadSize = sizeof(pubsub_tcp_msg_header_t);
-            if (entry->expectedReadSize > entry->bufferSize) {
-                char* buffer = realloc(entry->buffer, (size_t )entry->expectedReadSize);
-                if (buffer) {
-                    entry->buffer = buffer;
-                    entry->bufferSize = entry->expectedReadSize;
-                    L_WARN("[TCP Socket: %d, url: %s,  realloc read buffer: (%d, %d) \n", entry->fd, entry->url,
-                           entry->bufferSize, entry->expectedReadSize);
-                }
+            if (pubsub_tcpHandler_ensureBufferSize(handle, entry, (unsigned int) entry->expectedReadSize) != 0) {
+                // No buffer to read the header in, try again at the next read
+                entry->readState = READ_STATE_INIT;
+                celixThreadMutex_unlock(&entry->readMutex);
+                celixThreadRwlock_unlock(&handle->dbLock);
+                return -1;
             }
         } else {
             // When no header use Max buffer size
@@ -632,31 +865,33 @@ int pubsub_tcpHandler_dataAvailable(pubsub_tcpHandler_t *handle, int fd, unsigne
                 // When markers are not correct, find a new marker and update state to FIND Header
                 L_ERROR(
                     "[TCP Socket] Read Header: Marker (%d)  start: 0x%08X != 0x%08X stop: 0x%08X != 0x%08X errno: %s",
-                    handle->readSeqNr, pHeader->marker_start, MARKER_START_PATTERN, pHeader->marker_end,
+                    entry->readSeqNr, pHeader->marker_start, MARKER_START_PATTERN, pHeader->marker_end,
                     MARKER_END_PATTERN, strerror(errno));
                 entry->bufferReadSize = 0;
                 entry->expectedReadSize = sizeof(unsigned int);
                 entry->readState = READ_STATE_FIND_HEADER;
             } else if (entry->readState == READ_STATE_HEADER) {
                 // Header is found, read the data from the socket, update state to READ_STATE_DATA
-                int buffer_size = pHeader->bufferSize + entry->bufferReadSize;
-                // When buffer is not big enough, reallocate buffer
-                if ((buffer_size > entry->bufferSize) && (buffer_size)) {
-                    char* buffer = realloc(entry->buffer, (size_t )buffer_size);
-                    if (buffer) {
-                        entry->buffer = buffer;
-                        entry->bufferSize = buffer_size;
-                        L_WARN("[TCP Socket: %d, url: %s,  realloc read buffer: (%d, %d) \n", entry->fd, entry->url,
-                               entry->bufferSize, buffer_size);
-                    }
+                // When buffer is not big enough, take a larger buffer from the receive buffer pool
+                if ((pHeader->bufferSize > handle->maxRecvMsgSize) ||
+                    (pubsub_tcpHandler_ensureBufferSize(handle, entry, pHeader->bufferSize + entry->bufferReadSize) != 0)) {
+                    // The msg cannot be read, the remaining data of the msg is not read, so close the connection.
+                    L_ERROR("[TCP Socket: %d, url: %s] Cannot read msg of %u bytes (max %u), closing connection\n",
+                            entry->fd, entry->url, pHeader->bufferSize, handle->maxRecvMsgSize);
+                    entry->bufferReadSize = 0;
+                    entry->expectedReadSize = sizeof(unsigned int);
+                    entry->readState = READ_STATE_FIND_HEADER;
+                    nbytes = 0;
+                } else {
+                    pHeader = (pubsub_tcp_msg_header_t *) entry->buffer; // header moved with the buffer
+                    // Set data read size
+                    entry->expectedReadSize = pHeader->bufferSize;
+                    entry->readState++;
                 }
-                // Set data read size
-                entry->expectedReadSize = pHeader->bufferSize;
-                entry->readState++;
                 // The data is read, update administation and set state to READ_STATE_READY
             } else if (entry->readState == READ_STATE_DATA) {
-                handle->readSeqNr = pHeader->seqNr;
-                //fprintf(stdout, "ReadSeqNr: Count: %d\n", handle->readSeqNr);
+                entry->readSeqNr = pHeader->seqNr;
+                //fprintf(stdout, "ReadSeqNr: Count: %d\n", entry->readSeqNr);
                 nbytes = entry->bufferReadSize - sizeof(pubsub_tcp_msg_header_t);
                 if (nbytes == 0) {
                     errno = 0;
@@ -677,12 +912,13 @@ int pubsub_tcpHandler_dataAvailable(pubsub_tcpHandler_t *handle, int fd, unsigne
         pubsub_tcp_msg_header_t *pHeader = (pubsub_tcp_msg_header_t *) entry->buffer;
         if (nbytes != pHeader->bufferSize) {
             L_ERROR( "[TCP Socket] Buffer size is not correct %d: %d!=%d  errno: %s",
-                handle->readSeqNr, nbytes, pHeader->bufferSize, strerror(errno));
+                entry->readSeqNr, nbytes, pHeader->bufferSize, strerror(errno));
             entry->readState = READ_STATE_INIT;
         } else {
             *size = nbytes;
         }
     }
+    celixThreadMutex_unlock(&entry->readMutex);
     celixThreadRwlock_unlock(&handle->dbLock);
     return nbytes;
 }
@@ -697,6 +933,7 @@ int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd, unsigned int ind
     psa_tcp_connection_entry_t *entry = hashMap_get(handle->fd_map, (void *) (intptr_t)fd);
     if (entry == NULL) result = -1;
     if (entry) {
+        celixThreadMutex_lock(&entry->readMutex);
         result = (!entry->connected) ? -1 : result;
         result = (entry->readState != READ_STATE_READY) ? -1 : result;
     }
@@ -705,7 +942,7 @@ int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd, unsigned int ind
             *header = &entry->header;
             *buffer = entry->buffer;
             entry->header.type = (unsigned int) entry->buffer[handle->msgIdOffset];
-            entry->header.seqNr = handle->readSeqNr++;
+            entry->header.seqNr = entry->readSeqNr++;
             entry->header.sendTimeNanoseconds = 0;
             entry->header.sendTimeNanoseconds = 0;
             entry->readState = READ_STATE_INIT;
@@ -716,6 +953,9 @@ int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd, unsigned int ind
         }
         entry->readState = READ_STATE_INIT;
     }
+    if (entry) {
+        celixThreadMutex_unlock(&entry->readMutex);
+    }
     celixThreadRwlock_unlock(&handle->dbLock);
     return result;
 }
@@ -743,11 +983,170 @@ int pubsub_tcpHandler_addConnectionCallback(pubsub_tcpHandler_t *handle, void *p
 }
 
 
+//
+// Sets the EPOLLOUT registration of a connection, so that the epoll thread drains the send queue of the connection.
+// Note the send queue lock of the entry must be locked.
+//
+static inline void pubsub_tcpHandler_setPollOut(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, bool pollOut) {
+    if (entry->sendQueue.pollOut != pollOut && entry->efd >= 0) {
+        struct epoll_event event;
+        bzero(&event, sizeof(event)); // zero the struct
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR | (pollOut ? EPOLLOUT : 0u);
+        event.data.fd = entry->fd;
+        int rc = epoll_ctl(entry->efd, EPOLL_CTL_MOD, entry->fd, &event);
+        if (rc < 0) {
+            L_ERROR("[TCP Socket] Cannot modify epoll %s\n", strerror(errno));
+            errno = 0;
+        } else {
+            entry->sendQueue.pollOut = pollOut;
+        }
+    }
+}
+
+//
+// Queues the not written part of a msg, starting at offset.
+// Note the send queue lock of the entry must be locked.
+//
+static inline void pubsub_tcpHandler_enqueue(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry,
+                                             struct iovec *msg_iovec, size_t msg_iovlen, size_t offset, size_t msgSize) {
+    psa_tcp_queued_msg_t *msg = pubsub_bufferPool_take(handle->sendQueuePool, sizeof(*msg) + (msgSize - offset));
+    if (msg == NULL) {
+        L_ERROR("[TCP Socket] Cannot queue msg for %s, out of memory\n", entry->url);
+        return;
+    }
+    msg->next = NULL;
+    msg->size = msgSize - offset;
+    char *data = (char *) (msg + 1);
+    for (size_t i = 0; i < msg_iovlen; i++) {
+        size_t len = msg_iovec[i].iov_len;
+        if (offset >= len) {
+            offset -= len;
+            continue;
+        }
+        memcpy(data, (char *) msg_iovec[i].iov_base + offset, len - offset);
+        data += len - offset;
+        offset = 0;
+    }
+    if (entry->sendQueue.tail != NULL) {
+        entry->sendQueue.tail->next = msg;
+    } else {
+        entry->sendQueue.head = msg;
+    }
+    entry->sendQueue.tail = msg;
+    entry->sendQueue.size += msg->size;
+    pubsub_tcpHandler_setPollOut(handle, entry, true);
+}
+
+//
+// Writes a msg to a connection. If the send queue of the connection is empty, the msg is written directly and the
+// not written part (socket buffer full) is queued. Otherwise the msg is queued -to keep the msg order- and written
+// by the epoll thread. A msg which does not fit in the send queue is dropped, a msg is never partly dropped.
+// Note the send queue lock of the entry must be locked.
+//
+static inline int pubsub_tcpHandler_writeToConnection(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry,
+                                                      struct msghdr *msg, size_t msgSize, int flags) {
+    ssize_t nbytes = 0;
+    if (entry->sendQueue.head == NULL) {
+        int sendFlags = MSG_NOSIGNAL | flags | (handle->useBlockingWrite ? 0 : MSG_DONTWAIT);
+        nbytes = sendmsg(entry->fd, msg, sendFlags);
+        //  Several errors are OK. When speculative write is being done we may not
+        //  be able to write a single byte to the socket buffer. (socket buffer full)
+        //  In this case the msg is queued.
+        //  Btw, also, SIGSTOP issued by a debugging tool can result in EINTR error.
+        if (nbytes == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                L_ERROR("[TCP Socket] Cannot send msg to %s: %s\n", entry->url, strerror(errno));
+                errno = 0;
+                return -1;
+            }
+            errno = 0;
+            nbytes = 0;
+        }
+    }
+    if ((size_t) nbytes < msgSize) {
+        if (nbytes == 0 && entry->sendQueue.size + msgSize > handle->maxSendQueueSize) {
+            L_WARN("[TCP Socket] Send queue of %s is full (%zu bytes), dropping msg\n", entry->url, entry->sendQueue.size);
+            return -1;
+        }
+        pubsub_tcpHandler_enqueue(handle, entry, msg->msg_iov, msg->msg_iovlen, (size_t) nbytes, msgSize);
+    }
+    return (int) msgSize;
+}
+
+//
+// Writes the queued msgs of a connection, coalescing up to MAX_MSG_VECTOR_LEN msgs per sendmsg call.
+// Called from the epoll thread, when the socket of the connection is writable.
+//
+static void pubsub_tcpHandler_drainSendQueue(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry) {
+    celixThreadMutex_lock(&entry->sendQueue.mutex);
+    while (entry->sendQueue.head != NULL && entry->fd >= 0) {
+        struct iovec msg_iovec[MAX_MSG_VECTOR_LEN];
+        size_t msg_iovlen = 0;
+        size_t msgSize = 0;
+        size_t offset = entry->sendQueue.offset;
+        for (psa_tcp_queued_msg_t *queued = entry->sendQueue.head; queued != NULL && msg_iovlen < MAX_MSG_VECTOR_LEN; queued = queued->next) {
+            msg_iovec[msg_iovlen].iov_base = (char *) (queued + 1) + offset;
+            msg_iovec[msg_iovlen].iov_len = queued->size - offset;
+            msgSize += queued->size - offset;
+            msg_iovlen++;
+            offset = 0;
+        }
+        struct msghdr msg;
+        bzero(&msg, sizeof(msg));
+        msg.msg_iov = msg_iovec;
+        msg.msg_iovlen = msg_iovlen;
+        ssize_t nbytes = sendmsg(entry->fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (nbytes == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                // The connection is broken and will be closed, the queued msgs cannot be send anymore
+                L_ERROR("[TCP Socket] Cannot send queued msgs to %s: %s\n", entry->url, strerror(errno));
+                psa_tcp_queued_msg_t *queued = entry->sendQueue.head;
+                while (queued != NULL) {
+                    psa_tcp_queued_msg_t *next = queued->next;
+                    pubsub_bufferPool_release(queued);
+                    queued = next;
+                }
+                entry->sendQueue.head = NULL;
+                entry->sendQueue.tail = NULL;
+                entry->sendQueue.offset = 0;
+                entry->sendQueue.size = 0;
+            }
+            errno = 0;
+            break;
+        }
+        // Release the written msgs
+        size_t written = (size_t) nbytes;
+        entry->sendQueue.size -= written;
+        while (written > 0) {
+            psa_tcp_queued_msg_t *head = entry->sendQueue.head;
+            size_t remaining = head->size - entry->sendQueue.offset;
+            if (written < remaining) {
+                entry->sendQueue.offset += written;
+                break;
+            }
+            written -= remaining;
+            entry->sendQueue.offset = 0;
+            entry->sendQueue.head = head->next;
+            if (entry->sendQueue.head == NULL) {
+                entry->sendQueue.tail = NULL;
+            }
+            pubsub_bufferPool_release(head);
+        }
+        if ((size_t) nbytes < msgSize) {
+            break; // socket buffer full
+        }
+    }
+    pubsub_tcpHandler_setPollOut(handle, entry, entry->sendQueue.head != NULL);
+    celixThreadMutex_unlock(&entry->sendQueue.mutex);
+}
+
 //
 // Write large data to TCP. .
 //
 int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle, pubsub_tcp_msg_header_t *header, void *buffer,
                             unsigned int size, int flags) {
+    // Note the handler lock only protects the connection administration, a write to a connection
+    // is protected by the (per connection) send queue lock of the entry.
     celixThreadRwlock_readLock(&handle->dbLock);
     int result = 0;
     int written = 0;
@@ -781,23 +1180,19 @@ int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle, pubsub_tcp_msg_header_t
             msg.msg_iovlen = 1;
         }
 
-        int nbytes = 0;
-        if (entry->fd >= 0) nbytes = sendmsg(entry->fd, &msg, MSG_NOSIGNAL);
-        //  Several errors are OK. When speculative write is being done we may not
-        //  be able to write a single byte to the socket buffer. (socket buffer full)
-        //  In this case when socket is not blocking, exit write function.
-        //  Btw, also, SIGSTOP issued by a debugging tool can result in EINTR error.
-        if (nbytes == -1) {
-            result = ((errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) ? 0 : -1;
-            L_ERROR("[TCP Socket] Seq_Id: %d Cannot send msg %s\n", header->seqNr, strerror(errno));
-            errno = 0;
+        size_t msgSize = 0;
+        for (size_t i = 0; i < msg.msg_iovlen; i++) {
+            msgSize += msg.msg_iov[i].iov_len;
         }
-        int msgSize = 0;
-        for (int i = 0; i < msg.msg_iovlen; i++) {
-            msgSize+=msg.msg_iov[i].iov_len;
+        int nbytes = 0;
+        if (entry->fd >= 0) {
+            celixThreadMutex_lock(&entry->sendQueue.mutex);
+            nbytes = pubsub_tcpHandler_writeToConnection(handle, entry, &msg, msgSize, flags);
+            celixThreadMutex_unlock(&entry->sendQueue.mutex);
         }
-        if (nbytes != msgSize) {
-            L_ERROR("[TCP Socket] Seq; %d, MsgSize not correct: %d != %d (BufferSize: %d \n", header->seqNr, msgSize, nbytes, header->bufferSize);
+        if (nbytes < 0) {
+            L_ERROR("[TCP Socket] Seq_Id: %d Cannot send msg to %s\n", header->seqNr, entry->url);
+            result = -1;
         }
         written = (result == 0) ? written + nbytes : written;
     }
@@ -809,12 +1204,268 @@ const char *pubsub_tcpHandler_url(pubsub_tcpHandler_t *handle) {
     return handle->own.url;
 }
 
+//
+// Returns the epoll fd of a receive thread, index 0 is the thread calling pubsub_tcpHandler_handler
+//
+static inline int pubsub_tcpHandler_efdOf(pubsub_tcpHandler_t *handle, unsigned int index) {
+    return (index == 0) ? handle->efd : handle->receiveThreads.threads[index - 1].efd;
+}
+
+//
+// Returns the epoll fd for a new connection, the connections are divided round robin over the receive threads
+//
+static inline int pubsub_tcpHandler_nextEfd(pubsub_tcpHandler_t *handle) {
+    celixThreadMutex_lock(&handle->receiveThreads.mutex);
+    unsigned int index = handle->receiveThreads.next;
+    handle->receiveThreads.next = (index + 1) % (handle->receiveThreads.nofThreads + 1);
+    celixThreadMutex_unlock(&handle->receiveThreads.mutex);
+    return pubsub_tcpHandler_efdOf(handle, index);
+}
+
+static void *pubsub_tcpHandler_receiveThread(void *data) {
+    psa_tcp_receive_thread_t *thread = data;
+    pubsub_tcpHandler_t *handle = thread->handle;
+
+    celixThreadMutex_lock(&handle->receiveThreads.mutex);
+    bool running = handle->receiveThreads.running;
+    celixThreadMutex_unlock(&handle->receiveThreads.mutex);
+
+    while (running) {
+        pubsub_tcpHandler_handleEvents(handle, thread->efd);
+
+        celixThreadMutex_lock(&handle->receiveThreads.mutex);
+        running = handle->receiveThreads.running;
+        celixThreadMutex_unlock(&handle->receiveThreads.mutex);
+    }
+    return NULL;
+}
+
+void pubsub_tcpHandler_setReceiveThreads(pubsub_tcpHandler_t *handle, unsigned int nofThreads) {
+    if ((handle != NULL) && (nofThreads > 1)) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        if ((handle->receiveThreads.threads == NULL) && (handle->own.fd < 0) && (hashMap_size(handle->fd_map) == 0)) {
+            handle->receiveThreads.threads = calloc(nofThreads - 1, sizeof(*handle->receiveThreads.threads));
+            for (unsigned int i = 0; i < nofThreads - 1; i++) {
+                psa_tcp_receive_thread_t *thread = &handle->receiveThreads.threads[i];
+                thread->handle = handle;
+                thread->efd = epoll_create1(0);
+                celixThread_create(&thread->thread, NULL, pubsub_tcpHandler_receiveThread, thread);
+                celixThread_setName(&thread->thread, "TCP Receive");
+            }
+            celixThreadMutex_lock(&handle->receiveThreads.mutex);
+            handle->receiveThreads.nofThreads = nofThreads - 1;
+            celixThreadMutex_unlock(&handle->receiveThreads.mutex);
+        } else {
+            L_WARN("[TCP Socket] Cannot set the receive threads, the receive threads must be set once, before listen or connect\n");
+        }
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
+static void pubsub_tcpHandler_stopReceiveThreads(pubsub_tcpHandler_t *handle) {
+    celixThreadMutex_lock(&handle->receiveThreads.mutex);
+    handle->receiveThreads.running = false;
+    celixThreadMutex_unlock(&handle->receiveThreads.mutex);
+    for (unsigned int i = 0; i < handle->receiveThreads.nofThreads; i++) {
+        celixThread_join(handle->receiveThreads.threads[i].thread, NULL);
+    }
+}
+
+static void *pubsub_tcpHandler_dispatchThread(void *data) {
+    psa_tcp_dispatch_thread_t *thread = data;
+    pubsub_tcpHandler_t *handle = thread->handle;
+
+    celixThreadMutex_lock(&thread->mutex);
+    while (thread->running) {
+        if (thread->head == NULL) {
+            celixThreadCondition_wait(&thread->cond, &thread->mutex);
+            continue;
+        }
+        psa_tcp_dispatch_msg_t *msg = thread->head;
+        thread->head = msg->next;
+        if (thread->head == NULL) {
+            thread->tail = NULL;
+        }
+        thread->size -= 1;
+        celixThreadCondition_broadcast(&thread->cond); // a receive thread can wait for room in the queue
+        celixThreadMutex_unlock(&thread->mutex);
+
+        celixThreadRwlock_readLock(&handle->dbLock);
+        if (handle->processMessageCallback) {
+            handle->processMessageCallback(handle->processMessagePayload, &msg->header, msg->payload, msg->size,
+                                           &msg->receiveTime);
+        }
+        celixThreadRwlock_unlock(&handle->dbLock);
+        pubsub_bufferPool_release(msg);
+
+        celixThreadMutex_lock(&thread->mutex);
+    }
+    celixThreadMutex_unlock(&thread->mutex);
+    return NULL;
+}
+
+void pubsub_tcpHandler_setDispatchThreads(pubsub_tcpHandler_t *handle, unsigned int nofThreads, size_t maxQueueSize) {
+    if ((handle != NULL) && (nofThreads > 0)) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        if ((handle->dispatchThreads.threads == NULL) && (handle->own.fd < 0) && (hashMap_size(handle->fd_map) == 0)) {
+            handle->dispatchThreads.maxQueueSize = (maxQueueSize > 0) ? maxQueueSize : MAX_DEFAULT_DISPATCH_QUEUE_SIZE;
+            handle->dispatchThreads.threads = calloc(nofThreads, sizeof(*handle->dispatchThreads.threads));
+            for (unsigned int i = 0; i < nofThreads; i++) {
+                psa_tcp_dispatch_thread_t *thread = &handle->dispatchThreads.threads[i];
+                thread->handle = handle;
+                thread->running = true;
+                celixThreadMutex_create(&thread->mutex, NULL);
+                celixThreadCondition_init(&thread->cond, NULL);
+                celixThread_create(&thread->thread, NULL, pubsub_tcpHandler_dispatchThread, thread);
+                celixThread_setName(&thread->thread, "TCP Dispatch");
+            }
+            handle->dispatchThreads.nofThreads = nofThreads;
+        } else {
+            L_WARN("[TCP Socket] Cannot set the dispatch threads, the dispatch threads must be set once, before listen or connect\n");
+        }
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
+static void pubsub_tcpHandler_stopDispatchThreads(pubsub_tcpHandler_t *handle) {
+    for (unsigned int i = 0; i < handle->dispatchThreads.nofThreads; i++) {
+        psa_tcp_dispatch_thread_t *thread = &handle->dispatchThreads.threads[i];
+        celixThreadMutex_lock(&thread->mutex);
+        thread->running = false;
+        celixThreadCondition_broadcast(&thread->cond);
+        celixThreadMutex_unlock(&thread->mutex);
+        celixThread_join(thread->thread, NULL);
+
+        // Drop the msgs which are not dispatched
+        psa_tcp_dispatch_msg_t *msg = thread->head;
+        while (msg != NULL) {
+            psa_tcp_dispatch_msg_t *next = msg->next;
+            pubsub_bufferPool_release(msg);
+            msg = next;
+        }
+        celixThreadCondition_destroy(&thread->cond);
+        celixThreadMutex_destroy(&thread->mutex);
+    }
+    free(handle->dispatchThreads.threads);
+    handle->dispatchThreads.threads = NULL;
+    handle->dispatchThreads.nofThreads = 0;
+}
+
+//
+// Creates the dispatch msg for a read msg of a connection.
+// If the msg fills at least half of the read buffer, the read buffer is handed over to a dispatch thread without
+// copying the msg and the connection continues with a new read buffer, of the receive buffer size, from the receive
+// buffer pool. Otherwise the msg is copied to a buffer -of the size class of the msg- from the receive buffer pool, so
+// that a small msg does not pin a (large) read buffer while it is queued. If no new read buffer can be taken, the msg
+// is copied as well, so that the connection keeps its read buffer.
+// Note the handler lock must be (read) locked.
+//
+static inline psa_tcp_dispatch_msg_t *pubsub_tcpHandler_detachDispatchMsg(pubsub_tcpHandler_t *handle, int fd,
+                                                                         const pubsub_tcp_msg_header_t *header,
+                                                                         const void *buffer, unsigned int size) {
+    psa_tcp_dispatch_msg_t *msg = NULL;
+    psa_tcp_connection_entry_t *entry = hashMap_get(handle->fd_map, (void *) (intptr_t) fd);
+    if (entry != NULL) {
+        celixThreadMutex_lock(&entry->readMutex);
+        pubsub_tcp_msg_header_t msgHeader = *header; // note the header is in the read buffer or in the entry
+        size_t usedSize = (size_t) ((const char *) buffer + size - entry->buffer);
+        unsigned int newBufferSize = 0;
+        char *newBuffer = NULL;
+        if (usedSize * 2 >= entry->bufferSize) {
+            newBuffer = pubsub_tcpHandler_takeReadBuffer(handle, handle->bufferSize, &newBufferSize);
+        }
+        if (newBuffer != NULL) {
+            msg = (psa_tcp_dispatch_msg_t *) (entry->buffer - READ_BUFFER_PREFIX_SIZE);
+            msg->payload = buffer;
+            entry->buffer = newBuffer;
+            entry->bufferSize = newBufferSize;
+            entry->largeBuffer = false;
+        } else {
+            msg = pubsub_bufferPool_take(handle->receivePool, READ_BUFFER_PREFIX_SIZE + size);
+            if (msg != NULL) {
+                unsigned char *payload = (unsigned char *) msg + READ_BUFFER_PREFIX_SIZE;
+                memcpy(payload, buffer, size);
+                msg->payload = payload;
+            } else {
+                L_ERROR("[TCP Socket] Cannot dispatch msg of %s, out of memory\n", entry->url);
+            }
+        }
+        if (msg != NULL) {
+            msg->next = NULL;
+            msg->header = msgHeader;
+            msg->size = size;
+            clock_gettime(CLOCK_REALTIME, &msg->receiveTime);
+        }
+        celixThreadMutex_unlock(&entry->readMutex);
+    }
+    return msg;
+}
+
+//
+// Returns a read buffer which is grown for a large msg to the receive buffer pool, after the msg is processed. So that
+// the memory per connection stays bounded to the receive buffer size, while the large buffers are reused -through the
+// pool- by all connections.
+// Note the handler lock must be (read) locked.
+//
+static inline void pubsub_tcpHandler_releaseLargeBuffer(pubsub_tcpHandler_t *handle, int fd) {
+    psa_tcp_connection_entry_t *entry = hashMap_get(handle->fd_map, (void *) (intptr_t) fd);
+    if (entry != NULL) {
+        celixThreadMutex_lock(&entry->readMutex);
+        if (entry->largeBuffer && (entry->readState == READ_STATE_INIT)) {
+            unsigned int bufferSize = 0;
+            char *buffer = pubsub_tcpHandler_takeReadBuffer(handle, handle->bufferSize, &bufferSize);
+            if (buffer != NULL) { // else keep using the large buffer
+                pubsub_tcpHandler_releaseReadBuffer(entry->buffer);
+                entry->buffer = buffer;
+                entry->bufferSize = bufferSize;
+                entry->largeBuffer = false;
+            }
+        }
+        celixThreadMutex_unlock(&entry->readMutex);
+    }
+}
+
+//
+// Queues a msg for the dispatch thread of the connection. The msgs of a connection are always handled by the same
+// dispatch thread, so that the msgs of a connection are handled in order. When the queue of the dispatch thread is
+// full, the receive thread waits (and so stops reading its connections) until there is room in the queue.
+//
+static void pubsub_tcpHandler_dispatch(pubsub_tcpHandler_t *handle, int fd, psa_tcp_dispatch_msg_t *msg) {
+    psa_tcp_dispatch_thread_t *thread = &handle->dispatchThreads.threads[(unsigned int) fd % handle->dispatchThreads.nofThreads];
+    celixThreadMutex_lock(&thread->mutex);
+    while (thread->running && thread->size >= handle->dispatchThreads.maxQueueSize) {
+        celixThreadCondition_wait(&thread->cond, &thread->mutex);
+    }
+    bool queued = thread->running;
+    if (queued) {
+        if (thread->tail != NULL) {
+            thread->tail->next = msg;
+        } else {
+            thread->head = msg;
+        }
+        thread->tail = msg;
+        thread->size += 1;
+        celixThreadCondition_broadcast(&thread->cond);
+    }
+    celixThreadMutex_unlock(&thread->mutex);
+    if (!queued) {
+        pubsub_bufferPool_release(msg);
+    }
+}
+
 int pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
+    return pubsub_tcpHandler_handleEvents(handle, handle->efd);
+}
+
+//
+// Handles the epoll events of the connections of a receive thread
+//
+static int pubsub_tcpHandler_handleEvents(pubsub_tcpHandler_t *handle, int efd) {
     int rc = 0;
-    if (handle->efd >= 0) {
+    if (efd >= 0) {
         struct epoll_event events[MAX_EPOLL_EVENTS];
         int nof_events = 0;
-        nof_events = epoll_wait(handle->efd, events, MAX_EPOLL_EVENTS, handle->timeout);
+        nof_events = epoll_wait(efd, events, MAX_EPOLL_EVENTS, handle->timeout);
         if (nof_events < 0) {
             if ((errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {}
             else L_ERROR("[TCP Socket] Cannot create epoll wait (%d) %s\n", nof_events, strerror(errno));
@@ -829,7 +1480,10 @@ int pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
                 int fd = accept(handle->own.fd, &their_addr, &len);
                 rc = fd;
                 if (rc == -1) {
-                  L_ERROR("[TCP Socket] accept failed: %s\n", strerror(errno));
+                  // Another receive thread can already have accepted the connection
+                  if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                      L_ERROR("[TCP Socket] accept failed: %s\n", strerror(errno));
+                  }
                   errno = 0;
                 }
                 // Make file descriptor NonBlocking
@@ -846,18 +1500,16 @@ int pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
                     unsigned int port = ntohs(their_addr.sin_port);
                     char *url = NULL;
                     asprintf(&url, "tcp://%s:%u", address, port);
-                    psa_tcp_connection_entry_t *entry = calloc(1, sizeof(*entry));
-                    pubsub_tcpHandler_setupEntry(entry, fd, url, MAX_DEFAULT_BUFFER_SIZE);
+                    psa_tcp_connection_entry_t *entry = pubsub_tcpHandler_createEntry(handle, fd, url, MAX_DEFAULT_BUFFER_SIZE);
                     entry->addr = their_addr;
                     entry->len  = len;
                     entry->connected = false;
                     event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLOUT;
                     event.data.fd = entry->fd;
-                    // Register Read to epoll
-                    rc = epoll_ctl(handle->efd, EPOLL_CTL_ADD, entry->fd, &event);
+                    // Register Read to the epoll of the receive thread of the connection
+                    rc = epoll_ctl(entry->efd, EPOLL_CTL_ADD, entry->fd, &event);
                     if (rc < 0) {
-                        pubsub_tcpHandler_freeEntry(entry);
-                        free(entry);
+                        pubsub_tcpHandler_destroyEntry(entry);
                         L_ERROR("[TCP Socket] Cannot create epoll\n");
                     } else {
                         hashMap_put(handle->fd_map, (void *) (intptr_t) entry->fd, entry);
@@ -867,84 +1519,91 @@ int pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
                     free(url);
                 }
                 celixThreadRwlock_unlock(&handle->dbLock);
-            } else if (events[i].events & EPOLLIN) {
-                int count = 0;
-                bool isReading = true;
-                while(isReading) {
-                    unsigned int index = 0;
-                    unsigned int size = 0;
-                    isReading = (handle->useBlockingRead) ? false : isReading;
-                    count++;
-                    rc = pubsub_tcpHandler_dataAvailable(handle, events[i].data.fd, &index, &size);
-                    if (rc <= 0) {
-                        // close connection.
-                        if (rc == 0) {
-                            pubsub_tcpHandler_closeConnection(handle, events[i].data.fd);
-                        }
-                        isReading = false;
+            } else {
+                if (events[i].events & EPOLLOUT) {
+                    // Handled before EPOLLIN, so that the send queue is also drained for a connection with received data
+                    int err = 0;
+                    socklen_t len = sizeof(int);
+                    rc = getsockopt(events[i].data.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                    if (rc != 0) {
+                        L_ERROR("[TCP Socket]:EPOLLOUT ERROR read from socket %s\n", strerror(errno));
+                        errno = 0;
                         continue;
                     }
-                    if (size) {
-                        // Handle data
-                        void *buffer = NULL;
-                        pubsub_tcp_msg_header_t *msgHeader = NULL;
-                        rc = pubsub_tcpHandler_read(handle, events[i].data.fd, index, &msgHeader, &buffer, size);
-                        if (rc < 0) {
+                    celixThreadRwlock_readLock(&handle->dbLock);
+                    psa_tcp_connection_entry_t *entry = hashMap_get(handle->fd_map, (void *) (intptr_t) events[i].data.fd);
+                    if (entry) {
+                        if ((!entry->connected)) {
+                            // tell sender that an receiver is connected
+                            if (handle->connectMessageCallback) handle->connectMessageCallback(handle->connectPayload, entry->url, false);
+                            entry->connected = true;
+                        }
+                        // Write the queued msgs, EPOLLOUT is unregistered when the send queue is empty
+                        pubsub_tcpHandler_drainSendQueue(handle, entry);
+                    }
+                    celixThreadRwlock_unlock(&handle->dbLock);
+                }
+                if (events[i].events & EPOLLIN) {
+                    int count = 0;
+                    bool isReading = true;
+                    while(isReading) {
+                        unsigned int index = 0;
+                        unsigned int size = 0;
+                        isReading = (handle->useBlockingRead) ? false : isReading;
+                        count++;
+                        rc = pubsub_tcpHandler_dataAvailable(handle, events[i].data.fd, &index, &size);
+                        if (rc <= 0) {
+                            // close connection.
+                            if (rc == 0) {
+                                pubsub_tcpHandler_closeConnection(handle, events[i].data.fd);
+                            }
                             isReading = false;
                             continue;
                         }
-                        celixThreadRwlock_readLock(&handle->dbLock);
-                        if (handle->processMessageCallback) {
-                            struct timespec receiveTime;
-                            clock_gettime(CLOCK_REALTIME, &receiveTime);
-                            handle->processMessageCallback(handle->processMessagePayload, msgHeader, buffer, size,
-                                                           &receiveTime);
-                            isReading = false;
+                        if (size) {
+                            // Handle data
+                            void *buffer = NULL;
+                            pubsub_tcp_msg_header_t *msgHeader = NULL;
+                            rc = pubsub_tcpHandler_read(handle, events[i].data.fd, index, &msgHeader, &buffer, size);
+                            if (rc < 0) {
+                                isReading = false;
+                                continue;
+                            }
+                            psa_tcp_dispatch_msg_t *dispatchMsg = NULL;
+                            celixThreadRwlock_readLock(&handle->dbLock);
+                            if (handle->dispatchThreads.nofThreads > 0) {
+                                // The msg is handled by a dispatch thread, so that the connection can be read further
+                                dispatchMsg = pubsub_tcpHandler_detachDispatchMsg(handle, events[i].data.fd, msgHeader, buffer, size);
+                                isReading = false;
+                            } else if (handle->processMessageCallback) {
+                                struct timespec receiveTime;
+                                clock_gettime(CLOCK_REALTIME, &receiveTime);
+                                handle->processMessageCallback(handle->processMessagePayload, msgHeader, buffer, size,
+                                                               &receiveTime);
+                                pubsub_tcpHandler_releaseLargeBuffer(handle, events[i].data.fd);
+                                isReading = false;
+                            }
+                            celixThreadRwlock_unlock(&handle->dbLock);
+                            if (dispatchMsg != NULL) {
+                                pubsub_tcpHandler_dispatch(handle, events[i].data.fd, dispatchMsg);
+                            }
                         }
-                        celixThreadRwlock_unlock(&handle->dbLock);
                     }
-                }
-            } else if (events[i].events & EPOLLOUT) {
-                int err = 0;
-                socklen_t len = sizeof(int);
-                rc = getsockopt(events[i].data.fd, SOL_SOCKET, SO_ERROR, &err, &len);
-                if (rc != 0) {
-                    L_ERROR("[TCP Socket]:EPOLLOUT ERROR read from socket %s\n", strerror(errno));
-                    errno = 0;
-                    continue;
-                }
-                celixThreadRwlock_readLock(&handle->dbLock);
-                psa_tcp_connection_entry_t *entry = hashMap_get(handle->fd_map, (void *) (intptr_t) events[i].data.fd);
-                if (entry)
-                  if ((!entry->connected)) {
-                      // tell sender that an receiver is connected
-                      if (handle->connectMessageCallback) handle->connectMessageCallback(handle->connectPayload, entry->url, false);
-                      entry->connected = true;
-                      struct epoll_event event;
-                      bzero(&event, sizeof(event)); // zero the struct
-                      event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR;
-                      event.data.fd = events[i].data.fd;
-                      // Register Modify epoll
-                      rc = epoll_ctl(handle->efd, EPOLL_CTL_MOD, events[i].data.fd, &event);
-                      if (rc < 0) {
-                          L_ERROR("[TCP Socket] Cannot create epoll\n");
-                      }
-                  }
-                celixThreadRwlock_unlock(&handle->dbLock);
-            } else if (events[i].events & EPOLLRDHUP) {
-                int err = 0;
-                socklen_t len = sizeof(int);
-                rc = getsockopt(events[i].data.fd, SOL_SOCKET, SO_ERROR, &err, &len);
-                if (rc != 0) {
-                    L_ERROR("[TCP Socket]:EPOLLRDHUP ERROR read from socket %s\n",strerror(errno));
+                } else if (events[i].events & EPOLLRDHUP) {
+                    int err = 0;
+                    socklen_t len = sizeof(int);
+                    rc = getsockopt(events[i].data.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                    if (rc != 0) {
+                        L_ERROR("[TCP Socket]:EPOLLRDHUP ERROR read from socket %s\n",strerror(errno));
+                        errno = 0;
+                        continue;
+                    }
+                    pubsub_tcpHandler_closeConnection(handle, events[i].data.fd);
+                } else if (events[i].events & EPOLLERR) {
+                    L_ERROR("[TCP Socket]:EPOLLERR  ERROR read from socket %s\n",strerror(errno));
                     errno = 0;
                     continue;
                 }
-                pubsub_tcpHandler_closeConnection(handle, events[i].data.fd);
-            } else if (events[i].events & EPOLLERR) {
-                L_ERROR("[TCP Socket]:EPOLLERR  ERROR read from socket %s\n",strerror(errno));
-                errno = 0;
-                continue;
             }
         }
     }
@@ -59,7 +59,28 @@ int pubsub_tcpHandler_createReceiveBufferStore(pubsub_tcpHandler_t *handle, unsi
 void pubsub_tcpHandler_setTimeout(pubsub_tcpHandler_t *handle, unsigned int timeout);
 void pubsub_tcpHandler_setBypassHeader(pubsub_tcpHandler_t *handle, bool bypassHeader, unsigned int msgIdOffset, unsigned int msgIdSize);
 void pubsub_tcpHandler_setBlockingWrite(pubsub_tcpHandler_t *handle, bool blocking);
+void pubsub_tcpHandler_setSendQueueSize(pubsub_tcpHandler_t *handle, size_t size);
 void pubsub_tcpHandler_setBlockingRead(pubsub_tcpHandler_t *handle, bool blocking);
+/**
+ * Sets the max size of a received msg. A connection which sends a msg header with a larger msg size is closed.
+ */
+void pubsub_tcpHandler_setMaxReceiveMsgSize(pubsub_tcpHandler_t *handle, unsigned int size);
+
+/**
+ * Sets the nr of threads which handle the connections (reading and accepting). The thread calling
+ * pubsub_tcpHandler_handler is one of them, the others are started by the handler. The connections are divided over
+ * the threads; a connection is always handled by the same thread.
+ * Must be called once, before listen or connect.
+ */
+void pubsub_tcpHandler_setReceiveThreads(pubsub_tcpHandler_t *handle, unsigned int nofThreads);
+
+/**
+ * Starts nofThreads dispatch threads, which call the process message callback, so that a receive thread can read
+ * further while the received msgs are processed. The msgs of a connection are always processed by the same dispatch
+ * thread, in order. A receive thread waits when maxQueueSize msgs are queued for a dispatch thread.
+ * Must be called once, before listen or connect.
+ */
+void pubsub_tcpHandler_setDispatchThreads(pubsub_tcpHandler_t *handle, unsigned int nofThreads, size_t maxQueueSize);
 
 int pubsub_tcpHandler_dataAvailable(pubsub_tcpHandler_t *handle, int fd, unsigned int *index, unsigned int *size);
 int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd, unsigned int index, pubsub_tcp_msg_header_t** header, void ** buffer, unsigned int size);
@@ -35,6 +35,7 @@
 
 #include <uuid/uuid.h>
 #include <pubsub_admin_metrics.h>
+#include <pubsub_shared_msg.h>
 
 #define MAX_EPOLL_EVENTS     16
 #ifndef UUID_STR_LEN
@@ -60,6 +61,7 @@ struct pubsub_tcp_topic_receiver {
     char *topic;
     char scopeAndTopicFilter[5];
     bool metricsEnabled;
+    bool sharedMsgEnabled;
     pubsub_tcpHandler_t *socketHandler;
     pubsub_tcpHandler_t *sharedSocketHandler;
 
@@ -77,7 +79,8 @@ struct pubsub_tcp_topic_receiver {
 
     long subscriberTrackerId;
     struct {
-        celix_thread_mutex_t mutex;
+        celix_thread_rwlock_t lock; //read locked when processing a msg, msgs can be processed concurrently
+        celix_thread_mutex_t metricsMutex; //protects the metrics of the subscriber entries when processing msgs
         hash_map_t *map; //key = bnd id, value = psa_tcp_subscriber_entry_t
         bool allInitialized;
     } subscribers;
@@ -153,6 +156,10 @@ pubsub_tcp_topic_receiver_t *pubsub_tcpTopicReceiver_create(celix_bundle_context
     long sessions = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_MAX_RECV_SESSIONS, PSA_TCP_DEFAULT_MAX_RECV_SESSIONS);
     long buffer_size = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_RECV_BUFFER_SIZE, PSA_TCP_DEFAULT_RECV_BUFFER_SIZE);
     long timeout = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_TIMEOUT, PSA_TCP_DEFAULT_TIMEOUT);
+    long maxMsgSize = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_MAX_RECV_MSG_SIZE, PSA_TCP_DEFAULT_MAX_RECV_MSG_SIZE);
+    long recvThreads = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_RECV_THREADS, PSA_TCP_DEFAULT_RECV_THREADS);
+    long dispatchThreads = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_DISPATCH_THREADS, PSA_TCP_DEFAULT_DISPATCH_THREADS);
+    long dispatchQueueSize = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_DISPATCH_QUEUE_SIZE, PSA_TCP_DEFAULT_DISPATCH_QUEUE_SIZE);
     const char *staticConnectUrls = celix_properties_get(topicProperties, PUBSUB_TCP_STATIC_CONNECT_URLS, NULL);
 
     /* Check if it's a static endpoint */
@@ -184,11 +191,19 @@ pubsub_tcp_topic_receiver_t *pubsub_tcpTopicReceiver_create(celix_bundle_context
 
     if (receiver->socketHandler == NULL) {
         receiver->socketHandler = pubsub_tcpHandler_create(receiver->logHelper);
+        if ((receiver->socketHandler != NULL) && (recvThreads > 1)) {
+            pubsub_tcpHandler_setReceiveThreads(receiver->socketHandler, (unsigned int) recvThreads);
+        }
+        if ((receiver->socketHandler != NULL) && (dispatchThreads > 0)) {
+            pubsub_tcpHandler_setDispatchThreads(receiver->socketHandler, (unsigned int) dispatchThreads,
+                                                 (size_t) dispatchQueueSize);
+        }
     }
 
     if (receiver->socketHandler != NULL) {
         pubsub_tcpHandler_createReceiveBufferStore(receiver->socketHandler, (unsigned int) sessions, (unsigned int) buffer_size);
         pubsub_tcpHandler_setTimeout(receiver->socketHandler, (unsigned int) timeout);
+        pubsub_tcpHandler_setMaxReceiveMsgSize(receiver->socketHandler, (unsigned int) maxMsgSize);
         pubsub_tcpHandler_addMessageHandler(receiver->socketHandler, receiver, processMsg);
         pubsub_tcpHandler_addConnectionCallback(receiver->socketHandler, receiver, psa_tcp_connectHandler, psa_tcp_disConnectHandler);
     }
@@ -205,8 +220,11 @@ pubsub_tcp_topic_receiver_t *pubsub_tcpTopicReceiver_create(celix_bundle_context
     psa_tcp_setScopeAndTopicFilter(scope, topic, receiver->scopeAndTopicFilter);
     receiver->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_TCP_METRICS_ENABLED,
                                                                      PSA_TCP_DEFAULT_METRICS_ENABLED);
+    receiver->sharedMsgEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_TCP_SHARED_MSG_ENABLED,
+                                                                       PSA_TCP_DEFAULT_SHARED_MSG_ENABLED);
 
-    celixThreadMutex_create(&receiver->subscribers.mutex, NULL);
+    celixThreadRwlock_create(&receiver->subscribers.lock, NULL);
+    celixThreadMutex_create(&receiver->subscribers.metricsMutex, NULL);
     celixThreadMutex_create(&receiver->requestedConnections.mutex, NULL);
     celixThreadMutex_create(&receiver->thread.mutex, NULL);
 
@@ -274,10 +292,12 @@ void pubsub_tcpTopicReceiver_destroy(pubsub_tcp_topic_receiver_t *receiver) {
             celixThreadMutex_unlock(&receiver->thread.mutex);
             celixThread_join(receiver->thread.thread, NULL);
         }
+        // Returns when the receive and dispatch threads of the handler are not processing a msg anymore
+        pubsub_tcpHandler_addMessageHandler(receiver->socketHandler, NULL, NULL);
 
         celix_bundleContext_stopTracker(receiver->ctx, receiver->subscriberTrackerId);
 
-        celixThreadMutex_lock(&receiver->subscribers.mutex);
+        celixThreadRwlock_writeLock(&receiver->subscribers.lock);
         hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
         while (hashMapIterator_hasNext(&iter)) {
             psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
@@ -296,7 +316,7 @@ void pubsub_tcpTopicReceiver_destroy(pubsub_tcp_topic_receiver_t *receiver) {
         hashMap_destroy(receiver->subscribers.map, false, false);
 
 
-        celixThreadMutex_unlock(&receiver->subscribers.mutex);
+        celixThreadRwlock_unlock(&receiver->subscribers.lock);
 
         celixThreadMutex_lock(&receiver->requestedConnections.mutex);
         iter = hashMapIterator_construct(receiver->requestedConnections.map);
@@ -310,11 +330,11 @@ void pubsub_tcpTopicReceiver_destroy(pubsub_tcp_topic_receiver_t *receiver) {
         hashMap_destroy(receiver->requestedConnections.map, false, false);
         celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-        celixThreadMutex_destroy(&receiver->subscribers.mutex);
+        celixThreadRwlock_destroy(&receiver->subscribers.lock);
+        celixThreadMutex_destroy(&receiver->subscribers.metricsMutex);
         celixThreadMutex_destroy(&receiver->requestedConnections.mutex);
         celixThreadMutex_destroy(&receiver->thread.mutex);
 
-        pubsub_tcpHandler_addMessageHandler(receiver->socketHandler, NULL, NULL);
         pubsub_tcpHandler_addConnectionCallback(receiver->socketHandler, NULL, NULL, NULL);
         if ((receiver->socketHandler) && (receiver->sharedSocketHandler == NULL)) {
             pubsub_tcpHandler_destroy(receiver->socketHandler);
@@ -406,7 +426,7 @@ static void pubsub_tcpTopicReceiver_addSubscriber(void *handle, void *svc, const
         return;
     }
 
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
     psa_tcp_subscriber_entry_t *entry = hashMap_get(receiver->subscribers.map, (void *) bndId);
     if (entry != NULL) {
         entry->usageCount += 1;
@@ -438,7 +458,7 @@ static void pubsub_tcpTopicReceiver_addSubscriber(void *handle, void *svc, const
             free(entry);
         }
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
 }
 
 static void pubsub_tcpTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props,
@@ -447,7 +467,7 @@ static void pubsub_tcpTopicReceiver_removeSubscriber(void *handle, void *svc, co
 
     long bndId = celix_bundle_getId(bnd);
 
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
     psa_tcp_subscriber_entry_t *entry = hashMap_get(receiver->subscribers.map, (void *) bndId);
     if (entry != NULL) {
         entry->usageCount -= 1;
@@ -467,14 +487,14 @@ static void pubsub_tcpTopicReceiver_removeSubscriber(void *handle, void *svc, co
         hashMap_destroy(entry->metrics, false, false);
         free(entry);
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
 }
 
 static inline void
 processMsgForSubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry,
                              const pubsub_tcp_msg_header_t *hdr, const unsigned char *payload, size_t payloadSize,
-                             struct timespec *receiveTime) {
-    //NOTE receiver->subscribers.mutex locked
+                             pubsub_shared_msg_t *sharedMsg, struct timespec *receiveTime) {
+    //NOTE receiver->subscribers.lock read locked, the msg can be processed concurrently by the receive/dispatch threads
     pubsub_msg_serializer_t *msgSer = hashMap_get(entry->msgTypes, (void *) (uintptr_t)(hdr->type));
     pubsub_subscriber_t *svc = entry->svc;
     bool monitor = receiver->metricsEnabled;
@@ -492,14 +512,22 @@ processMsgForSubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subs
             if (monitor) {
                 clock_gettime(CLOCK_REALTIME, &beginSer);
             }
-            celix_status_t status = msgSer->deserialize(msgSer->handle, payload, payloadSize, &deserializedMsg);
+            bool shared = false;
+            celix_status_t status;
+            if (sharedMsg != NULL) {
+                status = pubsubSharedMsg_deserialize(sharedMsg, msgSer, &deserializedMsg, &shared);
+            } else {
+                status = msgSer->deserialize(msgSer->handle, payload, payloadSize, &deserializedMsg);
+            }
             if (monitor) {
                 clock_gettime(CLOCK_REALTIME, &endSer);
             }
             if (status == CELIX_SUCCESS) {
                 bool release = true;
                 svc->receive(svc->handle, msgSer->msgName, msgSer->msgId, deserializedMsg, &release);
-                if (release) {
+                if (shared) {
+                    pubsubSharedMsg_done(sharedMsg, deserializedMsg, release);
+                } else if (release) {
                     msgSer->freeMsg(msgSer->handle, deserializedMsg);
                 }
                 updateReceiveCount += 1;
@@ -514,6 +542,7 @@ processMsgForSubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subs
     }
 
     if (msgSer != NULL && monitor) {
+        celixThreadMutex_lock(&receiver->subscribers.metricsMutex);
         hash_map_t *origins = hashMap_get(entry->metrics, (void *) (uintptr_t) hdr->type);
         char uuidStr[UUID_STR_LEN + 1];
         uuid_unparse(hdr->originUUID, uuidStr);
@@ -563,20 +592,25 @@ processMsgForSubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subs
 
         metrics->nrOfMessagesReceived += updateReceiveCount;
         metrics->nrOfSerializationErrors += updateSerError;
+        celixThreadMutex_unlock(&receiver->subscribers.metricsMutex);
     }
 }
 
 static void processMsg(void *handle, const pubsub_tcp_msg_header_t *hdr, const unsigned char *payload, size_t payloadSize, struct timespec *receiveTime) {
     pubsub_tcp_topic_receiver_t *receiver = handle;
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    pubsub_shared_msg_t sharedMsg;
+    pubsubSharedMsg_init(&sharedMsg, payload, payloadSize);
+    celixThreadRwlock_readLock(&receiver->subscribers.lock);
     hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
     while (hashMapIterator_hasNext(&iter)) {
         psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
         if (entry != NULL) {
-            processMsgForSubscriberEntry(receiver, entry, hdr, payload, payloadSize, receiveTime);
+            processMsgForSubscriberEntry(receiver, entry, hdr, payload, payloadSize,
+                                         receiver->sharedMsgEnabled ? &sharedMsg : NULL, receiveTime);
         }
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    pubsubSharedMsg_deinit(&sharedMsg);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
 }
 
 static void *psa_tcp_recvThread(void *data) {
@@ -590,9 +624,9 @@ static void *psa_tcp_recvThread(void *data) {
     bool allConnected = receiver->requestedConnections.allConnected;
     celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_readLock(&receiver->subscribers.lock);
     bool allInitialized = receiver->subscribers.allInitialized;
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
 
     while (running) {
         if (!allConnected) {
@@ -611,9 +645,9 @@ static void *psa_tcp_recvThread(void *data) {
         allConnected = receiver->requestedConnections.allConnected;
         celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-        celixThreadMutex_lock(&receiver->subscribers.mutex);
+        celixThreadRwlock_readLock(&receiver->subscribers.lock);
         allInitialized = receiver->subscribers.allInitialized;
-        celixThreadMutex_unlock(&receiver->subscribers.mutex);
+        celixThreadRwlock_unlock(&receiver->subscribers.lock);
     } // while
     return NULL;
 }
@@ -624,7 +658,7 @@ pubsub_admin_receiver_metrics_t *pubsub_tcpTopicReceiver_metrics(pubsub_tcp_topi
     snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->topic);
 
     int msgTypesCount = 0;
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
     hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
     while (hashMapIterator_hasNext(&iter)) {
         psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
@@ -673,7 +707,7 @@ pubsub_admin_receiver_metrics_t *pubsub_tcpTopicReceiver_metrics(pubsub_tcp_topi
             i += 1;
         }
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
     return result;
 }
 
@@ -729,7 +763,7 @@ static void psa_tcp_disConnectHandler(void *handle, const char *url, bool lock)
 
 
 static void psa_tcp_initializeAllSubscribers(pubsub_tcp_topic_receiver_t *receiver) {
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
     if (!receiver->subscribers.allInitialized) {
         bool allInitialized = true;
         hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
@@ -750,5 +784,5 @@ static void psa_tcp_initializeAllSubscribers(pubsub_tcp_topic_receiver_t *receiv
         }
         receiver->subscribers.allInitialized = allInitialized;
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
 }
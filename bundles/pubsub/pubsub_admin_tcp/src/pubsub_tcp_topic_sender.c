@@ -31,6 +31,7 @@
 #include "pubsub_psa_tcp_constants.h"
 #include "pubsub_tcp_common.h"
 #include "pubsub_endpoint.h"
+#include "pubsub_buffer_pool.h"
 #include <uuid/uuid.h>
 #include "celix_constants.h"
 #include <signal.h>
@@ -56,6 +57,7 @@ struct pubsub_tcp_topic_sender {
     bool metricsEnabled;
     pubsub_tcpHandler_t *socketHandler;
     pubsub_tcpHandler_t *sharedSocketHandler;
+    pubsub_buffer_pool_t *loanPool; //buffers loaned by the publishers of the topic
 
     char *scope;
     char *topic;
@@ -113,6 +115,9 @@ static unsigned int rand_range(unsigned int min, unsigned int max);
 static void delay_first_send_for_late_joiners(pubsub_tcp_topic_sender_t *sender);
 static void *psa_tcp_sendThread(void *data);
 static int psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, const void *msg);
+static int psa_tcp_topicPublicationLoan(void *handle, unsigned int msgTypeId, size_t size, void **buffer);
+static int psa_tcp_topicPublicationCommit(void *handle, unsigned int msgTypeId, void *buffer, size_t size);
+static void psa_tcp_topicPublicationDiscard(void *handle, void *buffer);
 
 pubsub_tcp_topic_sender_t *pubsub_tcpTopicSender_create(
         celix_bundle_context_t *ctx,
@@ -133,6 +138,7 @@ pubsub_tcp_topic_sender_t *pubsub_tcpTopicSender_create(
     sender->serializerSvcId = serializerSvcId;
     sender->serializer = ser;
     sender->socketHandler = pubsub_tcpHandler_create(sender->logHelper);
+    sender->loanPool = pubsub_bufferPool_create(PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS);
     psa_tcp_setScopeAndTopicFilter(scope, topic, sender->scopeAndTopicFilter);
     const char *uuid = celix_bundleContext_getProperty(ctx, OSGI_FRAMEWORK_FRAMEWORK_UUID, NULL);
     if (uuid != NULL) {
@@ -146,6 +152,8 @@ pubsub_tcp_topic_sender_t *pubsub_tcpTopicSender_create(
         long msgIdSize    = celix_properties_getAsLong(topicProperties, PUBSUB_TCP_MESSAGE_ID_SIZE,   PUBSUB_TCP_DEFAULT_MESSAGE_ID_SIZE);
         pubsub_tcpHandler_setBypassHeader(sender->socketHandler, bypassHeader, (unsigned int)msgIdOffset, (unsigned int)msgIdSize);
         pubsub_tcpHandler_setBlockingWrite(sender->socketHandler, blocking);
+        long sendQueueSize = celix_properties_getAsLong(topicProperties, PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE_KEY, PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE_DEFAULT);
+        pubsub_tcpHandler_setSendQueueSize(sender->socketHandler, (size_t) sendQueueSize);
     }
     /* Check if it's a static endpoint */
     bool isEndPointTypeClient = false;
@@ -248,6 +256,7 @@ pubsub_tcp_topic_sender_t *pubsub_tcpTopicSender_create(
     }
 
     if (sender->url == NULL) {
+        pubsub_bufferPool_destroy(sender->loanPool);
         free(sender);
         sender = NULL;
     }
@@ -290,6 +299,7 @@ void pubsub_tcpTopicSender_destroy(pubsub_tcp_topic_sender_t *sender) {
             pubsub_tcpHandler_destroy(sender->socketHandler);
             sender->socketHandler = NULL;
         }
+        pubsub_bufferPool_destroy(sender->loanPool);
 
         free(sender->scope);
         free(sender->topic);
@@ -372,6 +382,9 @@ static void *psa_tcp_getPublisherService(void *handle, const celix_bundle_t *req
             entry->service.handle = entry;
             entry->service.localMsgTypeIdForMsgType = psa_tcp_localMsgTypeIdForMsgType;
             entry->service.send = psa_tcp_topicPublicationSend;
+            entry->service.loan = psa_tcp_topicPublicationLoan;
+            entry->service.commit = psa_tcp_topicPublicationCommit;
+            entry->service.discard = psa_tcp_topicPublicationDiscard;
             hashMap_put(sender->boundedServices.map, (void *) bndId, entry);
         } else {
             L_ERROR("Error creating serializer map for TCP TopicSender %s/%s", sender->scope, sender->topic);
@@ -477,9 +490,12 @@ pubsub_admin_sender_metrics_t *pubsub_tcpTopicSender_metrics(pubsub_tcp_topic_se
     return result;
 }
 
-static int psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, const void *inMsg) {
+/**
+ * Serializes and sends a msg or -if loanedPayload is not NULL- sends a loaned payload.
+ * A loaned payload is released to the loan pool.
+ */
+static int psa_tcp_send(psa_tcp_bounded_service_entry_t *bound, unsigned int msgTypeId, const void *inMsg, void *loanedPayload, size_t loanedPayloadSize) {
     int status = CELIX_SUCCESS;
-    psa_tcp_bounded_service_entry_t *bound = handle;
     pubsub_tcp_topic_sender_t *sender = bound->parent;
     bool monitor = sender->metricsEnabled;
 
@@ -500,9 +516,11 @@ static int psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, co
             clock_gettime(CLOCK_REALTIME, &serializationStart);
         }
 
-        void *serializedOutput = NULL;
-        size_t serializedOutputLen = 0;
-        status = entry->msgSer->serialize(entry->msgSer->handle, inMsg, &serializedOutput, &serializedOutputLen);
+        void *serializedOutput = loanedPayload;
+        size_t serializedOutputLen = loanedPayloadSize;
+        if (loanedPayload == NULL) {
+            status = entry->msgSer->serialize(entry->msgSer->handle, inMsg, &serializedOutput, &serializedOutputLen);
+        }
 
         if (monitor) {
             clock_gettime(CLOCK_REALTIME, &serializationEnd);
@@ -529,7 +547,9 @@ static int psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, co
                     status = -1;
                     sendOk = false;
                 }
-                free(serializedOutput);
+                if (loanedPayload == NULL) {
+                    free(serializedOutput);
+                }
             }
 
             //celixThreadMutex_unlock(&entry->sendLock);
@@ -575,9 +595,39 @@ static int psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, co
         celixThreadMutex_unlock(&entry->metrics.mutex);
     }
 
+    pubsub_bufferPool_release(loanedPayload);
     return status;
 }
 
+static int psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, const void *inMsg) {
+    return psa_tcp_send(handle, msgTypeId, inMsg, NULL, 0);
+}
+
+static int psa_tcp_topicPublicationLoan(void *handle, unsigned int msgTypeId, size_t size, void **buffer) {
+    psa_tcp_bounded_service_entry_t *bound = handle;
+    if (hashMap_get(bound->msgEntries, (void *) (uintptr_t) msgTypeId) == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    *buffer = pubsub_bufferPool_take(bound->parent->loanPool, size);
+    return *buffer == NULL ? CELIX_ENOMEM : CELIX_SUCCESS;
+}
+
+static int psa_tcp_topicPublicationCommit(void *handle, unsigned int msgTypeId, void *buffer, size_t size) {
+    if (buffer == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    if (size > pubsub_bufferPool_capacity(buffer)) {
+        //the buffer is given back, also when the commit fails
+        pubsub_bufferPool_release(buffer);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    return psa_tcp_send(handle, msgTypeId, NULL, buffer, size);
+}
+
+static void psa_tcp_topicPublicationDiscard(void *handle __attribute__((unused)), void *buffer) {
+    pubsub_bufferPool_release(buffer);
+}
+
 static void delay_first_send_for_late_joiners(pubsub_tcp_topic_sender_t *sender) {
 
     static bool firstSend = true;
@@ -32,6 +32,14 @@
 #define PSA_WEBSOCKET_METRICS_ENABLED                 "PSA_WEBSOCKET_METRICS_ENABLED"
 #define PSA_WEBSOCKET_DEFAULT_METRICS_ENABLED         true
 
+/**
+ * Whether a received msg is deserialized once and shared between the subscribers of a topic receiver, instead of
+ * deserialized for every subscriber. Subscribers must handle a shared msg as immutable.
+ * See pubsub_shared_msg.h
+ */
+#define PSA_WEBSOCKET_SHARED_MSG_ENABLED              "PSA_WEBSOCKET_SHARED_MSG_ENABLED"
+#define PSA_WEBSOCKET_DEFAULT_SHARED_MSG_ENABLED      false
+
 #define PUBSUB_WEBSOCKET_VERBOSE_KEY                  "PSA_WEBSOCKET_VERBOSE"
 #define PUBSUB_WEBSOCKET_VERBOSE_DEFAULT              true
 
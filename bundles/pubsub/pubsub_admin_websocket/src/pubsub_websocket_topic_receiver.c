@@ -35,6 +35,7 @@
 #include <uuid/uuid.h>
 #include <http_admin/api.h>
 #include <jansson.h>
+#include <pubsub_shared_msg.h>
 
 #ifndef UUID_STR_LEN
 #define UUID_STR_LEN 37
@@ -69,6 +70,7 @@ struct pubsub_websocket_topic_receiver {
     char *topic;
     char scopeAndTopicFilter[5];
     char *uri;
+    bool sharedMsgEnabled;
 
     pubsub_websocket_rcv_buffer_t recvBuffer;
 
@@ -138,6 +140,7 @@ pubsub_websocket_topic_receiver_t* pubsub_websocketTopicReceiver_create(celix_bu
     receiver->scope = strndup(scope, 1024 * 1024);
     receiver->topic = strndup(topic, 1024 * 1024);
     psa_websocket_setScopeAndTopicFilter(scope, topic, receiver->scopeAndTopicFilter);
+    receiver->sharedMsgEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_WEBSOCKET_SHARED_MSG_ENABLED, PSA_WEBSOCKET_DEFAULT_SHARED_MSG_ENABLED);
 
     receiver->uri = psa_websocket_createURI(scope, topic);
 
@@ -435,7 +438,7 @@ static void * psa_websocket_getMsgTypeIdFromFqn(const char *fqn, hash_map_t *msg
     return msgTypeId;
 }
 
-static inline void processMsgForSubscriberEntry(pubsub_websocket_topic_receiver_t *receiver, psa_websocket_subscriber_entry_t* entry, pubsub_websocket_msg_header_t *hdr, const char* payload, size_t payloadSize) {
+static inline void processMsgForSubscriberEntry(pubsub_websocket_topic_receiver_t *receiver, psa_websocket_subscriber_entry_t* entry, pubsub_websocket_msg_header_t *hdr, const char* payload, size_t payloadSize, pubsub_shared_msg_t *sharedMsg) {
     //NOTE receiver->subscribers.mutex locked
     void *msgTypeId = psa_websocket_getMsgTypeIdFromFqn(hdr->id, entry->msgTypes);
     pubsub_msg_serializer_t* msgSer = hashMap_get(entry->msgTypes, msgTypeId);
@@ -445,12 +448,20 @@ static inline void processMsgForSubscriberEntry(pubsub_websocket_topic_receiver_
         void *deserializedMsg = NULL;
         bool validVersion = psa_websocket_checkVersion(msgSer->msgVersion, hdr);
         if (validVersion) {
-            celix_status_t status = msgSer->deserialize(msgSer->handle, payload, payloadSize, &deserializedMsg);
+            bool shared = false;
+            celix_status_t status;
+            if (sharedMsg != NULL) {
+                status = pubsubSharedMsg_deserialize(sharedMsg, msgSer, &deserializedMsg, &shared);
+            } else {
+                status = msgSer->deserialize(msgSer->handle, payload, payloadSize, &deserializedMsg);
+            }
 
             if (status == CELIX_SUCCESS) {
                 bool release = true;
                 svc->receive(svc->handle, msgSer->msgName, msgSer->msgId, deserializedMsg, &release);
-                if (release) {
+                if (shared) {
+                    pubsubSharedMsg_done(sharedMsg, deserializedMsg, release);
+                } else if (release) {
                     msgSer->freeMsg(msgSer->handle, deserializedMsg);
                 }
             } else {
@@ -482,14 +493,17 @@ static inline void processMsg(pubsub_websocket_topic_receiver_t *receiver, const
             size_t payloadSize = strlen(payload);
             printf("Received msg: id %s\tmajor %u\tminor %u\tseqNr %u\tdata %s\n", hdr.id, hdr.major, hdr.minor, hdr.seqNr, payload);
 
+            pubsub_shared_msg_t sharedMsg;
+            pubsubSharedMsg_init(&sharedMsg, payload, payloadSize);
             celixThreadMutex_lock(&receiver->subscribers.mutex);
             hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
             while (hashMapIterator_hasNext(&iter)) {
                 psa_websocket_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
                 if (entry != NULL) {
-                    processMsgForSubscriberEntry(receiver, entry, &hdr, payload, payloadSize);
+                    processMsgForSubscriberEntry(receiver, entry, &hdr, payload, payloadSize, receiver->sharedMsgEnabled ? &sharedMsg : NULL);
                 }
             }
+            pubsubSharedMsg_deinit(&sharedMsg);
             celixThreadMutex_unlock(&receiver->subscribers.mutex);
             free((void *) hdr.id);
             free((void *) payload);
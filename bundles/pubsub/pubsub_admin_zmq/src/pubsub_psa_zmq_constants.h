@@ -42,6 +42,14 @@
 #define PSA_ZMQ_ZEROCOPY_ENABLED "PSA_ZMQ_ZEROCOPY_ENABLED"
 #define PSA_ZMQ_DEFAULT_ZEROCOPY_ENABLED false
 
+/**
+ * Whether a received msg is deserialized once and shared between the subscribers of a topic receiver, instead of
+ * deserialized for every subscriber. Subscribers must handle a shared msg as immutable.
+ * See pubsub_shared_msg.h
+ */
+#define PSA_ZMQ_SHARED_MSG_ENABLED "PSA_ZMQ_SHARED_MSG_ENABLED"
+#define PSA_ZMQ_DEFAULT_SHARED_MSG_ENABLED false
+
 
 #define PUBSUB_ZMQ_VERBOSE_KEY      "PSA_ZMQ_VERBOSE"
 #define PUBSUB_ZMQ_VERBOSE_DEFAULT  true
@@ -34,6 +34,7 @@
 
 #include <uuid/uuid.h>
 #include <pubsub_admin_metrics.h>
+#include <pubsub_shared_msg.h>
 
 #define PSA_ZMQ_RECV_TIMEOUT 1000
 
@@ -60,6 +61,7 @@ struct pubsub_zmq_topic_receiver {
     char *topic;
     char scopeAndTopicFilter[5];
     bool metricsEnabled;
+    bool sharedMsgEnabled;
 
     void *zmqCtx;
     void *zmqSock;
@@ -141,6 +143,7 @@ pubsub_zmq_topic_receiver_t* pubsub_zmqTopicReceiver_create(celix_bundle_context
     receiver->topic = strndup(topic, 1024 * 1024);
     psa_zmq_setScopeAndTopicFilter(scope, topic, receiver->scopeAndTopicFilter);
     receiver->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_METRICS_ENABLED, PSA_ZMQ_DEFAULT_METRICS_ENABLED);
+    receiver->sharedMsgEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_SHARED_MSG_ENABLED, PSA_ZMQ_DEFAULT_SHARED_MSG_ENABLED);
 
 
 #ifdef BUILD_WITH_ZMQ_SECURITY
@@ -456,7 +459,7 @@ static void pubsub_zmqTopicReceiver_removeSubscriber(void *handle, void *svc, co
     celixThreadMutex_unlock(&receiver->subscribers.mutex);
 }
 
-static inline void processMsgForSubscriberEntry(pubsub_zmq_topic_receiver_t *receiver, psa_zmq_subscriber_entry_t* entry, const pubsub_zmq_msg_header_t *hdr, const byte* payload, size_t payloadSize, struct timespec *receiveTime) {
+static inline void processMsgForSubscriberEntry(pubsub_zmq_topic_receiver_t *receiver, psa_zmq_subscriber_entry_t* entry, const pubsub_zmq_msg_header_t *hdr, const byte* payload, size_t payloadSize, pubsub_shared_msg_t *sharedMsg, struct timespec *receiveTime) {
     //NOTE receiver->subscribers.mutex locked
     pubsub_msg_serializer_t* msgSer = hashMap_get(entry->msgTypes, (void*)(uintptr_t)(hdr->type));
     pubsub_subscriber_t *svc = entry->svc;
@@ -475,14 +478,22 @@ static inline void processMsgForSubscriberEntry(pubsub_zmq_topic_receiver_t *rec
             if (monitor) {
                 clock_gettime(CLOCK_REALTIME, &beginSer);
             }
-            celix_status_t status = msgSer->deserialize(msgSer->handle, payload, payloadSize, &deserializedMsg);
+            bool shared = false;
+            celix_status_t status;
+            if (sharedMsg != NULL) {
+                status = pubsubSharedMsg_deserialize(sharedMsg, msgSer, &deserializedMsg, &shared);
+            } else {
+                status = msgSer->deserialize(msgSer->handle, payload, payloadSize, &deserializedMsg);
+            }
             if (monitor) {
                 clock_gettime(CLOCK_REALTIME, &endSer);
             }
             if (status == CELIX_SUCCESS) {
                 bool release = true;
                 svc->receive(svc->handle, msgSer->msgName, msgSer->msgId, deserializedMsg, &release);
-                if (release) {
+                if (shared) {
+                    pubsubSharedMsg_done(sharedMsg, deserializedMsg, release);
+                } else if (release) {
                     msgSer->freeMsg(msgSer->handle, deserializedMsg);
                 }
                 updateReceiveCount += 1;
@@ -548,14 +559,17 @@ static inline void processMsgForSubscriberEntry(pubsub_zmq_topic_receiver_t *rec
 }
 
 static inline void processMsg(pubsub_zmq_topic_receiver_t *receiver, const pubsub_zmq_msg_header_t *hdr, const byte *payload, size_t payloadSize, struct timespec *receiveTime) {
+    pubsub_shared_msg_t sharedMsg;
+    pubsubSharedMsg_init(&sharedMsg, payload, payloadSize);
     celixThreadMutex_lock(&receiver->subscribers.mutex);
     hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
     while (hashMapIterator_hasNext(&iter)) {
         psa_zmq_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
         if (entry != NULL) {
-            processMsgForSubscriberEntry(receiver, entry, hdr, payload, payloadSize, receiveTime);
+            processMsgForSubscriberEntry(receiver, entry, hdr, payload, payloadSize, receiver->sharedMsgEnabled ? &sharedMsg : NULL, receiveTime);
         }
     }
+    pubsubSharedMsg_deinit(&sharedMsg);
     celixThreadMutex_unlock(&receiver->subscribers.mutex);
 }
 
@@ -30,6 +30,7 @@
 #include "pubsub_zmq_topic_sender.h"
 #include "pubsub_psa_zmq_constants.h"
 #include "pubsub_zmq_common.h"
+#include "pubsub_buffer_pool.h"
 #include <uuid/uuid.h>
 #include "celix_constants.h"
 
@@ -53,6 +54,7 @@ struct pubsub_zmq_topic_sender {
     uuid_t fwUUID;
     bool metricsEnabled;
     bool zeroCopyEnabled;
+    pubsub_buffer_pool_t *loanPool; //buffers loaned by the publishers of the topic
 
     char *scope;
     char *topic;
@@ -109,6 +111,9 @@ static unsigned int rand_range(unsigned int min, unsigned int max);
 static void delay_first_send_for_late_joiners(pubsub_zmq_topic_sender_t *sender);
 
 static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *msg);
+static int psa_zmq_topicPublicationLoan(void* handle, unsigned int msgTypeId, size_t size, void **buffer);
+static int psa_zmq_topicPublicationCommit(void* handle, unsigned int msgTypeId, void *buffer, size_t size);
+static void psa_zmq_topicPublicationDiscard(void* handle, void *buffer);
 
 pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
         celix_bundle_context_t *ctx,
@@ -133,6 +138,7 @@ pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
     }
     sender->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_METRICS_ENABLED, PSA_ZMQ_DEFAULT_METRICS_ENABLED);
     sender->zeroCopyEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_ZEROCOPY_ENABLED, PSA_ZMQ_DEFAULT_ZEROCOPY_ENABLED);
+    sender->loanPool = pubsub_bufferPool_create(PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS);
 
     //setting up zmq socket for ZMQ TopicSender
     {
@@ -272,6 +278,7 @@ pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
     }
 
     if (sender->url == NULL) {
+        pubsub_bufferPool_destroy(sender->loanPool);
         free(sender);
         sender = NULL;
     }
@@ -309,6 +316,8 @@ void pubsub_zmqTopicSender_destroy(pubsub_zmq_topic_sender_t *sender) {
 
         celixThreadMutex_destroy(&sender->boundedServices.mutex);
         celixThreadMutex_destroy(&sender->zmq.mutex);
+        //note loaned buffers still owned by zmq (zero copy) are freed when released by zmq
+        pubsub_bufferPool_destroy(sender->loanPool);
 
         free(sender->scope);
         free(sender->topic);
@@ -390,6 +399,9 @@ static void* psa_zmq_getPublisherService(void *handle, const celix_bundle_t *req
             entry->service.handle = entry;
             entry->service.localMsgTypeIdForMsgType = psa_zmq_localMsgTypeIdForMsgType;
             entry->service.send = psa_zmq_topicPublicationSend;
+            entry->service.loan = psa_zmq_topicPublicationLoan;
+            entry->service.commit = psa_zmq_topicPublicationCommit;
+            entry->service.discard = psa_zmq_topicPublicationDiscard;
             hashMap_put(sender->boundedServices.map, (void*)bndId, entry);
         } else {
             L_ERROR("Error creating serializer map for ZMQ TopicSender %s/%s", sender->scope, sender->topic);
@@ -480,9 +492,16 @@ static void psa_zmq_freeMsg(void *msg, void *hint __attribute__((unused))) {
     free(msg);
 }
 
-static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg) {
+static void psa_zmq_releaseLoanedMsg(void *msg, void *hint __attribute__((unused))) {
+    pubsub_bufferPool_release(msg);
+}
+
+/**
+ * Serializes and sends a msg or -if loanedPayload is not NULL- sends a loaned payload.
+ * A loaned payload is released to the loan pool, for zero copy when zmq is done with the payload.
+ */
+static int psa_zmq_send(psa_zmq_bounded_service_entry_t *bound, unsigned int msgTypeId, const void *inMsg, void *loanedPayload, size_t loanedPayloadSize) {
     int status = CELIX_SUCCESS;
-    psa_zmq_bounded_service_entry_t *bound = handle;
     pubsub_zmq_topic_sender_t *sender = bound->parent;
     bool monitor = sender->metricsEnabled;
 
@@ -506,9 +525,11 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
             clock_gettime(CLOCK_REALTIME, &serializationStart);
         }
 
-        void *serializedOutput = NULL;
-        size_t serializedOutputLen = 0;
-        status = entry->msgSer->serialize(entry->msgSer->handle, inMsg, &serializedOutput, &serializedOutputLen);
+        void *serializedOutput = loanedPayload;
+        size_t serializedOutputLen = loanedPayloadSize;
+        if (loanedPayload == NULL) {
+            status = entry->msgSer->serialize(entry->msgSer->handle, inMsg, &serializedOutput, &serializedOutputLen);
+        }
 
         if (monitor) {
             clock_gettime(CLOCK_REALTIME, &serializationEnd);
@@ -560,7 +581,8 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
 
 
                 if (rc > 0) {
-                    zmq_msg_init_data(&msg3, serializedOutput, serializedOutputLen, psa_zmq_freeMsg, bound);
+                    zmq_msg_init_data(&msg3, serializedOutput, serializedOutputLen, loanedPayload != NULL ? psa_zmq_releaseLoanedMsg : psa_zmq_freeMsg, bound);
+                    loanedPayload = NULL; //owned by zmq
                     rc = zmq_msg_send(&msg3, socket, 0);
                     if (rc == -1) {
                         L_WARN("Error sending payload msg. %s", strerror(errno));
@@ -576,7 +598,9 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
                 zmsg_addmem(msg, serializedOutput, serializedOutputLen);
                 int rc = zmsg_send(&msg, sender->zmq.socket);
                 sendOk = rc == 0;
-                free(serializedOutput);
+                if (loanedPayload == NULL) {
+                    free(serializedOutput);
+                }
                 free(hdr);
                 if (!sendOk) {
                     zmsg_destroy(&msg); //if send was not ok, no owner change -> destroy msg
@@ -624,9 +648,39 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
         celixThreadMutex_unlock(&entry->metrics.mutex);
     }
 
+    pubsub_bufferPool_release(loanedPayload);
     return status;
 }
 
+static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg) {
+    return psa_zmq_send(handle, msgTypeId, inMsg, NULL, 0);
+}
+
+static int psa_zmq_topicPublicationLoan(void* handle, unsigned int msgTypeId, size_t size, void **buffer) {
+    psa_zmq_bounded_service_entry_t *bound = handle;
+    if (hashMap_get(bound->msgEntries, (void*)(uintptr_t)(msgTypeId)) == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    *buffer = pubsub_bufferPool_take(bound->parent->loanPool, size);
+    return *buffer == NULL ? CELIX_ENOMEM : CELIX_SUCCESS;
+}
+
+static int psa_zmq_topicPublicationCommit(void* handle, unsigned int msgTypeId, void *buffer, size_t size) {
+    if (buffer == NULL) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    if (size > pubsub_bufferPool_capacity(buffer)) {
+        //the buffer is given back, also when the commit fails
+        pubsub_bufferPool_release(buffer);
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    return psa_zmq_send(handle, msgTypeId, NULL, buffer, size);
+}
+
+static void psa_zmq_topicPublicationDiscard(void* handle __attribute__((unused)), void *buffer) {
+    pubsub_bufferPool_release(buffer);
+}
+
 static void delay_first_send_for_late_joiners(pubsub_zmq_topic_sender_t *sender) {
 
     static bool firstSend = true;
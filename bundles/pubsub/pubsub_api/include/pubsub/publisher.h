@@ -30,7 +30,7 @@
 #include <stdlib.h>
 
 #define PUBSUB_PUBLISHER_SERVICE_NAME           "pubsub.publisher"
-#define PUBSUB_PUBLISHER_SERVICE_VERSION        "3.0.0"
+#define PUBSUB_PUBLISHER_SERVICE_VERSION        "3.1.0"
  
 //properties
 #define PUBSUB_PUBLISHER_TOPIC                  "topic"
@@ -60,6 +60,33 @@ struct pubsub_publisher {
      * Returns 0 on success.
      */
     int (*send)(void *handle, unsigned int msgTypeId, const void *msg);
+
+    /**
+     * Loans a buffer with a capacity of at least size bytes from the publisher. The payload of a msg can be written
+     * in place in the loaned buffer -in the serialized form expected by the serializer of the subscribers- and send
+     * with commit, without a copy or serialization of the msg. For fixed-layout msgs this means the msg can be
+     * written directly in the loaned buffer.
+     * The loaned buffers are taken from a buffer pool of the topic, so sending a loaned buffer needs no malloc/free.
+     *
+     * A loaned buffer must be given back to the publisher with commit or discard.
+     * Returns 0 on success.
+     *
+     * this method can be NULL (the pubsubadmin does not support loaning).
+     */
+    int (*loan)(void *handle, unsigned int msgTypeId, size_t size, void **buffer);
+
+    /**
+     * Sends the first size bytes of a loaned buffer as the serialized payload of a msg with the provided msg type.
+     * commit is a async function. The buffer is given back to the publisher, also when sending fails, and must not be
+     * used after commit.
+     * Returns 0 on success and CELIX_ILLEGAL_ARGUMENT if size is larger than the loaned buffer.
+     */
+    int (*commit)(void *handle, unsigned int msgTypeId, void *buffer, size_t size);
+
+    /**
+     * Gives back a loaned buffer without sending it.
+     */
+    void (*discard)(void *handle, void *buffer);
  
 };
 typedef struct pubsub_publisher pubsub_publisher_t;
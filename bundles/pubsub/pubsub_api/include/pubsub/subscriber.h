@@ -54,6 +54,8 @@ struct pubsub_subscriber_struct {
      * msgType contains fully qualified name of the type and msgTypeId is a local id which presents the type for performance reasons.
      * Release can be used to instruct the pubsubadmin to release (free) the message when receive function returns. Set it to false to take
      * over ownership of the msg (e.g. take the responsibility to free it).
+     * If the pubsubadmin is configured to share msgs between subscribers (e.g. PSA_ZMQ_SHARED_MSG_ENABLED), the same msg
+     * instance can be provided to multiple subscribers and the msg must not be changed, unless the ownership is taken over.
      *
      * The callbacks argument is only valid inside the receive function, use the getMultipart callback, with retain=true, to keep multipart messages in memory.
      * results of the localMsgTypeIdForMsgType callback are valid during the complete lifecycle of the component, not just a single receive call.
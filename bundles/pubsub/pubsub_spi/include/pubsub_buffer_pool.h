@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PUBSUB_BUFFER_POOL_H_
+#define PUBSUB_BUFFER_POOL_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The nr of size classes of a buffer pool. The capacity of the buffers of size class i is
+ * PUBSUB_BUFFER_POOL_MIN_BUFFER_SIZE << i, so the largest pooled buffer is 2 MiB. Larger buffers are allocated
+ * and freed on every take/release.
+ */
+#define PUBSUB_BUFFER_POOL_NR_OF_SIZE_CLASSES       16
+#define PUBSUB_BUFFER_POOL_MIN_BUFFER_SIZE          64
+
+#define PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS   16
+
+/**
+ * A thread safe pool of (message) buffers, so that sending or receiving a message does not need a malloc/free.
+ *
+ * The buffers are kept in power of two size classes. Released buffers are cached -up to a maximum nr of buffers per
+ * size class- and reused for the next take of the same size class.
+ *
+ * A buffer is released with the buffer only (no pool argument), so that the release can be done from a free callback
+ * (e.g. of zmq). If the pool is destroyed while buffers are still taken, the pool is freed when the last taken buffer
+ * is released.
+ */
+typedef struct pubsub_buffer_pool pubsub_buffer_pool_t;
+
+/**
+ * Creates a buffer pool which caches up to maxCachedBuffersPerSizeClass released buffers per size class.
+ * Returns NULL if the pool cannot be allocated.
+ */
+pubsub_buffer_pool_t* pubsub_bufferPool_create(size_t maxCachedBuffersPerSizeClass);
+
+void pubsub_bufferPool_destroy(pubsub_buffer_pool_t *pool);
+
+/**
+ * Takes a buffer with a capacity of at least size bytes from the pool.
+ * The buffer must be returned with pubsub_bufferPool_release.
+ * Returns NULL if the buffer cannot be allocated or if the pool is NULL.
+ */
+void* pubsub_bufferPool_take(pubsub_buffer_pool_t *pool, size_t size);
+
+/**
+ * Returns a buffer taken from a pool to the pool.
+ */
+void pubsub_bufferPool_release(void *buffer);
+
+/**
+ * Returns the capacity of a buffer taken from a pool.
+ */
+size_t pubsub_bufferPool_capacity(const void *buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PUBSUB_BUFFER_POOL_H_ */
@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PUBSUB_SHARED_MSG_H_
+#define PUBSUB_SHARED_MSG_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "celix_errno.h"
+#include "pubsub_serializer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A received message which is deserialized once and shared between the subscribers of a topic receiver, instead of
+ * deserializing the message for every subscriber.
+ *
+ * A shared message is only valid during the dispatch of a single received message and is not thread safe; the
+ * topic receivers dispatch a message to their subscribers sequentially on the receive thread.
+ * The payload is deserialized on the first use. Every subscriber using a compatible serializer (same msg id, msg name
+ * and msg version) gets the same instance, which must be handled as immutable.
+ * A subscriber which takes over the ownership of the message (release=false in pubsub_subscriber_t.receive) keeps the
+ * instance, the next subscribers get a newly deserialized instance.
+ */
+typedef struct pubsub_shared_msg {
+    const void *payload;
+    size_t payloadSize;
+    pubsub_msg_serializer_t *msgSer; //the serializer which deserialized msg, NULL if there is no shared instance
+    void *msg;
+} pubsub_shared_msg_t;
+
+void pubsubSharedMsg_init(pubsub_shared_msg_t *sharedMsg, const void *payload, size_t payloadSize);
+
+/**
+ * Returns the deserialized message for the provided serializer.
+ *
+ * If there is no shared instance yet, the payload is deserialized and the result is the shared instance.
+ * If the shared instance is deserialized with an incompatible serializer, the payload is deserialized for the
+ * provided serializer and the result is not shared; the caller is owner of the message.
+ *
+ * @param sharedMsg     The shared message.
+ * @param msgSer        The msg serializer of the subscriber.
+ * @param out           Output pointer for the deserialized message.
+ * @param outIsShared   Output for whether the message is the shared instance.
+ * @return              The status of the deserialize call or CELIX_SUCCESS if the shared instance is reused.
+ */
+celix_status_t pubsubSharedMsg_deserialize(pubsub_shared_msg_t *sharedMsg, pubsub_msg_serializer_t *msgSer, void **out, bool *outIsShared);
+
+/**
+ * Handles the release flag of a subscriber for the shared instance. If the subscriber did not release the message,
+ * the ownership of the instance is transferred to the subscriber and the shared message will deserialize a new
+ * instance on the next use.
+ */
+void pubsubSharedMsg_done(pubsub_shared_msg_t *sharedMsg, void *msg, bool release);
+
+/**
+ * Frees the shared instance, if still owned by the shared message.
+ */
+void pubsubSharedMsg_deinit(pubsub_shared_msg_t *sharedMsg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PUBSUB_SHARED_MSG_H_ */
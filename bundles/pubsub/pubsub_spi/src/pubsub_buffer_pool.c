@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "celix_threads.h"
+#include "pubsub_buffer_pool.h"
+
+typedef struct pubsub_buffer_pool_entry pubsub_buffer_pool_entry_t;
+
+struct pubsub_buffer_pool_entry {
+    pubsub_buffer_pool_t *pool;
+    pubsub_buffer_pool_entry_t *next; //only used when cached
+    size_t capacity;
+    int sizeClass; //-1 for a buffer larger than the largest size class
+};
+
+//the buffer directly follows the entry, aligned for any type
+#define PUBSUB_BUFFER_POOL_ENTRY_SIZE ((sizeof(pubsub_buffer_pool_entry_t) + 15) & ~((size_t)15))
+
+struct pubsub_buffer_pool {
+    celix_thread_mutex_t mutex; //protects below
+    size_t maxCachedBuffersPerSizeClass;
+    pubsub_buffer_pool_entry_t *cached[PUBSUB_BUFFER_POOL_NR_OF_SIZE_CLASSES];
+    size_t nrOfCached[PUBSUB_BUFFER_POOL_NR_OF_SIZE_CLASSES];
+    size_t nrOfTaken;
+    bool destroyed;
+};
+
+static inline pubsub_buffer_pool_entry_t* pubsub_bufferPool_entryFor(const void *buffer) {
+    return (pubsub_buffer_pool_entry_t*)((char*)buffer - PUBSUB_BUFFER_POOL_ENTRY_SIZE);
+}
+
+static inline void* pubsub_bufferPool_bufferFor(pubsub_buffer_pool_entry_t *entry) {
+    return (char*)entry + PUBSUB_BUFFER_POOL_ENTRY_SIZE;
+}
+
+static int pubsub_bufferPool_sizeClassFor(size_t size) {
+    size_t capacity = PUBSUB_BUFFER_POOL_MIN_BUFFER_SIZE;
+    for (int i = 0; i < PUBSUB_BUFFER_POOL_NR_OF_SIZE_CLASSES; ++i) {
+        if (size <= capacity) {
+            return i;
+        }
+        capacity <<= 1;
+    }
+    return -1;
+}
+
+static void pubsub_bufferPool_free(pubsub_buffer_pool_t *pool) {
+    for (int i = 0; i < PUBSUB_BUFFER_POOL_NR_OF_SIZE_CLASSES; ++i) {
+        pubsub_buffer_pool_entry_t *entry = pool->cached[i];
+        while (entry != NULL) {
+            pubsub_buffer_pool_entry_t *next = entry->next;
+            free(entry);
+            entry = next;
+        }
+        pool->cached[i] = NULL;
+        pool->nrOfCached[i] = 0;
+    }
+}
+
+pubsub_buffer_pool_t* pubsub_bufferPool_create(size_t maxCachedBuffersPerSizeClass) {
+    pubsub_buffer_pool_t *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    celixThreadMutex_create(&pool->mutex, NULL);
+    pool->maxCachedBuffersPerSizeClass = maxCachedBuffersPerSizeClass;
+    return pool;
+}
+
+void pubsub_bufferPool_destroy(pubsub_buffer_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    celixThreadMutex_lock(&pool->mutex);
+    pubsub_bufferPool_free(pool);
+    pool->destroyed = true;
+    bool freePool = pool->nrOfTaken == 0;
+    celixThreadMutex_unlock(&pool->mutex);
+    if (freePool) {
+        celixThreadMutex_destroy(&pool->mutex);
+        free(pool);
+    }
+}
+
+void* pubsub_bufferPool_take(pubsub_buffer_pool_t *pool, size_t size) {
+    if (pool == NULL) {
+        return NULL;
+    }
+    int sizeClass = pubsub_bufferPool_sizeClassFor(size);
+    pubsub_buffer_pool_entry_t *entry = NULL;
+
+    celixThreadMutex_lock(&pool->mutex);
+    if (sizeClass >= 0 && pool->cached[sizeClass] != NULL) {
+        entry = pool->cached[sizeClass];
+        pool->cached[sizeClass] = entry->next;
+        pool->nrOfCached[sizeClass] -= 1;
+    }
+    pool->nrOfTaken += 1;
+    celixThreadMutex_unlock(&pool->mutex);
+
+    if (entry == NULL) {
+        size_t capacity = sizeClass >= 0 ? (size_t)PUBSUB_BUFFER_POOL_MIN_BUFFER_SIZE << sizeClass : size;
+        entry = capacity <= SIZE_MAX - PUBSUB_BUFFER_POOL_ENTRY_SIZE ? malloc(PUBSUB_BUFFER_POOL_ENTRY_SIZE + capacity) : NULL;
+        if (entry == NULL) {
+            celixThreadMutex_lock(&pool->mutex);
+            pool->nrOfTaken -= 1;
+            celixThreadMutex_unlock(&pool->mutex);
+            return NULL;
+        }
+        entry->pool = pool;
+        entry->capacity = capacity;
+        entry->sizeClass = sizeClass;
+    }
+    entry->next = NULL;
+    return pubsub_bufferPool_bufferFor(entry);
+}
+
+void pubsub_bufferPool_release(void *buffer) {
+    if (buffer == NULL) {
+        return;
+    }
+    pubsub_buffer_pool_entry_t *entry = pubsub_bufferPool_entryFor(buffer);
+    pubsub_buffer_pool_t *pool = entry->pool;
+
+    celixThreadMutex_lock(&pool->mutex);
+    pool->nrOfTaken -= 1;
+    bool cached = false;
+    if (!pool->destroyed && entry->sizeClass >= 0 && pool->nrOfCached[entry->sizeClass] < pool->maxCachedBuffersPerSizeClass) {
+        entry->next = pool->cached[entry->sizeClass];
+        pool->cached[entry->sizeClass] = entry;
+        pool->nrOfCached[entry->sizeClass] += 1;
+        cached = true;
+    }
+    bool freePool = pool->destroyed && pool->nrOfTaken == 0;
+    celixThreadMutex_unlock(&pool->mutex);
+
+    if (!cached) {
+        free(entry);
+    }
+    if (freePool) {
+        celixThreadMutex_destroy(&pool->mutex);
+        free(pool);
+    }
+}
+
+size_t pubsub_bufferPool_capacity(const void *buffer) {
+    return buffer == NULL ? 0 : pubsub_bufferPool_entryFor(buffer)->capacity;
+}
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "pubsub_shared_msg.h"
+
+void pubsubSharedMsg_init(pubsub_shared_msg_t *sharedMsg, const void *payload, size_t payloadSize) {
+    sharedMsg->payload = payload;
+    sharedMsg->payloadSize = payloadSize;
+    sharedMsg->msgSer = NULL;
+    sharedMsg->msg = NULL;
+}
+
+/**
+ * Returns whether a msg deserialized by serializer a can be used as msg of serializer b. This is the case if both
+ * serializers use the same msg definition. The serializers can differ, because every subscriber bundle has its own
+ * serializer map.
+ */
+static bool pubsubSharedMsg_isCompatible(pubsub_msg_serializer_t *a, pubsub_msg_serializer_t *b) {
+    if (a == b) {
+        return true;
+    }
+    if (a->msgId != b->msgId || a->msgName == NULL || b->msgName == NULL || strcmp(a->msgName, b->msgName) != 0) {
+        return false;
+    }
+    int cmp = -1;
+    if (a->msgVersion != NULL && b->msgVersion != NULL) {
+        version_compareTo(a->msgVersion, b->msgVersion, &cmp);
+    } else if (a->msgVersion == NULL && b->msgVersion == NULL) {
+        cmp = 0;
+    }
+    return cmp == 0;
+}
+
+celix_status_t pubsubSharedMsg_deserialize(pubsub_shared_msg_t *sharedMsg, pubsub_msg_serializer_t *msgSer, void **out, bool *outIsShared) {
+    if (sharedMsg->msg != NULL && pubsubSharedMsg_isCompatible(sharedMsg->msgSer, msgSer)) {
+        *out = sharedMsg->msg;
+        *outIsShared = true;
+        return CELIX_SUCCESS;
+    }
+
+    void *msg = NULL;
+    celix_status_t status = msgSer->deserialize(msgSer->handle, sharedMsg->payload, sharedMsg->payloadSize, &msg);
+    *outIsShared = false;
+    if (status == CELIX_SUCCESS && sharedMsg->msg == NULL) {
+        sharedMsg->msg = msg;
+        sharedMsg->msgSer = msgSer;
+        *outIsShared = true;
+    }
+    *out = msg;
+    return status;
+}
+
+void pubsubSharedMsg_done(pubsub_shared_msg_t *sharedMsg, void *msg, bool release) {
+    if (!release && msg != NULL && msg == sharedMsg->msg) {
+        //ownership transferred to the subscriber
+        sharedMsg->msg = NULL;
+        sharedMsg->msgSer = NULL;
+    }
+}
+
+void pubsubSharedMsg_deinit(pubsub_shared_msg_t *sharedMsg) {
+    if (sharedMsg->msg != NULL) {
+        sharedMsg->msgSer->freeMsg(sharedMsg->msgSer->handle, sharedMsg->msg);
+        sharedMsg->msg = NULL;
+        sharedMsg->msgSer = NULL;
+    }
+}
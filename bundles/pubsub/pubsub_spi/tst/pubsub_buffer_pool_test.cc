@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "pubsub_buffer_pool.h"
+
+TEST_GROUP(PubSubBufferPoolTests) {
+    pubsub_buffer_pool_t *pool = nullptr;
+
+    void setup() {
+        pool = pubsub_bufferPool_create(2);
+    }
+
+    void teardown() {
+        pubsub_bufferPool_destroy(pool);
+    }
+};
+
+TEST(PubSubBufferPoolTests, sizeClasses) {
+    size_t maxPooledSize = (size_t)PUBSUB_BUFFER_POOL_MIN_BUFFER_SIZE << (PUBSUB_BUFFER_POOL_NR_OF_SIZE_CLASSES - 1);
+    CHECK_EQUAL(2 * 1024 * 1024, maxPooledSize);
+
+    struct {
+        size_t size;
+        size_t expectedCapacity;
+    } cases[] = {
+            {0, 64},
+            {1, 64},
+            {64, 64},
+            {65, 128},
+            {1000, 1024},
+            {1024, 1024},
+            {1025, 2048},
+            {maxPooledSize - 1, maxPooledSize},
+            {maxPooledSize, maxPooledSize},
+    };
+    for (auto &c : cases) {
+        void *buffer = pubsub_bufferPool_take(pool, c.size);
+        CHECK(buffer != nullptr);
+        CHECK_EQUAL(c.expectedCapacity, pubsub_bufferPool_capacity(buffer));
+        CHECK_EQUAL(0, (uintptr_t)buffer % 16);
+        memset(buffer, 0xAB, pubsub_bufferPool_capacity(buffer));
+        pubsub_bufferPool_release(buffer);
+
+        //a released buffer is reused for the next take of the same size class
+        void *reused = pubsub_bufferPool_take(pool, c.expectedCapacity);
+        POINTERS_EQUAL(buffer, reused);
+        pubsub_bufferPool_release(reused);
+    }
+}
+
+TEST(PubSubBufferPoolTests, buffersLargerThanLargestSizeClass) {
+    size_t size = ((size_t)2 * 1024 * 1024) + 1;
+    void *buffer = pubsub_bufferPool_take(pool, size);
+    CHECK(buffer != nullptr);
+    CHECK_EQUAL(size, pubsub_bufferPool_capacity(buffer)); //not rounded up to a size class
+    memset(buffer, 0xAB, size);
+    pubsub_bufferPool_release(buffer); //not cached, freed
+
+    size = (size_t)8 * 1024 * 1024;
+    buffer = pubsub_bufferPool_take(pool, size);
+    CHECK(buffer != nullptr);
+    CHECK_EQUAL(size, pubsub_bufferPool_capacity(buffer));
+    pubsub_bufferPool_release(buffer);
+}
+
+TEST(PubSubBufferPoolTests, cacheCap) {
+    //pool caches at most 2 buffers per size class
+    void *b1 = pubsub_bufferPool_take(pool, 100);
+    void *b2 = pubsub_bufferPool_take(pool, 100);
+    void *b3 = pubsub_bufferPool_take(pool, 100);
+    CHECK(b1 != b2 && b2 != b3 && b1 != b3);
+    pubsub_bufferPool_release(b1);
+    pubsub_bufferPool_release(b2);
+    pubsub_bufferPool_release(b3); //cache full, freed
+
+    //cached buffers are reused last released first
+    void *t1 = pubsub_bufferPool_take(pool, 100);
+    void *t2 = pubsub_bufferPool_take(pool, 100);
+    POINTERS_EQUAL(b2, t1);
+    POINTERS_EQUAL(b1, t2);
+
+    //the cache is per size class
+    void *other = pubsub_bufferPool_take(pool, 1000);
+    CHECK(other != b3);
+    pubsub_bufferPool_release(other);
+
+    pubsub_bufferPool_release(t1);
+    pubsub_bufferPool_release(t2);
+}
+
+TEST(PubSubBufferPoolTests, noCache) {
+    pubsub_buffer_pool_t *noCachePool = pubsub_bufferPool_create(0);
+    void *buffer = pubsub_bufferPool_take(noCachePool, 100);
+    CHECK_EQUAL(128, pubsub_bufferPool_capacity(buffer));
+    pubsub_bufferPool_release(buffer); //freed
+    pubsub_bufferPool_destroy(noCachePool);
+}
+
+TEST(PubSubBufferPoolTests, destroyWhileBuffersAreTaken) {
+    pubsub_buffer_pool_t *loanPool = pubsub_bufferPool_create(PUBSUB_BUFFER_POOL_DEFAULT_MAX_CACHED_BUFFERS);
+    void *cached = pubsub_bufferPool_take(loanPool, 100);
+    pubsub_bufferPool_release(cached);
+    void *b1 = pubsub_bufferPool_take(loanPool, 100);
+    void *b2 = pubsub_bufferPool_take(loanPool, 4 * 1024 * 1024);
+
+    //the pool is freed when the last taken buffer is released
+    pubsub_bufferPool_destroy(loanPool);
+    memset(b1, 0xAB, pubsub_bufferPool_capacity(b1));
+    memset(b2, 0xAB, pubsub_bufferPool_capacity(b2));
+    pubsub_bufferPool_release(b1); //not cached, because the pool is destroyed
+    pubsub_bufferPool_release(b2); //last taken buffer, frees the pool
+}
+
+TEST(PubSubBufferPoolTests, takeFailure) {
+    void *buffer = pubsub_bufferPool_take(pool, SIZE_MAX);
+    POINTERS_EQUAL(nullptr, buffer);
+    CHECK_EQUAL(0, pubsub_bufferPool_capacity(buffer));
+    pubsub_bufferPool_release(buffer); //nop
+
+    //a failed take is not counted as taken, so destroy frees the pool directly
+    pubsub_buffer_pool_t *otherPool = pubsub_bufferPool_create(1);
+    POINTERS_EQUAL(nullptr, pubsub_bufferPool_take(otherPool, SIZE_MAX - 1));
+    pubsub_bufferPool_destroy(otherPool);
+
+    //no pool (e.g. a failed pubsub_bufferPool_create), no buffers
+    POINTERS_EQUAL(nullptr, pubsub_bufferPool_take(nullptr, 64));
+}
+
+TEST(PubSubBufferPoolTests, concurrentTakeAndRelease) {
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([this, t] {
+            for (int i = 0; i < 1000; ++i) {
+                size_t size = (size_t)(t + 1) * 100 + (size_t)i;
+                auto *buffer = static_cast<char*>(pubsub_bufferPool_take(pool, size));
+                CHECK(buffer != nullptr);
+                memset(buffer, t, size);
+                pubsub_bufferPool_release(buffer);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,249 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <initializer_list>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pubsub_shared_msg.h"
+
+namespace {
+    struct serializer_data {
+        int deserializeCount = 0;
+        int freeCount = 0;
+        bool fail = false;
+    };
+
+    celix_status_t deserialize(void *handle, const void *input, size_t inputLen, void **out) {
+        auto *data = static_cast<serializer_data*>(handle);
+        if (data->fail) {
+            return CELIX_ILLEGAL_ARGUMENT;
+        }
+        data->deserializeCount += 1;
+        void *msg = malloc(inputLen);
+        memcpy(msg, input, inputLen);
+        *out = msg;
+        return CELIX_SUCCESS;
+    }
+
+    void freeMsg(void *handle, void *msg) {
+        auto *data = static_cast<serializer_data*>(handle);
+        data->freeCount += 1;
+        free(msg);
+    }
+}
+
+TEST_GROUP(PubSubSharedMsgTests) {
+    serializer_data data{};
+    pubsub_msg_serializer_t ser1{}; //note ser1 and ser2 are compatible, e.g. the serializers of two subscriber bundles
+    pubsub_msg_serializer_t ser2{};
+    pubsub_msg_serializer_t otherVersionSer{};
+    pubsub_msg_serializer_t otherNameSer{};
+    pubsub_msg_serializer_t otherIdSer{};
+    int payload = 42;
+    pubsub_shared_msg_t sharedMsg{};
+
+    void setupSerializer(pubsub_msg_serializer_t *ser, unsigned int msgId, const char *msgName, int major) {
+        ser->handle = &data;
+        ser->msgId = msgId;
+        ser->msgName = msgName;
+        version_createVersion(major, 0, 0, nullptr, &ser->msgVersion);
+        ser->deserialize = deserialize;
+        ser->freeMsg = freeMsg;
+    }
+
+    void setup() {
+        setupSerializer(&ser1, 1, "msg", 1);
+        setupSerializer(&ser2, 1, "msg", 1);
+        setupSerializer(&otherVersionSer, 1, "msg", 2);
+        setupSerializer(&otherNameSer, 1, "other", 1);
+        setupSerializer(&otherIdSer, 2, "msg", 1);
+        pubsubSharedMsg_init(&sharedMsg, &payload, sizeof(payload));
+    }
+
+    void teardown() {
+        for (auto *ser : {&ser1, &ser2, &otherVersionSer, &otherNameSer, &otherIdSer}) {
+            if (ser->msgVersion != nullptr) {
+                version_destroy(ser->msgVersion);
+            }
+        }
+    }
+};
+
+TEST(PubSubSharedMsgTests, deserializeOnceForCompatibleSerializers) {
+    void *msg1 = nullptr;
+    bool shared1 = false;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser1, &msg1, &shared1));
+    CHECK(shared1);
+    CHECK_EQUAL(42, *static_cast<int*>(msg1));
+    pubsubSharedMsg_done(&sharedMsg, msg1, true);
+
+    void *msg2 = nullptr;
+    bool shared2 = false;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser2, &msg2, &shared2));
+    CHECK(shared2);
+    POINTERS_EQUAL(msg1, msg2);
+    pubsubSharedMsg_done(&sharedMsg, msg2, true);
+    CHECK_EQUAL(1, data.deserializeCount);
+
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(1, data.freeCount);
+}
+
+TEST(PubSubSharedMsgTests, deserializeForIncompatibleSerializers) {
+    void *sharedInstance = nullptr;
+    bool shared = false;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser1, &sharedInstance, &shared));
+    CHECK(shared);
+    pubsubSharedMsg_done(&sharedMsg, sharedInstance, true);
+
+    pubsub_msg_serializer_t *incompatible[] = {&otherVersionSer, &otherNameSer, &otherIdSer};
+    for (auto *ser : incompatible) {
+        void *msg = nullptr;
+        CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, ser, &msg, &shared));
+        CHECK_FALSE(shared);
+        CHECK(msg != sharedInstance);
+        CHECK_EQUAL(42, *static_cast<int*>(msg));
+        pubsubSharedMsg_done(&sharedMsg, msg, true);
+        ser->freeMsg(ser->handle, msg); //not shared, so owned by the caller
+    }
+    CHECK_EQUAL(4, data.deserializeCount);
+
+    //the shared instance is still used for compatible serializers
+    void *msg = nullptr;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser2, &msg, &shared));
+    CHECK(shared);
+    POINTERS_EQUAL(sharedInstance, msg);
+    pubsubSharedMsg_done(&sharedMsg, msg, true);
+
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(4, data.freeCount);
+}
+
+TEST(PubSubSharedMsgTests, compatibleSerializersWithoutVersion) {
+    version_destroy(ser1.msgVersion);
+    version_destroy(ser2.msgVersion);
+    ser1.msgVersion = nullptr;
+    ser2.msgVersion = nullptr;
+
+    void *msg1 = nullptr;
+    void *msg2 = nullptr;
+    bool shared = false;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser1, &msg1, &shared));
+    pubsubSharedMsg_done(&sharedMsg, msg1, true);
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser2, &msg2, &shared));
+    CHECK(shared);
+    POINTERS_EQUAL(msg1, msg2);
+    pubsubSharedMsg_done(&sharedMsg, msg2, true);
+
+    //a serializer with a version is not compatible with a serializer without version
+    void *msg3 = nullptr;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &otherVersionSer, &msg3, &shared));
+    CHECK_FALSE(shared);
+    otherVersionSer.freeMsg(otherVersionSer.handle, msg3);
+
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(2, data.freeCount);
+}
+
+TEST(PubSubSharedMsgTests, ownershipTransferredWhenNotReleased) {
+    void *msg1 = nullptr;
+    bool shared = false;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser1, &msg1, &shared));
+    CHECK(shared);
+    pubsubSharedMsg_done(&sharedMsg, msg1, false); //subscriber keeps the msg
+
+    //the next subscriber gets a newly deserialized msg, which is shared again
+    void *msg2 = nullptr;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser2, &msg2, &shared));
+    CHECK(shared);
+    CHECK(msg1 != msg2);
+    CHECK_EQUAL(42, *static_cast<int*>(msg2));
+    CHECK_EQUAL(2, data.deserializeCount);
+    pubsubSharedMsg_done(&sharedMsg, msg2, true);
+
+    void *msg3 = nullptr;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser1, &msg3, &shared));
+    POINTERS_EQUAL(msg2, msg3);
+    pubsubSharedMsg_done(&sharedMsg, msg3, true);
+    CHECK_EQUAL(2, data.deserializeCount);
+
+    //deinit only frees the msg still owned by the shared msg
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(1, data.freeCount);
+    ser1.freeMsg(ser1.handle, msg1);
+    CHECK_EQUAL(2, data.freeCount);
+}
+
+TEST(PubSubSharedMsgTests, doneWithNotSharedMsgKeepsSharedInstance) {
+    void *sharedInstance = nullptr;
+    bool shared = false;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser1, &sharedInstance, &shared));
+
+    void *msg = nullptr;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &otherIdSer, &msg, &shared));
+    CHECK_FALSE(shared);
+    pubsubSharedMsg_done(&sharedMsg, msg, false); //not the shared instance, so no ownership change
+    POINTERS_EQUAL(sharedInstance, sharedMsg.msg);
+    otherIdSer.freeMsg(otherIdSer.handle, msg);
+
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(2, data.freeCount);
+}
+
+TEST(PubSubSharedMsgTests, deserializeFailure) {
+    data.fail = true;
+    void *msg = nullptr;
+    bool shared = true;
+    CHECK_EQUAL(CELIX_ILLEGAL_ARGUMENT, pubsubSharedMsg_deserialize(&sharedMsg, &ser1, &msg, &shared));
+    CHECK_FALSE(shared);
+    POINTERS_EQUAL(nullptr, msg);
+    pubsubSharedMsg_done(&sharedMsg, msg, true);
+
+    //no shared instance, so the next use deserializes again
+    data.fail = false;
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser2, &msg, &shared));
+    CHECK(shared);
+    pubsubSharedMsg_done(&sharedMsg, msg, true);
+
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(1, data.freeCount);
+}
+
+TEST(PubSubSharedMsgTests, deinit) {
+    //deinit without use does not free anything
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(0, data.freeCount);
+
+    void *msg = nullptr;
+    bool shared = false;
+    pubsubSharedMsg_init(&sharedMsg, &payload, sizeof(payload));
+    CHECK_EQUAL(CELIX_SUCCESS, pubsubSharedMsg_deserialize(&sharedMsg, &ser1, &msg, &shared));
+    pubsubSharedMsg_done(&sharedMsg, msg, true);
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(1, data.freeCount);
+    POINTERS_EQUAL(nullptr, sharedMsg.msg);
+    POINTERS_EQUAL(nullptr, sharedMsg.msgSer);
+
+    //a second deinit is a no-op
+    pubsubSharedMsg_deinit(&sharedMsg);
+    CHECK_EQUAL(1, data.freeCount);
+}
@@ -507,10 +507,10 @@ static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_servic
         }
     }
 
-    hash_map_entry_pt entry = hashMap_getEntry(endpointProperties, (void *) OSGI_FRAMEWORK_SERVICE_ID);
-
-    char* key = hashMapEntry_getKey(entry);
-    char *serviceId = (char *) hashMap_remove(endpointProperties, (void *) OSGI_FRAMEWORK_SERVICE_ID);
+    // note the key is owned by the properties (and can be interned), so unset instead of removing and freeing it
+    const char *svcId = celix_properties_get(endpointProperties, OSGI_FRAMEWORK_SERVICE_ID, NULL);
+    char *serviceId = svcId != NULL ? strdup(svcId) : NULL;
+    celix_properties_unset(endpointProperties, OSGI_FRAMEWORK_SERVICE_ID);
     const char *uuid = NULL;
 
     char buf[512];
@@ -555,7 +555,6 @@ static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_servic
         (*endpoint)->properties = endpointProperties;
     }
 
-    free(key);
     free(serviceId);
     free(keys);
 
@@ -742,10 +742,10 @@ celix_status_t remoteServiceAdmin_installEndpoint(remote_service_admin_t *admin,
 		}
 	}
 
-	hash_map_entry_pt entry = hashMap_getEntry(endpointProperties, (void *) OSGI_FRAMEWORK_SERVICE_ID);
-
-	char* key = hashMapEntry_getKey(entry);
-	char *serviceId = (char *) hashMap_remove(endpointProperties, (void *) OSGI_FRAMEWORK_SERVICE_ID);
+	// note the key is owned by the properties (and can be interned), so unset instead of removing and freeing it
+	const char *svcId = celix_properties_get(endpointProperties, OSGI_FRAMEWORK_SERVICE_ID, NULL);
+	char *serviceId = svcId != NULL ? strdup(svcId) : NULL;
+	celix_properties_unset(endpointProperties, OSGI_FRAMEWORK_SERVICE_ID);
 	const char *uuid = NULL;
 
 	uuid_t endpoint_uid;
@@ -790,7 +790,6 @@ celix_status_t remoteServiceAdmin_installEndpoint(remote_service_admin_t *admin,
 	remoteServiceAdmin_createEndpointDescription(admin, reference, endpointProperties, interface, &endpointDescription);
 	exportRegistration_setEndpointDescription(registration, endpointDescription);
 
-	free(key);
 	free(serviceId);
 	free(keys);
 
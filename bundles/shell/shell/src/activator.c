@@ -33,7 +33,7 @@
 #include "service_tracker.h"
 #include "celix_constants.h"
 
-#define NUMBER_OF_COMMANDS 11
+#define NUMBER_OF_COMMANDS 12
 
 struct command {
     celix_status_t (*exec)(void *handle, char *commandLine, FILE *out, FILE *err);
@@ -149,6 +149,15 @@ celix_status_t bundleActivator_create(bundle_context_pt context_ptr, void **_ppt
                         .usage = "dm [wtf] [f|full] [<Bundle ID> [<Bundle ID> [...]]]"
                 };
         instance_ptr->std_commands[10] =
+                (struct command) {
+                        .exec = registryStatsCommand_execute,
+                        .name = "registry",
+                        .description = "print the service registry statistics per bundle and per service name." \
+                            "\nThe statistics must be enabled with the CELIX_FRAMEWORK_REGISTRY_STATISTICS framework property." \
+                            "\nUse reset to reset the statistics.",
+                        .usage = "registry [bundles | services | reset]"
+                };
+        instance_ptr->std_commands[11] =
                 (struct command) { NULL, NULL, NULL, NULL, NULL, NULL, -1L }; /*marker for last element*/
 
         unsigned int i = 0;
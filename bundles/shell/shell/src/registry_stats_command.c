@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "celix_bundle_context.h"
+#include "celix_bundle.h"
+#include "celix_constants.h"
+#include "celix_registry_statistics_service.h"
+#include "std_commands.h"
+
+static const char * const STATISTICS_TYPE_NAMES[CELIX_REGISTRY_STATISTICS_NR_OF_TYPES] = {
+        "lookups",
+        "filter matches",
+        "listener calls",
+        "tracker callbacks"
+};
+
+typedef struct registry_stats_command_data {
+    celix_bundle_context_t *ctx;
+    FILE *out;
+    bool printBundles;
+    bool printServices;
+    bool reset;
+} registry_stats_command_data_t;
+
+/**
+ * Returns the upper bound in microseconds of the histogram bucket containing the provided percentile,
+ * or -1 if the bucket has no upper bound.
+ */
+static long registryStats_percentileUpperBound(const celix_registry_call_statistics_t *calls, double percentile) {
+    size_t threshold = (size_t)((double)calls->count * percentile);
+    size_t cumulative = 0;
+    for (int i = 0; i < CELIX_REGISTRY_STATISTICS_NR_OF_BUCKETS; ++i) {
+        cumulative += calls->histogram[i];
+        if (cumulative > threshold || cumulative == calls->count) {
+            return i == CELIX_REGISTRY_STATISTICS_NR_OF_BUCKETS - 1 ? -1L : 1L << i;
+        }
+    }
+    return -1L;
+}
+
+static void registryStats_printCalls(FILE *out, const celix_registry_statistics_entry_t *entry) {
+    for (int i = 0; i < CELIX_REGISTRY_STATISTICS_NR_OF_TYPES; ++i) {
+        const celix_registry_call_statistics_t *calls = &entry->calls[i];
+        if (calls->count == 0) {
+            continue;
+        }
+        double avgInUs = calls->totalTimeInSeconds * 1000000.0 / (double)calls->count;
+        long p50 = registryStats_percentileUpperBound(calls, 0.5);
+        long p99 = registryStats_percentileUpperBound(calls, 0.99);
+        fprintf(out, "   |- %-17s count=%zu, avg=%.1fus, max=%.1fus", STATISTICS_TYPE_NAMES[i], calls->count, avgInUs,
+                calls->maxTimeInSeconds * 1000000.0);
+        if (p50 >= 0) {
+            fprintf(out, ", p50<%lius", p50);
+        }
+        if (p99 >= 0) {
+            fprintf(out, ", p99<%lius", p99);
+        }
+        fprintf(out, "\n");
+    }
+}
+
+static void registryStats_printBundleName(void *handle, const celix_bundle_t *bnd) {
+    FILE *out = handle;
+    fprintf(out, " (%s)", celix_bundle_getSymbolicName(bnd));
+}
+
+static void registryStats_printBundleEntry(void *handle, const celix_registry_statistics_entry_t *entry) {
+    registry_stats_command_data_t *data = handle;
+    fprintf(data->out, "Bundle %li", entry->bundleId);
+    celix_bundleContext_useBundle(data->ctx, entry->bundleId, data->out, registryStats_printBundleName);
+    fprintf(data->out, ":\n");
+    registryStats_printCalls(data->out, entry);
+}
+
+static void registryStats_printServiceNameEntry(void *handle, const celix_registry_statistics_entry_t *entry) {
+    registry_stats_command_data_t *data = handle;
+    fprintf(data->out, "Service %s:\n", entry->serviceName);
+    registryStats_printCalls(data->out, entry);
+}
+
+static void registryStats_useService(void *handle, void *svc) {
+    registry_stats_command_data_t *data = handle;
+    celix_registry_statistics_service_t *stats = svc;
+    if (data->reset) {
+        stats->reset(stats->handle);
+        fprintf(data->out, "Registry statistics reset.\n");
+        return;
+    }
+    if (data->printBundles) {
+        stats->useBundleStatistics(stats->handle, data, registryStats_printBundleEntry);
+    }
+    if (data->printServices) {
+        if (data->printBundles) {
+            fprintf(data->out, "\n");
+        }
+        stats->useServiceNameStatistics(stats->handle, data, registryStats_printServiceNameEntry);
+    }
+}
+
+celix_status_t registryStatsCommand_execute(void *handle, char *line, FILE *out, FILE *err) {
+    registry_stats_command_data_t data;
+    data.ctx = handle;
+    data.out = out;
+    data.printBundles = false;
+    data.printServices = false;
+    data.reset = false;
+
+    char *str = strdup(line);
+    char *savePtr = NULL;
+    strtok_r(str, OSGI_SHELL_COMMAND_SEPARATOR, &savePtr); //skip command
+    char *tok = strtok_r(NULL, OSGI_SHELL_COMMAND_SEPARATOR, &savePtr);
+    while (tok != NULL) {
+        if (strcmp("bundles", tok) == 0 || strcmp("b", tok) == 0) {
+            data.printBundles = true;
+        } else if (strcmp("services", tok) == 0 || strcmp("s", tok) == 0) {
+            data.printServices = true;
+        } else if (strcmp("reset", tok) == 0) {
+            data.reset = true;
+        } else {
+            fprintf(err, "Skipping unknown argument: %s\n", tok);
+        }
+        tok = strtok_r(NULL, OSGI_SHELL_COMMAND_SEPARATOR, &savePtr);
+    }
+    free(str);
+
+    if (!data.printBundles && !data.printServices) {
+        data.printBundles = true;
+        data.printServices = true;
+    }
+
+    bool called = celix_bundleContext_useService(data.ctx, CELIX_REGISTRY_STATISTICS_SERVICE_NAME, &data, registryStats_useService);
+    if (!called) {
+        fprintf(err, "Registry statistics not available. Enable them with the %s framework property.\n", CELIX_FRAMEWORK_REGISTRY_STATISTICS);
+    }
+    return CELIX_SUCCESS;
+}
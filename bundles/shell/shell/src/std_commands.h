@@ -41,6 +41,7 @@ celix_status_t logCommand_execute(void *handle, char * commandline, FILE *outStr
 celix_status_t inspectCommand_execute(void *handle, char * commandline, FILE *outStream, FILE *errStream);
 celix_status_t helpCommand_execute(void *handle, char * commandline, FILE *outStream, FILE *errStream);
 celix_status_t dmListCommand_execute(void* handle, char * line, FILE *out, FILE *err);
+celix_status_t registryStatsCommand_execute(void *handle, char *line, FILE *out, FILE *err);
 
 
 #endif
@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <atomic>
+#include <vector>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "celix_api.h"
+#include "celix_framework_factory.h"
+extern "C" {
+#include "framework_private.h"
+}
+
+namespace {
+    constexpr int NR_OF_EVENTS = 1000;
+
+    celix_status_t countBundleEvent(void *listener, bundle_event_t *) {
+        auto *count = static_cast<std::atomic<long>*>(static_cast<bundle_listener_t*>(listener)->handle);
+        count->fetch_add(1, std::memory_order_relaxed);
+        return CELIX_SUCCESS;
+    }
+}
+
+/**
+ * Fires NR_OF_EVENTS bundle events per iteration from range(1) threads and waits until all range(0) bundle listeners
+ * received them.
+ */
+static void BM_FireBundleEvents(benchmark::State &state) {
+    int nrOfListeners = (int)state.range(0);
+    int nrOfThreads = (int)state.range(1);
+
+    celix_properties_t *config = celix_properties_create();
+    celix_properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    celix_properties_set(config, "org.osgi.framework.storage", ".cacheBundleEventBenchmark");
+    celix_framework_t *fw = celix_frameworkFactory_createFramework(config);
+    celix_bundle_context_t *ctx = celix_framework_getFrameworkContext(fw);
+    celix_bundle_t *bnd = celix_bundleContext_getBundle(ctx);
+
+    std::atomic<long> count{0};
+    std::vector<bundle_listener_t> listeners{(size_t)nrOfListeners};
+    for (auto &listener : listeners) {
+        listener.handle = &count;
+        listener.bundleChanged = countBundleEvent;
+        bundleContext_addBundleListener(ctx, &listener);
+    }
+
+    long expected = 0;
+    for (auto _ : state) {
+        std::vector<std::thread> threads{};
+        for (int t = 0; t < nrOfThreads; ++t) {
+            threads.emplace_back([fw, bnd, nrOfThreads]{
+                for (int i = 0; i < NR_OF_EVENTS / nrOfThreads; ++i) {
+                    fw_fireBundleEvent(fw, OSGI_FRAMEWORK_BUNDLE_EVENT_RESOLVED, bnd);
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        expected += (NR_OF_EVENTS / nrOfThreads) * nrOfThreads * nrOfListeners;
+        while (count.load() < expected) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (NR_OF_EVENTS / nrOfThreads) * nrOfThreads);
+
+    for (auto &listener : listeners) {
+        bundleContext_removeBundleListener(ctx, &listener);
+    }
+    celix_frameworkFactory_destroyFramework(fw);
+}
+BENCHMARK(BM_FireBundleEvents)->Args({1, 1})->Args({10, 1})->Args({1, 4})->Args({10, 4})->UseRealTime();
@@ -0,0 +1,152 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "celix_api.h"
+#include "celix_framework_factory.h"
+
+namespace {
+    int countStart(void *handle) {
+        static_cast<std::atomic<int>*>(handle)->fetch_add(1, std::memory_order_relaxed);
+        return CELIX_SUCCESS;
+    }
+}
+
+/**
+ * Starts range(0) components and waits until all components are started.
+ * Component i provides service "cmp<i>", requires service "cmp<i/2>" and has an optional dependency on "cmp<i-1>".
+ * The components are added in reverse order, so that most components are started by a cascade of service events.
+ * range(1) selects the component threading: 0 is on the calling/event thread, 1 is on the framework executor
+ * (CELIX_DM_COMPONENT_USE_EXECUTOR).
+ */
+static void BM_StartComponents(benchmark::State &state) {
+    int nrOfComponents = (int)state.range(0);
+    bool useExecutor = state.range(1) != 0;
+
+    celix_properties_t *config = celix_properties_create();
+    celix_properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    celix_properties_set(config, "org.osgi.framework.storage", ".cacheDmComponentBenchmark");
+    celix_properties_set(config, CELIX_DM_COMPONENT_USE_EXECUTOR, useExecutor ? "true" : "false");
+    celix_framework_t *fw = celix_frameworkFactory_createFramework(config);
+    celix_bundle_context_t *ctx = celix_framework_getFrameworkContext(fw);
+    celix_dependency_manager_t *mng = celix_bundleContext_getDependencyManager(ctx);
+
+    std::vector<std::string> names{};
+    for (int i = 0; i < nrOfComponents; ++i) {
+        names.emplace_back(std::string{"cmp"} + std::to_string(i));
+    }
+    int dummySvc = 0;
+    std::atomic<int> nrOfStarted{0};
+
+    for (auto _ : state) {
+        nrOfStarted = 0;
+        for (int i = nrOfComponents - 1; i >= 0; --i) {
+            celix_dm_component_t *cmp = celix_dmComponent_create(ctx, names[i].c_str());
+            celix_dmComponent_setImplementation(cmp, &nrOfStarted);
+            celix_dmComponent_setCallbacks(cmp, nullptr, countStart, nullptr, nullptr);
+            celix_dmComponent_addInterface(cmp, names[i].c_str(), nullptr, &dummySvc, nullptr);
+            if (i > 0) {
+                celix_dm_service_dependency_t *required = celix_dmServiceDependency_create();
+                celix_dmServiceDependency_setService(required, names[i / 2].c_str(), nullptr, nullptr);
+                celix_dmServiceDependency_setRequired(required, true);
+                celix_dmComponent_addServiceDependency(cmp, required);
+
+                celix_dm_service_dependency_t *optional = celix_dmServiceDependency_create();
+                celix_dmServiceDependency_setService(optional, names[i - 1].c_str(), nullptr, nullptr);
+                celix_dmComponent_addServiceDependency(cmp, optional);
+            }
+            celix_dependencyManager_add(mng, cmp);
+        }
+        while (nrOfStarted.load() < nrOfComponents) {
+            std::this_thread::yield();
+        }
+
+        state.PauseTiming();
+        celix_dependencyManager_removeAllComponents(mng);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfComponents);
+
+    celix_frameworkFactory_destroyFramework(fw);
+}
+BENCHMARK(BM_StartComponents)->Args({1000, 0})->Args({1000, 1})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * Registers the range(0) services required by a single component, i.e. a burst of service events for the component,
+ * and waits until the component is started.
+ */
+static void BM_RequiredDependencyBurst(benchmark::State &state) {
+    int nrOfDependencies = (int)state.range(0);
+
+    celix_properties_t *config = celix_properties_create();
+    celix_properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    celix_properties_set(config, "org.osgi.framework.storage", ".cacheDmComponentBenchmark");
+    celix_framework_t *fw = celix_frameworkFactory_createFramework(config);
+    celix_bundle_context_t *ctx = celix_framework_getFrameworkContext(fw);
+    celix_dependency_manager_t *mng = celix_bundleContext_getDependencyManager(ctx);
+
+    std::vector<std::string> names{};
+    for (int i = 0; i < nrOfDependencies; ++i) {
+        names.emplace_back(std::string{"svc"} + std::to_string(i));
+    }
+    int dummySvc = 0;
+    std::atomic<int> nrOfStarted{0};
+    std::vector<long> svcIds{};
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        nrOfStarted = 0;
+        celix_dm_component_t *cmp = celix_dmComponent_create(ctx, "cmp");
+        celix_dmComponent_setImplementation(cmp, &nrOfStarted);
+        celix_dmComponent_setCallbacks(cmp, nullptr, countStart, nullptr, nullptr);
+        for (const auto &name : names) {
+            celix_dm_service_dependency_t *dep = celix_dmServiceDependency_create();
+            celix_dmServiceDependency_setService(dep, name.c_str(), nullptr, nullptr);
+            celix_dmServiceDependency_setRequired(dep, true);
+            celix_dmComponent_addServiceDependency(cmp, dep);
+        }
+        celix_dependencyManager_add(mng, cmp);
+        state.ResumeTiming();
+
+        for (const auto &name : names) {
+            svcIds.push_back(celix_bundleContext_registerService(ctx, &dummySvc, name.c_str(), nullptr));
+        }
+        while (nrOfStarted.load() < 1) {
+            std::this_thread::yield();
+        }
+
+        state.PauseTiming();
+        celix_dependencyManager_removeAllComponents(mng);
+        for (long svcId : svcIds) {
+            celix_bundleContext_unregisterService(ctx, svcId);
+        }
+        svcIds.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfDependencies);
+
+    celix_frameworkFactory_destroyFramework(fw);
+}
+BENCHMARK(BM_RequiredDependencyBurst)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond)->UseRealTime();
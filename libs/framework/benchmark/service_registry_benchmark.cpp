@@ -0,0 +1,184 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "celix_api.h"
+#include "celix_framework_factory.h"
+
+namespace {
+    constexpr int NR_OF_SERVICE_NAMES = 100;
+
+    /**
+     * Framework with nrOfServices registered services, spread over NR_OF_SERVICE_NAMES service names.
+     */
+    class RegistryFixture {
+    public:
+        explicit RegistryFixture(int nrOfServices) {
+            celix_properties_t *config = celix_properties_create();
+            celix_properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+            celix_properties_set(config, "org.osgi.framework.storage", ".cacheServiceRegistryBenchmark");
+            fw = celix_frameworkFactory_createFramework(config);
+            ctx = celix_framework_getFrameworkContext(fw);
+
+            svcIds.reserve(nrOfServices);
+            for (int i = 0; i < nrOfServices; ++i) {
+                celix_properties_t *props = celix_properties_create();
+                celix_properties_setLong(props, "index", i);
+                std::string name = "example" + std::to_string(i % NR_OF_SERVICE_NAMES);
+                svcIds.push_back(celix_bundleContext_registerService(ctx, &dummySvc, name.c_str(), props));
+            }
+        }
+
+        ~RegistryFixture() {
+            for (long svcId : svcIds) {
+                celix_bundleContext_unregisterService(ctx, svcId);
+            }
+            celix_frameworkFactory_destroyFramework(fw);
+        }
+
+        RegistryFixture(const RegistryFixture&) = delete;
+        RegistryFixture& operator=(const RegistryFixture&) = delete;
+
+        celix_framework_t *fw = nullptr;
+        celix_bundle_context_t *ctx = nullptr;
+        std::vector<long> svcIds{};
+    private:
+        int dummySvc = 0;
+    };
+}
+
+static void BM_FindServiceByName(benchmark::State &state) {
+    RegistryFixture fixture{(int)state.range(0)};
+    for (auto _ : state) {
+        long svcId = celix_bundleContext_findService(fixture.ctx, "example42");
+        benchmark::DoNotOptimize(svcId);
+    }
+}
+BENCHMARK(BM_FindServiceByName)->Arg(1000)->Arg(10000)->Arg(20000);
+
+static void BM_FindServiceById(benchmark::State &state) {
+    RegistryFixture fixture{(int)state.range(0)};
+    long lastId = fixture.svcIds.back();
+    std::string filter = "(service.id=" + std::to_string(lastId) + ")";
+    std::string name = "example" + std::to_string((fixture.svcIds.size() - 1) % NR_OF_SERVICE_NAMES);
+    celix_service_filter_options_t opts{};
+    opts.serviceName = name.c_str();
+    opts.filter = filter.c_str();
+    for (auto _ : state) {
+        long svcId = celix_bundleContext_findServiceWithOptions(fixture.ctx, &opts);
+        benchmark::DoNotOptimize(svcId);
+    }
+}
+BENCHMARK(BM_FindServiceById)->Arg(1000)->Arg(10000)->Arg(20000);
+
+static void BM_GetServiceReferencesFullScan(benchmark::State &state) {
+    //a filter without objectClass or service.id cannot use an index and matches all registrations
+    RegistryFixture fixture{(int)state.range(0)};
+    for (auto _ : state) {
+        array_list_pt refs = nullptr;
+        bundleContext_getServiceReferences(fixture.ctx, nullptr, "(index=42)", &refs);
+        for (int i = 0; i < celix_arrayList_size(refs); ++i) {
+            bundleContext_ungetServiceReference(fixture.ctx, (service_reference_pt)celix_arrayList_get(refs, i));
+        }
+        celix_arrayList_destroy(refs);
+    }
+}
+BENCHMARK(BM_GetServiceReferencesFullScan)->Arg(1000)->Arg(10000)->Arg(20000);
+
+static void BM_UseServiceWithId(benchmark::State &state) {
+    RegistryFixture fixture{(int)state.range(0)};
+    long svcId = fixture.svcIds.back();
+    std::string name = "example" + std::to_string((fixture.svcIds.size() - 1) % NR_OF_SERVICE_NAMES);
+    int count = 0;
+    for (auto _ : state) {
+        celix_bundleContext_useServiceWithId(fixture.ctx, svcId, name.c_str(), &count, [](void *handle, void *) {
+            auto *c = static_cast<int*>(handle);
+            *c += 1;
+        });
+    }
+    benchmark::DoNotOptimize(count);
+}
+BENCHMARK(BM_UseServiceWithId)->Arg(1)->Arg(1000)->Arg(10000);
+
+static RegistryFixture *sharedFixture = nullptr;
+
+static void BM_FindServiceByNameThreads(benchmark::State &state) {
+    //lookups by service name from multiple threads on a single framework, to measure the read path scalability
+    if (state.thread_index() == 0) {
+        sharedFixture = new RegistryFixture{10000};
+    }
+    for (auto _ : state) {
+        long svcId = celix_bundleContext_findService(sharedFixture->ctx, "example42");
+        benchmark::DoNotOptimize(svcId);
+    }
+    if (state.thread_index() == 0) {
+        delete sharedFixture;
+        sharedFixture = nullptr;
+    }
+}
+BENCHMARK(BM_FindServiceByNameThreads)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->Threads(16)->Threads(32)->UseRealTime();
+
+static void BM_RegisterUnregisterStormWithTracker(benchmark::State &state) {
+    //registers and unregisters state.range(0) services with the same name while a tracker tracks that name
+    RegistryFixture fixture{1000};
+    long trkId = celix_bundleContext_trackServices(fixture.ctx, "storm", nullptr, nullptr, nullptr);
+    int dummySvc = 0;
+    std::vector<long> svcIds{};
+    svcIds.reserve(state.range(0));
+    for (auto _ : state) {
+        for (int i = 0; i < state.range(0); ++i) {
+            svcIds.push_back(celix_bundleContext_registerService(fixture.ctx, &dummySvc, "storm", nullptr));
+        }
+        for (long svcId : svcIds) {
+            celix_bundleContext_unregisterService(fixture.ctx, svcId);
+        }
+        svcIds.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    celix_bundleContext_stopTracker(fixture.ctx, trkId);
+}
+BENCHMARK(BM_RegisterUnregisterStormWithTracker)->Arg(100)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+static void BM_RegisterUnregisterManyServiceNames(benchmark::State &state) {
+    //registers and unregisters state.range(0) services, each with a distinct service name
+    RegistryFixture fixture{0};
+    int dummySvc = 0;
+    std::vector<std::string> names{};
+    names.reserve(state.range(0));
+    for (int i = 0; i < state.range(0); ++i) {
+        names.push_back("distinct" + std::to_string(i));
+    }
+    std::vector<long> svcIds{};
+    svcIds.reserve(state.range(0));
+    for (auto _ : state) {
+        for (const auto& name : names) {
+            svcIds.push_back(celix_bundleContext_registerService(fixture.ctx, &dummySvc, name.c_str(), nullptr));
+        }
+        for (long svcId : svcIds) {
+            celix_bundleContext_unregisterService(fixture.ctx, svcId);
+        }
+        svcIds.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RegisterUnregisterManyServiceNames)->Arg(1000)->Arg(8000)->Arg(16000)->Unit(benchmark::kMillisecond);
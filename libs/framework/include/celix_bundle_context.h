@@ -145,11 +145,27 @@ typedef struct celix_service_registration_options {
 * Register a service to the Celix framework using the provided service registration options.
 *
 * @param ctx The bundle context
-* @param opts The pointer to the registration options. The options are only in the during registration call.
+* @param opts The pointer to the registration options. The options are only used during the registration call.
 * @return The serviceId (>= 0) or < 0 if the registration was unsuccessful.
 */
 long celix_bundleContext_registerServiceWithOptions(celix_bundle_context_t *ctx, const celix_service_registration_options_t *opts);
 
+/**
+* Register multiple services to the Celix framework as one batch.
+*
+* The services are added to the service registry with a single registry lock and the resulting service events
+* are dispatched as one batch, so that a service listener (tracker) handles all its matching services in a single
+* update pass (e.g. the set callback of a service tracker is called once for the batch).
+*
+* @param ctx The bundle context
+* @param opts Array of nrOfServices registration options. The options are only used during the registration call.
+* @param nrOfServices The number of services to register.
+* @param svcIds Output array of nrOfServices service ids. Set to the serviceId (>= 0) of the registered service
+*               or < 0 if the registration was unsuccessful.
+* @return The number of successfully registered services.
+*/
+size_t celix_bundleContext_registerServicesWithOptions(celix_bundle_context_t *ctx, const celix_service_registration_options_t *opts, size_t nrOfServices, long *svcIds);
+
 
 /**
  * Unregister the service or service factory with service id.
@@ -162,6 +178,18 @@ long celix_bundleContext_registerServiceWithOptions(celix_bundle_context_t *ctx,
  */
 void celix_bundleContext_unregisterService(celix_bundle_context_t *ctx, long serviceId);
 
+/**
+ * Unregister multiple services or service factories as one batch.
+ * The services are removed with a single registry lock and the resulting service events are dispatched as one batch.
+ *
+ * Will log an error for unknown service ids. Will silently ignore services ids < 0.
+ *
+ * @param ctx The bundle context
+ * @param serviceIds Array of nrOfServices service ids
+ * @param nrOfServices The number of service ids
+ */
+void celix_bundleContext_unregisterServices(celix_bundle_context_t *ctx, const long *serviceIds, size_t nrOfServices);
+
 
 
 
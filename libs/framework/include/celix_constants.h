@@ -79,6 +79,44 @@ static const char *const CELIX_BUNDLES_PATH_DEFAULT = "bundles";
 
 static const char *const CELIX_LOAD_BUNDLES_WITH_NODELETE = "CELIX_LOAD_BUNDLES_WITH_NODELETE";
 
+/**
+ * If set to true, service events are queued and delivered in batches by a dedicated service event thread, instead
+ * of on the thread (un)registering the service. Registering a service will then not wait for the service listeners.
+ * Unregistering a service still waits until the UNREGISTERING event is handled. A queued REGISTERED or MODIFIED
+ * event of a service which is already unregistering is not delivered.
+ * Default is false.
+ */
+static const char *const CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS = "CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS";
+
+/**
+ * The max nr of worker threads of the executor service (celix_executor_service_t) provided by the framework.
+ * The worker threads are started on demand, when there are more queued tasks than idle workers.
+ * Default is 0, i.e. at most a worker thread per available core.
+ */
+static const char *const CELIX_FRAMEWORK_EXECUTOR_NR_OF_THREADS = "CELIX_FRAMEWORK_EXECUTOR_NR_OF_THREADS";
+
+/**
+ * The resolution (tick) of the timer service (celix_timer_service_t) provided by the framework. A coarser resolution
+ * lowers the precision of the timers and the nr of wakeups of the timer thread.
+ * Default is 0.001 (1 ms).
+ */
+static const char *const CELIX_FRAMEWORK_TIMER_RESOLUTION_IN_SECONDS = "CELIX_FRAMEWORK_TIMER_RESOLUTION_IN_SECONDS";
+
+/**
+ * If set to true, the framework keeps statistics (counts and durations) of the service registry lookups, filter
+ * evaluations, service listener calls and service tracker callbacks per bundle and per service name.
+ * The statistics are provided with the celix_registry_statistics_service_t.
+ * Default is false.
+ */
+static const char *const CELIX_FRAMEWORK_REGISTRY_STATISTICS = "CELIX_FRAMEWORK_REGISTRY_STATISTICS";
+
+/**
+ * If true, the dependency manager components handle their events and state changes as serialized tasks (a strand per
+ * component) on the framework executor, instead of on the thread which triggered the event.
+ * Default is false.
+ */
+static const char *const CELIX_DM_COMPONENT_USE_EXECUTOR = "CELIX_DM_COMPONENT_USE_EXECUTOR";
+
 #define CELIX_AUTO_START_0 "CELIX_AUTO_START_0"
 #define CELIX_AUTO_START_1 "CELIX_AUTO_START_1"
 #define CELIX_AUTO_START_2 "CELIX_AUTO_START_2"
@@ -86,6 +124,14 @@ static const char *const CELIX_LOAD_BUNDLES_WITH_NODELETE = "CELIX_LOAD_BUNDLES_
 #define CELIX_AUTO_START_4 "CELIX_AUTO_START_4"
 #define CELIX_AUTO_START_5 "CELIX_AUTO_START_5"
 
+/**
+ * Number of threads used to extract the bundle archives and load the bundle libraries of the CELIX_AUTO_START_N
+ * bundles. The bundles of a run level are still installed, resolved and started in the configured order.
+ * Use 0 for a thread per available core.
+ * Default is 1, i.e. the bundles are installed and started sequentially.
+ */
+#define CELIX_AUTO_START_NR_OF_THREADS "CELIX_AUTO_START_NR_OF_THREADS"
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,130 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_EXECUTOR_SERVICE_H_
+#define CELIX_EXECUTOR_SERVICE_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "celix_errno.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The executor service is registered by the framework (bundle id 0) and provides a shared, bounded pool of worker
+ * threads, so that bundles do not need to create their own (mostly idle) threads.
+ *
+ * The max nr of worker threads can be configured with the CELIX_FRAMEWORK_EXECUTOR_NR_OF_THREADS framework property.
+ * The worker threads are started on demand, so an unused executor service does not cost any threads.
+ *
+ * Tasks are submitted to a named queue. The queue name is used for the priority of the tasks and for the metrics.
+ * Tasks of the same queue can run concurrently and there is no ordering guarantee between tasks.
+ *
+ * Note that a bundle is responsible for cancelling its scheduled tasks and for ensuring that its submitted tasks
+ * are done before the bundle is stopped.
+ */
+#define CELIX_EXECUTOR_SERVICE_NAME "celix_executor_service"
+#define CELIX_EXECUTOR_SERVICE_VERSION "1.0.0"
+
+/**
+ * The queue used if no queue name is provided.
+ */
+#define CELIX_EXECUTOR_DEFAULT_QUEUE_NAME "default"
+
+typedef enum celix_executor_priority {
+    CELIX_EXECUTOR_PRIORITY_LOW = 0,
+    CELIX_EXECUTOR_PRIORITY_NORMAL = 1,
+    CELIX_EXECUTOR_PRIORITY_HIGH = 2
+} celix_executor_priority_e;
+
+typedef struct celix_executor_queue_metrics {
+    const char *queueName;
+    celix_executor_priority_e priority;
+
+    /**
+     * The nr of tasks in the queue which are not yet started.
+     */
+    size_t queueDepth;
+
+    /**
+     * The nr of active delayed or periodic tasks for the queue.
+     */
+    size_t nrOfScheduledTasks;
+
+    size_t nrOfExecutedTasks;
+
+    /**
+     * The latency is the time between the submit (or the due time for a scheduled task) and the start of a task.
+     */
+    double averageLatencyInSeconds;
+    double maxLatencyInSeconds;
+
+    double averageExecutionTimeInSeconds;
+} celix_executor_queue_metrics_t;
+
+typedef struct celix_executor_service {
+    void *handle;
+
+    /**
+     * Submits a task to the provided queue. If queueName is NULL, the default queue is used.
+     * The task will be called on one of the executor worker threads.
+     *
+     * @return CELIX_SUCCESS, CELIX_ILLEGAL_STATE if the executor is stopped or CELIX_ENOMEM if the task could not be queued.
+     */
+    celix_status_t (*submit)(void *handle, const char *queueName, void *taskData, void (*task)(void *taskData));
+
+    /**
+     * Schedules a task to the provided queue, after initialDelayInSeconds and -if intervalInSeconds is > 0- repeated
+     * every intervalInSeconds. A periodic task is not submitted again while the previous run is still queued
+     * or running.
+     *
+     * @return The scheduled task id (>= 0) or -1 if the executor is stopped.
+     */
+    long (*schedule)(void *handle, const char *queueName, double initialDelayInSeconds, double intervalInSeconds, void *taskData, void (*task)(void *taskData));
+
+    /**
+     * Cancels a scheduled task. A already submitted run of the task is not cancelled, but -if not called from an
+     * executor worker thread- the call waits until that run is done. A task can cancel itself, in that case the
+     * call does not wait.
+     *
+     * @return True if the scheduled task was found and cancelled.
+     */
+    bool (*cancelScheduledTask)(void *handle, long scheduledTaskId);
+
+    /**
+     * Sets the priority of a queue, the default priority is CELIX_EXECUTOR_PRIORITY_NORMAL.
+     * Worker threads first execute the tasks of higher priority queues.
+     */
+    celix_status_t (*setQueuePriority)(void *handle, const char *queueName, celix_executor_priority_e priority);
+
+    /**
+     * Calls the provided callback for the metrics of every queue.
+     * The metrics are only valid during the callback.
+     */
+    void (*useQueueMetrics)(void *handle, void *callbackHandle, void (*use)(void *callbackHandle, const celix_executor_queue_metrics_t *metrics));
+} celix_executor_service_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CELIX_EXECUTOR_SERVICE_H_ */
@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_REGISTRY_STATISTICS_SERVICE_H_
+#define CELIX_REGISTRY_STATISTICS_SERVICE_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The registry statistics service is registered by the framework (bundle id 0) if the
+ * CELIX_FRAMEWORK_REGISTRY_STATISTICS framework property is set to true.
+ *
+ * The statistics are kept per (calling) bundle and per service name and can be used to find out which bundle
+ * or service is causing most of the service registry load.
+ */
+#define CELIX_REGISTRY_STATISTICS_SERVICE_NAME "celix_registry_statistics_service"
+#define CELIX_REGISTRY_STATISTICS_SERVICE_VERSION "1.0.0"
+
+/**
+ * Nr of buckets of the duration histograms.
+ * Bucket 0 counts the calls which took less than 1 microsecond, bucket N (N > 0) the calls which took
+ * [2^(N-1), 2^N) microseconds. The last bucket also counts all longer calls.
+ */
+#define CELIX_REGISTRY_STATISTICS_NR_OF_BUCKETS 16
+
+typedef enum celix_registry_statistics_type {
+    CELIX_REGISTRY_STATISTICS_LOOKUP = 0,           //service reference lookups in the service registry
+    CELIX_REGISTRY_STATISTICS_FILTER_MATCH = 1,     //filter evaluations for lookups and service listeners
+    CELIX_REGISTRY_STATISTICS_LISTENER_CALL = 2,    //service listener invocations for service events
+    CELIX_REGISTRY_STATISTICS_TRACKER_CALLBACK = 3, //service tracker set, add, remove and modified callbacks
+    CELIX_REGISTRY_STATISTICS_NR_OF_TYPES = 4
+} celix_registry_statistics_type_e;
+
+typedef struct celix_registry_call_statistics {
+    size_t count;
+    double totalTimeInSeconds;
+    double maxTimeInSeconds;
+    size_t histogram[CELIX_REGISTRY_STATISTICS_NR_OF_BUCKETS];
+} celix_registry_call_statistics_t;
+
+typedef struct celix_registry_statistics_entry {
+    /**
+     * The bundle id of the calling bundle, -1 for service name statistics.
+     * For listener calls and tracker callbacks this is the bundle of the listener/tracker.
+     */
+    long bundleId;
+
+    /**
+     * The service name, NULL for bundle statistics.
+     */
+    const char *serviceName;
+
+    celix_registry_call_statistics_t calls[CELIX_REGISTRY_STATISTICS_NR_OF_TYPES];
+} celix_registry_statistics_entry_t;
+
+typedef struct celix_registry_statistics_service {
+    void *handle;
+
+    /**
+     * Calls the provided callback for the statistics of every bundle which used the service registry.
+     * The entry is only valid during the callback.
+     */
+    void (*useBundleStatistics)(void *handle, void *callbackHandle, void (*use)(void *callbackHandle, const celix_registry_statistics_entry_t *entry));
+
+    /**
+     * Calls the provided callback for the statistics of every service name which was looked up or for which
+     * service events were delivered.
+     * The entry is only valid during the callback.
+     */
+    void (*useServiceNameStatistics)(void *handle, void *callbackHandle, void (*use)(void *callbackHandle, const celix_registry_statistics_entry_t *entry));
+
+    /**
+     * Resets all statistics.
+     */
+    void (*reset)(void *handle);
+} celix_registry_statistics_service_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CELIX_REGISTRY_STATISTICS_SERVICE_H_ */
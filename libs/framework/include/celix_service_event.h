@@ -17,6 +17,8 @@
  * under the License.
  */
 
+#include <stdbool.h>
+
 #include "celix_types.h"
 
 #ifndef CELIX_SERVICE_EVENT_H_
@@ -36,6 +38,7 @@ typedef enum celix_service_event_type {
 typedef struct celix_service_event {
 	service_reference_pt reference;
 	celix_service_event_type_t type;
+	bool moreEventsInBatch; //true if more events of the same (un)registration batch follow for the listener
 } celix_service_event_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_TIMER_SERVICE_H_
+#define CELIX_TIMER_SERVICE_H_
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The timer service is registered by the framework (bundle id 0) and provides one-shot and periodic timers, handled
+ * by a single timer thread of the framework. Bundles can use the timer service for timeouts and periodic work (e.g.
+ * polling or refreshing a TTL) instead of a dedicated thread which mostly sleeps.
+ *
+ * The timers are kept in a hierarchical timing wheel. The precision of the timers -and so the nr of wakeups of the
+ * timer thread- is controlled with the CELIX_FRAMEWORK_TIMER_RESOLUTION_IN_SECONDS framework property. A timer is
+ * never called before its due time.
+ *
+ * The timer callbacks are called on the timer thread and should be short; longer work should be submitted to the
+ * executor service (celix_executor_service_t).
+ *
+ * Note that a bundle is responsible for cancelling its timers before the bundle is stopped.
+ */
+#define CELIX_TIMER_SERVICE_NAME "celix_timer_service"
+#define CELIX_TIMER_SERVICE_VERSION "1.0.0"
+
+typedef struct celix_timer_service {
+    void *handle;
+
+    /**
+     * Schedules a timer, which calls the callback after initialDelayInSeconds and -if intervalInSeconds is > 0-
+     * repeatedly every intervalInSeconds (fixed rate). Runs missed because the timer thread was busy are skipped.
+     *
+     * @return The timer id (>= 0) or -1 if the timer is stopped.
+     */
+    long (*scheduleTimer)(void *handle, double initialDelayInSeconds, double intervalInSeconds, void *callbackData, void (*callback)(void *callbackData));
+
+    /**
+     * Cancels a timer. After this call the timer callback will not be called anymore and -unless cancelTimer is
+     * called from the timer callback itself- a running callback of the timer is finished.
+     *
+     * @return True if the timer was found and cancelled, false if the timer id is unknown or a one-shot timer
+     * already fired.
+     */
+    bool (*cancelTimer)(void *handle, long timerId);
+} celix_timer_service_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CELIX_TIMER_SERVICE_H_ */
@@ -43,6 +43,18 @@ extern "C" {
 #endif
 
 typedef void (*serviceChanged_function_pt)(celix_framework_t*, celix_service_event_type_t, service_registration_pt, celix_properties_t*);
+typedef void (*celix_serviceRegistry_serviceChangedBatch_fp)(celix_framework_t*, celix_service_event_type_t, celix_array_list_t *registrations);
+
+/**
+ * Entry for a batch registration with celix_serviceRegistry_registerServices.
+ */
+typedef struct celix_service_registry_batch_entry {
+    const char *serviceName;
+    const void *svc; //used if factory is NULL
+    celix_service_factory_t *factory;
+    celix_properties_t *properties; //ownership is transferred to the service registration
+    service_registration_t *registration; //output
+} celix_service_registry_batch_entry_t;
 
 celix_status_t serviceRegistry_create(celix_framework_t *framework, serviceChanged_function_pt serviceChanged,
                                       service_registry_pt *registry);
@@ -110,6 +122,27 @@ celix_serviceRegistry_registerServiceFactory(
         celix_properties_t* props,
         service_registration_t **registration);
 
+/**
+ * Registers the services of the provided entries using a single registry write lock.
+ * The REGISTERED service events are dispatched as one batch after all services are registered.
+ */
+celix_status_t
+celix_serviceRegistry_registerServices(
+        celix_service_registry_t *registry,
+        const celix_bundle_t *bnd,
+        celix_service_registry_batch_entry_t *entries,
+        size_t nrOfEntries);
+
+/**
+ * Unregisters the provided service registrations (list of service_registration_t*) using a single registry write
+ * lock. The UNREGISTERING service events are dispatched as one batch.
+ */
+celix_status_t
+celix_serviceRegistry_unregisterServices(
+        celix_service_registry_t *registry,
+        const celix_bundle_t *bnd,
+        celix_array_list_t *registrations);
+
 #ifdef __cplusplus
 }
 #endif
@@ -112,7 +112,6 @@ void celix_serviceTracker_destroy(celix_service_tracker_t *tracker);
  * No match -> no call to use.
  *
  * If waitForSvcTimeoutInSec is > 0. The call will block until a service is found or the timeout is expired.
- * (with a precision of roughly 1 microsecond)
  *
  * @return bool     if the service if found and use has been called.
  */
@@ -126,6 +125,14 @@ bool celix_serviceTracker_useHighestRankingService(
         void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner)
 );
 
+/**
+ * Waits until the service tracker tracks at least one service or the timeout is expired.
+ * The waiting thread is woken up as soon as a service is added to the tracker (i.e. no polling).
+ *
+ * @return bool     true if the tracker tracks at least one service.
+ */
+bool celix_serviceTracker_waitForService(celix_service_tracker_t *tracker, double waitTimeoutInSeconds);
+
 
 /**
  * Calls the use callback for every services found by this tracker.
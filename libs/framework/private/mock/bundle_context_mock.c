@@ -370,4 +370,11 @@ bool celix_bundleContext_getPropertyAsBool(celix_bundle_context_t *ctx, const ch
 			->withStringParameters("key", key)
 			->withBoolParameters("defaultValue", defaultValue);
 	return mock_c()->returnValue().value.boolValue;
-}
\ No newline at end of file
+}
+long celix_bundleContext_getPropertyAsLong(celix_bundle_context_t *ctx, const char *key, long defaultValue) {
+	mock_c()->actualCall("celix_bundleContext_getPropertyAsLong")
+			->withPointerParameters("ctx", ctx)
+			->withStringParameters("key", key)
+			->withLongIntParameters("defaultValue", defaultValue);
+	return mock_c()->returnValue().value.longIntValue;
+}
@@ -53,3 +53,10 @@ celix_status_t filter_getString(filter_pt filter, const char **filterStr) {
 			->withOutputParameter("filterStr", filterStr);
 	return mock_c()->returnValue().value.intValue;
 }
+
+const char* celix_filter_findMandatoryEqualityValue(const celix_filter_t *filter, const char *attribute) {
+	mock_c()->actualCall("celix_filter_findMandatoryEqualityValue")
+			->withConstPointerParameters("filter", filter)
+			->withStringParameters("attribute", attribute);
+	return mock_c()->returnValue().value.stringValue;
+}
@@ -59,6 +59,28 @@ bool serviceRegistration_isValid(service_registration_pt registration) {
 	return mock_c()->returnValue().value.intValue;
 }
 
+bool celix_serviceRegistration_markUnregistering(service_registration_pt registration) {
+	mock_c()->actualCall("celix_serviceRegistration_markUnregistering")
+			->withPointerParameters("registration", registration);
+	return mock_c()->returnValue().value.intValue;
+}
+
+bool celix_serviceRegistration_tryUse(service_registration_pt registration) {
+	mock_c()->actualCall("celix_serviceRegistration_tryUse")
+			->withPointerParameters("registration", registration);
+	return mock_c()->returnValue().value.intValue;
+}
+
+void celix_serviceRegistration_releaseUse(service_registration_pt registration) {
+	mock_c()->actualCall("celix_serviceRegistration_releaseUse")
+			->withPointerParameters("registration", registration);
+}
+
+void celix_serviceRegistration_waitForUses(service_registration_pt registration) {
+	mock_c()->actualCall("celix_serviceRegistration_waitForUses")
+			->withPointerParameters("registration", registration);
+}
+
 void serviceRegistration_invalidate(service_registration_pt registration) {
 	mock_c()->actualCall("serviceRegistration_invalidate")
 			->withPointerParameters("registration", registration);
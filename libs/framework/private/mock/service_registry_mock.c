@@ -27,6 +27,7 @@
 #include "CppUTestExt/MockSupport_c.h"
 
 #include "service_registry.h"
+#include "celix_registry_statistics.h"
 
 celix_status_t serviceRegistry_create(framework_pt framework, serviceChanged_function_pt serviceChanged, service_registry_pt *registry) {
 	mock_c()->actualCall("serviceRegistry_create")
@@ -195,3 +196,32 @@ void serviceRegistry_callHooksForListenerFilter(
             ->withStringParameters("filter", filter)
             ->withBoolParameters("removed", removed);
 }
+
+void celix_serviceRegistry_setStatistics(service_registry_pt registry, celix_registry_statistics_t *statistics) {
+    mock_c()->actualCall("celix_serviceRegistry_setStatistics")
+            ->withPointerParameters("registry", registry)
+            ->withPointerParameters("statistics", statistics);
+}
+
+void celix_serviceRegistry_setServiceChangedBatchCallback(service_registry_pt registry, celix_serviceRegistry_serviceChangedBatch_fp serviceChangedBatch) {
+    mock_c()->actualCall("celix_serviceRegistry_setServiceChangedBatchCallback")
+            ->withPointerParameters("registry", registry)
+            ->withPointerParameters("serviceChangedBatch", (void*)serviceChangedBatch);
+}
+
+celix_status_t celix_serviceRegistry_registerServices(celix_service_registry_t *registry, const celix_bundle_t *bnd, celix_service_registry_batch_entry_t *entries, size_t nrOfEntries) {
+    mock_c()->actualCall("celix_serviceRegistry_registerServices")
+            ->withPointerParameters("registry", registry)
+            ->withConstPointerParameters("bnd", bnd)
+            ->withPointerParameters("entries", entries)
+            ->withIntParameters("nrOfEntries", (int)nrOfEntries);
+    return mock_c()->returnValue().value.intValue;
+}
+
+celix_status_t celix_serviceRegistry_unregisterServices(celix_service_registry_t *registry, const celix_bundle_t *bnd, celix_array_list_t *registrations) {
+    mock_c()->actualCall("celix_serviceRegistry_unregisterServices")
+            ->withPointerParameters("registry", registry)
+            ->withConstPointerParameters("bnd", bnd)
+            ->withPointerParameters("registrations", registrations);
+    return mock_c()->returnValue().value.intValue;
+}
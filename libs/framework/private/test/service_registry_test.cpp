@@ -208,6 +208,14 @@ TEST(service_registry, registerServiceNoProps) {
 			.withParameter("registration", reg)
 			.withParameter("oldprops", (void*)NULL);
 
+	mock().expectOneCall("serviceRegistration_getServiceId")
+			.withParameter("registration", reg)
+			.andReturnValue(2);
+	mock().expectOneCall("serviceRegistration_getServiceName")
+			.withParameter("registration", reg)
+			.withOutputParameterReturning("serviceName", &serviceName, sizeof(serviceName))
+			.andReturnValue(CELIX_SUCCESS);
+
 	service_registration_pt registration = NULL;
 	serviceRegistry_registerService(registry, bundle, serviceName, service, NULL, &registration);
 	POINTERS_EQUAL(reg, registration);
@@ -245,6 +253,14 @@ TEST(service_registry, registerServiceFactoryNoProps) {
 		.withParameter("registration", reg)
 		.withParameter("oldprops", (void*)NULL);
 
+	mock().expectOneCall("serviceRegistration_getServiceId")
+			.withParameter("registration", reg)
+			.andReturnValue(2);
+	mock().expectOneCall("serviceRegistration_getServiceName")
+			.withParameter("registration", reg)
+			.withOutputParameterReturning("serviceName", &serviceName, sizeof(serviceName))
+			.andReturnValue(CELIX_SUCCESS);
+
 	service_registration_pt registration = NULL;
 	serviceRegistry_registerServiceFactory(registry, bundle, serviceName, factory, NULL, &registration);
 	POINTERS_EQUAL(reg, registration);
@@ -283,9 +299,13 @@ TEST(service_registry, registerServiceListenerHook) {
 			.withParameter("registration", reg)
 			.withParameter("oldprops", (void*)NULL);
 
-    mock().expectOneCall("serviceRegistration_getServiceId")
+    mock().expectNCalls(2, "serviceRegistration_getServiceId")
             .withParameter("registration", reg)
             .andReturnValue(svcId);
+	mock().expectOneCall("serviceRegistration_getServiceName")
+			.withParameter("registration", reg)
+			.withOutputParameterReturning("serviceName", &serviceName, sizeof(serviceName))
+			.andReturnValue(CELIX_SUCCESS);
 
 	service_registration_pt registration = NULL;
 	serviceRegistry_registerService(registry, bundle, serviceName, service, NULL, &registration);
@@ -334,9 +354,15 @@ TEST(service_registry, unregisterService) {
 		.withParameter("key", (char *)OSGI_FRAMEWORK_OBJECTCLASS)
 		.andReturnValue((char*)OSGI_FRAMEWORK_LISTENER_HOOK_SERVICE_NAME);
 
-    mock().expectOneCall("serviceRegistration_getServiceId")
+    mock().expectNCalls(2, "serviceRegistration_getServiceId")
             .withParameter("registration", registration)
             .andReturnValue(svcId);
+	const char *serviceName = "test";
+	mock()
+		.expectOneCall("serviceRegistration_getServiceName")
+		.withParameter("registration", registration)
+		.withOutputParameterReturning("serviceName", &serviceName, sizeof(serviceName))
+		.andReturnValue(CELIX_SUCCESS);
 
 	mock()
 		.expectOneCall("serviceRegistryTest_serviceChanged")
@@ -349,6 +375,10 @@ TEST(service_registry, unregisterService) {
 		.expectOneCall("serviceReference_invalidate")
 		.withParameter("reference", reference);
 
+	mock()
+		.expectOneCall("celix_serviceRegistration_waitForUses")
+		.withParameter("registration", registration);
+
 		mock()
 		.expectOneCall("serviceRegistration_invalidate")
 		.withParameter("registration", registration);
@@ -488,17 +518,46 @@ TEST(service_registry, getServiceReferences) {
 	serviceRegistry_create(framework,serviceRegistryTest_serviceChanged, &registry);
 
 	bundle_pt bundle = (bundle_pt) 0x10;
+	char *serviceName = (char *) "test";
+	void *service = (void *) 0x20;
 	service_registration_pt registration = (service_registration_pt) calloc(1,sizeof(struct serviceRegistration));
-	registration->serviceId = 20UL;
+	registration->serviceId = 2UL;
 
-	array_list_pt registrations = NULL;
-	arrayList_create(&registrations);
-	arrayList_add(registrations, registration);
-	hashMap_put(registry->serviceRegistrations, bundle, registrations);
+	//register through the registry, so that the registration is added to the service name index and snapshot
+	mock()
+		.expectOneCall("serviceRegistration_create")
+		.withParameterOfType("registry_callback_t", "callback", &registry->callback)
+		.withParameter("bundle", bundle)
+		.withParameter("serviceName", serviceName)
+		.withParameter("serviceId", 2)
+		.withParameter("serviceObject", service)
+		.withParameter("dictionary", (void *) NULL)
+		.andReturnValue(registration);
+	mock().expectOneCall("serviceRegistryTest_serviceChanged")
+		.withParameter("framework", framework)
+		.withParameter("eventType", OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED)
+		.withParameter("registration", registration)
+		.withParameter("oldprops", (void*)NULL);
+	mock().expectOneCall("serviceRegistration_getServiceId")
+		.withParameter("registration", registration)
+		.andReturnValue(2);
+	mock().expectOneCall("serviceRegistration_getServiceName")
+		.withParameter("registration", registration)
+		.withOutputParameterReturning("serviceName", &serviceName, sizeof(serviceName))
+		.andReturnValue(CELIX_SUCCESS);
+	service_registration_pt registered = NULL;
+	serviceRegistry_registerService(registry, bundle, serviceName, service, NULL, &registered);
+	POINTERS_EQUAL(registration, registered);
 
 	properties_pt properties = (properties_pt) 0x30;
 	filter_pt filter = (filter_pt) 0x40;
 
+	mock()
+		.expectOneCall("celix_filter_findMandatoryEqualityValue")
+		.withParameter("filter", filter)
+		.withParameter("attribute", OSGI_FRAMEWORK_SERVICE_ID)
+		.andReturnValue((const char*)NULL);
+
 	hash_map_pt references = hashMap_create(NULL, NULL, NULL, NULL);
 	service_reference_pt reference = (service_reference_pt) 0x50;
 	hashMap_put(references, (void*)registration->serviceId, reference);
@@ -514,11 +573,10 @@ TEST(service_registry, getServiceReferences) {
 		.withOutputParameterReturning("properties", &properties, sizeof(properties))
 		.andReturnValue(CELIX_SUCCESS);
 	bool matchResult = true;
-	mock().expectNCalls(2, "filter_match")
+	mock().expectOneCall("filter_match")
 		.withParameter("filter", filter)
 		.withParameter("properties", properties)
 		.withOutputParameterReturning("result", &matchResult, sizeof(matchResult));
-	char *serviceName = (char *) "test";
 	mock()
 		.expectOneCall("serviceRegistration_getServiceName")
 		.withParameter("registration", registration)
@@ -545,8 +603,9 @@ TEST(service_registry, getServiceReferences) {
 
 	hashMap_destroy(references, false, false);
 	arrayList_destroy(actual);
+	//note the registry destroy cleans up the service name index and snapshot
+	array_list_pt registrations = (array_list_pt) hashMap_remove(registry->serviceRegistrations, bundle);
 	arrayList_destroy(registrations);
-	hashMap_remove(registry->serviceRegistrations, bundle);
 	free(registration);
 	serviceRegistry_destroy(registry);
 }
@@ -565,8 +624,6 @@ TEST(service_registry, getServiceReferences_noFilterOrName) {
 	arrayList_add(registrations, registration);
 	hashMap_put(registry->serviceRegistrations, bundle, registrations);
 
-	properties_pt properties = (properties_pt) 0x30;
-
 	hash_map_pt references = hashMap_create(NULL, NULL, NULL, NULL);
 	service_reference_pt reference = (service_reference_pt) 0x50;
 	hashMap_put(references, (void*)registration->serviceId, reference);
@@ -576,11 +633,6 @@ TEST(service_registry, getServiceReferences_noFilterOrName) {
 		.expectOneCall("serviceRegistration_retain")
 		.withParameter("registration", registration);
 
-	mock()
-		.expectOneCall("serviceRegistration_getProperties")
-		.withParameter("registration", registration)
-		.withOutputParameterReturning("properties", &properties, sizeof(properties))
-		.andReturnValue(CELIX_SUCCESS);
 	mock()
 		.expectOneCall("serviceRegistration_isValid")
 		.withParameter("registration", registration)
@@ -634,7 +686,7 @@ TEST(service_registry, retainServiceReference){
 
 	registry->checkDeletedReferences = true;
 	//test known reference, with owner == bundle
-	hashMap_put(registry->deletedServiceReferences, reference, (void*) false);
+	celix_ptrHashMap_put(registry->deletedServiceReferences, reference, (void*) false);
 	mock().expectOneCall("serviceReference_getOwner")
 			.withParameter("reference", reference)
 			.withOutputParameterReturning("owner", &bundle, sizeof(bundle));
@@ -644,7 +696,7 @@ TEST(service_registry, retainServiceReference){
 	serviceRegistry_retainServiceReference(registry, bundle, reference);
 
 	//cleanup
-	hashMap_remove(registry->deletedServiceReferences, reference);
+	celix_ptrHashMap_remove(registry->deletedServiceReferences, reference);
 	serviceRegistry_destroy(registry);
 }
 
@@ -679,7 +731,7 @@ TEST(service_registry, ungetServiceReference){
 	//test known reference, but destroyed == false
 	size_t count = 0;
 	bool destroyed = false;
-	hashMap_put(registry->deletedServiceReferences, reference, (void*) false);
+	celix_ptrHashMap_put(registry->deletedServiceReferences, reference, (void*) false);
 
 	mock().expectOneCall("serviceReference_getUsageCount")
 			.withParameter("reference", reference)
@@ -725,14 +777,14 @@ TEST(service_registry, ungetServiceReference){
 
 	serviceRegistry_ungetServiceReference(registry, bundle, reference);
 
-	CHECK((bool)hashMap_remove(registry->deletedServiceReferences, reference));
+	CHECK((bool)celix_ptrHashMap_remove(registry->deletedServiceReferences, reference));
 
 	//test known reference2, destroyed == true, and count == 0
 	references = hashMap_create(NULL, NULL, NULL, NULL);
 	hashMap_put(references, registration, reference);
 	hashMap_put(references, registration2, reference2);
 	hashMap_put(registry->serviceReferences, bundle, references);
-	hashMap_put(registry->deletedServiceReferences, reference2, (void*) false);
+	celix_ptrHashMap_put(registry->deletedServiceReferences, reference2, (void*) false);
 	destroyed = true;
 	count = 0;
 
@@ -745,7 +797,7 @@ TEST(service_registry, ungetServiceReference){
 
 	serviceRegistry_ungetServiceReference(registry, bundle, reference2);
 
-	CHECK((bool)hashMap_remove(registry->deletedServiceReferences, reference2));//check that ref2 deleted == true
+	CHECK((bool)celix_ptrHashMap_remove(registry->deletedServiceReferences, reference2));//check that ref2 deleted == true
 	POINTERS_EQUAL(reference, hashMap_remove(references, registration)); //check that ref1 is untouched
 
 	//cleanup
@@ -773,7 +825,7 @@ TEST(service_registry, clearReferencesFor_1){
 	size_t useCount = 0;
 	size_t refCount = 0;
 	bool destroyed = true;
-	hashMap_put(registry->deletedServiceReferences, reference, (void*) false);
+	celix_ptrHashMap_put(registry->deletedServiceReferences, reference, (void*) false);
 
 	//expected calls for removing reference1
 	mock().expectOneCall("serviceReference_getUsageCount")
@@ -874,7 +926,7 @@ TEST(service_registry, getService) {
 	celix_status_t status = serviceRegistry_getService(registry, bundle, reference, &actual);
 	LONGS_EQUAL(CELIX_BUNDLE_EXCEPTION, status);
 	//test reference with invalid registration
-	hashMap_put(registry->deletedServiceReferences, reference, (void*) false);
+	celix_ptrHashMap_put(registry->deletedServiceReferences, reference, (void*) false);
 
 	mock()
 		.expectOneCall("serviceReference_getServiceRegistration")
@@ -956,7 +1008,7 @@ TEST(service_registry, ungetService) {
 	array_list_pt usages = NULL;
 	arrayList_create(&usages);
 	hashMap_put(registry->serviceReferences, bundle, reference);
-	hashMap_put(registry->deletedServiceReferences, reference, (void*) false);
+	celix_ptrHashMap_put(registry->deletedServiceReferences, reference, (void*) false);
 	void * service = (void*) 0x50;
 
 	int count = 0;
@@ -987,8 +1039,8 @@ TEST(service_registry, ungetService) {
 	LONGS_EQUAL(CELIX_SUCCESS, status)
 	LONGS_EQUAL(true, result);
 
-	hashMap_remove(registry->deletedServiceReferences, reference);
-	hashMap_put(registry->deletedServiceReferences, reference, (void*) true);
+	celix_ptrHashMap_remove(registry->deletedServiceReferences, reference);
+	celix_ptrHashMap_put(registry->deletedServiceReferences, reference, (void*) true);
 
 	mock()
 		.expectOneCall("framework_log");
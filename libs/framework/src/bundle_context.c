@@ -29,6 +29,8 @@
 #include "celix_bundle.h"
 #include "celix_log.h"
 #include "service_tracker.h"
+#include "service_tracker_private.h"
+#include "service_registration_private.h"
 #include "celix_dependency_manager.h"
 #include "dm_dependency_manager_impl.h"
 #include "celix_array_list.h"
@@ -56,7 +58,7 @@ celix_status_t bundleContext_create(framework_pt framework, framework_logger_pt
 
             celixThreadMutex_create(&context->mutex, NULL);
 
-            arrayList_create(&context->svcRegistrations);
+            context->svcRegistrations = celix_longHashMap_create();
             context->bundleTrackers = hashMap_create(NULL,NULL,NULL,NULL);
             context->serviceTrackers = hashMap_create(NULL,NULL,NULL,NULL);
             context->serviceTrackerTrackers =  hashMap_create(NULL,NULL,NULL,NULL);
@@ -87,7 +89,7 @@ celix_status_t bundleContext_destroy(bundle_context_pt context) {
 	    //service registry (serviceRegistry_clearServiceRegistrations).
         celixThreadMutex_unlock(&context->mutex);
 	    celixThreadMutex_destroy(&context->mutex); 
-	    arrayList_destroy(context->svcRegistrations);
+	    celix_longHashMap_destroy(context->svcRegistrations);
 
 	    if (context->mng != NULL) {
 	        celix_dependencyManager_removeAllComponents(context->mng);
@@ -446,9 +448,7 @@ long celix_bundleContext_registerServiceFactory(celix_bundle_context_t *ctx, cel
     return celix_bundleContext_registerServiceWithOptions(ctx, &opts);
 }
 
-long celix_bundleContext_registerServiceWithOptions(bundle_context_t *ctx, const celix_service_registration_options_t *opts) {
-    long svcId = -1;
-    service_registration_t *reg = NULL;
+static celix_properties_t* bundleContext_createRegistrationProperties(const celix_service_registration_options_t *opts) {
     celix_properties_t *props = opts->properties;
     if (props == NULL) {
         props = celix_properties_create();
@@ -458,6 +458,13 @@ long celix_bundleContext_registerServiceWithOptions(bundle_context_t *ctx, const
     }
     const char *lang = opts->serviceLanguage != NULL && strncmp("", opts->serviceLanguage, 1) != 0 ? opts->serviceLanguage : CELIX_FRAMEWORK_SERVICE_C_LANGUAGE;
     celix_properties_set(props, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang);
+    return props;
+}
+
+long celix_bundleContext_registerServiceWithOptions(bundle_context_t *ctx, const celix_service_registration_options_t *opts) {
+    long svcId = -1;
+    service_registration_t *reg = NULL;
+    celix_properties_t *props = bundleContext_createRegistrationProperties(opts);
     if (opts->serviceName != NULL && strncmp("", opts->serviceName, 1) != 0) {
         if (opts->factory != NULL) {
             reg = celix_framework_registerServiceFactory(ctx->framework, ctx->bundle, opts->serviceName, opts->factory, props);
@@ -472,28 +479,73 @@ long celix_bundleContext_registerServiceWithOptions(bundle_context_t *ctx, const
         properties_destroy(props);
     } else {
         celixThreadMutex_lock(&ctx->mutex);
-        arrayList_add(ctx->svcRegistrations, reg);
+        celix_longHashMap_put(ctx->svcRegistrations, svcId, reg);
         celixThreadMutex_unlock(&ctx->mutex);
     }
     return svcId;
 }
 
+size_t celix_bundleContext_registerServicesWithOptions(bundle_context_t *ctx, const celix_service_registration_options_t *opts, size_t nrOfServices, long *svcIds) {
+    size_t count = 0;
+    if (ctx == NULL || nrOfServices == 0) {
+        return count;
+    }
+
+    celix_service_registry_batch_entry_t *entries = calloc(nrOfServices, sizeof(*entries));
+    for (size_t i = 0; i < nrOfServices; ++i) {
+        entries[i].serviceName = opts[i].serviceName != NULL && strncmp("", opts[i].serviceName, 1) != 0 ? opts[i].serviceName : NULL;
+        entries[i].svc = opts[i].svc;
+        entries[i].factory = opts[i].factory;
+        entries[i].properties = bundleContext_createRegistrationProperties(&opts[i]);
+    }
+    celix_framework_registerServices(ctx->framework, ctx->bundle, entries, nrOfServices);
+
+    celixThreadMutex_lock(&ctx->mutex);
+    for (size_t i = 0; i < nrOfServices; ++i) {
+        svcIds[i] = serviceRegistration_getServiceId(entries[i].registration); //safe to call with NULL
+        if (svcIds[i] < 0) {
+            properties_destroy(entries[i].properties);
+        } else {
+            celix_longHashMap_put(ctx->svcRegistrations, svcIds[i], entries[i].registration);
+            count += 1;
+        }
+    }
+    celixThreadMutex_unlock(&ctx->mutex);
+
+    free(entries);
+    return count;
+}
+
+void celix_bundleContext_unregisterServices(bundle_context_t *ctx, const long *serviceIds, size_t nrOfServices) {
+    if (ctx == NULL || nrOfServices == 0) {
+        return;
+    }
+    celix_array_list_t *registrations = celix_arrayList_create();
+    celixThreadMutex_lock(&ctx->mutex);
+    for (size_t i = 0; i < nrOfServices; ++i) {
+        if (serviceIds[i] < 0) {
+            continue;
+        }
+        service_registration_t *reg = celix_longHashMap_get(ctx->svcRegistrations, serviceIds[i]);
+        if (reg != NULL) {
+            celix_longHashMap_remove(ctx->svcRegistrations, serviceIds[i]);
+            celix_arrayList_add(registrations, reg);
+        } else {
+            framework_logIfError(logger, CELIX_ILLEGAL_ARGUMENT, NULL, "Provided service id (%li) is not used to registered using celix_bundleContext_registerCService/celix_registerServiceForLang", serviceIds[i]);
+        }
+    }
+    celixThreadMutex_unlock(&ctx->mutex);
+
+    celix_framework_unregisterServices(ctx->framework, ctx->bundle, registrations);
+    celix_arrayList_destroy(registrations);
+}
+
 void celix_bundleContext_unregisterService(bundle_context_t *ctx, long serviceId) {
     service_registration_t *found = NULL;
     if (ctx != NULL && serviceId >= 0) {
         celixThreadMutex_lock(&ctx->mutex);
-        unsigned int size = arrayList_size(ctx->svcRegistrations);
-        for (unsigned int i = 0; i < size; ++i) {
-            service_registration_t *reg = arrayList_get(ctx->svcRegistrations, i);
-            if (reg != NULL) {
-                long svcId = serviceRegistration_getServiceId(reg);
-                if (svcId == serviceId) {
-                    found = reg;
-                    arrayList_remove(ctx->svcRegistrations, i);
-                    break;
-                }
-            }
-        }
+        found = celix_longHashMap_get(ctx->svcRegistrations, serviceId);
+        celix_longHashMap_remove(ctx->svcRegistrations, serviceId);
         celixThreadMutex_unlock(&ctx->mutex);
 
         if (found != NULL) {
@@ -812,56 +864,126 @@ void celix_bundleContext_useServices(
 }
 
 
-bool celix_bundleContext_useServiceWithOptions(
+static bool bundleContext_useServiceReference(
         celix_bundle_context_t *ctx,
+        service_reference_pt ref,
         const celix_service_use_options_t *opts) {
     bool called = false;
-    celix_service_tracking_options_t trkOpts;
-    memset(&trkOpts, 0, sizeof(trkOpts));
-
-    if (opts != NULL) {
-        trkOpts.filter.serviceName = opts->filter.serviceName;
-        trkOpts.filter = opts->filter;
-        trkOpts.filter.versionRange = opts->filter.versionRange;
-        trkOpts.filter.serviceLanguage = opts->filter.serviceLanguage;
+    service_registration_t *reg = NULL;
+    serviceReference_getServiceRegistration(ref, &reg);
+    if (reg != NULL && celix_serviceRegistration_tryUse(reg)) {
+        void *svc = NULL;
+        bundleContext_getService(ctx, ref, &svc);
+        if (svc != NULL) {
+            celix_properties_t *props = NULL;
+            celix_bundle_t *owner = NULL;
+            serviceRegistration_getProperties(reg, &props);
+            serviceReference_getBundle(ref, &owner);
 
-        service_tracker_t *trk = celix_serviceTracker_createWithOptions(ctx, &trkOpts);
-        if (trk != NULL) {
             if (opts->use != NULL) {
-
+                opts->use(opts->callbackHandle, svc);
             }
             if (opts->useWithProperties != NULL) {
-
+                opts->useWithProperties(opts->callbackHandle, svc, props);
             }
             if (opts->useWithOwner != NULL) {
-
+                opts->useWithOwner(opts->callbackHandle, svc, props, owner);
             }
-            called = celix_serviceTracker_useHighestRankingService(trk, opts->filter.serviceName, opts->waitTimeoutInSeconds, opts->callbackHandle, opts->use, opts->useWithProperties, opts->useWithOwner);
-            celix_serviceTracker_destroy(trk);
+            called = true;
+
+            bool ungetResult = false;
+            bundleContext_ungetService(ctx, ref, &ungetResult);
         }
+        celix_serviceRegistration_releaseUse(reg);
     }
     return called;
 }
 
+/**
+ * Uses the services matching the filter options directly from the service registry.
+ * In contrast to a service tracker this does not register (and remove) a service listener, so this is a lot cheaper
+ * for single use calls. Every use is registered on the service registration and unregistration of the service waits
+ * until the use callbacks are done; services which are already unregistering are not used.
+ * Note that as a result a service cannot be unregistered from its own use callback.
+ * @return The number of used services
+ */
+static size_t bundleContext_useServicesWithoutTracker(
+        celix_bundle_context_t *ctx,
+        const celix_service_use_options_t *opts,
+        bool onlyHighestRanking) {
+    size_t count = 0;
+    array_list_t *refs = NULL;
+    char *filter = celix_serviceTracker_createFilterString(&opts->filter);
+    if (filter != NULL) {
+        bundleContext_getServiceReferences(ctx, NULL, filter, &refs);
+        free(filter);
+    } else {
+        framework_log(logger, OSGI_FRAMEWORK_LOG_ERROR, __FUNCTION__, __BASE_FILE__, __LINE__,
+                      "Error incorrect arguments. Missing service name.");
+    }
 
+    int size = refs == NULL ? 0 : celix_arrayList_size(refs);
+    service_reference_pt highest = NULL;
+    if (onlyHighestRanking) {
+        for (int i = 0; i < size; ++i) {
+            service_reference_pt ref = celix_arrayList_get(refs, i);
+            int compare = 1;
+            if (highest != NULL) {
+                serviceReference_compareTo(ref, highest, &compare);
+            }
+            if (compare > 0) {
+                highest = ref;
+            }
+        }
+    }
+    for (int i = 0; i < size; ++i) {
+        service_reference_pt ref = celix_arrayList_get(refs, i);
+        if (!onlyHighestRanking || ref == highest) {
+            if (bundleContext_useServiceReference(ctx, ref, opts)) {
+                count += 1;
+            }
+        }
+        bundleContext_ungetServiceReference(ctx, ref);
+    }
+    if (refs != NULL) {
+        celix_arrayList_destroy(refs);
+    }
+    return count;
+}
 
-void celix_bundleContext_useServicesWithOptions(
+bool celix_bundleContext_useServiceWithOptions(
         celix_bundle_context_t *ctx,
         const celix_service_use_options_t *opts) {
-    celix_service_tracking_options_t trkOpts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
+    bool called = false;
+    celix_service_tracking_options_t trkOpts;
+    memset(&trkOpts, 0, sizeof(trkOpts));
 
-    if (opts != NULL) {
+    if (opts != NULL && opts->waitTimeoutInSeconds <= 0) {
+        //no waiting needed, no need to create a service tracker
+        called = bundleContext_useServicesWithoutTracker(ctx, opts, true) > 0;
+    } else if (opts != NULL) {
         trkOpts.filter.serviceName = opts->filter.serviceName;
-        trkOpts.filter.filter = opts->filter.filter;
+        trkOpts.filter = opts->filter;
         trkOpts.filter.versionRange = opts->filter.versionRange;
         trkOpts.filter.serviceLanguage = opts->filter.serviceLanguage;
 
         service_tracker_t *trk = celix_serviceTracker_createWithOptions(ctx, &trkOpts);
         if (trk != NULL) {
-            celix_serviceTracker_useServices(trk, opts->filter.serviceName, opts->callbackHandle, opts->use, opts->useWithProperties, opts->useWithOwner);
+            called = celix_serviceTracker_useHighestRankingService(trk, opts->filter.serviceName, opts->waitTimeoutInSeconds, opts->callbackHandle, opts->use, opts->useWithProperties, opts->useWithOwner);
             celix_serviceTracker_destroy(trk);
         }
     }
+    return called;
+}
+
+
+
+void celix_bundleContext_useServicesWithOptions(
+        celix_bundle_context_t *ctx,
+        const celix_service_use_options_t *opts) {
+    if (opts != NULL) {
+        bundleContext_useServicesWithoutTracker(ctx, opts, false);
+    }
 }
 
 
@@ -25,6 +25,7 @@
 #include "bundle_listener.h"
 #include "celix_bundle_context.h"
 #include "listener_hook_service.h"
+#include "celix_hash_map.h"
 
 typedef struct celix_bundle_context_bundle_tracker_entry {
 	celix_bundle_context_t *ctx;
@@ -50,7 +51,7 @@ struct celix_bundle_context {
 	celix_bundle_t *bundle;
 
 	celix_thread_mutex_t mutex; //protects fields below
-	array_list_t *svcRegistrations;
+	celix_long_hash_map_t *svcRegistrations; //key = service id, value = service_registration_t*
 	celix_dependency_manager_t *mng;
 	long nextTrackerId;
 	hash_map_t *bundleTrackers; //key = trackerId, value = celix_bundle_context_bundle_tracker_entry_t*
@@ -31,6 +31,7 @@ struct celix_bundle {
 	struct celix_bundle_activator *activator;
 	bundle_state_e state;
 	void * handle;
+	bool librariesPreloaded; //true if the bundle libraries are loaded before the bundle is resolved (parallel auto start)
 	bundle_archive_pt archive;
 	array_list_pt modules;
 	manifest_pt manifest;
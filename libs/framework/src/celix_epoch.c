@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "celix_epoch.h"
+#include "celix_threads.h"
+
+#define CELIX_EPOCH_NR_OF_STRIPES 16
+#define CELIX_EPOCH_CACHE_LINE_SIZE 64
+
+typedef struct celix_epoch_stripe {
+    long readers[2]; //nr of active readers per epoch parity
+    char padding[CELIX_EPOCH_CACHE_LINE_SIZE - 2 * sizeof(long)];
+} celix_epoch_stripe_t;
+
+struct celix_epoch {
+    celix_epoch_stripe_t stripes[CELIX_EPOCH_NR_OF_STRIPES];
+    unsigned long current;
+    celix_thread_mutex_t mutex; //serializes celix_epoch_synchronize calls
+};
+
+celix_epoch_t* celix_epoch_create(void) {
+    celix_epoch_t *epoch = NULL;
+    if (posix_memalign((void**)&epoch, CELIX_EPOCH_CACHE_LINE_SIZE, sizeof(*epoch)) != 0) {
+        return NULL;
+    }
+    for (int i = 0; i < CELIX_EPOCH_NR_OF_STRIPES; ++i) {
+        epoch->stripes[i].readers[0] = 0;
+        epoch->stripes[i].readers[1] = 0;
+    }
+    epoch->current = 0;
+    celixThreadMutex_create(&epoch->mutex, NULL);
+    return epoch;
+}
+
+void celix_epoch_destroy(celix_epoch_t *epoch) {
+    if (epoch != NULL) {
+        celixThreadMutex_destroy(&epoch->mutex);
+        free(epoch);
+    }
+}
+
+static int celix_epoch_stripeIndex(void) {
+    //Fibonacci hash of the thread id, the low bits of a pthread_t are mostly the same
+    uint64_t id = (uint64_t)(uintptr_t)pthread_self();
+    return (int)((id * 0x9E3779B97F4A7C15ULL) >> 60) % CELIX_EPOCH_NR_OF_STRIPES;
+}
+
+int celix_epoch_enter(celix_epoch_t *epoch) {
+    int stripe = celix_epoch_stripeIndex();
+    while (true) {
+        unsigned long current = __atomic_load_n(&epoch->current, __ATOMIC_SEQ_CST);
+        int parity = (int)(current & 1UL);
+        __atomic_fetch_add(&epoch->stripes[stripe].readers[parity], 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&epoch->current, __ATOMIC_SEQ_CST) == current) {
+            return stripe * 2 + parity;
+        }
+        //epoch changed between the load and the registration, a synchronize could have missed this reader
+        __atomic_fetch_sub(&epoch->stripes[stripe].readers[parity], 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+void celix_epoch_exit(celix_epoch_t *epoch, int token) {
+    __atomic_fetch_sub(&epoch->stripes[token / 2].readers[token % 2], 1, __ATOMIC_RELEASE);
+}
+
+void celix_epoch_synchronize(celix_epoch_t *epoch) {
+    celixThreadMutex_lock(&epoch->mutex);
+    //new readers register on the other parity, so only the readers of the old parity have to be waited for.
+    //The previous synchronize already waited for the readers of the new parity.
+    unsigned long old = __atomic_fetch_add(&epoch->current, 1UL, __ATOMIC_SEQ_CST);
+    int parity = (int)(old & 1UL);
+    for (int i = 0; i < CELIX_EPOCH_NR_OF_STRIPES; ++i) {
+        while (__atomic_load_n(&epoch->stripes[i].readers[parity], __ATOMIC_ACQUIRE) != 0) {
+            sched_yield();
+        }
+    }
+    celixThreadMutex_unlock(&epoch->mutex);
+}
@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_CELIX_EPOCH_H
+#define CELIX_CELIX_EPOCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Epoch based reclamation for read-mostly data which is published with an atomic pointer store.
+ *
+ * Readers surround the use of the published data with celix_epoch_enter/celix_epoch_exit. A writer publishes new
+ * data and then calls celix_epoch_synchronize, after which no reader can use the old data anymore and the old
+ * data can be freed.
+ *
+ * The reader counters are striped over cache line sized slots, selected by the calling thread, so that readers on
+ * different threads mostly do not share a cache line. Readers never block, celix_epoch_synchronize waits until all
+ * readers which entered before the call have exited.
+ * Note that a reader must not call celix_epoch_synchronize or wait on a writer between enter and exit.
+ */
+typedef struct celix_epoch celix_epoch_t;
+
+celix_epoch_t* celix_epoch_create(void);
+
+void celix_epoch_destroy(celix_epoch_t *epoch);
+
+/**
+ * Enters a read section.
+ * @return The token to be used for celix_epoch_exit.
+ */
+int celix_epoch_enter(celix_epoch_t *epoch);
+
+void celix_epoch_exit(celix_epoch_t *epoch, int token);
+
+/**
+ * Waits until all read sections which were entered before this call have exited.
+ */
+void celix_epoch_synchronize(celix_epoch_t *epoch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_CELIX_EPOCH_H
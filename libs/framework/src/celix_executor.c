@@ -0,0 +1,589 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "celix_executor.h"
+#include "celix_threads.h"
+#include "celix_array_list.h"
+#include "celix_hash_map.h"
+#include "utils.h"
+
+#define CELIX_EXECUTOR_NR_OF_PRIORITIES 3
+#define CELIX_EXECUTOR_DEQUE_INITIAL_CAPACITY 16
+
+typedef struct celix_executor_queue {
+    char *name;
+    celix_thread_mutex_t mutex; //protects below
+    celix_executor_priority_e priority;
+    size_t depth;
+    size_t nrOfScheduledTasks;
+    size_t nrOfExecutedTasks;
+    double totalLatency;
+    double maxLatency;
+    double totalExecutionTime;
+} celix_executor_queue_t;
+
+typedef struct celix_executor_scheduled_task {
+    long id; //the timer id
+    celix_executor_t *executor;
+    celix_executor_queue_t *queue;
+    void *taskData;
+    void (*task)(void *taskData);
+    double interval;
+
+    //protected by the executor scheduler mutex
+    bool inFlight; //submitted and not yet done
+    int useCount; //nr of references, i.e. the scheduled task list and the in flight task
+} celix_executor_scheduled_task_t;
+
+typedef struct celix_executor_task {
+    void *taskData;
+    void (*task)(void *taskData);
+    celix_executor_queue_t *queue;
+    celix_executor_scheduled_task_t *scheduledTask; //NULL if not a scheduled task
+    struct timespec submitTime;
+} celix_executor_task_t;
+
+typedef struct celix_executor_deque {
+    celix_executor_task_t *tasks;
+    size_t capacity;
+    size_t head;
+    size_t size;
+} celix_executor_deque_t;
+
+typedef struct celix_executor_worker {
+    celix_executor_t *executor;
+    int index;
+    celix_thread_t thread;
+    celix_thread_mutex_t mutex; //protects the deques
+    celix_executor_deque_t deques[CELIX_EXECUTOR_NR_OF_PRIORITIES];
+} celix_executor_worker_t;
+
+struct celix_executor {
+    int nrOfWorkers; //the max nr of workers, the worker threads are started on demand
+    celix_executor_worker_t *workers;
+
+    celix_thread_mutex_t mutex; //protects below
+    celix_thread_cond_t cond;
+    bool active;
+    long nrOfQueuedTasks;
+    unsigned int nextWorker;
+    int nrOfStartedWorkers;
+    int nrOfIdleWorkers; //nr of workers waiting for a task
+
+    celix_thread_rwlock_t queuesLock; //protects queues
+    celix_string_hash_map_t *queues; //key = queue name, value = celix_executor_queue_t*
+
+    struct {
+        celix_timer_t *timer; //not owned, the timer calls the scheduled tasks when they are due
+        celix_thread_mutex_t mutex; //protects below
+        celix_thread_cond_t cond; //signalled when a scheduled task run is done
+        bool active;
+        celix_long_hash_map_t *tasks; //key = scheduled task id, value = celix_executor_scheduled_task_t*
+    } scheduler;
+};
+
+static celix_thread_once_t celix_executor_workerKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t celix_executor_workerKey; //value = the celix_executor_worker_t of the calling worker thread
+
+static void* celix_executor_runWorker(void *data);
+
+static void celix_executor_createWorkerKey(void) {
+    pthread_key_create(&celix_executor_workerKey, NULL);
+}
+
+static celix_status_t celix_executor_pushBack(celix_executor_deque_t *deque, const celix_executor_task_t *task) {
+    if (deque->size == deque->capacity) {
+        size_t newCapacity = deque->capacity == 0 ? CELIX_EXECUTOR_DEQUE_INITIAL_CAPACITY : deque->capacity * 2;
+        celix_executor_task_t *newTasks = malloc(newCapacity * sizeof(*newTasks));
+        if (newTasks == NULL) {
+            return CELIX_ENOMEM;
+        }
+        for (size_t i = 0; i < deque->size; ++i) {
+            newTasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+        }
+        free(deque->tasks);
+        deque->tasks = newTasks;
+        deque->capacity = newCapacity;
+        deque->head = 0;
+    }
+    deque->tasks[(deque->head + deque->size) % deque->capacity] = *task;
+    deque->size += 1;
+    return CELIX_SUCCESS;
+}
+
+static bool celix_executor_popFront(celix_executor_deque_t *deque, celix_executor_task_t *out) {
+    if (deque->size == 0) {
+        return false;
+    }
+    *out = deque->tasks[deque->head];
+    deque->head = (deque->head + 1) % deque->capacity;
+    deque->size -= 1;
+    return true;
+}
+
+static bool celix_executor_popBack(celix_executor_deque_t *deque, celix_executor_task_t *out) {
+    if (deque->size == 0) {
+        return false;
+    }
+    deque->size -= 1;
+    *out = deque->tasks[(deque->head + deque->size) % deque->capacity];
+    return true;
+}
+
+static double celix_executor_elapsed(const struct timespec *begin, const struct timespec *end) {
+    return celix_difftime(begin, end);
+}
+
+celix_executor_t* celix_executor_create(int nrOfThreads, celix_timer_t *timer) {
+    celix_executor_t *executor = calloc(1, sizeof(*executor));
+    executor->nrOfWorkers = nrOfThreads < 1 ? 1 : nrOfThreads;
+    executor->active = true;
+    celixThreadMutex_create(&executor->mutex, NULL);
+    celixThreadCondition_init(&executor->cond, NULL);
+    celixThreadRwlock_create(&executor->queuesLock, NULL);
+    executor->queues = celix_stringHashMap_create();
+
+    executor->scheduler.timer = timer;
+    celixThreadMutex_create(&executor->scheduler.mutex, NULL);
+    celixThreadCondition_init(&executor->scheduler.cond, NULL);
+    executor->scheduler.active = true;
+    executor->scheduler.tasks = celix_longHashMap_create();
+
+    executor->workers = calloc(executor->nrOfWorkers, sizeof(*executor->workers));
+    for (int i = 0; i < executor->nrOfWorkers; ++i) {
+        celix_executor_worker_t *worker = &executor->workers[i];
+        worker->executor = executor;
+        worker->index = i;
+        celixThreadMutex_create(&worker->mutex, NULL);
+    }
+    celixThread_once(&celix_executor_workerKeyOnce, celix_executor_createWorkerKey);
+
+    return executor;
+}
+
+static void celix_executor_startWorker(celix_executor_t *executor) {
+    //precondition executor mutex locked
+    celix_executor_worker_t *worker = &executor->workers[executor->nrOfStartedWorkers++];
+    celixThread_create(&worker->thread, NULL, celix_executor_runWorker, worker);
+    celixThread_setName(&worker->thread, "CelixExecutor");
+}
+
+static void celix_executor_releaseScheduledTask(celix_executor_t *executor, celix_executor_scheduled_task_t *scheduledTask) {
+    //precondition scheduler mutex locked
+    (void)executor;
+    scheduledTask->useCount -= 1;
+    if (scheduledTask->useCount == 0) {
+        free(scheduledTask);
+    }
+}
+
+void celix_executor_destroy(celix_executor_t *executor) {
+    if (executor == NULL) {
+        return;
+    }
+
+    celix_array_list_t *scheduledTaskIds = celix_arrayList_create();
+    celixThreadMutex_lock(&executor->scheduler.mutex);
+    executor->scheduler.active = false;
+    celix_long_hash_map_iterator_t taskIter = celix_longHashMap_begin(executor->scheduler.tasks);
+    for (; !celix_longHashMapIterator_isEnd(&taskIter); celix_longHashMapIterator_next(&taskIter)) {
+        celix_arrayList_addLong(scheduledTaskIds, taskIter.key);
+    }
+    celixThreadMutex_unlock(&executor->scheduler.mutex);
+    for (int i = 0; i < celix_arrayList_size(scheduledTaskIds); ++i) {
+        celix_executor_cancelScheduledTask(executor, celix_arrayList_getLong(scheduledTaskIds, i));
+    }
+    celix_arrayList_destroy(scheduledTaskIds);
+
+    celixThreadMutex_lock(&executor->mutex);
+    executor->active = false;
+    int nrOfStartedWorkers = executor->nrOfStartedWorkers;
+    celixThreadCondition_broadcast(&executor->cond);
+    celixThreadMutex_unlock(&executor->mutex);
+    for (int i = 0; i < nrOfStartedWorkers; ++i) {
+        celixThread_join(executor->workers[i].thread, NULL);
+    }
+
+    //note the workers finished the queued tasks, release the deques
+    celixThreadMutex_lock(&executor->scheduler.mutex);
+    for (int i = 0; i < executor->nrOfWorkers; ++i) {
+        celix_executor_worker_t *worker = &executor->workers[i];
+        for (int p = 0; p < CELIX_EXECUTOR_NR_OF_PRIORITIES; ++p) {
+            celix_executor_task_t task;
+            while (celix_executor_popFront(&worker->deques[p], &task)) {
+                if (task.scheduledTask != NULL) {
+                    celix_executor_releaseScheduledTask(executor, task.scheduledTask);
+                }
+            }
+            free(worker->deques[p].tasks);
+        }
+        celixThreadMutex_destroy(&worker->mutex);
+    }
+    celixThreadMutex_unlock(&executor->scheduler.mutex);
+    celix_longHashMap_destroy(executor->scheduler.tasks);
+    free(executor->workers);
+
+    celix_string_hash_map_iterator_t iter = celix_stringHashMap_begin(executor->queues);
+    for (; !celix_stringHashMapIterator_isEnd(&iter); celix_stringHashMapIterator_next(&iter)) {
+        celix_executor_queue_t *queue = iter.value;
+        celixThreadMutex_destroy(&queue->mutex);
+        free(queue->name);
+        free(queue);
+    }
+    celix_stringHashMap_destroy(executor->queues);
+
+    celixThreadMutex_destroy(&executor->scheduler.mutex);
+    celixThreadCondition_destroy(&executor->scheduler.cond);
+    celixThreadRwlock_destroy(&executor->queuesLock);
+    celixThreadMutex_destroy(&executor->mutex);
+    celixThreadCondition_destroy(&executor->cond);
+    free(executor);
+}
+
+int celix_executor_getNrOfThreads(const celix_executor_t *executor) {
+    return executor->nrOfWorkers;
+}
+
+static celix_executor_queue_t* celix_executor_getOrCreateQueue(celix_executor_t *executor, const char *queueName) {
+    const char *name = queueName == NULL ? CELIX_EXECUTOR_DEFAULT_QUEUE_NAME : queueName;
+    celixThreadRwlock_readLock(&executor->queuesLock);
+    celix_executor_queue_t *queue = celix_stringHashMap_get(executor->queues, name);
+    celixThreadRwlock_unlock(&executor->queuesLock);
+
+    if (queue == NULL) {
+        celixThreadRwlock_writeLock(&executor->queuesLock);
+        queue = celix_stringHashMap_get(executor->queues, name);
+        if (queue == NULL) {
+            queue = calloc(1, sizeof(*queue));
+            queue->name = strdup(name);
+            queue->priority = CELIX_EXECUTOR_PRIORITY_NORMAL;
+            celixThreadMutex_create(&queue->mutex, NULL);
+            celix_stringHashMap_put(executor->queues, name, queue);
+        }
+        celixThreadRwlock_unlock(&executor->queuesLock);
+    }
+    return queue;
+}
+
+/**
+ * Returns the worker for the calling thread or NULL if the caller is not a worker thread of this executor.
+ */
+static celix_executor_worker_t* celix_executor_currentWorker(celix_executor_t *executor) {
+    celix_executor_worker_t *worker = pthread_getspecific(celix_executor_workerKey);
+    return worker != NULL && worker->executor == executor ? worker : NULL;
+}
+
+bool celix_executor_isWorkerThread(celix_executor_t *executor) {
+    return celix_executor_currentWorker(executor) != NULL;
+}
+
+static celix_status_t celix_executor_submitTask(celix_executor_t *executor, const celix_executor_task_t *task) {
+    celix_executor_worker_t *worker = celix_executor_currentWorker(executor);
+
+    celixThreadMutex_lock(&task->queue->mutex);
+    int priority = task->queue->priority;
+    task->queue->depth += 1;
+    celixThreadMutex_unlock(&task->queue->mutex);
+
+    celixThreadMutex_lock(&executor->mutex);
+    celix_status_t status = executor->active ? CELIX_SUCCESS : CELIX_ILLEGAL_STATE;
+    if (status == CELIX_SUCCESS) {
+        if (executor->nrOfQueuedTasks >= executor->nrOfIdleWorkers && executor->nrOfStartedWorkers < executor->nrOfWorkers) {
+            //not enough idle workers for the queued tasks, start an additional worker
+            celix_executor_startWorker(executor);
+        }
+        if (worker == NULL) {
+            worker = &executor->workers[executor->nextWorker++ % executor->nrOfStartedWorkers];
+        }
+        //note the task is pushed before it is counted and signalled, so that a woken worker can take it
+        celixThreadMutex_lock(&worker->mutex);
+        status = celix_executor_pushBack(&worker->deques[priority], task);
+        celixThreadMutex_unlock(&worker->mutex);
+        if (status == CELIX_SUCCESS) {
+            executor->nrOfQueuedTasks += 1;
+            celixThreadCondition_signal(&executor->cond);
+        }
+    }
+    celixThreadMutex_unlock(&executor->mutex);
+
+    if (status != CELIX_SUCCESS) {
+        celixThreadMutex_lock(&task->queue->mutex);
+        task->queue->depth -= 1;
+        celixThreadMutex_unlock(&task->queue->mutex);
+    }
+    return status;
+}
+
+celix_status_t celix_executor_submit(celix_executor_t *executor, const char *queueName, void *taskData, void (*task)(void *taskData)) {
+    celix_executor_task_t entry;
+    entry.taskData = taskData;
+    entry.task = task;
+    entry.queue = celix_executor_getOrCreateQueue(executor, queueName);
+    entry.scheduledTask = NULL;
+    clock_gettime(CLOCK_MONOTONIC, &entry.submitTime);
+    return celix_executor_submitTask(executor, &entry);
+}
+
+/**
+ * Takes a task, first from the own deques and then -stealing- from the other workers, highest priority first.
+ * Own tasks are taken from the front and stolen tasks from the back of the deques, so that a worker and a thief
+ * do not compete for the same tasks.
+ * Note that the deques of not (yet) started workers are always empty.
+ */
+static bool celix_executor_takeTask(celix_executor_t *executor, celix_executor_worker_t *worker, celix_executor_task_t *out) {
+    bool found = false;
+    for (int p = CELIX_EXECUTOR_NR_OF_PRIORITIES - 1; !found && p >= 0; --p) {
+        celixThreadMutex_lock(&worker->mutex);
+        found = celix_executor_popFront(&worker->deques[p], out);
+        celixThreadMutex_unlock(&worker->mutex);
+
+        for (int i = 1; !found && i < executor->nrOfWorkers; ++i) {
+            celix_executor_worker_t *victim = &executor->workers[(worker->index + i) % executor->nrOfWorkers];
+            celixThreadMutex_lock(&victim->mutex);
+            found = celix_executor_popBack(&victim->deques[p], out);
+            celixThreadMutex_unlock(&victim->mutex);
+        }
+    }
+    if (found) {
+        celixThreadMutex_lock(&executor->mutex);
+        executor->nrOfQueuedTasks -= 1;
+        celixThreadMutex_unlock(&executor->mutex);
+    }
+    return found;
+}
+
+static void celix_executor_runTask(celix_executor_t *executor, celix_executor_task_t *task) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    double latency = celix_executor_elapsed(&task->submitTime, &start);
+    celix_executor_queue_t *queue = task->queue;
+    celixThreadMutex_lock(&queue->mutex);
+    queue->depth -= 1;
+    queue->totalLatency += latency;
+    if (latency > queue->maxLatency) {
+        queue->maxLatency = latency;
+    }
+    celixThreadMutex_unlock(&queue->mutex);
+
+    task->task(task->taskData);
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    celixThreadMutex_lock(&queue->mutex);
+    queue->nrOfExecutedTasks += 1;
+    queue->totalExecutionTime += celix_executor_elapsed(&start, &end);
+    celixThreadMutex_unlock(&queue->mutex);
+
+    if (task->scheduledTask != NULL) {
+        celixThreadMutex_lock(&executor->scheduler.mutex);
+        task->scheduledTask->inFlight = false;
+        celix_executor_releaseScheduledTask(executor, task->scheduledTask);
+        celixThreadCondition_broadcast(&executor->scheduler.cond);
+        celixThreadMutex_unlock(&executor->scheduler.mutex);
+    }
+}
+
+static void* celix_executor_runWorker(void *data) {
+    celix_executor_worker_t *worker = data;
+    celix_executor_t *executor = worker->executor;
+    pthread_setspecific(celix_executor_workerKey, worker);
+
+    bool active = true;
+    while (active) {
+        celix_executor_task_t task;
+        if (celix_executor_takeTask(executor, worker, &task)) {
+            celix_executor_runTask(executor, &task);
+            continue;
+        }
+
+        celixThreadMutex_lock(&executor->mutex);
+        while (executor->active && executor->nrOfQueuedTasks <= 0) {
+            executor->nrOfIdleWorkers += 1;
+            celixThreadCondition_wait(&executor->cond, &executor->mutex);
+            executor->nrOfIdleWorkers -= 1;
+        }
+        active = executor->active || executor->nrOfQueuedTasks > 0; //finish the queued tasks before stopping
+        celixThreadMutex_unlock(&executor->mutex);
+    }
+
+    celixThread_exit(NULL);
+    return NULL;
+}
+
+static void celix_executor_removeScheduledTask(celix_executor_t *executor, celix_executor_scheduled_task_t *scheduledTask) {
+    //precondition scheduler mutex locked
+    celix_longHashMap_remove(executor->scheduler.tasks, scheduledTask->id);
+    celixThreadMutex_lock(&scheduledTask->queue->mutex);
+    scheduledTask->queue->nrOfScheduledTasks -= 1;
+    celixThreadMutex_unlock(&scheduledTask->queue->mutex);
+}
+
+/**
+ * Timer callback of a scheduled task, submits the task if it is not cancelled and the previous run is not still
+ * in flight.
+ */
+static void celix_executor_submitScheduledTask(void *data) {
+    celix_executor_scheduled_task_t *scheduledTask = data;
+    celix_executor_t *executor = scheduledTask->executor;
+
+    celixThreadMutex_lock(&executor->scheduler.mutex);
+    if (celix_longHashMap_get(executor->scheduler.tasks, scheduledTask->id) == scheduledTask) {
+        if (!scheduledTask->inFlight) {
+            celix_executor_task_t task;
+            task.taskData = scheduledTask->taskData;
+            task.task = scheduledTask->task;
+            task.queue = scheduledTask->queue;
+            task.scheduledTask = scheduledTask;
+            clock_gettime(CLOCK_MONOTONIC, &task.submitTime);
+            scheduledTask->inFlight = true;
+            scheduledTask->useCount += 1;
+            if (celix_executor_submitTask(executor, &task) != CELIX_SUCCESS) {
+                scheduledTask->inFlight = false;
+                scheduledTask->useCount -= 1;
+            }
+        }
+        if (scheduledTask->interval <= 0) {
+            //one-shot timer done
+            celix_executor_removeScheduledTask(executor, scheduledTask);
+            celix_executor_releaseScheduledTask(executor, scheduledTask);
+        }
+    }
+    celixThreadMutex_unlock(&executor->scheduler.mutex);
+}
+
+long celix_executor_schedule(celix_executor_t *executor, const char *queueName, double initialDelayInSeconds, double intervalInSeconds, void *taskData, void (*task)(void *taskData)) {
+    celix_executor_scheduled_task_t *scheduledTask = calloc(1, sizeof(*scheduledTask));
+    scheduledTask->executor = executor;
+    scheduledTask->queue = celix_executor_getOrCreateQueue(executor, queueName);
+    scheduledTask->taskData = taskData;
+    scheduledTask->task = task;
+    scheduledTask->interval = intervalInSeconds;
+    scheduledTask->useCount = 1;
+
+    long id = -1L;
+    celixThreadMutex_lock(&executor->scheduler.mutex);
+    if (executor->scheduler.active) {
+        //note scheduler mutex is locked, so the timer callback cannot use the scheduled task before it is added
+        id = celix_timer_schedule(executor->scheduler.timer, initialDelayInSeconds, intervalInSeconds, scheduledTask, celix_executor_submitScheduledTask);
+    }
+    if (id >= 0) {
+        scheduledTask->id = id;
+        celix_longHashMap_put(executor->scheduler.tasks, id, scheduledTask);
+        celixThreadMutex_lock(&scheduledTask->queue->mutex);
+        scheduledTask->queue->nrOfScheduledTasks += 1;
+        celixThreadMutex_unlock(&scheduledTask->queue->mutex);
+    } else {
+        free(scheduledTask);
+    }
+    celixThreadMutex_unlock(&executor->scheduler.mutex);
+    return id;
+}
+
+bool celix_executor_cancelScheduledTask(celix_executor_t *executor, long scheduledTaskId) {
+    celixThreadMutex_lock(&executor->scheduler.mutex);
+    celix_executor_scheduled_task_t *scheduledTask = celix_longHashMap_get(executor->scheduler.tasks, scheduledTaskId);
+    if (scheduledTask != NULL) {
+        celix_executor_removeScheduledTask(executor, scheduledTask);
+    }
+    celixThreadMutex_unlock(&executor->scheduler.mutex);
+
+    if (scheduledTask != NULL) {
+        //note cancel without the scheduler mutex, because the cancel waits for a running timer callback
+        celix_timer_cancel(executor->scheduler.timer, scheduledTaskId);
+        //note a worker thread does not wait for the in flight run, the run could be queued behind the caller or be
+        //the caller itself
+        bool wait = celix_executor_currentWorker(executor) == NULL;
+        celixThreadMutex_lock(&executor->scheduler.mutex);
+        while (wait && scheduledTask->inFlight) {
+            celixThreadCondition_wait(&executor->scheduler.cond, &executor->scheduler.mutex);
+        }
+        celix_executor_releaseScheduledTask(executor, scheduledTask);
+        celixThreadMutex_unlock(&executor->scheduler.mutex);
+    }
+    return scheduledTask != NULL;
+}
+
+celix_status_t celix_executor_setQueuePriority(celix_executor_t *executor, const char *queueName, celix_executor_priority_e priority) {
+    if (priority < CELIX_EXECUTOR_PRIORITY_LOW || priority > CELIX_EXECUTOR_PRIORITY_HIGH) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    celix_executor_queue_t *queue = celix_executor_getOrCreateQueue(executor, queueName);
+    celixThreadMutex_lock(&queue->mutex);
+    queue->priority = priority;
+    celixThreadMutex_unlock(&queue->mutex);
+    return CELIX_SUCCESS;
+}
+
+void celix_executor_useQueueMetrics(celix_executor_t *executor, void *callbackHandle, void (*use)(void *callbackHandle, const celix_executor_queue_metrics_t *metrics)) {
+    celixThreadRwlock_readLock(&executor->queuesLock);
+    celix_string_hash_map_iterator_t iter = celix_stringHashMap_begin(executor->queues);
+    for (; !celix_stringHashMapIterator_isEnd(&iter); celix_stringHashMapIterator_next(&iter)) {
+        celix_executor_queue_t *queue = iter.value;
+        celix_executor_queue_metrics_t metrics;
+        memset(&metrics, 0, sizeof(metrics));
+        metrics.queueName = queue->name;
+        celixThreadMutex_lock(&queue->mutex);
+        metrics.priority = queue->priority;
+        metrics.queueDepth = queue->depth;
+        metrics.nrOfScheduledTasks = queue->nrOfScheduledTasks;
+        metrics.nrOfExecutedTasks = queue->nrOfExecutedTasks;
+        metrics.maxLatencyInSeconds = queue->maxLatency;
+        if (queue->nrOfExecutedTasks > 0) {
+            metrics.averageLatencyInSeconds = queue->totalLatency / (double)queue->nrOfExecutedTasks;
+            metrics.averageExecutionTimeInSeconds = queue->totalExecutionTime / (double)queue->nrOfExecutedTasks;
+        }
+        celixThreadMutex_unlock(&queue->mutex);
+        use(callbackHandle, &metrics);
+    }
+    celixThreadRwlock_unlock(&executor->queuesLock);
+}
+
+static celix_status_t celix_executor_submitForService(void *handle, const char *queueName, void *taskData, void (*task)(void *taskData)) {
+    return celix_executor_submit(handle, queueName, taskData, task);
+}
+
+static long celix_executor_scheduleForService(void *handle, const char *queueName, double initialDelayInSeconds, double intervalInSeconds, void *taskData, void (*task)(void *taskData)) {
+    return celix_executor_schedule(handle, queueName, initialDelayInSeconds, intervalInSeconds, taskData, task);
+}
+
+static bool celix_executor_cancelScheduledTaskForService(void *handle, long scheduledTaskId) {
+    return celix_executor_cancelScheduledTask(handle, scheduledTaskId);
+}
+
+static celix_status_t celix_executor_setQueuePriorityForService(void *handle, const char *queueName, celix_executor_priority_e priority) {
+    return celix_executor_setQueuePriority(handle, queueName, priority);
+}
+
+static void celix_executor_useQueueMetricsForService(void *handle, void *callbackHandle, void (*use)(void *callbackHandle, const celix_executor_queue_metrics_t *metrics)) {
+    celix_executor_useQueueMetrics(handle, callbackHandle, use);
+}
+
+void celix_executor_initService(celix_executor_t *executor, celix_executor_service_t *svc) {
+    svc->handle = executor;
+    svc->submit = celix_executor_submitForService;
+    svc->schedule = celix_executor_scheduleForService;
+    svc->cancelScheduledTask = celix_executor_cancelScheduledTaskForService;
+    svc->setQueuePriority = celix_executor_setQueuePriorityForService;
+    svc->useQueueMetrics = celix_executor_useQueueMetricsForService;
+}
@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_CELIX_EXECUTOR_H
+#define CELIX_CELIX_EXECUTOR_H
+
+#include "celix_executor_service.h"
+#include "celix_timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Work stealing executor, used by the framework to provide the celix_executor_service_t.
+ *
+ * Every worker has a deque per priority. Tasks submitted from a worker thread are added to the deque of that worker,
+ * other tasks are spread over the workers. A worker without tasks steals tasks from the other workers.
+ * Delayed and periodic tasks are handled by the provided (framework) timer, which submits the tasks when they are due.
+ */
+typedef struct celix_executor celix_executor_t;
+
+/**
+ * Creates the executor. The timer is used for the delayed and periodic tasks and must outlive the executor.
+ * The worker threads are started on demand, up to nrOfThreads workers.
+ */
+celix_executor_t* celix_executor_create(int nrOfThreads, celix_timer_t *timer);
+
+/**
+ * Cancels the scheduled tasks, stops the worker threads and destroys the executor.
+ * Scheduled tasks are cancelled, already submitted tasks are finished before the worker threads stop.
+ */
+void celix_executor_destroy(celix_executor_t *executor);
+
+/**
+ * Returns the max nr of worker threads.
+ */
+int celix_executor_getNrOfThreads(const celix_executor_t *executor);
+
+/**
+ * Returns whether the calling thread is a worker thread of the executor.
+ */
+bool celix_executor_isWorkerThread(celix_executor_t *executor);
+
+/**
+ * Submits a task to the provided queue.
+ * Returns CELIX_SUCCESS, CELIX_ILLEGAL_STATE if the executor is stopped or CELIX_ENOMEM if the task could not be queued.
+ */
+celix_status_t celix_executor_submit(celix_executor_t *executor, const char *queueName, void *taskData, void (*task)(void *taskData));
+
+long celix_executor_schedule(celix_executor_t *executor, const char *queueName, double initialDelayInSeconds, double intervalInSeconds, void *taskData, void (*task)(void *taskData));
+
+/**
+ * Cancels a scheduled task and -if not called from a worker thread- waits until an already submitted run is done.
+ */
+bool celix_executor_cancelScheduledTask(celix_executor_t *executor, long scheduledTaskId);
+
+celix_status_t celix_executor_setQueuePriority(celix_executor_t *executor, const char *queueName, celix_executor_priority_e priority);
+
+void celix_executor_useQueueMetrics(celix_executor_t *executor, void *callbackHandle, void (*use)(void *callbackHandle, const celix_executor_queue_metrics_t *metrics));
+
+/**
+ * Fills in the executor service functions, using the executor as service handle.
+ */
+void celix_executor_initService(celix_executor_t *executor, celix_executor_service_t *svc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_CELIX_EXECUTOR_H
@@ -0,0 +1,247 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "celix_registry_statistics.h"
+#include "utils.h"
+
+#define CELIX_REGISTRY_STATISTICS_NR_OF_STRIPES 8
+
+/**
+ * The max nr of bundles and the max nr of service names for which statistics are kept. Calls for other bundles or
+ * service names are not recorded.
+ */
+#define CELIX_REGISTRY_STATISTICS_MAX_NR_OF_ENTRIES 4096
+
+typedef struct celix_registry_statistics_stripe {
+    size_t count;
+    uint64_t totalTimeInNs;
+    uint64_t maxTimeInNs;
+    size_t histogram[CELIX_REGISTRY_STATISTICS_NR_OF_BUCKETS];
+} celix_registry_statistics_stripe_t;
+
+typedef struct celix_registry_statistics_counters {
+    long bundleId;
+    char *serviceName;
+    celix_registry_statistics_stripe_t stripes[CELIX_REGISTRY_STATISTICS_NR_OF_TYPES][CELIX_REGISTRY_STATISTICS_NR_OF_STRIPES];
+} celix_registry_statistics_counters_t;
+
+/**
+ * The counters are kept in two fixed size open addressing tables (linear probing), one for the bundles and one for
+ * the service names. A slot is set once -with a compare exchange- and entries are never removed, so lookups and
+ * inserts do not need a lock.
+ */
+struct celix_registry_statistics {
+    celix_registry_statistics_counters_t *bundleCounters[CELIX_REGISTRY_STATISTICS_MAX_NR_OF_ENTRIES];
+    celix_registry_statistics_counters_t *serviceNameCounters[CELIX_REGISTRY_STATISTICS_MAX_NR_OF_ENTRIES];
+};
+
+celix_registry_statistics_t* celix_registryStatistics_create(void) {
+    return calloc(1, sizeof(celix_registry_statistics_t));
+}
+
+static void celix_registryStatistics_freeCounters(celix_registry_statistics_counters_t *counters) {
+    if (counters != NULL) {
+        free(counters->serviceName);
+        free(counters);
+    }
+}
+
+void celix_registryStatistics_destroy(celix_registry_statistics_t *stats) {
+    if (stats != NULL) {
+        for (size_t i = 0; i < CELIX_REGISTRY_STATISTICS_MAX_NR_OF_ENTRIES; ++i) {
+            celix_registryStatistics_freeCounters(stats->bundleCounters[i]);
+            celix_registryStatistics_freeCounters(stats->serviceNameCounters[i]);
+        }
+        free(stats);
+    }
+}
+
+void celix_registryStatistics_startTimer(const celix_registry_statistics_t *stats, struct timespec *start) {
+    if (stats != NULL) {
+        clock_gettime(CLOCK_MONOTONIC, start);
+    }
+}
+
+static bool celix_registryStatistics_matches(const celix_registry_statistics_counters_t *counters, long bundleId, const char *serviceName) {
+    return serviceName != NULL ? strcmp(counters->serviceName, serviceName) == 0 : counters->bundleId == bundleId;
+}
+
+/**
+ * Returns the counters for the bundle id (if serviceName is NULL) or the service name, creating them if needed.
+ * Returns NULL if the table is full.
+ */
+static celix_registry_statistics_counters_t* celix_registryStatistics_getCounters(celix_registry_statistics_t *stats, long bundleId, const char *serviceName) {
+    celix_registry_statistics_counters_t **table = serviceName != NULL ? stats->serviceNameCounters : stats->bundleCounters;
+    uint64_t hash = serviceName != NULL ? utils_stringHash(serviceName) : (uint64_t)bundleId * 0x9E3779B97F4A7C15ULL;
+    celix_registry_statistics_counters_t *created = NULL;
+    celix_registry_statistics_counters_t *result = NULL;
+    for (size_t i = 0; result == NULL && i < CELIX_REGISTRY_STATISTICS_MAX_NR_OF_ENTRIES; ++i) {
+        celix_registry_statistics_counters_t **slot = &table[(hash + i) % CELIX_REGISTRY_STATISTICS_MAX_NR_OF_ENTRIES];
+        celix_registry_statistics_counters_t *counters = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+        if (counters == NULL) {
+            if (created == NULL) {
+                created = calloc(1, sizeof(*created));
+                created->bundleId = serviceName != NULL ? -1L : bundleId;
+                created->serviceName = serviceName != NULL ? strdup(serviceName) : NULL;
+            }
+            if (__atomic_compare_exchange_n(slot, &counters, created, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                result = created;
+                created = NULL;
+                break;
+            }
+            //slot set by another thread, counters is updated by the failed compare exchange
+        }
+        if (celix_registryStatistics_matches(counters, bundleId, serviceName)) {
+            result = counters;
+        }
+    }
+    celix_registryStatistics_freeCounters(created);
+    return result;
+}
+
+static size_t celix_registryStatistics_stripeIndex(void) {
+    //Fibonacci hash of the thread id, the low bits of a pthread_t are mostly the same
+    uint64_t id = (uint64_t)(uintptr_t)pthread_self();
+    return (size_t)((id * 0x9E3779B97F4A7C15ULL) >> 61) % CELIX_REGISTRY_STATISTICS_NR_OF_STRIPES;
+}
+
+static size_t celix_registryStatistics_bucket(uint64_t durationInNs) {
+    uint64_t us = durationInNs / 1000;
+    size_t bucket = 0;
+    while (us > 0 && bucket < CELIX_REGISTRY_STATISTICS_NR_OF_BUCKETS - 1) {
+        us >>= 1;
+        bucket += 1;
+    }
+    return bucket;
+}
+
+static void celix_registryStatistics_update(celix_registry_statistics_stripe_t *stripe, uint64_t durationInNs, size_t bucket) {
+    __atomic_fetch_add(&stripe->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stripe->totalTimeInNs, durationInNs, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stripe->histogram[bucket], 1, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&stripe->maxTimeInNs, __ATOMIC_RELAXED);
+    while (durationInNs > max && !__atomic_compare_exchange_n(&stripe->maxTimeInNs, &max, durationInNs, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        //max updated by the failed compare exchange, retry
+    }
+}
+
+void celix_registryStatistics_record(celix_registry_statistics_t *stats, celix_registry_statistics_type_e type, long bundleId, const char *serviceName, const struct timespec *start) {
+    if (stats == NULL || (int)type < 0 || type >= CELIX_REGISTRY_STATISTICS_NR_OF_TYPES) {
+        return;
+    }
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    int64_t diff = (int64_t)(end.tv_sec - start->tv_sec) * 1000000000LL + (end.tv_nsec - start->tv_nsec);
+    uint64_t durationInNs = diff > 0 ? (uint64_t)diff : 0;
+    size_t bucket = celix_registryStatistics_bucket(durationInNs);
+    size_t stripe = celix_registryStatistics_stripeIndex();
+
+    celix_registry_statistics_counters_t *counters = bundleId >= 0 ? celix_registryStatistics_getCounters(stats, bundleId, NULL) : NULL;
+    if (counters != NULL) {
+        celix_registryStatistics_update(&counters->stripes[type][stripe], durationInNs, bucket);
+    }
+    counters = serviceName != NULL ? celix_registryStatistics_getCounters(stats, -1L, serviceName) : NULL;
+    if (counters != NULL) {
+        celix_registryStatistics_update(&counters->stripes[type][stripe], durationInNs, bucket);
+    }
+}
+
+static void celix_registryStatistics_aggregate(const celix_registry_statistics_counters_t *counters, celix_registry_statistics_entry_t *entry) {
+    memset(entry, 0, sizeof(*entry));
+    entry->bundleId = counters->bundleId;
+    entry->serviceName = counters->serviceName;
+    for (int t = 0; t < CELIX_REGISTRY_STATISTICS_NR_OF_TYPES; ++t) {
+        celix_registry_call_statistics_t *calls = &entry->calls[t];
+        uint64_t totalTimeInNs = 0;
+        uint64_t maxTimeInNs = 0;
+        for (int s = 0; s < CELIX_REGISTRY_STATISTICS_NR_OF_STRIPES; ++s) {
+            const celix_registry_statistics_stripe_t *stripe = &counters->stripes[t][s];
+            calls->count += __atomic_load_n(&stripe->count, __ATOMIC_RELAXED);
+            totalTimeInNs += __atomic_load_n(&stripe->totalTimeInNs, __ATOMIC_RELAXED);
+            uint64_t max = __atomic_load_n(&stripe->maxTimeInNs, __ATOMIC_RELAXED);
+            maxTimeInNs = max > maxTimeInNs ? max : maxTimeInNs;
+            for (int b = 0; b < CELIX_REGISTRY_STATISTICS_NR_OF_BUCKETS; ++b) {
+                calls->histogram[b] += __atomic_load_n(&stripe->histogram[b], __ATOMIC_RELAXED);
+            }
+        }
+        calls->totalTimeInSeconds = (double)totalTimeInNs / 1000000000.0;
+        calls->maxTimeInSeconds = (double)maxTimeInNs / 1000000000.0;
+    }
+}
+
+static void celix_registryStatistics_useEntries(celix_registry_statistics_t *stats, bool bundleEntries, void *callbackHandle, void (*use)(void *callbackHandle, const celix_registry_statistics_entry_t *entry)) {
+    celix_registry_statistics_counters_t **table = bundleEntries ? stats->bundleCounters : stats->serviceNameCounters;
+    for (size_t i = 0; i < CELIX_REGISTRY_STATISTICS_MAX_NR_OF_ENTRIES; ++i) {
+        celix_registry_statistics_counters_t *counters = __atomic_load_n(&table[i], __ATOMIC_ACQUIRE);
+        if (counters != NULL) {
+            celix_registry_statistics_entry_t entry;
+            celix_registryStatistics_aggregate(counters, &entry);
+            use(callbackHandle, &entry);
+        }
+    }
+}
+
+static void celix_registryStatistics_useBundleStatistics(void *handle, void *callbackHandle, void (*use)(void *callbackHandle, const celix_registry_statistics_entry_t *entry)) {
+    celix_registryStatistics_useEntries(handle, true, callbackHandle, use);
+}
+
+static void celix_registryStatistics_useServiceNameStatistics(void *handle, void *callbackHandle, void (*use)(void *callbackHandle, const celix_registry_statistics_entry_t *entry)) {
+    celix_registryStatistics_useEntries(handle, false, callbackHandle, use);
+}
+
+static void celix_registryStatistics_resetCounters(celix_registry_statistics_counters_t *counters) {
+    for (int t = 0; t < CELIX_REGISTRY_STATISTICS_NR_OF_TYPES; ++t) {
+        for (int s = 0; s < CELIX_REGISTRY_STATISTICS_NR_OF_STRIPES; ++s) {
+            celix_registry_statistics_stripe_t *stripe = &counters->stripes[t][s];
+            __atomic_store_n(&stripe->count, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&stripe->totalTimeInNs, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&stripe->maxTimeInNs, 0, __ATOMIC_RELAXED);
+            for (int b = 0; b < CELIX_REGISTRY_STATISTICS_NR_OF_BUCKETS; ++b) {
+                __atomic_store_n(&stripe->histogram[b], 0, __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+static void celix_registryStatistics_reset(void *handle) {
+    //note counters are reset instead of removed, because a recording thread can still use the counters
+    celix_registry_statistics_t *stats = handle;
+    for (size_t i = 0; i < CELIX_REGISTRY_STATISTICS_MAX_NR_OF_ENTRIES; ++i) {
+        celix_registry_statistics_counters_t *counters = __atomic_load_n(&stats->bundleCounters[i], __ATOMIC_ACQUIRE);
+        if (counters != NULL) {
+            celix_registryStatistics_resetCounters(counters);
+        }
+        counters = __atomic_load_n(&stats->serviceNameCounters[i], __ATOMIC_ACQUIRE);
+        if (counters != NULL) {
+            celix_registryStatistics_resetCounters(counters);
+        }
+    }
+}
+
+void celix_registryStatistics_initService(celix_registry_statistics_t *stats, celix_registry_statistics_service_t *svc) {
+    svc->handle = stats;
+    svc->useBundleStatistics = celix_registryStatistics_useBundleStatistics;
+    svc->useServiceNameStatistics = celix_registryStatistics_useServiceNameStatistics;
+    svc->reset = celix_registryStatistics_reset;
+}
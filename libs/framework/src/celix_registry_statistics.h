@@ -0,0 +1,67 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_CELIX_REGISTRY_STATISTICS_H
+#define CELIX_CELIX_REGISTRY_STATISTICS_H
+
+#include <time.h>
+
+#include "celix_registry_statistics_service.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Registry statistics, used by the service registry, the framework service event delivery and the service trackers.
+ *
+ * The counters of an entry are striped over a small nr of slots, selected by the calling thread, and updated with
+ * relaxed atomics. The slots are aggregated when the statistics are read.
+ * The entries are looked up in fixed size tables with atomic slots, so recording a call does not take a lock.
+ * Statistics are kept for at most 4096 bundles and 4096 service names.
+ * All functions which record statistics accept a NULL statistics pointer (statistics not enabled), in which case they
+ * do nothing.
+ */
+typedef struct celix_registry_statistics celix_registry_statistics_t;
+
+celix_registry_statistics_t* celix_registryStatistics_create(void);
+
+void celix_registryStatistics_destroy(celix_registry_statistics_t *stats);
+
+/**
+ * Sets start to the current (monotonic) time, if stats is not NULL.
+ */
+void celix_registryStatistics_startTimer(const celix_registry_statistics_t *stats, struct timespec *start);
+
+/**
+ * Records a call of the provided type, which started at start (see celix_registryStatistics_startTimer).
+ * The call is recorded for the bundle (if bundleId >= 0) and for the service name (if not NULL).
+ */
+void celix_registryStatistics_record(celix_registry_statistics_t *stats, celix_registry_statistics_type_e type, long bundleId, const char *serviceName, const struct timespec *start);
+
+/**
+ * Fills in the registry statistics service functions, using the statistics as service handle.
+ */
+void celix_registryStatistics_initService(celix_registry_statistics_t *stats, celix_registry_statistics_service_t *svc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_CELIX_REGISTRY_STATISTICS_H
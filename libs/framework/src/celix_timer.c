@@ -0,0 +1,270 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "celix_timer.h"
+#include "celix_timer_wheel.h"
+#include "celix_threads.h"
+#include "celix_array_list.h"
+#include "celix_hash_map.h"
+#include "utils.h"
+
+typedef struct celix_timer_entry {
+    celix_timer_wheel_entry_t wheelEntry; //note first member, so that a wheel entry can be cast to a timer entry
+    long id;
+    double interval; //<= 0 for a one-shot timer
+    double nextDue; //in seconds since the start of the timer
+    void *callbackData;
+    void (*callback)(void *callbackData);
+} celix_timer_entry_t;
+
+struct celix_timer {
+    double resolution; //seconds per tick
+    struct timespec startTime;
+    celix_thread_t thread;
+
+    celix_thread_mutex_t mutex; //protects below
+    celix_thread_cond_t cond; //signalled when a timer is scheduled or the timer is stopped
+    celix_thread_cond_t firingCond; //broadcasted when a timer callback is done
+    bool active;
+    long nextId;
+    celix_timer_wheel_t wheel;
+    celix_long_hash_map_t *timers; //key = timer id, value = celix_timer_entry_t*. Includes expired, not yet fired one-shot timers
+    celix_array_list_t *expired; //celix_timer_entry_t*, only used by the timer thread
+    celix_array_list_t *expiredIds; //long, only used by the timer thread
+    long firingTimerId; //id of the timer of which the callback is called, -1 if none
+};
+
+static void* celix_timer_run(void *data);
+
+static double celix_timer_elapsed(celix_timer_t *timer) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return celix_difftime(&timer->startTime, &now);
+}
+
+/**
+ * Returns the first tick on or after the provided time, so that a timer is never called before its due time.
+ */
+static uint64_t celix_timer_tickFor(celix_timer_t *timer, double time) {
+    double ticks = time / timer->resolution;
+    uint64_t tick = (uint64_t)ticks;
+    return (double)tick < ticks ? tick + 1 : tick;
+}
+
+celix_timer_t* celix_timer_create(double resolutionInSeconds) {
+    celix_timer_t *timer = calloc(1, sizeof(*timer));
+    timer->resolution = resolutionInSeconds > 0 ? resolutionInSeconds : CELIX_TIMER_DEFAULT_RESOLUTION_IN_SECONDS;
+    clock_gettime(CLOCK_MONOTONIC, &timer->startTime);
+    celixThreadMutex_create(&timer->mutex, NULL);
+    celixThreadCondition_init(&timer->cond, NULL);
+    celixThreadCondition_init(&timer->firingCond, NULL);
+    timer->active = true;
+    timer->nextId = 1L;
+    celix_timerWheel_init(&timer->wheel, 0);
+    timer->timers = celix_longHashMap_create();
+    timer->expired = celix_arrayList_create();
+    timer->expiredIds = celix_arrayList_create();
+    timer->firingTimerId = -1L;
+
+    celixThread_create(&timer->thread, NULL, celix_timer_run, timer);
+    celixThread_setName(&timer->thread, "CelixTimer");
+    return timer;
+}
+
+void celix_timer_destroy(celix_timer_t *timer) {
+    if (timer == NULL) {
+        return;
+    }
+
+    celixThreadMutex_lock(&timer->mutex);
+    timer->active = false;
+    celixThreadCondition_broadcast(&timer->cond);
+    celixThreadMutex_unlock(&timer->mutex);
+    celixThread_join(timer->thread, NULL);
+
+    celix_long_hash_map_iterator_t iter = celix_longHashMap_begin(timer->timers);
+    for (; !celix_longHashMapIterator_isEnd(&iter); celix_longHashMapIterator_next(&iter)) {
+        free(iter.value);
+    }
+    celix_longHashMap_destroy(timer->timers);
+    celix_arrayList_destroy(timer->expired);
+    celix_arrayList_destroy(timer->expiredIds);
+    celixThreadCondition_destroy(&timer->firingCond);
+    celixThreadCondition_destroy(&timer->cond);
+    celixThreadMutex_destroy(&timer->mutex);
+    free(timer);
+}
+
+long celix_timer_schedule(celix_timer_t *timer, double initialDelayInSeconds, double intervalInSeconds, void *callbackData, void (*callback)(void *callbackData)) {
+    if (callback == NULL) {
+        return -1L;
+    }
+    celix_timer_entry_t *entry = calloc(1, sizeof(*entry));
+    celix_timerWheel_initEntry(&entry->wheelEntry);
+    entry->interval = intervalInSeconds;
+    entry->nextDue = celix_timer_elapsed(timer) + (initialDelayInSeconds > 0 ? initialDelayInSeconds : 0);
+    entry->callbackData = callbackData;
+    entry->callback = callback;
+
+    long id = -1L;
+    celixThreadMutex_lock(&timer->mutex);
+    if (timer->active) {
+        id = timer->nextId++;
+        entry->id = id;
+        celix_longHashMap_put(timer->timers, id, entry);
+        celix_timerWheel_add(&timer->wheel, &entry->wheelEntry, celix_timer_tickFor(timer, entry->nextDue));
+        celixThreadCondition_signal(&timer->cond);
+    } else {
+        free(entry);
+    }
+    celixThreadMutex_unlock(&timer->mutex);
+    return id;
+}
+
+bool celix_timer_cancel(celix_timer_t *timer, long timerId) {
+    celixThreadMutex_lock(&timer->mutex);
+    celix_timer_entry_t *entry = celix_longHashMap_get(timer->timers, timerId);
+    if (entry != NULL) {
+        celix_longHashMap_remove(timer->timers, timerId);
+        celix_timerWheel_remove(&timer->wheel, &entry->wheelEntry);
+        if (!celixThread_equals(celixThread_self(), timer->thread)) {
+            //ensure the callback of the timer is not running after the cancel
+            while (timer->firingTimerId == timerId) {
+                celixThreadCondition_wait(&timer->firingCond, &timer->mutex);
+            }
+        }
+    }
+    celixThreadMutex_unlock(&timer->mutex);
+    free(entry);
+    return entry != NULL;
+}
+
+size_t celix_timer_getNrOfTimers(celix_timer_t *timer) {
+    celixThreadMutex_lock(&timer->mutex);
+    size_t size = celix_longHashMap_size(timer->timers);
+    celixThreadMutex_unlock(&timer->mutex);
+    return size;
+}
+
+static void celix_timer_expired(void *handle, celix_timer_wheel_entry_t *wheelEntry) {
+    celix_timer_t *timer = handle;
+    celix_arrayList_add(timer->expired, wheelEntry);
+}
+
+/**
+ * Advances the timer wheel to the current time and reschedules the expired periodic timers.
+ * The ids of the expired timers are added to expiredIds.
+ */
+static void celix_timer_advance(celix_timer_t *timer) {
+    //precondition mutex locked
+    double now = celix_timer_elapsed(timer);
+    celix_timerWheel_advance(&timer->wheel, (uint64_t)(now / timer->resolution), timer, celix_timer_expired);
+    for (int i = 0; i < celix_arrayList_size(timer->expired); ++i) {
+        celix_timer_entry_t *entry = celix_arrayList_get(timer->expired, i);
+        celix_arrayList_addLong(timer->expiredIds, entry->id);
+        if (entry->interval > 0) {
+            //fixed rate, runs missed because the timer thread was busy are skipped
+            entry->nextDue += entry->interval;
+            if (entry->nextDue <= now) {
+                uint64_t missed = (uint64_t)((now - entry->nextDue) / entry->interval) + 1;
+                entry->nextDue += entry->interval * (double)missed;
+            }
+            celix_timerWheel_add(&timer->wheel, &entry->wheelEntry, celix_timer_tickFor(timer, entry->nextDue));
+        }
+    }
+    celix_arrayList_clear(timer->expired);
+}
+
+/**
+ * Calls the callbacks of the expired timers, without holding the timer mutex.
+ * Timers cancelled while calling the callbacks are skipped.
+ */
+static void celix_timer_fireExpired(celix_timer_t *timer) {
+    //precondition mutex locked
+    for (int i = 0; i < celix_arrayList_size(timer->expiredIds); ++i) {
+        long id = celix_arrayList_getLong(timer->expiredIds, i);
+        celix_timer_entry_t *entry = celix_longHashMap_get(timer->timers, id);
+        if (entry == NULL) {
+            continue;
+        }
+        void *callbackData = entry->callbackData;
+        void (*callback)(void *callbackData) = entry->callback;
+        timer->firingTimerId = id;
+        celixThreadMutex_unlock(&timer->mutex);
+
+        callback(callbackData);
+
+        celixThreadMutex_lock(&timer->mutex);
+        timer->firingTimerId = -1L;
+        celixThreadCondition_broadcast(&timer->firingCond);
+        entry = celix_longHashMap_get(timer->timers, id);
+        if (entry != NULL && entry->interval <= 0) {
+            //one-shot timer done
+            celix_longHashMap_remove(timer->timers, id);
+            free(entry);
+        }
+    }
+    celix_arrayList_clear(timer->expiredIds);
+}
+
+static void* celix_timer_run(void *data) {
+    celix_timer_t *timer = data;
+
+    celixThreadMutex_lock(&timer->mutex);
+    while (timer->active) {
+        celix_timer_advance(timer);
+        celix_timer_fireExpired(timer);
+        if (!timer->active) {
+            break;
+        }
+
+        uint64_t nextTick;
+        if (celix_timerWheel_nextTick(&timer->wheel, &nextTick)) {
+            double waitTime = (double)nextTick * timer->resolution - celix_timer_elapsed(timer);
+            if (waitTime > 0) {
+                long sec = (long)waitTime;
+                long nsec = (long)((waitTime - (double)sec) * 1000000000.0);
+                celixThreadCondition_timedwaitRelative(&timer->cond, &timer->mutex, sec, nsec);
+            }
+        } else {
+            celixThreadCondition_wait(&timer->cond, &timer->mutex);
+        }
+    }
+    celixThreadMutex_unlock(&timer->mutex);
+
+    celixThread_exit(NULL);
+    return NULL;
+}
+
+static long celix_timer_scheduleForService(void *handle, double initialDelayInSeconds, double intervalInSeconds, void *callbackData, void (*callback)(void *callbackData)) {
+    return celix_timer_schedule(handle, initialDelayInSeconds, intervalInSeconds, callbackData, callback);
+}
+
+static bool celix_timer_cancelForService(void *handle, long timerId) {
+    return celix_timer_cancel(handle, timerId);
+}
+
+void celix_timer_initService(celix_timer_t *timer, celix_timer_service_t *svc) {
+    svc->handle = timer;
+    svc->scheduleTimer = celix_timer_scheduleForService;
+    svc->cancelTimer = celix_timer_cancelForService;
+}
@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_CELIX_TIMER_H
+#define CELIX_CELIX_TIMER_H
+
+#include <stddef.h>
+
+#include "celix_timer_service.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The default resolution of the framework timer, 1 ms.
+ */
+#define CELIX_TIMER_DEFAULT_RESOLUTION_IN_SECONDS 0.001
+
+/**
+ * Timer thread with a hierarchical timing wheel (see celix_timer_wheel.h), used by the framework to provide the
+ * celix_timer_service_t and the delayed and periodic tasks of the executor.
+ *
+ * The timer thread only wakes up for ticks on which timers expire (or on which a slot of the wheel is cascaded).
+ */
+typedef struct celix_timer celix_timer_t;
+
+celix_timer_t* celix_timer_create(double resolutionInSeconds);
+
+/**
+ * Stops the timer thread and destroys the timer. Timers which are still scheduled are cancelled.
+ */
+void celix_timer_destroy(celix_timer_t *timer);
+
+long celix_timer_schedule(celix_timer_t *timer, double initialDelayInSeconds, double intervalInSeconds, void *callbackData, void (*callback)(void *callbackData));
+
+bool celix_timer_cancel(celix_timer_t *timer, long timerId);
+
+/**
+ * Returns the nr of scheduled timers.
+ */
+size_t celix_timer_getNrOfTimers(celix_timer_t *timer);
+
+/**
+ * Fills in the timer service functions, using the timer as service handle.
+ */
+void celix_timer_initService(celix_timer_t *timer, celix_timer_service_t *svc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_CELIX_TIMER_H
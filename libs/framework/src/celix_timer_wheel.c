@@ -0,0 +1,201 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "celix_timer_wheel.h"
+
+#define CELIX_TIMER_WHEEL_SLOT_MASK ((uint64_t)CELIX_TIMER_WHEEL_NR_OF_SLOTS - 1)
+#define CELIX_TIMER_WHEEL_MAX_DELTA (((uint64_t)1 << (CELIX_TIMER_WHEEL_NR_OF_LEVELS * CELIX_TIMER_WHEEL_SLOT_BITS)) - 1)
+
+//note the occupied bitmap of a level is a uint64_t
+_Static_assert(CELIX_TIMER_WHEEL_NR_OF_SLOTS == 64, "The timer wheel needs 64 slots per level");
+
+void celix_timerWheel_init(celix_timer_wheel_t *wheel, uint64_t currentTick) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->currentTick = currentTick;
+}
+
+void celix_timerWheel_initEntry(celix_timer_wheel_entry_t *entry) {
+    entry->expiry = 0;
+    entry->prev = NULL;
+    entry->next = NULL;
+    entry->level = -1;
+    entry->slot = -1;
+}
+
+/**
+ * Links the entry in the slot for its expiry, relative to the current tick.
+ * An entry with an expiry on the current tick is linked in the current level 0 slot, this is only done when
+ * cascading during a tick.
+ */
+static void celix_timerWheel_link(celix_timer_wheel_t *wheel, celix_timer_wheel_entry_t *entry) {
+    uint64_t expiry = entry->expiry;
+    uint64_t delta = expiry > wheel->currentTick ? expiry - wheel->currentTick : 0;
+    if (delta > CELIX_TIMER_WHEEL_MAX_DELTA) {
+        //beyond the range of the wheel, re-added when the slot of the highest level is cascaded
+        delta = CELIX_TIMER_WHEEL_MAX_DELTA;
+        expiry = wheel->currentTick + delta;
+    }
+    int level = 0;
+    while (level < CELIX_TIMER_WHEEL_NR_OF_LEVELS - 1 && delta >= ((uint64_t)1 << ((level + 1) * CELIX_TIMER_WHEEL_SLOT_BITS))) {
+        ++level;
+    }
+    int slot = (int)((expiry >> (level * CELIX_TIMER_WHEEL_SLOT_BITS)) & CELIX_TIMER_WHEEL_SLOT_MASK);
+
+    entry->level = level;
+    entry->slot = slot;
+    entry->prev = NULL;
+    entry->next = wheel->slots[level][slot];
+    if (entry->next != NULL) {
+        entry->next->prev = entry;
+    }
+    wheel->slots[level][slot] = entry;
+    wheel->occupied[level] |= (uint64_t)1 << slot;
+}
+
+static void celix_timerWheel_unlink(celix_timer_wheel_t *wheel, celix_timer_wheel_entry_t *entry) {
+    if (entry->prev != NULL) {
+        entry->prev->next = entry->next;
+    } else {
+        wheel->slots[entry->level][entry->slot] = entry->next;
+    }
+    if (entry->next != NULL) {
+        entry->next->prev = entry->prev;
+    }
+    if (wheel->slots[entry->level][entry->slot] == NULL) {
+        wheel->occupied[entry->level] &= ~((uint64_t)1 << entry->slot);
+    }
+    entry->prev = NULL;
+    entry->next = NULL;
+    entry->level = -1;
+    entry->slot = -1;
+}
+
+/**
+ * Removes and returns all entries of a slot as a (next linked) list.
+ */
+static celix_timer_wheel_entry_t* celix_timerWheel_detachSlot(celix_timer_wheel_t *wheel, int level, int slot) {
+    celix_timer_wheel_entry_t *list = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~((uint64_t)1 << slot);
+    return list;
+}
+
+void celix_timerWheel_add(celix_timer_wheel_t *wheel, celix_timer_wheel_entry_t *entry, uint64_t expiry) {
+    if (entry->level >= 0) {
+        celix_timerWheel_unlink(wheel, entry);
+    } else {
+        wheel->size += 1;
+    }
+    entry->expiry = expiry > wheel->currentTick ? expiry : wheel->currentTick + 1;
+    celix_timerWheel_link(wheel, entry);
+}
+
+bool celix_timerWheel_remove(celix_timer_wheel_t *wheel, celix_timer_wheel_entry_t *entry) {
+    if (entry->level < 0) {
+        return false;
+    }
+    celix_timerWheel_unlink(wheel, entry);
+    wheel->size -= 1;
+    return true;
+}
+
+size_t celix_timerWheel_size(const celix_timer_wheel_t *wheel) {
+    return wheel->size;
+}
+
+bool celix_timerWheel_nextTick(const celix_timer_wheel_t *wheel, uint64_t *tick) {
+    if (wheel->size == 0) {
+        return false;
+    }
+    uint64_t next = UINT64_MAX;
+    for (int level = 0; level < CELIX_TIMER_WHEEL_NR_OF_LEVELS; ++level) {
+        uint64_t occupied = wheel->occupied[level];
+        if (occupied == 0) {
+            continue;
+        }
+        //the first slot -from the next slot of the level onwards- with entries. For level 0 this is the expiry, for
+        //the other levels the tick on which the slot is cascaded.
+        int shift = level * CELIX_TIMER_WHEEL_SLOT_BITS;
+        uint64_t base = (wheel->currentTick >> shift) + 1;
+        int start = (int)(base & CELIX_TIMER_WHEEL_SLOT_MASK);
+        uint64_t rotated = start == 0 ? occupied : (occupied >> start) | (occupied << (CELIX_TIMER_WHEEL_NR_OF_SLOTS - start));
+        uint64_t levelNext = (base + (uint64_t)__builtin_ctzll(rotated)) << shift;
+        if (levelNext < next) {
+            next = levelNext;
+        }
+    }
+    *tick = next;
+    return true;
+}
+
+/**
+ * Moves the wheel one tick forward, cascades the slots of the higher levels which start on the new tick and
+ * expires the entries of the level 0 slot of the new tick.
+ */
+static size_t celix_timerWheel_tick(celix_timer_wheel_t *wheel, void *handle, void (*expired)(void *handle, celix_timer_wheel_entry_t *entry)) {
+    wheel->currentTick += 1;
+    uint64_t now = wheel->currentTick;
+
+    for (int level = 1; level < CELIX_TIMER_WHEEL_NR_OF_LEVELS; ++level) {
+        int shift = level * CELIX_TIMER_WHEEL_SLOT_BITS;
+        if ((now & (((uint64_t)1 << shift) - 1)) != 0) {
+            break; //the lower level did not wrap around
+        }
+        int slot = (int)((now >> shift) & CELIX_TIMER_WHEEL_SLOT_MASK);
+        celix_timer_wheel_entry_t *entry = celix_timerWheel_detachSlot(wheel, level, slot);
+        while (entry != NULL) {
+            celix_timer_wheel_entry_t *next = entry->next;
+            celix_timerWheel_link(wheel, entry);
+            entry = next;
+        }
+    }
+
+    size_t count = 0;
+    celix_timer_wheel_entry_t *entry = celix_timerWheel_detachSlot(wheel, 0, (int)(now & CELIX_TIMER_WHEEL_SLOT_MASK));
+    while (entry != NULL) {
+        celix_timer_wheel_entry_t *next = entry->next;
+        entry->prev = NULL;
+        entry->next = NULL;
+        entry->level = -1;
+        entry->slot = -1;
+        wheel->size -= 1;
+        count += 1;
+        expired(handle, entry);
+        entry = next;
+    }
+    return count;
+}
+
+size_t celix_timerWheel_advance(celix_timer_wheel_t *wheel, uint64_t tick, void *handle, void (*expired)(void *handle, celix_timer_wheel_entry_t *entry)) {
+    size_t count = 0;
+    while (wheel->currentTick < tick) {
+        uint64_t next;
+        if (!celix_timerWheel_nextTick(wheel, &next) || next > tick) {
+            //no expiring or cascading entries up to tick
+            wheel->currentTick = tick;
+            break;
+        }
+        //skip the ticks without work
+        wheel->currentTick = next - 1;
+        count += celix_timerWheel_tick(wheel, handle, expired);
+    }
+    return count;
+}
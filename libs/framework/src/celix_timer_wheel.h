@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_CELIX_TIMER_WHEEL_H
+#define CELIX_CELIX_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Hierarchical timing wheel, used by the framework timer.
+ *
+ * Level 0 has a slot per tick and a slot of level n covers CELIX_TIMER_WHEEL_NR_OF_SLOTS^n ticks. An entry is added
+ * to the lowest level which covers its expiry and is moved (cascaded) to a lower level when the wheel reaches the
+ * slot of the entry. Entries beyond the range of the wheel are kept in the highest level and are re-added when their
+ * slot is cascaded.
+ *
+ * Adding and removing an entry is O(1) and advancing the wheel skips the ticks without expiring or cascading
+ * entries, so that the wheel can be advanced over a long sleep.
+ *
+ * The timer wheel is not thread safe and does not allocate memory, the entries are owned by the caller.
+ */
+#define CELIX_TIMER_WHEEL_NR_OF_LEVELS 4
+#define CELIX_TIMER_WHEEL_SLOT_BITS 6
+#define CELIX_TIMER_WHEEL_NR_OF_SLOTS (1 << CELIX_TIMER_WHEEL_SLOT_BITS)
+
+typedef struct celix_timer_wheel_entry {
+    uint64_t expiry; //the tick on which the entry expires
+
+    //managed by the timer wheel
+    struct celix_timer_wheel_entry *prev;
+    struct celix_timer_wheel_entry *next;
+    int level; //-1 if the entry is not added to a timer wheel
+    int slot;
+} celix_timer_wheel_entry_t;
+
+typedef struct celix_timer_wheel {
+    uint64_t currentTick;
+    size_t size;
+    uint64_t occupied[CELIX_TIMER_WHEEL_NR_OF_LEVELS]; //bit per non empty slot
+    celix_timer_wheel_entry_t *slots[CELIX_TIMER_WHEEL_NR_OF_LEVELS][CELIX_TIMER_WHEEL_NR_OF_SLOTS];
+} celix_timer_wheel_t;
+
+void celix_timerWheel_init(celix_timer_wheel_t *wheel, uint64_t currentTick);
+
+void celix_timerWheel_initEntry(celix_timer_wheel_entry_t *entry);
+
+/**
+ * Adds the entry to the wheel, an entry already added is moved to the new expiry.
+ * An expiry before or on the current tick is handled as an expiry on the next tick.
+ */
+void celix_timerWheel_add(celix_timer_wheel_t *wheel, celix_timer_wheel_entry_t *entry, uint64_t expiry);
+
+/**
+ * Removes the entry from the wheel.
+ * @return True if the entry was added to the wheel.
+ */
+bool celix_timerWheel_remove(celix_timer_wheel_t *wheel, celix_timer_wheel_entry_t *entry);
+
+size_t celix_timerWheel_size(const celix_timer_wheel_t *wheel);
+
+/**
+ * Returns the next tick on which the wheel has work, i.e. the earliest expiry or an earlier cascade of a slot.
+ * Sleeping until (and advancing to) the returned tick will never miss an expiry.
+ *
+ * @return False if the wheel is empty.
+ */
+bool celix_timerWheel_nextTick(const celix_timer_wheel_t *wheel, uint64_t *tick);
+
+/**
+ * Advances the wheel to the provided tick and calls expired for every expired entry, in expiry order.
+ * An expired entry is removed from the wheel before the expired callback is called, so the callback can re-add
+ * (e.g. for a periodic timer) or release the entry. A re-added entry with an expiry up to the provided tick
+ * expires in the same advance. The expired callback must not add or remove other entries.
+ *
+ * @return The nr of expired entries.
+ */
+size_t celix_timerWheel_advance(celix_timer_wheel_t *wheel, uint64_t tick, void *handle, void (*expired)(void *handle, celix_timer_wheel_entry_t *entry));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_CELIX_TIMER_WHEEL_H
@@ -31,6 +31,8 @@
 #include "celix_constants.h"
 #include "filter.h"
 #include "dm_component_impl.h"
+#include "bundle_context_private.h"
+#include "framework_private.h"
 
 
 typedef struct dm_executor_struct * dm_executor_pt;
@@ -51,6 +53,10 @@ struct celix_dm_component_struct {
     array_list_pt dependencies; //protected by mutex
     pthread_mutex_t mutex;
 
+    //nr of required dependencies which are not available, used to check the required dependencies in O(1)
+    int nrOfUnavailableRequired; //protected by mutex, excluding instance bound dependencies
+    int nrOfUnavailableInstanceBound; //protected by mutex
+
     celix_dm_component_state_t state;
     bool isStarted;
     bool active;
@@ -70,16 +76,30 @@ typedef struct dm_interface_struct {
 } dm_interface_t;
 
 struct dm_executor_struct {
+    celix_dm_component_t *component;
     pthread_t runningThread;
-    bool runningThreadSet;
+    bool runningThreadSet; //true if a thread is -or a framework executor task is scheduled for- running the work queue
+    bool running; //true if runningThread is running the work queue
     celix_array_list_t *workQueue;
-    pthread_mutex_t mutex;
+    //strand mode (CELIX_DM_COMPONENT_USE_EXECUTOR), the work queue is run as task on the framework executor.
+    bool strandQueued; //true if a submitted strand task should run the work queue, false if it is run inline instead
+    int nrOfSubmittedStrands; //nr of submitted strand tasks which did not run yet
+    bool destroyed; //true if the executor is destroyed, the last submitted strand task frees the executor
+    pthread_mutex_t mutex; //protects above
+    pthread_cond_t idle; //signalled when runningThreadSet becomes false
+
+    bool useFrameworkExecutor;
+
+    //the component state change of deferrable tasks is coalesced, i.e. done once for consecutive deferrable tasks
+    bool deferStateChange; //only used by the running thread
+    bool stateChangePending; //only used by the running thread
 };
 
 typedef struct dm_executor_task_struct {
     celix_dm_component_t *component;
     void (*command)(void *command_ptr, void *data);
     void *data;
+    bool deferrable; //true if the component state change of the task can be coalesced with the next tasks
 } dm_executor_task_t;
 
 typedef struct dm_handle_event_type_struct {
@@ -88,11 +108,14 @@ typedef struct dm_handle_event_type_struct {
 	dm_event_pt newEvent;
 } *dm_handle_event_type_pt;
 
-static celix_status_t executor_runTasks(dm_executor_pt executor, pthread_t  currentThread __attribute__((unused)));
-static celix_status_t executor_execute(dm_executor_pt executor);
-static celix_status_t executor_executeTask(dm_executor_pt executor, celix_dm_component_t *component, void (*command), void *data);
-static celix_status_t executor_schedule(dm_executor_pt executor, celix_dm_component_t *component, void (*command), void *data);
-static celix_status_t executor_create(celix_dm_component_t *component __attribute__((unused)), dm_executor_pt *executor);
+static celix_status_t executor_runTasks(dm_executor_pt executor, pthread_t currentThread);
+static celix_status_t executor_execute(dm_executor_pt executor, bool deferrable);
+static celix_status_t executor_executeTask(dm_executor_pt executor, celix_dm_component_t *component, void (*command), void *data, bool deferrable);
+static celix_status_t executor_schedule(dm_executor_pt executor, celix_dm_component_t *component, void (*command), void *data, bool deferrable);
+static celix_status_t executor_create(celix_dm_component_t *component, dm_executor_pt *executor);
+static void executor_waitForIdle(dm_executor_pt executor);
+static void executor_runQueuedStrandOrWaitForIdle(dm_executor_pt executor, bool runQueuedStrand);
+static void executor_removeDependencyEvents(dm_executor_pt executor, celix_dm_service_dependency_t *dependency);
 static void executor_destroy(dm_executor_pt executor);
 
 static celix_status_t component_invokeRemoveRequiredDependencies(celix_dm_component_t *component);
@@ -107,6 +130,8 @@ static celix_status_t component_invokeAutoConfigInstanceBoundDependencies(celix_
 static celix_status_t component_invokeAutoConfigDependencies(celix_dm_component_t *component);
 static celix_status_t component_configureImplementation(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency);
 static celix_status_t component_allInstanceBoundAvailable(celix_dm_component_t *component, bool *available);
+static void component_countDependency(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency, int delta);
+static void component_setDependencyAvailable(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency, bool available);
 static celix_status_t component_allRequiredAvailable(celix_dm_component_t *component, bool *available);
 static celix_status_t component_performTransition(celix_dm_component_t *component, celix_dm_component_state_t oldState, celix_dm_component_state_t newState, bool *transition);
 static celix_status_t component_calculateNewState(celix_dm_component_t *component, celix_dm_component_state_t currentState, celix_dm_component_state_t *newState);
@@ -190,6 +215,7 @@ void celix_dmComponent_destroy(celix_dm_component_t *component) {
 		}
 		arrayList_destroy(component->dm_interfaces);
 
+		executor_waitForIdle(component->executor);
 		executor_destroy(component->executor);
 
 		hash_map_iterator_pt iter = hashMapIterator_create(component->dependencyEvents);
@@ -219,7 +245,7 @@ celix_status_t celix_dmComponent_addServiceDependency(celix_dm_component_t *comp
 
     celix_status_t status = CELIX_SUCCESS;
 
-	executor_executeTask(component->executor, component, component_addTask, dep);
+	executor_executeTask(component->executor, component, component_addTask, dep, true);
 
     return status;
 }
@@ -234,17 +260,17 @@ static celix_status_t component_addTask(celix_dm_component_t *component, celix_d
     array_list_pt events = NULL;
     arrayList_createWithEquals(event_equals, &events);
 
-    pthread_mutex_lock(&component->mutex);
-    hashMap_put(component->dependencyEvents, dep, events);
-    arrayList_add(component->dependencies, dep);
-    pthread_mutex_unlock(&component->mutex);
-
-    serviceDependency_setComponent(dep, component);
-
     if (component->state != DM_CMP_STATE_INACTIVE) {
         serviceDependency_setInstanceBound(dep, true);
         arrayList_add(bounds, dep);
     }
+
+    pthread_mutex_lock(&component->mutex);
+    hashMap_put(component->dependencyEvents, dep, events);
+    arrayList_add(component->dependencies, dep);
+    serviceDependency_setComponent(dep, component);
+    component_countDependency(component, dep, 1);
+    pthread_mutex_unlock(&component->mutex);
     component_startDependencies(component, bounds);
     component_handleChange(component);
 
@@ -284,7 +310,7 @@ celix_status_t component_removeServiceDependency(celix_dm_component_t *component
 celix_status_t celix_dmComponent_removeServiceDependency(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency) {
     celix_status_t status = CELIX_SUCCESS;
 
-    executor_executeTask(component->executor, component, component_removeTask, dependency);
+    executor_executeTask(component->executor, component, component_removeTask, dependency, false);
 
     return status;
 }
@@ -294,11 +320,14 @@ static celix_status_t component_removeTask(celix_dm_component_t *component, celi
 
     pthread_mutex_lock(&component->mutex);
     arrayList_removeElement(component->dependencies, dependency);
+    component_countDependency(component, dependency, -1);
     pthread_mutex_unlock(&component->mutex);
 
     if (component->state != DM_CMP_STATE_INACTIVE) {
         serviceDependency_stop(dependency);
     }
+    //note stopping the dependency queues removed events, which should not be handled after the dependency is destroyed
+    executor_removeDependencyEvents(component->executor, dependency);
 
     pthread_mutex_lock(&component->mutex);
     array_list_pt events = hashMap_remove(component->dependencyEvents, dependency);
@@ -321,7 +350,7 @@ celix_status_t celix_private_dmComponent_start(celix_dm_component_t *component)
     celix_status_t status = CELIX_SUCCESS;
 
     component->active = true;
-    executor_executeTask(component->executor, component, component_startTask, NULL);
+    executor_executeTask(component->executor, component, component_startTask, NULL, true);
 
     return status;
 }
@@ -339,7 +368,11 @@ celix_status_t celix_private_dmComponent_stop(celix_dm_component_t *component) {
     celix_status_t status = CELIX_SUCCESS;
 
     component->active = false;
-    executor_executeTask(component->executor, component, component_stopTask, NULL);
+    executor_executeTask(component->executor, component, component_stopTask, NULL, false);
+    if (component->executor->useFrameworkExecutor) {
+        //a stopped component should not be used anymore
+        executor_waitForIdle(component->executor);
+    }
 
     return status;
 }
@@ -468,7 +501,8 @@ celix_status_t celix_private_dmComponent_handleEvent(celix_dm_component_t *compo
 	data->event = event;
 	data->newEvent = NULL;
 
-	status = executor_executeTask(component->executor, component, component_handleEventTask, data);
+	bool deferrable = event->event_type != DM_EVENT_REMOVED;
+	status = executor_executeTask(component->executor, component, component_handleEventTask, data, deferrable);
 //	component_handleEventTask(component, data);
 
 	return status;
@@ -531,7 +565,7 @@ static celix_status_t component_handleAdded(celix_dm_component_t *component, cel
     arrayList_add(events, event);
     pthread_mutex_unlock(&component->mutex);
 
-    serviceDependency_setAvailable(dependency, true);
+    component_setDependencyAvailable(component, dependency, true);
 
     switch (component->state) {
         case DM_CMP_STATE_WAITING_FOR_REQUIRED: {
@@ -634,7 +668,7 @@ static celix_status_t component_handleRemoved(celix_dm_component_t *component, c
         size--;
     }
     pthread_mutex_unlock(&component->mutex);
-    serviceDependency_setAvailable(dependency, size > 0);
+    component_setDependencyAvailable(component, dependency, size > 0);
     component_handleChange(component);
 
     pthread_mutex_lock(&component->mutex);
@@ -803,6 +837,12 @@ static celix_status_t component_stopDependencies(celix_dm_component_t *component
 static celix_status_t component_handleChange(celix_dm_component_t *component) {
     celix_status_t status = CELIX_SUCCESS;
 
+    if (component->executor->deferStateChange) {
+        //coalesced, the state is recalculated after the next non deferrable task or when the work queue is empty
+        component->executor->stateChangePending = true;
+        return status;
+    }
+
     celix_dm_component_state_t oldState;
     celix_dm_component_state_t newState;
 
@@ -933,58 +973,55 @@ static celix_status_t component_performTransition(celix_dm_component_t *componen
     return status;
 }
 
-static celix_status_t component_allRequiredAvailable(celix_dm_component_t *component, bool *available) {
-    celix_status_t status = CELIX_SUCCESS;
+/**
+ * Adds (delta is 1) or removes (delta is -1) the dependency to/from the unavailable required counters, if the
+ * dependency is required and not available.
+ * precondition: component mutex is locked.
+ */
+static void component_countDependency(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency, int delta) {
+    bool required = false;
+    bool instanceBound = false;
+    bool available = false;
+    serviceDependency_isRequired(dependency, &required);
+    serviceDependency_isInstanceBound(dependency, &instanceBound);
+    serviceDependency_isAvailable(dependency, &available);
+    if (required && !available) {
+        if (instanceBound) {
+            component->nrOfUnavailableInstanceBound += delta;
+        } else {
+            component->nrOfUnavailableRequired += delta;
+        }
+    }
+}
 
+static void component_setDependencyAvailable(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency, bool available) {
     pthread_mutex_lock(&component->mutex);
-    *available = true;
-    for (unsigned int i = 0; i < arrayList_size(component->dependencies); i++) {
-        celix_dm_service_dependency_t *dependency = arrayList_get(component->dependencies, i);
-        bool required = false;
-        bool instanceBound = false;
-
-        serviceDependency_isRequired(dependency, &required);
-        serviceDependency_isInstanceBound(dependency, &instanceBound);
+    component_countDependency(component, dependency, -1);
+    serviceDependency_setAvailable(dependency, available);
+    component_countDependency(component, dependency, 1);
+    pthread_mutex_unlock(&component->mutex);
+}
 
-        if (required && !instanceBound) {
-            bool isAvailable = false;
-            serviceDependency_isAvailable(dependency, &isAvailable);
-            if (!isAvailable) {
-                *available = false;
-                break;
-            }
-        }
-    }
+void celix_private_dmComponent_setDependencyRequired(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency, bool required) {
+    pthread_mutex_lock(&component->mutex);
+    component_countDependency(component, dependency, -1);
+    dependency->required = required;
+    component_countDependency(component, dependency, 1);
     pthread_mutex_unlock(&component->mutex);
+}
 
-    return status;
+static celix_status_t component_allRequiredAvailable(celix_dm_component_t *component, bool *available) {
+    pthread_mutex_lock(&component->mutex);
+    *available = component->nrOfUnavailableRequired == 0;
+    pthread_mutex_unlock(&component->mutex);
+    return CELIX_SUCCESS;
 }
 
 static celix_status_t component_allInstanceBoundAvailable(celix_dm_component_t *component, bool *available) {
-    celix_status_t status = CELIX_SUCCESS;
-
     pthread_mutex_lock(&component->mutex);
-    *available = true;
-    for (unsigned int i = 0; i < arrayList_size(component->dependencies); i++) {
-        celix_dm_service_dependency_t *dependency = arrayList_get(component->dependencies, i);
-        bool required = false;
-        bool instanceBound = false;
-
-        serviceDependency_isRequired(dependency, &required);
-        serviceDependency_isInstanceBound(dependency, &instanceBound);
-
-        if (required && instanceBound) {
-            bool isAvailable = false;
-            serviceDependency_isAvailable(dependency, &isAvailable);
-            if (!isAvailable) {
-                *available = false;
-                break;
-            }
-        }
-    }
+    *available = component->nrOfUnavailableInstanceBound == 0;
     pthread_mutex_unlock(&component->mutex);
-
-    return status;
+    return CELIX_SUCCESS;
 }
 
 static celix_status_t component_invokeAddRequiredDependencies(celix_dm_component_t *component) {
@@ -1243,18 +1280,38 @@ static celix_status_t component_registerServices(celix_dm_component_t *component
     celix_status_t status = CELIX_SUCCESS;
 
     if (component->context != NULL) {
-	    unsigned int i;
         celixThreadMutex_lock(&component->mutex);
-        for (i = 0; i < arrayList_size(component->dm_interfaces); i++) {
+        //all provided interfaces are registered as one batch, so that service listeners/trackers see a single
+        //registry update for the component
+        unsigned int size = arrayList_size(component->dm_interfaces);
+        celix_service_registry_batch_entry_t *entries = calloc(size == 0 ? 1 : size, sizeof(*entries));
+        dm_interface_t **batched = calloc(size == 0 ? 1 : size, sizeof(*batched));
+        size_t nrOfEntries = 0;
+        for (unsigned int i = 0; i < size; i++) {
             dm_interface_t *interface = arrayList_get(component->dm_interfaces, i);
             if (interface->registration == NULL) {
                 properties_pt regProps = NULL;
                 properties_copy(interface->properties, &regProps);
-                bundleContext_registerService(component->context, interface->serviceName, interface->service, regProps,
-                                              &interface->registration);
+                entries[nrOfEntries].serviceName = interface->serviceName;
+                entries[nrOfEntries].svc = interface->service;
+                entries[nrOfEntries].properties = regProps;
+                batched[nrOfEntries] = interface;
+                nrOfEntries += 1;
+            }
+        }
+        if (nrOfEntries > 0) {
+            status = celix_framework_registerServices(component->context->framework, component->context->bundle, entries, nrOfEntries);
+            for (size_t i = 0; i < nrOfEntries; ++i) {
+                batched[i]->registration = entries[i].registration;
+                if (entries[i].registration == NULL) {
+                    //not registered, so the copied properties are still owned by the component
+                    properties_destroy(entries[i].properties);
+                }
             }
         }
         celixThreadMutex_unlock(&component->mutex);
+        free(batched);
+        free(entries);
     }
 
     return status;
@@ -1263,16 +1320,20 @@ static celix_status_t component_registerServices(celix_dm_component_t *component
 static celix_status_t component_unregisterServices(celix_dm_component_t *component) {
     celix_status_t status = CELIX_SUCCESS;
 
-    unsigned int i;
-
+    celix_array_list_t *registrations = celix_arrayList_takeScratch();
     celixThreadMutex_lock(&component->mutex);
-    for (i = 0; i < arrayList_size(component->dm_interfaces); i++) {
-	    dm_interface_t *interface = arrayList_get(component->dm_interfaces, i);
-
-	    serviceRegistration_unregister(interface->registration);
-	    interface->registration = NULL;
+    for (unsigned int i = 0; i < arrayList_size(component->dm_interfaces); i++) {
+        dm_interface_t *interface = arrayList_get(component->dm_interfaces, i);
+        if (interface->registration != NULL) {
+            celix_arrayList_add(registrations, interface->registration);
+        }
+        interface->registration = NULL;
+    }
+    if (celix_arrayList_size(registrations) > 0 && component->context != NULL) {
+        celix_framework_unregisterServices(component->context->framework, component->context->bundle, registrations);
     }
     celixThreadMutex_unlock(&component->mutex);
+    celix_arrayList_releaseScratch(registrations);
 
     return status;
 }
@@ -1322,32 +1383,101 @@ celix_bundle_context_t* celix_dmComponent_getBundleContext(celix_dm_component_t
 }
 
 
-static celix_status_t executor_create(celix_dm_component_t *component __attribute__((unused)), dm_executor_pt *executor) {
+static celix_status_t executor_create(celix_dm_component_t *component, dm_executor_pt *executor) {
     celix_status_t status = CELIX_SUCCESS;
 
-    *executor = malloc(sizeof(**executor));
+    *executor = calloc(1, sizeof(**executor));
     if (!*executor) {
         status = CELIX_ENOMEM;
     } else {
+        (*executor)->component = component;
         (*executor)->workQueue = celix_arrayList_create();
         pthread_mutex_init(&(*executor)->mutex, NULL);
+        pthread_cond_init(&(*executor)->idle, NULL);
         (*executor)->runningThreadSet = false;
+        if (component->context != NULL) {
+            (*executor)->useFrameworkExecutor = celix_bundleContext_getPropertyAsBool(component->context, CELIX_DM_COMPONENT_USE_EXECUTOR, false);
+        }
     }
 
     return status;
 }
 
+static void executor_free(dm_executor_pt executor) {
+    pthread_mutex_destroy(&executor->mutex);
+    pthread_cond_destroy(&executor->idle);
+    celix_arrayList_destroy(executor->workQueue);
+    free(executor);
+}
+
 static void executor_destroy(dm_executor_pt executor) {
 
 	if (executor) {
-		pthread_mutex_destroy(&executor->mutex);
-		celix_arrayList_destroy(executor->workQueue);
-
-		free(executor);
+		pthread_mutex_lock(&executor->mutex);
+		//note a strand task which was run inline can still be queued on the framework executor
+		bool freeNow = executor->nrOfSubmittedStrands == 0;
+		executor->destroyed = true;
+		pthread_mutex_unlock(&executor->mutex);
+		if (freeNow) {
+			executor_free(executor);
+		}
 	}
 }
 
-static celix_status_t executor_schedule(dm_executor_pt executor, celix_dm_component_t *component, void (*command), void *data) {
+/**
+ * Waits until no thread is running -or is scheduled to run- the work queue, unless called from the running thread.
+ * If called from a framework executor worker while the strand is still queued, the strand is run inline, because the
+ * queued strand task could be waiting for the calling worker.
+ */
+static void executor_waitForIdle(dm_executor_pt executor) {
+    bool calledFromWorker = executor->useFrameworkExecutor && celix_framework_isExecutorThread(executor->component->context->framework);
+    executor_runQueuedStrandOrWaitForIdle(executor, calledFromWorker);
+}
+
+/**
+ * If runQueuedStrand is true and the strand is still queued, claims the strand and runs the work queue inline.
+ * Otherwise waits until no thread is running the work queue, unless called from the running thread.
+ */
+static void executor_runQueuedStrandOrWaitForIdle(dm_executor_pt executor, bool runQueuedStrand) {
+    pthread_mutex_lock(&executor->mutex);
+    bool calledFromRunningThread = executor->running && pthread_equal(executor->runningThread, pthread_self());
+    if (runQueuedStrand && executor->strandQueued) {
+        executor->strandQueued = false;
+        pthread_mutex_unlock(&executor->mutex);
+        executor_runTasks(executor, pthread_self());
+        pthread_mutex_lock(&executor->mutex);
+    }
+    while (!calledFromRunningThread && executor->runningThreadSet) {
+        pthread_cond_wait(&executor->idle, &executor->mutex);
+    }
+    pthread_mutex_unlock(&executor->mutex);
+}
+
+/**
+ * Removes the queued events of the dependency from the work queue.
+ */
+static void executor_removeDependencyEvents(dm_executor_pt executor, celix_dm_service_dependency_t *dependency) {
+    pthread_mutex_lock(&executor->mutex);
+    int i = 0;
+    while (i < celix_arrayList_size(executor->workQueue)) {
+        dm_executor_task_t *entry = celix_arrayList_get(executor->workQueue, i);
+        dm_handle_event_type_pt data = entry->data;
+        if (entry->command == (void*)component_handleEventTask && data->dependency == dependency) {
+            celix_arrayList_removeAt(executor->workQueue, i);
+            event_destroy(&data->event);
+            if (data->newEvent != NULL) {
+                event_destroy(&data->newEvent);
+            }
+            free(data);
+            free(entry);
+        } else {
+            ++i;
+        }
+    }
+    pthread_mutex_unlock(&executor->mutex);
+}
+
+static celix_status_t executor_schedule(dm_executor_pt executor, celix_dm_component_t *component, void (*command), void *data, bool deferrable) {
     celix_status_t status = CELIX_SUCCESS;
 
     dm_executor_task_t *task = NULL;
@@ -1358,6 +1488,7 @@ static celix_status_t executor_schedule(dm_executor_pt executor, celix_dm_compon
         task->component = component;
         task->command = command;
         task->data = data;
+        task->deferrable = deferrable;
 
         pthread_mutex_lock(&executor->mutex);
         celix_arrayList_add(executor->workQueue, task);
@@ -1367,7 +1498,7 @@ static celix_status_t executor_schedule(dm_executor_pt executor, celix_dm_compon
     return status;
 }
 
-static celix_status_t executor_executeTask(dm_executor_pt executor, celix_dm_component_t *component, void (*command), void *data) {
+static celix_status_t executor_executeTask(dm_executor_pt executor, celix_dm_component_t *component, void (*command), void *data, bool deferrable) {
     celix_status_t status = CELIX_SUCCESS;
 
     // Check thread and executor thread, if the same, execute immediately.
@@ -1380,62 +1511,102 @@ static celix_status_t executor_executeTask(dm_executor_pt executor, celix_dm_com
 //    pthread_mutex_unlock(&executor->mutex);
 
     // For now, just schedule.
-    executor_schedule(executor, component, command, data);
-    executor_execute(executor);
+    executor_schedule(executor, component, command, data, deferrable);
+    executor_execute(executor, deferrable);
 
     return status;
 }
 
-static celix_status_t executor_execute(dm_executor_pt executor) {
+static void executor_runStrand(void *data) {
+    dm_executor_pt executor = data;
+    pthread_mutex_lock(&executor->mutex);
+    executor->nrOfSubmittedStrands -= 1;
+    bool run = executor->strandQueued;
+    executor->strandQueued = false;
+    bool freeExecutor = executor->destroyed && executor->nrOfSubmittedStrands == 0;
+    pthread_mutex_unlock(&executor->mutex);
+    if (run) {
+        executor_runTasks(executor, pthread_self());
+    } else if (freeExecutor) {
+        executor_free(executor);
+    }
+}
+
+static celix_status_t executor_execute(dm_executor_pt executor, bool deferrable) {
     celix_status_t status = CELIX_SUCCESS;
     pthread_t currentThread = pthread_self();
 
     pthread_mutex_lock(&executor->mutex);
     bool execute = false;
     if (!executor->runningThreadSet) {
-        executor->runningThread = currentThread;
         executor->runningThreadSet = true;
         execute = true;
     }
     pthread_mutex_unlock(&executor->mutex);
+    if (execute && executor->useFrameworkExecutor && deferrable) {
+        //note removals and stop are still run on the calling thread if possible, so that a removed service is
+        //no longer used when the service tracker callback returns.
+        pthread_mutex_lock(&executor->mutex);
+        executor->strandQueued = true;
+        executor->nrOfSubmittedStrands += 1;
+        pthread_mutex_unlock(&executor->mutex);
+        if (celix_framework_submitTask(executor->component->context->framework, "celix_dm_component", executor, executor_runStrand) == CELIX_SUCCESS) {
+            execute = false;
+        } else {
+            pthread_mutex_lock(&executor->mutex);
+            executor->strandQueued = false;
+            executor->nrOfSubmittedStrands -= 1;
+            pthread_mutex_unlock(&executor->mutex);
+        }
+    }
     if (execute) {
         executor_runTasks(executor, currentThread);
+    } else if (executor->useFrameworkExecutor && !deferrable) {
+        //a removal or stop must be handled before returning, also when the strand is queued or running: run the
+        //queued strand inline or wait until the strand running on another thread is done.
+        executor_runQueuedStrandOrWaitForIdle(executor, true);
     }
 
     return status;
 }
 
-static celix_status_t executor_runTasks(dm_executor_pt executor, pthread_t currentThread __attribute__((unused))) {
+static celix_status_t executor_runTasks(dm_executor_pt executor, pthread_t currentThread) {
     celix_status_t status = CELIX_SUCCESS;
-//    bool execute = false;
-
-    dm_executor_task_t *entry = NULL;
+    celix_dm_component_t *component = executor->component;
 
     pthread_mutex_lock(&executor->mutex);
-    if (celix_arrayList_size(executor->workQueue) > 0) {
-	    entry = celix_arrayList_get(executor->workQueue, 0);
-	    celix_arrayList_removeAt(executor->workQueue, 0);
-    }
+    executor->runningThread = currentThread;
+    executor->running = true;
     pthread_mutex_unlock(&executor->mutex);
 
-    while (entry != NULL) {
-	    entry->command(entry->component, entry->data);
-	    free(entry);
-
-	    pthread_mutex_lock(&executor->mutex);
-	    if (celix_arrayList_size(executor->workQueue) > 0) {
-		    entry = celix_arrayList_get(executor->workQueue, 0);
-		    celix_arrayList_removeAt(executor->workQueue, 0);
-	    } else {
-		    entry = NULL;
-	    }
-	    pthread_mutex_unlock(&executor->mutex);
-    }
+    while (true) {
+        dm_executor_task_t *entry = NULL;
+        pthread_mutex_lock(&executor->mutex);
+        if (celix_arrayList_size(executor->workQueue) > 0) {
+            entry = celix_arrayList_get(executor->workQueue, 0);
+            celix_arrayList_removeAt(executor->workQueue, 0);
+        } else if (!executor->stateChangePending) {
+            //done. Note the work queue is released under the same lock as the empty check, so that no task is missed
+            executor->running = false;
+            executor->runningThreadSet = false;
+            pthread_cond_broadcast(&executor->idle);
+            pthread_mutex_unlock(&executor->mutex);
+            break;
+        }
+        pthread_mutex_unlock(&executor->mutex);
 
+        if (executor->stateChangePending && (entry == NULL || !entry->deferrable)) {
+            executor->stateChangePending = false;
+            component_handleChange(component);
+        }
 
-    pthread_mutex_lock(&executor->mutex);
-    executor->runningThreadSet = false;
-    pthread_mutex_unlock(&executor->mutex);
+        if (entry != NULL) {
+            executor->deferStateChange = entry->deferrable;
+            entry->command(entry->component, entry->data);
+            executor->deferStateChange = false;
+            free(entry);
+        }
+    }
 
     return status;
 }
@@ -41,6 +41,12 @@ celix_status_t celix_private_dmComponent_stop(celix_dm_component_t *component);
 
 celix_status_t celix_private_dmComponent_handleEvent(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency, dm_event_pt event);
 
+/**
+ * Sets the required flag of a dependency of the component and updates the dependency availability counters of
+ * the component.
+ */
+void celix_private_dmComponent_setDependencyRequired(celix_dm_component_t *component, celix_dm_service_dependency_t *dependency, bool required);
+
 #ifdef __cplusplus
 }
 #endif
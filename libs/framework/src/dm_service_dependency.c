@@ -97,7 +97,11 @@ celix_status_t celix_dmServiceDependency_setRequired(celix_dm_service_dependency
 	}
 
 	if (status == CELIX_SUCCESS) {
-		dependency->required = required;
+		if (dependency->component != NULL) {
+			celix_private_dmComponent_setDependencyRequired(dependency->component, dependency, required);
+		} else {
+			dependency->required = required;
+		}
 	}
 
 	return status;
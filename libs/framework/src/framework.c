@@ -20,7 +20,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
+#include <time.h>
 #include "celixbool.h"
 #include <uuid/uuid.h>
 #include <assert.h>
@@ -39,6 +41,7 @@
 #include "bundle_context_private.h"
 #include "service_tracker.h"
 #include "celix_library_loader.h"
+#include "service_registry_private.h"
 
 typedef celix_status_t (*create_function_fp)(bundle_context_t *context, void **userData);
 typedef celix_status_t (*start_function_fp)(void *userData, bundle_context_t *context);
@@ -168,6 +171,8 @@ celix_status_t fw_populateDependentGraph(framework_pt framework, bundle_pt expor
 celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e, bundle_pt bundle);
 celix_status_t fw_fireFrameworkEvent(framework_pt framework, framework_event_type_e eventType, bundle_pt bundle, celix_status_t errorCode);
 static void *fw_eventDispatcher(void *fw);
+static void *fw_serviceEventThread(void *fw);
+static void fw_stopServiceEventThread(framework_pt framework);
 
 celix_status_t fw_invokeBundleListener(framework_pt framework, bundle_listener_pt listener, bundle_event_pt event, bundle_pt bundle);
 celix_status_t fw_invokeFrameworkListener(framework_pt framework, framework_listener_pt listener, framework_event_pt event, bundle_pt bundle);
@@ -181,7 +186,15 @@ static celix_status_t frameworkActivator_stop(void * userData, bundle_context_t
 static celix_status_t frameworkActivator_destroy(void * userData, bundle_context_t *context);
 
 static void framework_autoStartConfiguredBundles(bundle_context_t *fwCtx);
+static void framework_startTimer(framework_pt framework, bundle_context_t *fwCtx);
+static void framework_stopTimer(framework_pt framework);
+static void framework_startExecutor(framework_pt framework, bundle_context_t *fwCtx);
+static void framework_stopExecutor(framework_pt framework);
+static void framework_registerRegistryStatisticsService(framework_pt framework, bundle_context_t *fwCtx);
+static void framework_unregisterRegistryStatisticsService(framework_pt framework);
 static void framework_autoStartConfiguredBundlesForList(bundle_context_t *fwCtx, const char *autoStart);
+static void framework_autoStartConfiguredBundlesForListInParallel(bundle_context_t *fwCtx, const char *autoStart, int nrOfThreads);
+static char* resolveBundleLocation(celix_framework_t *fw, const char *bndLoc, const char *p);
 
 struct fw_refreshHelper {
     framework_pt framework;
@@ -215,40 +228,54 @@ enum event_type {
 
 typedef enum event_type event_type_e;
 
-struct request {
-	event_type_e type;
-	array_list_pt listeners;
+#define FW_EVENT_NAME_BUFFER_SIZE 128
+#define FW_EVENT_ERROR_BUFFER_SIZE 256
+#define FW_EVENT_RING_INITIAL_CAPACITY 256
+#define FW_EVENT_DISPATCH_BATCH_SIZE 64
 
+/**
+ * Preallocated bundle or framework event record, stored by value in the dispatcher event ring.
+ */
+struct celix_framework_event_record {
+	event_type_e type;
 	int eventType;
 	long bundleId;
-	char* bundleSymbolicName;
+	char bundleSymbolicName[FW_EVENT_NAME_BUFFER_SIZE];
+	char *longBundleSymbolicName; //only allocated if the symbolic name does not fit in bundleSymbolicName
 	celix_status_t errorCode;
-	char *error;
-
-	char *filter;
+	char error[FW_EVENT_ERROR_BUFFER_SIZE];
 };
 
-typedef struct request *request_pt;
+typedef struct celix_framework_event_record celix_framework_event_record_t;
 
 typedef struct celix_fw_service_listener_entry {
     //only set during creating
     celix_bundle_t *bundle;
 	celix_service_listener_t *listener;
 	celix_filter_t *filter;
+	const char *serviceName; //mandatory objectClass of the filter (owned by the filter), NULL if not present
 
     celix_thread_mutex_t mutex; //protects retainedReferences and useCount
-	celix_array_list_t* retainedReferences;
+	celix_long_hash_map_t* retainedReferences; //key = service id, value = retained service reference
 	celix_thread_cond_t useCond;
     size_t useCount;
+    bool removed; //true if the listener is removed and should not be called anymore
 } celix_fw_service_listener_entry_t;
 
+typedef struct celix_fw_service_event {
+    celix_service_event_type_t type;
+    service_registration_t *registration; //retained
+    long seqNr;
+} celix_fw_service_event_t;
+
 static inline celix_fw_service_listener_entry_t* listener_create(celix_bundle_t *bnd, const char *filter, celix_service_listener_t *listener) {
     celix_fw_service_listener_entry_t *entry = calloc(1, sizeof(*entry));
-    entry->retainedReferences = celix_arrayList_create();
+    entry->retainedReferences = celix_longHashMap_create();
     entry->listener = listener;
     entry->bundle = bnd;
     if (filter != NULL) {
         entry->filter = celix_filter_create(filter);
+        entry->serviceName = celix_filter_findMandatoryEqualityValue(entry->filter, OSGI_FRAMEWORK_OBJECTCLASS);
     }
 
     entry->useCount = 1;
@@ -283,15 +310,13 @@ static inline void listener_waitAndDestroy(celix_framework_t *framework, celix_f
 
     //use count == 0 -> safe to destroy.
     //destroy
-    int rSize = arrayList_size(entry->retainedReferences);
-    for (int i = 0; i < rSize; i += 1) {
-        service_reference_pt ref = arrayList_get(entry->retainedReferences, i);
-        if (ref != NULL) {
-            serviceRegistry_ungetServiceReference(framework->registry, entry->bundle, ref); // decrease retain counter
-        }
+    celix_long_hash_map_iterator_t iter = celix_longHashMap_begin(entry->retainedReferences);
+    for (; !celix_longHashMapIterator_isEnd(&iter); celix_longHashMapIterator_next(&iter)) {
+        service_reference_pt ref = iter.value;
+        serviceRegistry_ungetServiceReference(framework->registry, entry->bundle, ref); // decrease retain counter
     }
     celix_filter_destroy(entry->filter);
-    celix_arrayList_destroy(entry->retainedReferences);
+    celix_longHashMap_destroy(entry->retainedReferences);
     celixThreadMutex_destroy(&entry->mutex);
     celixThreadCondition_destroy(&entry->useCond);
     free(entry);
@@ -327,6 +352,8 @@ celix_status_t framework_create(framework_pt *framework, properties_pt config) {
         status = CELIX_DO_IF(status, celixThreadMutex_create(&(*framework)->bundleListenerLock, NULL));
         status = CELIX_DO_IF(status, celixThreadMutex_create(&(*framework)->installedBundles.mutex, NULL));
         status = CELIX_DO_IF(status, celixThreadCondition_init(&(*framework)->dispatcher.cond, NULL));
+        status = CELIX_DO_IF(status, celixThreadMutex_create(&(*framework)->serviceEvents.mutex, NULL));
+        status = CELIX_DO_IF(status, celixThreadCondition_init(&(*framework)->serviceEvents.cond, NULL));
         if (status == CELIX_SUCCESS) {
             (*framework)->bundle = NULL;
             (*framework)->registry = NULL;
@@ -338,9 +365,24 @@ celix_status_t framework_create(framework_pt *framework, properties_pt config) {
             (*framework)->installRequestMap = hashMap_create(utils_stringHash, utils_stringHash, utils_stringEquals, utils_stringEquals);
             (*framework)->installedBundles.entries = celix_arrayList_create();
             (*framework)->serviceListeners = NULL;
+            (*framework)->serviceListenersByServiceName = NULL;
+            (*framework)->serviceListenersWithoutServiceName = NULL;
             (*framework)->bundleListeners = NULL;
             (*framework)->frameworkListeners = NULL;
-            (*framework)->dispatcher.requests = NULL;
+            (*framework)->dispatcher.events = NULL;
+            (*framework)->dispatcher.capacity = 0;
+            (*framework)->dispatcher.head = 0;
+            (*framework)->dispatcher.size = 0;
+            (*framework)->timer.timer = NULL;
+            (*framework)->timer.svcId = -1L;
+            (*framework)->executor.executor = NULL;
+            (*framework)->executor.svcId = -1L;
+            (*framework)->registryStatistics.statistics = NULL;
+            (*framework)->registryStatistics.svcId = -1L;
+            (*framework)->serviceEvents.async = false;
+            (*framework)->serviceEvents.active = false;
+            (*framework)->serviceEvents.events = NULL;
+            (*framework)->serviceEvents.removedListeners = NULL;
             (*framework)->configurationMap = config;
             (*framework)->logger = logger;
 
@@ -375,6 +417,7 @@ celix_status_t framework_destroy(framework_pt framework) {
     //has not been joined yet.
     celixThread_join(framework->shutdown.thread, NULL);
 
+    fw_stopServiceEventThread(framework);
 
     celixThreadMutex_lock(&framework->installedBundles.mutex);
     for (int i = 0; i < celix_arrayList_size(framework->installedBundles.entries); ++i) {
@@ -424,6 +467,7 @@ celix_status_t framework_destroy(framework_pt framework) {
 	hashMap_destroy(framework->installRequestMap, false, false);
 
 	serviceRegistry_destroy(framework->registry);
+	celix_registryStatistics_destroy(framework->registryStatistics.statistics);
 
     if (framework->serviceListeners != NULL) {
         int size = celix_arrayList_size(framework->serviceListeners);
@@ -434,6 +478,16 @@ celix_status_t framework_destroy(framework_pt framework) {
         }
         arrayList_destroy(framework->serviceListeners);
     }
+    if (framework->serviceListenersByServiceName != NULL) {
+        celix_string_hash_map_iterator_t iter = celix_stringHashMap_begin(framework->serviceListenersByServiceName);
+        for (; !celix_stringHashMapIterator_isEnd(&iter); celix_stringHashMapIterator_next(&iter)) {
+            celix_arrayList_destroy(iter.value);
+        }
+        celix_stringHashMap_destroy(framework->serviceListenersByServiceName);
+    }
+    if (framework->serviceListenersWithoutServiceName != NULL) {
+        celix_arrayList_destroy(framework->serviceListenersWithoutServiceName);
+    }
     if (framework->bundleListeners) {
         arrayList_destroy(framework->bundleListeners);
     }
@@ -441,14 +495,12 @@ celix_status_t framework_destroy(framework_pt framework) {
         arrayList_destroy(framework->frameworkListeners);
     }
 
-	if(framework->dispatcher.requests){
-	    int i;
-	    for (i = 0; i < arrayList_size(framework->dispatcher.requests); i++) {
-	        request_pt request = arrayList_get(framework->dispatcher.requests, i);
-	        free(request->bundleSymbolicName);
-	        free(request);
+	if (framework->dispatcher.events != NULL) {
+	    for (size_t i = 0; i < framework->dispatcher.size; ++i) {
+	        celix_framework_event_record_t *record = &framework->dispatcher.events[(framework->dispatcher.head + i) % framework->dispatcher.capacity];
+	        free(record->longBundleSymbolicName);
 	    }
-	    arrayList_destroy(framework->dispatcher.requests);
+	    free(framework->dispatcher.events);
 	}
 
 	bundleCache_destroy(&framework->cache);
@@ -458,6 +510,8 @@ celix_status_t framework_destroy(framework_pt framework) {
     celixThreadMutex_destroy(&framework->frameworkListenersLock);
 	celixThreadMutex_destroy(&framework->bundleListenerLock);
 	celixThreadMutex_destroy(&framework->dispatcher.mutex);
+	celixThreadMutex_destroy(&framework->serviceEvents.mutex);
+	celixThreadCondition_destroy(&framework->serviceEvents.cond);
 	celixThreadMutex_destroy(&framework->shutdown.mutex);
 	celixThreadCondition_destroy(&framework->shutdown.cond);
 
@@ -492,10 +546,32 @@ celix_status_t fw_init(framework_pt framework) {
 
 	celix_status_t status = CELIX_SUCCESS;
 	status = CELIX_DO_IF(status, arrayList_create(&framework->serviceListeners)); //entry is celix_fw_service_listener_entry_t
+	if (status == CELIX_SUCCESS) {
+	    framework->serviceListenersByServiceName = celix_stringHashMap_create();
+	    framework->serviceListenersWithoutServiceName = celix_arrayList_create();
+	}
 	status = CELIX_DO_IF(status, arrayList_create(&framework->bundleListeners));
 	status = CELIX_DO_IF(status, arrayList_create(&framework->frameworkListeners));
-	status = CELIX_DO_IF(status, arrayList_create(&framework->dispatcher.requests));
+	if (status == CELIX_SUCCESS) {
+	    framework->dispatcher.capacity = FW_EVENT_RING_INITIAL_CAPACITY;
+	    framework->dispatcher.events = calloc(framework->dispatcher.capacity, sizeof(*framework->dispatcher.events));
+	    framework->dispatcher.head = 0;
+	    framework->dispatcher.size = 0;
+	}
 	status = CELIX_DO_IF(status, celixThread_create(&framework->dispatcher.thread, NULL, fw_eventDispatcher, framework));
+	if (status == CELIX_SUCCESS) {
+	    const char *async = NULL;
+	    fw_getProperty(framework, CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS, "false", &async);
+	    if (async != NULL && strcasecmp(async, "true") == 0) {
+	        framework->serviceEvents.events = celix_arrayList_create();
+	        framework->serviceEvents.removedListeners = celix_arrayList_create();
+	        framework->serviceEvents.nextSeqNr = 1L;
+	        framework->serviceEvents.deliveredSeqNr = 0L;
+	        framework->serviceEvents.active = true;
+	        framework->serviceEvents.async = true;
+	        status = celixThread_create(&framework->serviceEvents.thread, NULL, fw_serviceEventThread, framework);
+	    }
+	}
 	status = CELIX_DO_IF(status, bundle_getState(framework->bundle, &state));
 	if (status == CELIX_SUCCESS) {
 	    if ((state == OSGI_FRAMEWORK_BUNDLE_INSTALLED) || (state == OSGI_FRAMEWORK_BUNDLE_RESOLVED)) {
@@ -559,6 +635,17 @@ celix_status_t fw_init(framework_pt framework) {
     }
 
     status = CELIX_DO_IF(status, serviceRegistry_create(framework, fw_serviceChanged, &framework->registry));
+    if (status == CELIX_SUCCESS) {
+        celix_serviceRegistry_setServiceChangedBatchCallback(framework->registry, fw_serviceChangedBatch);
+    }
+    if (status == CELIX_SUCCESS) {
+        const char *statistics = NULL;
+        fw_getProperty(framework, CELIX_FRAMEWORK_REGISTRY_STATISTICS, "false", &statistics);
+        if (statistics != NULL && strcasecmp(statistics, "true") == 0) {
+            framework->registryStatistics.statistics = celix_registryStatistics_create();
+            celix_serviceRegistry_setStatistics(framework->registry, framework->registryStatistics.statistics);
+        }
+    }
     status = CELIX_DO_IF(status, framework_setBundleStateAndNotify(framework, framework->bundle, OSGI_FRAMEWORK_BUNDLE_STARTING));
 
     bundle_context_t *context = NULL;
@@ -638,24 +725,122 @@ celix_status_t framework_start(framework_pt framework) {
 
     bundle_context_t *fwCtx = framework_getContext(framework);
 	if (fwCtx != NULL) {
+        framework_startTimer(framework, fwCtx);
+        framework_startExecutor(framework, fwCtx);
+        framework_registerRegistryStatisticsService(framework, fwCtx);
         framework_autoStartConfiguredBundles(fwCtx);
     }
 
 	return status;
 }
 
+/**
+ * Creates the framework timer and registers it as timer service, so that it is available for the auto started bundles.
+ */
+static void framework_startTimer(framework_pt framework, bundle_context_t *fwCtx) {
+    if (framework->timer.timer != NULL) {
+        return;
+    }
+    double resolution = celix_bundleContext_getPropertyAsDouble(fwCtx, CELIX_FRAMEWORK_TIMER_RESOLUTION_IN_SECONDS, CELIX_TIMER_DEFAULT_RESOLUTION_IN_SECONDS);
+    framework->timer.timer = celix_timer_create(resolution);
+    celix_timer_initService(framework->timer.timer, &framework->timer.svc);
+
+    celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
+    opts.svc = &framework->timer.svc;
+    opts.serviceName = CELIX_TIMER_SERVICE_NAME;
+    opts.serviceVersion = CELIX_TIMER_SERVICE_VERSION;
+    framework->timer.svcId = celix_bundleContext_registerServiceWithOptions(fwCtx, &opts);
+}
+
+/**
+ * Unregisters the timer service and destroys the timer. Called after the executor is stopped.
+ */
+static void framework_stopTimer(framework_pt framework) {
+    if (framework->timer.timer != NULL) {
+        celix_bundleContext_unregisterService(framework_getContext(framework), framework->timer.svcId);
+        celix_timer_destroy(framework->timer.timer);
+        framework->timer.timer = NULL;
+        framework->timer.svcId = -1L;
+    }
+}
+
+/**
+ * Creates the framework executor and registers it as executor service, so that it is available for the auto started
+ * bundles.
+ */
+static void framework_startExecutor(framework_pt framework, bundle_context_t *fwCtx) {
+    if (framework->executor.executor != NULL) {
+        return;
+    }
+    long nrOfThreads = celix_bundleContext_getPropertyAsLong(fwCtx, CELIX_FRAMEWORK_EXECUTOR_NR_OF_THREADS, 0L);
+    if (nrOfThreads <= 0) {
+        nrOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    framework->executor.executor = celix_executor_create((int)nrOfThreads, framework->timer.timer);
+    celix_executor_initService(framework->executor.executor, &framework->executor.svc);
+
+    celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
+    opts.svc = &framework->executor.svc;
+    opts.serviceName = CELIX_EXECUTOR_SERVICE_NAME;
+    opts.serviceVersion = CELIX_EXECUTOR_SERVICE_VERSION;
+    framework->executor.svcId = celix_bundleContext_registerServiceWithOptions(fwCtx, &opts);
+}
+
+/**
+ * Unregisters the executor service and destroys the executor. Called after all bundles -except the framework
+ * bundle- are stopped.
+ */
+static void framework_stopExecutor(framework_pt framework) {
+    if (framework->executor.executor != NULL) {
+        celix_bundleContext_unregisterService(framework_getContext(framework), framework->executor.svcId);
+        celix_executor_destroy(framework->executor.executor);
+        framework->executor.executor = NULL;
+        framework->executor.svcId = -1L;
+    }
+}
+
+static void framework_registerRegistryStatisticsService(framework_pt framework, bundle_context_t *fwCtx) {
+    if (framework->registryStatistics.statistics == NULL || framework->registryStatistics.svcId >= 0) {
+        return;
+    }
+    celix_registryStatistics_initService(framework->registryStatistics.statistics, &framework->registryStatistics.svc);
+
+    celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
+    opts.svc = &framework->registryStatistics.svc;
+    opts.serviceName = CELIX_REGISTRY_STATISTICS_SERVICE_NAME;
+    opts.serviceVersion = CELIX_REGISTRY_STATISTICS_SERVICE_VERSION;
+    framework->registryStatistics.svcId = celix_bundleContext_registerServiceWithOptions(fwCtx, &opts);
+}
+
+static void framework_unregisterRegistryStatisticsService(framework_pt framework) {
+    if (framework->registryStatistics.svcId >= 0) {
+        celix_bundleContext_unregisterService(framework_getContext(framework), framework->registryStatistics.svcId);
+        framework->registryStatistics.svcId = -1L;
+    }
+}
+
 static void framework_autoStartConfiguredBundles(bundle_context_t *fwCtx) {
     const char* autoStart = NULL;
     const char* cosgiKeys[] = {"cosgi.auto.start.0","cosgi.auto.start.1","cosgi.auto.start.2","cosgi.auto.start.3","cosgi.auto.start.4","cosgi.auto.start.5"};
     const char* celixKeys[] = {CELIX_AUTO_START_0, CELIX_AUTO_START_1, CELIX_AUTO_START_2, CELIX_AUTO_START_3, CELIX_AUTO_START_4, CELIX_AUTO_START_5};
     size_t len = 6;
+
+    long nrOfThreads = celix_bundleContext_getPropertyAsLong(fwCtx, CELIX_AUTO_START_NR_OF_THREADS, 1L);
+    if (nrOfThreads <= 0) {
+        nrOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
     for (int i = 0; i < len; ++i) {
         bundleContext_getProperty(fwCtx, celixKeys[i], &autoStart);
         if (autoStart == NULL) {
             bundleContext_getProperty(fwCtx, cosgiKeys[i], &autoStart);
         }
         if (autoStart != NULL) {
-            framework_autoStartConfiguredBundlesForList(fwCtx, autoStart);
+            if (nrOfThreads > 1) {
+                framework_autoStartConfiguredBundlesForListInParallel(fwCtx, autoStart, (int)nrOfThreads);
+            } else {
+                framework_autoStartConfiguredBundlesForList(fwCtx, autoStart);
+            }
         }
     }
 }
@@ -697,6 +882,200 @@ static void framework_autoStartConfiguredBundlesForList(bundle_context_t *fwCtx,
     arrayList_destroy(installed);
 }
 
+typedef struct celix_framework_auto_start_entry {
+    char *location; //resolved bundle location
+    long bndId; //reserved bundle id, -1 if the bundle is already installed or the location is a duplicate
+    bundle_archive_pt archive; //created in parallel
+    celix_bundle_t *bnd;
+    celix_status_t status;
+    double installTime; //in ms
+    double loadTime; //in ms
+    double startTime; //in ms
+} celix_framework_auto_start_entry_t;
+
+typedef struct celix_framework_auto_start_pool {
+    framework_pt framework;
+    celix_array_list_t *entries; //celix_framework_auto_start_entry_t*
+    void (*work)(framework_pt framework, celix_framework_auto_start_entry_t *entry);
+
+    celix_thread_mutex_t mutex; //protects nextEntry
+    int nextEntry;
+} celix_framework_auto_start_pool_t;
+
+static double framework_elapsedMs(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+static void* framework_autoStartWorker(void *data) {
+    celix_framework_auto_start_pool_t *pool = data;
+    while (true) {
+        celixThreadMutex_lock(&pool->mutex);
+        int index = pool->nextEntry++;
+        celixThreadMutex_unlock(&pool->mutex);
+        if (index >= celix_arrayList_size(pool->entries)) {
+            break;
+        }
+        pool->work(pool->framework, celix_arrayList_get(pool->entries, index));
+    }
+    return NULL;
+}
+
+/**
+ * Runs work for every auto start entry, using (at most) nrOfThreads threads.
+ */
+static void framework_autoStartRunInParallel(framework_pt framework, celix_array_list_t *entries, int nrOfThreads, void (*work)(framework_pt framework, celix_framework_auto_start_entry_t *entry)) {
+    celix_framework_auto_start_pool_t pool;
+    pool.framework = framework;
+    pool.entries = entries;
+    pool.work = work;
+    pool.nextEntry = 0;
+    celixThreadMutex_create(&pool.mutex, NULL);
+
+    int size = celix_arrayList_size(entries);
+    int nrOfWorkers = nrOfThreads < size ? nrOfThreads : size;
+    celix_thread_t workers[nrOfWorkers > 0 ? nrOfWorkers : 1];
+    for (int i = 1; i < nrOfWorkers; ++i) {
+        celixThread_create(&workers[i], NULL, framework_autoStartWorker, &pool);
+    }
+    framework_autoStartWorker(&pool); //note calling thread is also a worker
+    for (int i = 1; i < nrOfWorkers; ++i) {
+        celixThread_join(workers[i], NULL);
+    }
+
+    celixThreadMutex_destroy(&pool.mutex);
+}
+
+static void framework_autoStartCreateArchive(framework_pt framework, celix_framework_auto_start_entry_t *entry) {
+    if (entry->bndId >= 0) {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        entry->status = bundleCache_createArchive(framework->cache, entry->bndId, entry->location, NULL, &entry->archive);
+        if (entry->status != CELIX_SUCCESS && entry->archive != NULL) {
+            bundleArchive_destroy(entry->archive);
+            entry->archive = NULL;
+        }
+        entry->installTime = framework_elapsedMs(&start);
+    }
+}
+
+/**
+ * Returns whether the bundle imports libraries (Import-Library manifest header). The libraries of such a bundle can
+ * depend on the libraries exported by another bundle and are therefore only loaded when the bundle is resolved.
+ */
+static bool framework_bundleImportsLibraries(bundle_pt bundle) {
+    bundle_archive_pt archive = NULL;
+    bundle_revision_pt revision = NULL;
+    manifest_pt manifest = NULL;
+    celix_status_t status = bundle_getArchive(bundle, &archive);
+    status = CELIX_DO_IF(status, bundleArchive_getCurrentRevision(archive, &revision));
+    status = CELIX_DO_IF(status, bundleRevision_getManifest(revision, &manifest));
+    //note if the manifest cannot be read, the libraries are also not preloaded
+    return status != CELIX_SUCCESS || manifest_getValue(manifest, OSGI_FRAMEWORK_IMPORT_LIBRARY) != NULL;
+}
+
+static void framework_autoStartLoadLibraries(framework_pt framework, celix_framework_auto_start_entry_t *entry) {
+    bundle_state_e state = OSGI_FRAMEWORK_BUNDLE_UNKNOWN;
+    if (entry->bnd != NULL && entry->bndId >= 0 && bundle_getState(entry->bnd, &state) == CELIX_SUCCESS && state == OSGI_FRAMEWORK_BUNDLE_INSTALLED &&
+            !framework_bundleImportsLibraries(entry->bnd)) {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (framework_loadBundleLibraries(framework, entry->bnd) == CELIX_SUCCESS) {
+            entry->bnd->librariesPreloaded = true;
+        }
+        entry->loadTime = framework_elapsedMs(&start);
+    }
+}
+
+/**
+ * Installs and starts the bundles of a run level, using nrOfThreads threads to extract the bundle archives and to
+ * load the bundle libraries. Registering the installed bundles, resolving and starting them is still done by the
+ * calling thread in the configured order, so that the bundle ids and the start order are the same as for a
+ * sequential auto start. The libraries of bundles which import libraries are not loaded in parallel, but when the
+ * bundle is resolved (after the bundles exporting the libraries).
+ */
+static void framework_autoStartConfiguredBundlesForListInParallel(bundle_context_t *fwCtx, const char *autoStartIn, int nrOfThreads) {
+    framework_pt framework = fwCtx->framework;
+    struct timespec runLevelStart;
+    clock_gettime(CLOCK_MONOTONIC, &runLevelStart);
+
+    const char *paths = NULL;
+    fw_getProperty(framework, CELIX_BUNDLES_PATH_NAME, CELIX_BUNDLES_PATH_DEFAULT, &paths);
+
+    celix_array_list_t *entries = celix_arrayList_create();
+    char *save_ptr = NULL;
+    char *autoStart = strndup(autoStartIn, 1024*1024*10);
+    char *location = autoStart == NULL ? NULL : strtok_r(autoStart, " ", &save_ptr);
+    while (location != NULL) {
+        celix_framework_auto_start_entry_t *entry = calloc(1, sizeof(*entry));
+        entry->bndId = -1L;
+        entry->location = resolveBundleLocation(framework, location, paths);
+        if (entry->location == NULL) {
+            printf("Could not install bundle '%s'\n", location);
+            free(entry);
+        } else {
+            bool duplicate = false;
+            for (int i = 0; i < celix_arrayList_size(entries); ++i) {
+                celix_framework_auto_start_entry_t *visit = celix_arrayList_get(entries, i);
+                duplicate = duplicate || strcmp(visit->location, entry->location) == 0;
+            }
+            if (!duplicate && framework_getBundle(framework, entry->location) == NULL) {
+                entry->bndId = framework_getNextBundleId(framework);
+            }
+            celix_arrayList_add(entries, entry);
+        }
+        location = strtok_r(NULL, " ", &save_ptr);
+    }
+    free(autoStart);
+
+    //extract the bundle archives in parallel
+    framework_autoStartRunInParallel(framework, entries, nrOfThreads, framework_autoStartCreateArchive);
+
+    //install in order
+    int size = celix_arrayList_size(entries);
+    for (int i = 0; i < size; ++i) {
+        celix_framework_auto_start_entry_t *entry = celix_arrayList_get(entries, i);
+        if (entry->bndId >= 0 && entry->archive == NULL) {
+            printf("Could not install bundle '%s'\n", entry->location);
+            continue;
+        }
+        celix_status_t rc;
+        if (entry->archive != NULL) {
+            rc = fw_installBundle2(framework, &entry->bnd, entry->bndId, entry->location, NULL, entry->archive);
+        } else {
+            rc = fw_installBundle(framework, &entry->bnd, entry->location, NULL); //already installed
+        }
+        if (rc != CELIX_SUCCESS) {
+            printf("Could not install bundle '%s'\n", entry->location);
+            entry->bnd = NULL;
+        }
+    }
+
+    //load bundle libraries in parallel
+    framework_autoStartRunInParallel(framework, entries, nrOfThreads, framework_autoStartLoadLibraries);
+
+    //resolve and start in order
+    for (int i = 0; i < size; ++i) {
+        celix_framework_auto_start_entry_t *entry = celix_arrayList_get(entries, i);
+        if (entry->bnd != NULL) {
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            celix_status_t rc = bundle_startWithOptions(entry->bnd, 0);
+            entry->startTime = framework_elapsedMs(&start);
+            if (rc != CELIX_SUCCESS) {
+                printf("Could not start bundle %li\n", celix_bundle_getId(entry->bnd));
+            }
+            fw_log(framework->logger, OSGI_FRAMEWORK_LOG_DEBUG, "Auto start of bundle %s [%li]: install %.3f ms, load libraries %.3f ms, resolve & start %.3f ms",
+                   entry->location, celix_bundle_getId(entry->bnd), entry->installTime, entry->loadTime, entry->startTime);
+        }
+        free(entry->location);
+        free(entry);
+    }
+    fw_log(framework->logger, OSGI_FRAMEWORK_LOG_INFO, "Auto started %i bundles with %i threads in %.3f ms", size, nrOfThreads, framework_elapsedMs(&runLevelStart));
+    celix_arrayList_destroy(entries);
+}
+
 
 celix_status_t framework_stop(framework_pt framework) {
 	return fw_stopBundle(framework, framework->bundle, true);
@@ -1617,11 +1996,46 @@ celix_status_t framework_ungetService(framework_pt framework, bundle_pt bundle,
 	return serviceRegistry_ungetService(framework->registry, bundle, reference, result);
 }
 
+/**
+ * Adds the service listener to the service listener index. Should be called with the serviceListenersLock locked.
+ */
+static void fw_addServiceListenerToIndex(framework_pt framework, celix_fw_service_listener_entry_t *entry) {
+    if (entry->serviceName != NULL) {
+        celix_array_list_t *listeners = celix_stringHashMap_get(framework->serviceListenersByServiceName, entry->serviceName);
+        if (listeners == NULL) {
+            listeners = celix_arrayList_create();
+            celix_stringHashMap_put(framework->serviceListenersByServiceName, entry->serviceName, listeners);
+        }
+        celix_arrayList_add(listeners, entry);
+    } else {
+        celix_arrayList_add(framework->serviceListenersWithoutServiceName, entry);
+    }
+}
+
+/**
+ * Removes the service listener from the service listener index. Should be called with the serviceListenersLock locked.
+ */
+static void fw_removeServiceListenerFromIndex(framework_pt framework, celix_fw_service_listener_entry_t *entry) {
+    if (entry->serviceName != NULL) {
+        celix_array_list_t *listeners = celix_stringHashMap_get(framework->serviceListenersByServiceName, entry->serviceName);
+        if (listeners != NULL) {
+            celix_arrayList_remove(listeners, entry);
+            if (celix_arrayList_size(listeners) == 0) {
+                celix_stringHashMap_remove(framework->serviceListenersByServiceName, entry->serviceName);
+                celix_arrayList_destroy(listeners);
+            }
+        }
+    } else {
+        celix_arrayList_remove(framework->serviceListenersWithoutServiceName, entry);
+    }
+}
+
 void fw_addServiceListener(framework_pt framework, bundle_pt bundle, celix_service_listener_t *listener, const char* sfilter) {
     celix_fw_service_listener_entry_t *fwListener = listener_create(bundle, sfilter, listener);
 
     celixThreadMutex_lock(&framework->serviceListenersLock);
 	arrayList_add(framework->serviceListeners, fwListener);
+	fw_addServiceListenerToIndex(framework, fwListener);
     celixThreadMutex_unlock(&framework->serviceListenersLock);
 
     serviceRegistry_callHooksForListenerFilter(framework->registry, bundle, sfilter, false);
@@ -1640,6 +2054,7 @@ void fw_removeServiceListener(framework_pt framework, bundle_pt bundle, celix_se
         if (visit->listener == listener && visit->bundle == bundle) {
             match = visit;
             arrayList_remove(framework->serviceListeners, i);
+            fw_removeServiceListenerFromIndex(framework, match);
             break;
         }
     }
@@ -1654,8 +2069,17 @@ void fw_removeServiceListener(framework_pt framework, bundle_pt bundle, celix_se
     }
 
     if (match != NULL) {
+        celixThreadMutex_lock(&match->mutex);
+        match->removed = true;
+        celixThreadMutex_unlock(&match->mutex);
         listener_release(match);
-        listener_waitAndDestroy(framework, match);
+        if (framework->serviceEvents.async && celixThread_equals(celixThread_self(), framework->serviceEvents.thread)) {
+            //removed during the delivery of a service event, which can still use the listener entry.
+            //waiting for the listener entry here would deadlock -> destroy after the event is delivered.
+            celix_arrayList_add(framework->serviceEvents.removedListeners, match);
+        } else {
+            listener_waitAndDestroy(framework, match);
+        }
     }
 }
 
@@ -1761,39 +2185,140 @@ celix_status_t fw_removeFrameworkListener(framework_pt framework, bundle_pt bund
     return status;
 }
 
-void fw_serviceChanged(framework_pt framework, celix_service_event_type_t eventType, service_registration_pt registration, properties_pt oldprops) {
-    unsigned int i;
-    celix_fw_service_listener_entry_t *entry;
+/**
+ * Delivers a service event to a single matched listener entry.
+ * moreEventsInBatch is set in the event if more events of the same batch follow for this listener.
+ */
+static void fw_deliverServiceEventToListener(framework_pt framework, celix_fw_service_listener_entry_t *entry, celix_service_event_type_t eventType, service_registration_pt registration, const char *serviceName, bool moreEventsInBatch) {
+    celix_registry_statistics_t *stats = framework->registryStatistics.statistics;
+    long svcId = serviceRegistration_getServiceId(registration);
+    service_reference_pt reference = NULL;
+    celix_service_event_t event;
+
+    //NOTE: that you are never sure that the UNREGISTERED event will by handle by an service_listener. listener could be gone
+    //Every reference retained is therefore stored and called when a service listener is removed from the framework.
+    //The reference retained for the listener is also used for the REGISTERED and UNREGISTERING event itself, so
+    //that those events do not need an additional reference lookup and retain/unget.
+    bool retained = false;
+    if (eventType == OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING) {
+        celixThreadMutex_lock(&entry->mutex);
+        reference = celix_longHashMap_get(entry->retainedReferences, svcId);
+        celix_longHashMap_remove(entry->retainedReferences, svcId);
+        celixThreadMutex_unlock(&entry->mutex);
+        retained = reference != NULL;
+    }
+    if (reference == NULL) {
+        serviceRegistry_getServiceReference(framework->registry, entry->bundle, registration, &reference);
+    }
+    if (eventType == OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED) {
+        celixThreadMutex_lock(&entry->mutex);
+        service_reference_pt prev = celix_longHashMap_get(entry->retainedReferences, svcId);
+        if (prev == NULL) {
+            celix_longHashMap_put(entry->retainedReferences, svcId, reference);
+            retained = true;
+        }
+        celixThreadMutex_unlock(&entry->mutex);
+    }
+
+    event.type = eventType;
+    event.reference = reference;
+    event.moreEventsInBatch = moreEventsInBatch;
 
-    celix_array_list_t* retainedEntries = celix_arrayList_create();
-    celix_array_list_t* matchedEntries = celix_arrayList_create();
+    struct timespec start;
+    celix_registryStatistics_startTimer(stats, &start);
+    entry->listener->serviceChanged(entry->listener, &event);
+    if (stats != NULL) {
+        celix_registryStatistics_record(stats, CELIX_REGISTRY_STATISTICS_LISTENER_CALL, celix_bundle_getId(entry->bundle), serviceName, &start);
+    }
+
+    if (eventType == OSGI_FRAMEWORK_SERVICE_EVENT_MODIFIED) {
+        entry->listener->serviceChanged(entry->listener, &event);
+    }
+
+    if (eventType != OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED || !retained) {
+        //for UNREGISTERING this also releases the reference retained when the service was registered
+        serviceRegistry_ungetServiceReference(framework->registry, entry->bundle, reference);
+    }
+}
 
+/**
+ * Returns true if a REGISTERED or MODIFIED event should not be delivered, because the service is already
+ * unregistering (e.g. unregistered by a listener callback or while the event was queued). Listeners will receive
+ * the UNREGISTERING event of the service after this, so a listener never keeps an unregistered service.
+ */
+static bool fw_isUnregisteredBeforeDelivery(celix_service_event_type_t eventType, service_registration_pt registration) {
+    return eventType != OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING && celix_serviceRegistration_isUnregistering(registration);
+}
+
+/**
+ * Returns the index of the first registration with the provided service name or -1.
+ * If firstWithServiceName is NULL, serviceNames contains a single service name.
+ */
+static int fw_firstRegistrationWithServiceName(const celix_string_hash_map_t *firstWithServiceName, const celix_array_list_t *serviceNames, const char *serviceName) {
+    if (firstWithServiceName == NULL) {
+        const char *name = celix_arrayList_size(serviceNames) == 0 ? NULL : celix_arrayList_get(serviceNames, 0);
+        return name != NULL && strcmp(name, serviceName) == 0 ? 0 : -1;
+    }
+    return (int)(intptr_t)celix_stringHashMap_get(firstWithServiceName, serviceName) - 1;
+}
+
+/**
+ * Delivers the service events of the same type for the provided registrations (list of service_registration_t*)
+ * as one batch. The listeners are collected once for the whole batch and every listener receives all its matching
+ * events in a single pass, with moreEventsInBatch set for all but its last event.
+ */
+static void fw_deliverServiceEvents(framework_pt framework, celix_service_event_type_t eventType, celix_array_list_t *registrations) {
+    int nrOfRegistrations = celix_arrayList_size(registrations);
+
+    //note scratch lists, so that delivering service events does not need heap allocations for the entry lists
+    celix_array_list_t* retainedEntries = celix_arrayList_takeScratch();
+    celix_array_list_t* matchedRegistrations = celix_arrayList_takeScratch();
+    celix_array_list_t* serviceNames = celix_arrayList_takeScratch();
+
+    for (int r = 0; r < nrOfRegistrations; ++r) {
+        const char *serviceName = NULL;
+        serviceRegistration_getServiceName(celix_arrayList_get(registrations, r), &serviceName);
+        celix_arrayList_add(serviceNames, (void*)serviceName);
+    }
+
+    //for a batch of registrations, the registrations are grouped on service name: the map contains the (index + 1)
+    //of the first registration with the service name and nextWithSameName the index of the next (or -1).
+    celix_string_hash_map_t *firstWithServiceName = NULL;
+    int *nextWithSameName = NULL;
+    if (nrOfRegistrations > 1) {
+        celix_hash_map_create_options_t opts = CELIX_EMPTY_HASH_MAP_CREATE_OPTIONS;
+        opts.initialCapacity = nrOfRegistrations;
+        opts.storeKeysWeakly = true; //note the service names are owned by the registrations
+        firstWithServiceName = celix_stringHashMap_createWithOptions(&opts);
+        nextWithSameName = malloc(sizeof(*nextWithSameName) * nrOfRegistrations);
+        for (int r = nrOfRegistrations - 1; r >= 0; --r) {
+            const char *serviceName = celix_arrayList_get(serviceNames, r);
+            void *next = serviceName == NULL ? NULL : celix_stringHashMap_put(firstWithServiceName, serviceName, (void*)(intptr_t)(r + 1));
+            nextWithSameName[r] = (int)(intptr_t)next - 1;
+        }
+    }
+
+    //only listeners with a filter on the service name of a registration or without a objectClass filter can match.
+    //Every listener is indexed on a single service name or is without service name, so candidates are added once
+    //per distinct service name.
     celixThreadMutex_lock(&framework->serviceListenersLock);
-    for (i = 0; i < celix_arrayList_size(framework->serviceListeners); i++) {
-        entry = (celix_fw_service_listener_entry_t *) celix_arrayList_get(framework->serviceListeners, i);
+    for (int r = 0; r < nrOfRegistrations; ++r) {
+        const char *serviceName = celix_arrayList_get(serviceNames, r);
+        bool first = serviceName != NULL && fw_firstRegistrationWithServiceName(firstWithServiceName, serviceNames, serviceName) == r;
+        celix_array_list_t *candidates = first ? celix_stringHashMap_get(framework->serviceListenersByServiceName, serviceName) : NULL;
+        for (int k = 0; candidates != NULL && k < celix_arrayList_size(candidates); ++k) {
+            celix_fw_service_listener_entry_t *entry = celix_arrayList_get(candidates, k);
+            celix_arrayList_add(retainedEntries, entry);
+            listener_retain(entry); //ensure that use count > 0, so that the listener cannot be destroyed until all pending event are handled.
+        }
+    }
+    for (int k = 0; k < celix_arrayList_size(framework->serviceListenersWithoutServiceName); ++k) {
+        celix_fw_service_listener_entry_t *entry = celix_arrayList_get(framework->serviceListenersWithoutServiceName, k);
         celix_arrayList_add(retainedEntries, entry);
-        listener_retain(entry); //ensure that use count > 0, so that the listener cannot be destroyed until all pending event are handled.
+        listener_retain(entry);
     }
     celixThreadMutex_unlock(&framework->serviceListenersLock);
 
-    for (i = 0; i < celix_arrayList_size(retainedEntries); ++i) {
-        entry = (celix_fw_service_listener_entry_t *) celix_arrayList_get(retainedEntries, i);
-        int matched = 0;
-        properties_pt props = NULL;
-        bool matchResult = false;
-        serviceRegistration_getProperties(registration, &props);
-        if (entry->filter != NULL) {
-            filter_match(entry->filter, props, &matchResult);
-        }
-        matched = (entry->filter == NULL) || matchResult;
-        if (matched) {
-            celix_arrayList_add(matchedEntries, entry);
-        } else {
-            listener_release(entry); //Not a match -> release entry
-        }
-    }
-    celix_arrayList_destroy(retainedEntries);
-
     /*
      * TODO FIXME, A deadlock can happen when (e.g.) a service is deregistered, triggering this fw_serviceChanged and
      * one of the matching service listener callback tries to remove an other matched service listener.
@@ -1801,49 +2326,193 @@ void fw_serviceChanged(framework_pt framework, celix_service_event_type_t eventT
      * usageCount on > 0.
      *
      * Not sure how to prevent/handle this.
+     * Note that with CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS enabled, removing a listener from a listener callback
+     * does not wait for the listener entry and the deadlock does not occur.
      */
-    for (i = 0; i < celix_arrayList_size(matchedEntries); ++i) {
-        entry = (celix_fw_service_listener_entry_t *) celix_arrayList_get(matchedEntries, i);
-
-        service_reference_pt reference = NULL;
-        celix_service_event_t event;
-
-        serviceRegistry_getServiceReference(framework->registry, entry->bundle, registration, &reference);
+    celix_registry_statistics_t *stats = framework->registryStatistics.statistics;
+    for (int i = 0; i < celix_arrayList_size(retainedEntries); ++i) {
+        celix_fw_service_listener_entry_t *entry = celix_arrayList_get(retainedEntries, i);
+
+        celix_arrayList_clear(matchedRegistrations);
+        //note a listener with a service name only visits the registrations with that service name
+        int r = entry->serviceName == NULL ? 0 : fw_firstRegistrationWithServiceName(firstWithServiceName, serviceNames, entry->serviceName);
+        for (; r >= 0 && r < nrOfRegistrations; r = entry->serviceName == NULL ? r + 1 : (nextWithSameName == NULL ? -1 : nextWithSameName[r])) {
+            service_registration_pt registration = celix_arrayList_get(registrations, r);
+            const char *serviceName = celix_arrayList_get(serviceNames, r);
+            bool matchResult = false;
+            if (entry->filter != NULL) {
+                properties_pt props = NULL;
+                serviceRegistration_getProperties(registration, &props);
+                struct timespec start;
+                celix_registryStatistics_startTimer(stats, &start);
+                filter_match(entry->filter, props, &matchResult);
+                if (stats != NULL) {
+                    celix_registryStatistics_record(stats, CELIX_REGISTRY_STATISTICS_FILTER_MATCH, celix_bundle_getId(entry->bundle), serviceName, &start);
+                }
+            }
+            if (entry->filter == NULL || matchResult) {
+                celix_arrayList_addLong(matchedRegistrations, r);
+            }
+        }
 
-        //NOTE: that you are never sure that the UNREGISTERED event will by handle by an service_listener. listener could be gone
-        //Every reference retained is therefore stored and called when a service listener is removed from the framework.
-        if (eventType == OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED) {
-            serviceRegistry_retainServiceReference(framework->registry, entry->bundle, reference);
+        int nrOfMatched = celix_arrayList_size(matchedRegistrations);
+        for (int m = 0; m < nrOfMatched; ++m) {
             celixThreadMutex_lock(&entry->mutex);
-            arrayList_add(entry->retainedReferences, reference); //TODO improve by using set (or hashmap) instead of list
+            bool removed = entry->removed;
             celixThreadMutex_unlock(&entry->mutex);
+            if (removed) {
+                //listener removed by a previous listener callback
+                break;
+            }
+            int r = (int)celix_arrayList_getLong(matchedRegistrations, m);
+            service_registration_pt registration = celix_arrayList_get(registrations, r);
+            if (fw_isUnregisteredBeforeDelivery(eventType, registration)) {
+                continue;
+            }
+            bool moreEvents = false;
+            for (int n = m + 1; !moreEvents && n < nrOfMatched; ++n) {
+                int next = (int)celix_arrayList_getLong(matchedRegistrations, n);
+                moreEvents = !fw_isUnregisteredBeforeDelivery(eventType, celix_arrayList_get(registrations, next));
+            }
+            fw_deliverServiceEventToListener(framework, entry, eventType, registration, celix_arrayList_get(serviceNames, r), moreEvents);
         }
+        listener_release(entry); //decrease usage, so that the listener can be destroyed (if use count is now 0)
+    }
+    if (firstWithServiceName != NULL) {
+        celix_stringHashMap_destroy(firstWithServiceName);
+    }
+    free(nextWithSameName);
+    celix_arrayList_releaseScratch(serviceNames);
+    celix_arrayList_releaseScratch(matchedRegistrations);
+    celix_arrayList_releaseScratch(retainedEntries);
+}
 
-        event.type = eventType;
-        event.reference = reference;
+static void fw_queueServiceEvents(framework_pt framework, celix_service_event_type_t eventType, celix_array_list_t *registrations) {
+    celixThreadMutex_lock(&framework->serviceEvents.mutex);
+    for (int i = 0; i < celix_arrayList_size(registrations); ++i) {
+        celix_fw_service_event_t *event = calloc(1, sizeof(*event));
+        event->type = eventType;
+        event->registration = celix_arrayList_get(registrations, i);
+        serviceRegistration_retain(event->registration);
+        event->seqNr = framework->serviceEvents.nextSeqNr++;
+        celix_arrayList_add(framework->serviceEvents.events, event);
+    }
+    celixThreadCondition_broadcast(&framework->serviceEvents.cond);
+    celixThreadMutex_unlock(&framework->serviceEvents.mutex);
+}
 
-        entry->listener->serviceChanged(entry->listener, &event);
+/**
+ * Handles UNREGISTERING events in async mode.
+ * The unregistering of a service must wait until the service listeners (trackers) have handled the UNREGISTERING
+ * event, otherwise a listener could still use a service which is already removed.
+ * Note that the UNREGISTERING event is always delivered, also if the REGISTERED event of the service is still queued:
+ * a listener (e.g. a tracker being opened) can already know the service through a service reference lookup.
+ * Queued REGISTERED and MODIFIED events of an unregistering service are skipped, see fw_isUnregisteredBeforeDelivery.
+ */
+static void fw_handleUnregisteringServiceEvents(framework_pt framework, celix_array_list_t *registrations) {
+    if (celixThread_equals(celixThread_self(), framework->serviceEvents.thread)) {
+        //unregistered from a listener callback, waiting for the service event thread would deadlock
+        fw_deliverServiceEvents(framework, OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING, registrations);
+    } else {
+        fw_queueServiceEvents(framework, OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING, registrations);
+        celixThreadMutex_lock(&framework->serviceEvents.mutex);
+        long seqNr = framework->serviceEvents.nextSeqNr - 1;
+        while (framework->serviceEvents.deliveredSeqNr < seqNr) {
+            celixThreadCondition_wait(&framework->serviceEvents.cond, &framework->serviceEvents.mutex);
+        }
+        celixThreadMutex_unlock(&framework->serviceEvents.mutex);
+    }
+}
 
-        serviceRegistry_ungetServiceReference(framework->registry, entry->bundle, reference);
+void fw_serviceChanged(framework_pt framework, celix_service_event_type_t eventType, service_registration_pt registration, properties_pt oldprops __attribute__((unused))) {
+    celix_inline_array_list_t buffer;
+    celix_array_list_t *registrations = celix_arrayList_initInline(&buffer);
+    celix_arrayList_add(registrations, registration);
+    fw_serviceChangedBatch(framework, eventType, registrations);
+    celix_arrayList_destroy(registrations);
+}
 
-        if (eventType == OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING) {
-            //if service listener was active when service was registered, release the retained reference
-            celixThreadMutex_lock(&entry->mutex);
-            bool removed = arrayList_removeElement(entry->retainedReferences, reference);
-            celixThreadMutex_unlock(&entry->mutex);
-            if (removed) {
-                serviceRegistry_ungetServiceReference(framework->registry, entry->bundle,
-                                                      reference); // decrease retain counter
+void fw_serviceChangedBatch(framework_pt framework, celix_service_event_type_t eventType, celix_array_list_t *registrations) {
+    if (!framework->serviceEvents.async) {
+        fw_deliverServiceEvents(framework, eventType, registrations);
+    } else if (eventType == OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING) {
+        fw_handleUnregisteringServiceEvents(framework, registrations);
+    } else {
+        fw_queueServiceEvents(framework, eventType, registrations);
+    }
+}
+
+static void *fw_serviceEventThread(void *data) {
+    framework_pt framework = data;
+    celix_array_list_t *batch = celix_arrayList_create();
+
+    celixThreadMutex_lock(&framework->serviceEvents.mutex);
+    bool active = framework->serviceEvents.active;
+    while (active || celix_arrayList_size(framework->serviceEvents.events) > 0) {
+        if (celix_arrayList_size(framework->serviceEvents.events) == 0) {
+            celixThreadCondition_wait(&framework->serviceEvents.cond, &framework->serviceEvents.mutex);
+        } else {
+            //take all queued events and deliver them as one batch
+            long lastSeqNr = 0;
+            for (int i = 0; i < celix_arrayList_size(framework->serviceEvents.events); ++i) {
+                celix_fw_service_event_t *event = celix_arrayList_get(framework->serviceEvents.events, i);
+                celix_arrayList_add(batch, event);
+                lastSeqNr = event->seqNr;
+            }
+            celix_arrayList_clear(framework->serviceEvents.events);
+            celixThreadMutex_unlock(&framework->serviceEvents.mutex);
+
+            //consecutive events of the same type are delivered as one batch
+            celix_array_list_t *run = celix_arrayList_takeScratch();
+            for (int i = 0; i < celix_arrayList_size(batch); ++i) {
+                celix_fw_service_event_t *event = celix_arrayList_get(batch, i);
+                celix_fw_service_event_t *next = i + 1 < celix_arrayList_size(batch) ? celix_arrayList_get(batch, i + 1) : NULL;
+                celix_arrayList_add(run, event->registration);
+                if (next == NULL || next->type != event->type) {
+                    fw_deliverServiceEvents(framework, event->type, run);
+                    celix_arrayList_clear(run);
+                }
+            }
+            celix_arrayList_releaseScratch(run);
+            for (int i = 0; i < celix_arrayList_size(batch); ++i) {
+                celix_fw_service_event_t *event = celix_arrayList_get(batch, i);
+                serviceRegistration_release(event->registration);
+                free(event);
             }
+            celix_arrayList_clear(batch);
 
-        }
+            for (int i = 0; i < celix_arrayList_size(framework->serviceEvents.removedListeners); ++i) {
+                celix_fw_service_listener_entry_t *entry = celix_arrayList_get(framework->serviceEvents.removedListeners, i);
+                listener_waitAndDestroy(framework, entry);
+            }
+            celix_arrayList_clear(framework->serviceEvents.removedListeners);
 
-        if (eventType == OSGI_FRAMEWORK_SERVICE_EVENT_MODIFIED) {
-            entry->listener->serviceChanged(entry->listener, &event);
+            celixThreadMutex_lock(&framework->serviceEvents.mutex);
+            framework->serviceEvents.deliveredSeqNr = lastSeqNr;
+            celixThreadCondition_broadcast(&framework->serviceEvents.cond);
         }
-        listener_release(entry); //decrease usage, so that the listener can be destroyed (if use count is now 0)
+        active = framework->serviceEvents.active;
+    }
+    celixThreadMutex_unlock(&framework->serviceEvents.mutex);
+
+    celix_arrayList_destroy(batch);
+    return NULL;
+}
+
+static void fw_stopServiceEventThread(framework_pt framework) {
+    if (framework->serviceEvents.async) {
+        celixThreadMutex_lock(&framework->serviceEvents.mutex);
+        framework->serviceEvents.active = false;
+        celixThreadCondition_broadcast(&framework->serviceEvents.cond);
+        celixThreadMutex_unlock(&framework->serviceEvents.mutex);
+        celixThread_join(framework->serviceEvents.thread, NULL); //note queued events are delivered before the thread stops
+        framework->serviceEvents.async = false;
+
+        celix_arrayList_destroy(framework->serviceEvents.events);
+        framework->serviceEvents.events = NULL;
+        celix_arrayList_destroy(framework->serviceEvents.removedListeners);
+        framework->serviceEvents.removedListeners = NULL;
     }
-    celix_arrayList_destroy(matchedEntries);
 }
 
 //celix_status_t fw_isServiceAssignable(framework_pt fw, bundle_pt requester, service_reference_pt reference, bool *assignable) {
@@ -1964,7 +2633,9 @@ celix_status_t framework_markBundleResolved(framework_pt framework, module_pt mo
             // Load libraries of this module
             bool isSystemBundle = false;
             bundle_isSystemBundle(bundle, &isSystemBundle);
-            if (!isSystemBundle) {
+            if (bundle->librariesPreloaded) {
+                bundle->librariesPreloaded = false; //libraries already loaded at framework launch
+            } else if (!isSystemBundle) {
                 status = CELIX_DO_IF(status, framework_loadBundleLibraries(framework, bundle));
             }
 
@@ -2104,6 +2775,9 @@ static void* framework_shutdown(void *framework) {
     }
     celix_arrayList_destroy(stopEntries);
 
+    framework_stopExecutor(fw);
+    framework_stopTimer(fw);
+    framework_unregisterRegistryStatisticsService(fw);
 
     // 'stop' framework bundle
     if (fwEntry != NULL) {
@@ -2147,56 +2821,82 @@ bundle_context_t* framework_getContext(framework_t *framework) {
     return result;
 }
 
-celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e eventType, bundle_pt bundle) {
-    celix_status_t status = CELIX_SUCCESS;
-
-    if ((eventType != OSGI_FRAMEWORK_BUNDLE_EVENT_STARTING)
-        && (eventType != OSGI_FRAMEWORK_BUNDLE_EVENT_STOPPING)
-        && (eventType != OSGI_FRAMEWORK_BUNDLE_EVENT_LAZY_ACTIVATION)) {
-        request_pt request = (request_pt) calloc(1, sizeof(*request));
-        if (!request) {
-            status = CELIX_ENOMEM;
-        } else {
-            bundle_archive_pt archive = NULL;
-            module_pt module = NULL;
-
-            request->eventType = eventType;
-            request->filter = NULL;
-            request->listeners = framework->bundleListeners;
-            request->type = BUNDLE_EVENT_TYPE;
-            request->error = NULL;
-            request->bundleId = -1;
-
-            status = bundle_getArchive(bundle, &archive);
-
-            if (status == CELIX_SUCCESS) {
-                long bundleId;
+static void fw_setEventRecordBundle(celix_framework_event_record_t *record, bundle_pt bundle, celix_status_t *status) {
+    bundle_archive_pt archive = NULL;
+    module_pt module = NULL;
 
-                status = bundleArchive_getId(archive, &bundleId);
+    *status = bundle_getArchive(bundle, &archive);
+    if (*status == CELIX_SUCCESS) {
+        long bundleId;
+        *status = bundleArchive_getId(archive, &bundleId);
+        if (*status == CELIX_SUCCESS) {
+            record->bundleId = bundleId;
+        }
+    }
 
-                if (status == CELIX_SUCCESS) {
-                    request->bundleId = bundleId;
+    if (*status == CELIX_SUCCESS) {
+        *status = bundle_getCurrentModule(bundle, &module);
+        if (*status == CELIX_SUCCESS) {
+            const char *symbolicName = NULL;
+            *status = module_getSymbolicName(module, &symbolicName);
+            if (*status == CELIX_SUCCESS && symbolicName != NULL) {
+                if (strlen(symbolicName) < FW_EVENT_NAME_BUFFER_SIZE) {
+                    strcpy(record->bundleSymbolicName, symbolicName);
+                } else {
+                    record->longBundleSymbolicName = strdup(symbolicName);
                 }
             }
+        }
+    }
+}
 
-            if (status == CELIX_SUCCESS) {
-                status = bundle_getCurrentModule(bundle, &module);
+/**
+ * Copies the event record into the dispatcher event ring and wakes up the dispatcher.
+ * The ring is preallocated and only grows when it is full (e.g. for a large burst of events), so normally
+ * queuing an event does not allocate memory.
+ * Note that the ring grows instead of blocking the caller, because events are also fired from the dispatcher
+ * thread (e.g. a bundle listener starting a bundle).
+ */
+static void fw_queueEventRecord(framework_pt framework, const celix_framework_event_record_t *record) {
+    celixThreadMutex_lock(&framework->dispatcher.mutex);
+    if (framework->dispatcher.size == framework->dispatcher.capacity) {
+        size_t newCapacity = framework->dispatcher.capacity * 2;
+        celix_framework_event_record_t *newEvents = calloc(newCapacity, sizeof(*newEvents));
+        for (size_t i = 0; i < framework->dispatcher.size; ++i) {
+            newEvents[i] = framework->dispatcher.events[(framework->dispatcher.head + i) % framework->dispatcher.capacity];
+        }
+        free(framework->dispatcher.events);
+        framework->dispatcher.events = newEvents;
+        framework->dispatcher.capacity = newCapacity;
+        framework->dispatcher.head = 0;
+    }
+    size_t tail = (framework->dispatcher.head + framework->dispatcher.size) % framework->dispatcher.capacity;
+    framework->dispatcher.events[tail] = *record;
+    framework->dispatcher.size += 1;
+    celixThreadCondition_signal(&framework->dispatcher.cond);
+    celixThreadMutex_unlock(&framework->dispatcher.mutex);
+}
 
-                if (status == CELIX_SUCCESS) {
-                    const char *symbolicName = NULL;
-                    status = module_getSymbolicName(module, &symbolicName);
-                    if (status == CELIX_SUCCESS) {
-                        request->bundleSymbolicName = strdup(symbolicName);
-                    }
-                }
-            }
+static void fw_initEventRecord(celix_framework_event_record_t *record, event_type_e type, int eventType, celix_status_t errorCode) {
+    record->type = type;
+    record->eventType = eventType;
+    record->bundleId = -1;
+    record->bundleSymbolicName[0] = '\0';
+    record->longBundleSymbolicName = NULL;
+    record->errorCode = errorCode;
+    record->error[0] = '\0';
+}
 
-            celixThreadMutex_lock(&framework->dispatcher.mutex);
-            arrayList_add(framework->dispatcher.requests, request);
-            celixThreadCondition_broadcast(&framework->dispatcher.cond);
-            celixThreadMutex_unlock(&framework->dispatcher.mutex);
+celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e eventType, bundle_pt bundle) {
+    celix_status_t status = CELIX_SUCCESS;
 
-        }
+    if ((eventType != OSGI_FRAMEWORK_BUNDLE_EVENT_STARTING)
+        && (eventType != OSGI_FRAMEWORK_BUNDLE_EVENT_STOPPING)
+        && (eventType != OSGI_FRAMEWORK_BUNDLE_EVENT_LAZY_ACTIVATION)) {
+        celix_framework_event_record_t record;
+        fw_initEventRecord(&record, BUNDLE_EVENT_TYPE, eventType, CELIX_SUCCESS);
+        fw_setEventRecordBundle(&record, bundle, &status);
+        fw_queueEventRecord(framework, &record);
     }
 
     framework_logIfError(framework->logger, status, NULL, "Failed to fire bundle event");
@@ -2207,130 +2907,97 @@ celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e ev
 celix_status_t fw_fireFrameworkEvent(framework_pt framework, framework_event_type_e eventType, bundle_pt bundle, celix_status_t errorCode) {
     celix_status_t status = CELIX_SUCCESS;
 
-    request_pt request = (request_pt) malloc(sizeof(*request));
-    if (!request) {
-        status = CELIX_ENOMEM;
-    } else {
-        bundle_archive_pt archive = NULL;
-        module_pt module = NULL;
-
-        request->eventType = eventType;
-        request->filter = NULL;
-        request->listeners = framework->frameworkListeners;
-        request->type = FRAMEWORK_EVENT_TYPE;
-        request->errorCode = errorCode;
-        request->error = "";
-        request->bundleId = -1;
-
-        status = bundle_getArchive(bundle, &archive);
-
-        if (status == CELIX_SUCCESS) {
-            long bundleId;
-
-            status = bundleArchive_getId(archive, &bundleId);
-
-            if (status == CELIX_SUCCESS) {
-                request->bundleId = bundleId;
-            }
-        }
+    celix_framework_event_record_t record;
+    fw_initEventRecord(&record, FRAMEWORK_EVENT_TYPE, eventType, errorCode);
+    fw_setEventRecordBundle(&record, bundle, &status);
+    if (errorCode != CELIX_SUCCESS) {
+        celix_strerror(errorCode, record.error, FW_EVENT_ERROR_BUFFER_SIZE);
+    }
+    fw_queueEventRecord(framework, &record);
 
-        if (status == CELIX_SUCCESS) {
-            status = bundle_getCurrentModule(bundle, &module);
+    framework_logIfError(framework->logger, status, NULL, "Failed to fire framework event");
 
-            if (status == CELIX_SUCCESS) {
-                const char *symbolicName = NULL;
-                status = module_getSymbolicName(module, &symbolicName);
-                if (status == CELIX_SUCCESS) {
-                    request->bundleSymbolicName = strdup(symbolicName);
-                }
-            }
-        }
+    return status;
+}
 
-        if (errorCode != CELIX_SUCCESS) {
-            char message[256];
-            celix_strerror(errorCode, message, 256);
-            request->error = message;
-        }
+static void fw_dispatchBundleEvent(framework_pt framework, celix_framework_event_record_t *record) {
+    bundle_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.bundleId = record->bundleId;
+    event.bundleSymbolicName = record->longBundleSymbolicName != NULL ? record->longBundleSymbolicName : record->bundleSymbolicName;
+    event.type = record->eventType;
 
-        celixThreadMutex_lock(&framework->dispatcher.mutex);
-        arrayList_add(framework->dispatcher.requests, request);
-        celixThreadCondition_broadcast(&framework->dispatcher.cond);
-        celixThreadMutex_unlock(&framework->dispatcher.mutex);
+    int size = arrayList_size(framework->bundleListeners);
+    for (int k = 0; k < size; k++) {
+        fw_bundle_listener_pt listener = (fw_bundle_listener_pt) arrayList_get(framework->bundleListeners, k);
+        fw_invokeBundleListener(framework, listener->listener, &event, listener->bundle);
     }
+}
 
-    framework_logIfError(framework->logger, status, NULL, "Failed to fire framework event");
+static void fw_dispatchFrameworkEvent(framework_pt framework, celix_framework_event_record_t *record) {
+    framework_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.bundleId = record->bundleId;
+    event.bundleSymbolicName = record->longBundleSymbolicName != NULL ? record->longBundleSymbolicName : record->bundleSymbolicName;
+    event.type = record->eventType;
+    event.error = record->error;
+    event.errorCode = record->errorCode;
 
-    return status;
+    int size = arrayList_size(framework->frameworkListeners);
+    for (int k = 0; k < size; k++) {
+        fw_framework_listener_pt listener = (fw_framework_listener_pt) arrayList_get(framework->frameworkListeners, k);
+        fw_invokeFrameworkListener(framework, listener->listener, &event, listener->bundle);
+    }
 }
 
 static void *fw_eventDispatcher(void *fw) {
     framework_pt framework = (framework_pt) fw;
+    celix_framework_event_record_t *batch = calloc(FW_EVENT_DISPATCH_BATCH_SIZE, sizeof(*batch));
 
     celixThreadMutex_lock(&framework->dispatcher.mutex);
     bool active = framework->dispatcher.active;
+    bool drained = framework->dispatcher.size == 0;
     celixThreadMutex_unlock(&framework->dispatcher.mutex);
 
-    celix_array_list_t *localRequests = celix_arrayList_create();
-
-    while (active) {
+    //keep dispatching after the dispatcher is deactivated until all queued events are delivered
+    while (active || !drained) {
+        //take a batch of events from the event ring
         celixThreadMutex_lock(&framework->dispatcher.mutex);
-        if (celix_arrayList_size(framework->dispatcher.requests) == 0) {
+        if (framework->dispatcher.size == 0 && framework->dispatcher.active) {
             celixThreadCondition_wait(&framework->dispatcher.cond, &framework->dispatcher.mutex);
         }
-        for (int i = 0; i < celix_arrayList_size(framework->dispatcher.requests); ++i) {
-            void *r = celix_arrayList_get(framework->dispatcher.requests, i);
-            celix_arrayList_add(localRequests, r);
+        size_t batchSize = 0;
+        while (batchSize < FW_EVENT_DISPATCH_BATCH_SIZE && framework->dispatcher.size > 0) {
+            batch[batchSize++] = framework->dispatcher.events[framework->dispatcher.head];
+            framework->dispatcher.head = (framework->dispatcher.head + 1) % framework->dispatcher.capacity;
+            framework->dispatcher.size -= 1;
         }
-        celix_arrayList_clear(framework->dispatcher.requests);
+        active = framework->dispatcher.active;
+        drained = framework->dispatcher.size == 0;
         celixThreadMutex_unlock(&framework->dispatcher.mutex);
 
-        //FIXME strange locking  of bundleListenerLock and frameworkListenerLock inside a loop.
-        //Seems like a request depends on bundle listeners or framework listeners -> this should be protected with
-        //a use count!!
-        for (int i = 0; i < celix_arrayList_size(localRequests); ++i) {
-            request_pt request = celix_arrayList_get(localRequests, i);
-            int size = arrayList_size(request->listeners);
-            for (int k = 0; k < size; k++) {
-                if (request->type == BUNDLE_EVENT_TYPE) {
-                    celixThreadMutex_lock(&framework->bundleListenerLock);
-                    fw_bundle_listener_pt listener = (fw_bundle_listener_pt) arrayList_get(request->listeners, k);
-                    bundle_event_t event;
-                    memset(&event, 0, sizeof(event));
-                    event.bundleId = request->bundleId;
-                    event.bundleSymbolicName = request->bundleSymbolicName;
-                    event.type = request->eventType;
-
-                    fw_invokeBundleListener(framework, listener->listener, &event, listener->bundle);
-                    celixThreadMutex_unlock(&framework->bundleListenerLock);
-                } else if (request->type == FRAMEWORK_EVENT_TYPE) {
-                    celixThreadMutex_lock(&framework->frameworkListenersLock);
-                    fw_framework_listener_pt listener = (fw_framework_listener_pt) arrayList_get(request->listeners, k);
-                    framework_event_t event;
-                    memset(&event, 0, sizeof(event));
-                    event.bundleId = request->bundleId;
-                    event.bundleSymbolicName = request->bundleSymbolicName;
-                    event.type = request->eventType;
-                    event.error = request->error;
-                    event.errorCode = request->errorCode;
-
-                    fw_invokeFrameworkListener(framework, listener->listener, &event, listener->bundle);
-                    celixThreadMutex_unlock(&framework->frameworkListenersLock);
+        //dispatch the batch, consecutive events of the same type are dispatched with a single listener lock
+        size_t i = 0;
+        while (i < batchSize) {
+            if (batch[i].type == BUNDLE_EVENT_TYPE) {
+                celixThreadMutex_lock(&framework->bundleListenerLock);
+                for (; i < batchSize && batch[i].type == BUNDLE_EVENT_TYPE; ++i) {
+                    fw_dispatchBundleEvent(framework, &batch[i]);
+                    free(batch[i].longBundleSymbolicName);
+                }
+                celixThreadMutex_unlock(&framework->bundleListenerLock);
+            } else {
+                celixThreadMutex_lock(&framework->frameworkListenersLock);
+                for (; i < batchSize && batch[i].type != BUNDLE_EVENT_TYPE; ++i) {
+                    fw_dispatchFrameworkEvent(framework, &batch[i]);
+                    free(batch[i].longBundleSymbolicName);
                 }
+                celixThreadMutex_unlock(&framework->frameworkListenersLock);
             }
-            free(request->bundleSymbolicName);
-            //NOTE next 2 free calls not needed? why it is a char* not a const char*
-            //free(request->filter);
-            //free(request->error);
-            free(request);
         }
-        celix_arrayList_clear(localRequests);
-
-        celixThreadMutex_lock(&framework->dispatcher.mutex);
-        active = framework->dispatcher.active;
-        celixThreadMutex_unlock(&framework->dispatcher.mutex);
     }
 
-    celix_arrayList_destroy(localRequests);
+    free(batch);
     celixThread_exit(NULL);
     return NULL;
 
@@ -2627,6 +3294,65 @@ service_registration_t* celix_framework_registerServiceFactory(framework_t *fw ,
     return reg;
 }
 
+celix_status_t celix_framework_registerServices(framework_t *fw, const celix_bundle_t *bnd, celix_service_registry_batch_entry_t *entries, size_t nrOfEntries) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    long bndId = celix_bundle_getId(bnd);
+    fw_bundleEntry_increaseUseCount(fw, bndId);
+
+    //note listener hook services are registered one by one, because fw_registerService also informs the hook
+    //about the already present service listeners
+    celix_service_registry_batch_entry_t *batch = calloc(nrOfEntries, sizeof(*batch));
+    size_t *batchIndices = calloc(nrOfEntries, sizeof(*batchIndices));
+    size_t batchSize = 0;
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        celix_service_registry_batch_entry_t *entry = &entries[i];
+        entry->registration = NULL;
+        if (entry->serviceName == NULL || (entry->svc == NULL && entry->factory == NULL)) {
+            status = CELIX_ILLEGAL_ARGUMENT;
+            fw_log(fw->logger, OSGI_FRAMEWORK_LOG_ERROR, "Cannot register service, service name and service (or service factory) are required");
+        } else if (entry->factory == NULL && strcmp(entry->serviceName, OSGI_FRAMEWORK_LISTENER_HOOK_SERVICE_NAME) == 0) {
+            fw_registerService(fw, &entry->registration, (bundle_pt)bnd, entry->serviceName, entry->svc, entry->properties);
+        } else {
+            batch[batchSize] = *entry;
+            batchIndices[batchSize] = i;
+            batchSize += 1;
+        }
+    }
+
+    if (batchSize > 0) {
+        celix_status_t batchStatus = celix_serviceRegistry_registerServices(fw->registry, bnd, batch, batchSize);
+        if (status == CELIX_SUCCESS) {
+            status = batchStatus;
+        }
+        framework_logIfError(fw->logger, batchStatus, NULL, "Cannot register services");
+        for (size_t i = 0; i < batchSize; ++i) {
+            entries[batchIndices[i]].registration = batch[i].registration;
+        }
+    }
+    free(batchIndices);
+    free(batch);
+
+    fw_bundleEntry_decreaseUseCount(fw, bndId);
+    return status;
+}
+
+void celix_framework_unregisterServices(framework_t *fw, const celix_bundle_t *bnd, celix_array_list_t *registrations) {
+    celix_array_list_t *unregistering = celix_arrayList_create();
+    for (int i = 0; i < celix_arrayList_size(registrations); ++i) {
+        service_registration_t *reg = celix_arrayList_get(registrations, i);
+        if (celix_serviceRegistration_markUnregistering(reg)) {
+            celix_arrayList_add(unregistering, reg);
+        } else {
+            fw_log(fw->logger, OSGI_FRAMEWORK_LOG_ERROR, "Cannot unregister service registration, registration is invalid or already unregistering");
+        }
+    }
+    if (celix_arrayList_size(unregistering) > 0) {
+        celix_serviceRegistry_unregisterServices(fw->registry, bnd, unregistering);
+    }
+    celix_arrayList_destroy(unregistering);
+}
+
 const char* celix_framework_getUUID(const celix_framework_t *fw) {
     if (fw != NULL) {
         return celix_properties_get(fw->configurationMap, OSGI_FRAMEWORK_FRAMEWORK_UUID, NULL);
@@ -2653,3 +3379,13 @@ celix_bundle_t* celix_framework_getFrameworkBundle(const celix_framework_t *fw)
     return bnd;
 }
 
+celix_status_t celix_framework_submitTask(framework_t *fw, const char *queueName, void *taskData, void (*task)(void *taskData)) {
+    if (fw->executor.executor == NULL) {
+        return CELIX_ILLEGAL_STATE;
+    }
+    return celix_executor_submit(fw->executor.executor, queueName, taskData, task);
+}
+
+bool celix_framework_isExecutorThread(framework_t *fw) {
+    return fw->executor.executor != NULL && celix_executor_isWorkerThread(fw->executor.executor);
+}
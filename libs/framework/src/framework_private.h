@@ -26,6 +26,7 @@
 #include "manifest.h"
 #include "wire.h"
 #include "hash_map.h"
+#include "celix_hash_map.h"
 #include "array_list.h"
 #include "celix_errno.h"
 #include "service_factory.h"
@@ -40,6 +41,8 @@
 
 #include "celix_threads.h"
 #include "service_registry.h"
+#include "celix_executor.h"
+#include "celix_registry_statistics.h"
 
 struct celix_framework {
 #ifdef WITH_APR
@@ -51,6 +54,9 @@ struct celix_framework {
 
     celix_thread_mutex_t serviceListenersLock;
     array_list_pt serviceListeners;
+    //index on serviceListeners, used to only match listeners which can match the service name of a service event
+    celix_string_hash_map_t *serviceListenersByServiceName; //key = objectClass of the listener filter, value = list (celix_fw_service_listener_entry_t*)
+    celix_array_list_t *serviceListenersWithoutServiceName; //listeners without a mandatory objectClass in the filter
 
     array_list_pt frameworkListeners;
     celix_thread_mutex_t frameworkListenersLock;
@@ -83,11 +89,44 @@ struct celix_framework {
     struct {
         celix_thread_cond_t cond;
         celix_thread_t thread;
-        celix_thread_mutex_t mutex; //protect active and requests
+        celix_thread_mutex_t mutex; //protect active and the event ring (events, capacity, head and size)
         bool active;
-        celix_array_list_t *requests;
+        struct celix_framework_event_record *events; //ring of preallocated bundle and framework event records
+        size_t capacity;
+        size_t head; //index of the oldest queued event
+        size_t size; //nr of queued events
     } dispatcher;
 
+    struct {
+        bool async; //true if service events are delivered by the service event thread (CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS)
+        celix_thread_t thread;
+        celix_thread_mutex_t mutex; //protects active, events, nextSeqNr and deliveredSeqNr
+        celix_thread_cond_t cond;
+        bool active;
+        celix_array_list_t *events; //value = celix_fw_service_event_t*, queued service events
+        long nextSeqNr; //sequence nr of the next queued service event
+        long deliveredSeqNr; //sequence nr of the last delivered service event
+        celix_array_list_t *removedListeners; //value = celix_fw_service_listener_entry_t*, listeners removed from the service event thread. Only used by the service event thread
+    } serviceEvents;
+
+    struct {
+        celix_timer_t *timer; //shared timer thread, provided to the bundles as celix_timer_service_t
+        celix_timer_service_t svc;
+        long svcId;
+    } timer;
+
+    struct {
+        celix_executor_t *executor; //shared worker threads, provided to the bundles as celix_executor_service_t
+        celix_executor_service_t svc;
+        long svcId;
+    } executor;
+
+    struct {
+        celix_registry_statistics_t *statistics; //NULL if CELIX_FRAMEWORK_REGISTRY_STATISTICS is not enabled
+        celix_registry_statistics_service_t svc;
+        long svcId;
+    } registryStatistics;
+
     framework_logger_pt logger;
 };
 
@@ -122,8 +161,15 @@ FRAMEWORK_EXPORT celix_status_t fw_removeBundleListener(framework_pt framework,
 FRAMEWORK_EXPORT celix_status_t fw_addFrameworkListener(framework_pt framework, bundle_pt bundle, framework_listener_pt listener);
 FRAMEWORK_EXPORT celix_status_t fw_removeFrameworkListener(framework_pt framework, bundle_pt bundle, framework_listener_pt listener);
 
+celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e, bundle_pt bundle);
 FRAMEWORK_EXPORT void fw_serviceChanged(framework_pt framework, celix_service_event_type_t eventType, service_registration_pt registration, properties_pt oldprops);
 
+/**
+ * Dispatches the service events of the same type for the provided registrations (list of service_registration_t*)
+ * as one batch.
+ */
+void fw_serviceChangedBatch(framework_pt framework, celix_service_event_type_t eventType, celix_array_list_t *registrations);
+
 FRAMEWORK_EXPORT celix_status_t fw_isServiceAssignable(framework_pt fw, bundle_pt requester, service_reference_pt reference, bool* assignable);
 
 //bundle_archive_t fw_createArchive(long id, char * location);
@@ -155,4 +201,28 @@ FRAMEWORK_EXPORT bundle_pt framework_getBundleById(framework_pt framework, long
 
 service_registration_t* celix_framework_registerServiceFactory(framework_t *fw , const celix_bundle_t *bnd, const char* serviceName, celix_service_factory_t *factory, celix_properties_t *properties);
 
+/**
+ * Registers the services of the provided entries as one batch, see celix_serviceRegistry_registerServices.
+ * Entries without a service name or without a service (and service factory) are not registered and get a NULL
+ * registration, ownership of their properties stays with the caller.
+ */
+celix_status_t celix_framework_registerServices(framework_t *fw, const celix_bundle_t *bnd, celix_service_registry_batch_entry_t *entries, size_t nrOfEntries);
+
+/**
+ * Unregisters the provided service registrations (list of service_registration_t*) of the bundle as one batch.
+ * Registrations which are already unregistered or unregistering are skipped.
+ */
+void celix_framework_unregisterServices(framework_t *fw, const celix_bundle_t *bnd, celix_array_list_t *registrations);
+
+/**
+ * Submits a task to the framework executor.
+ * @return CELIX_SUCCESS or CELIX_ILLEGAL_STATE if the framework executor is not started or already stopped.
+ */
+celix_status_t celix_framework_submitTask(framework_t *fw, const char *queueName, void *taskData, void (*task)(void *taskData));
+
+/**
+ * Returns whether the calling thread is a worker thread of the framework executor.
+ */
+bool celix_framework_isExecutorThread(framework_t *fw);
+
 #endif /* FRAMEWORK_PRIVATE_H_ */
@@ -49,6 +49,7 @@ celix_status_t serviceReference_create(registry_callback_t callback, bundle_pt r
         ref->callback = callback;
 		ref->referenceOwner = referenceOwner;
 		ref->registration = registration;
+        ref->serviceId = registration->serviceId;
         ref->service = NULL;
         serviceRegistration_getBundle(registration, &ref->registrationBundle);
 		celixThreadRwlock_create(&ref->lock, NULL);
@@ -35,6 +35,7 @@ struct serviceReference {
     registry_callback_t callback;
 	bundle_pt referenceOwner;
 	struct serviceRegistration * registration;
+    unsigned long serviceId; //service id of the registration, also valid after the reference is invalidated
     bundle_pt registrationBundle;
     const void* service;
 
@@ -73,6 +73,9 @@ static celix_status_t serviceRegistration_createInternal(registry_callback_t cal
 
 		reg->isUnregistering = false;
 		celixThreadRwlock_create(&reg->lock, NULL);
+		celixThreadMutex_create(&reg->useMutex, NULL);
+		celixThreadCondition_init(&reg->useCond, NULL);
+		reg->useCount = 0;
 
 		celixThreadRwlock_writeLock(&reg->lock);
 		serviceRegistration_initializeProperties(reg, dictionary);
@@ -90,20 +93,16 @@ static celix_status_t serviceRegistration_createInternal(registry_callback_t cal
 }
 
 void serviceRegistration_retain(service_registration_pt registration) {
-	celixThreadRwlock_writeLock(&registration->lock);
-	registration->refCount += 1;
-    celixThreadRwlock_unlock(&registration->lock);
+    __atomic_fetch_add(&registration->refCount, 1, __ATOMIC_RELAXED);
 }
 
 void serviceRegistration_release(service_registration_pt registration) {
-    celixThreadRwlock_writeLock(&registration->lock);
-    assert(registration->refCount > 0);
-	registration->refCount -= 1;
-	if (registration->refCount == 0) {
-		serviceRegistration_destroy(registration);
-	} else {
-        celixThreadRwlock_unlock(&registration->lock);
-	}
+    size_t count = __atomic_sub_fetch(&registration->refCount, 1, __ATOMIC_ACQ_REL);
+    assert(count != (size_t)-1);
+    if (count == 0) {
+        celixThreadRwlock_writeLock(&registration->lock);
+        serviceRegistration_destroy(registration);
+    }
 }
 
 static celix_status_t serviceRegistration_destroy(service_registration_pt registration) {
@@ -116,6 +115,8 @@ static celix_status_t serviceRegistration_destroy(service_registration_pt regist
 	properties_destroy(registration->properties);
 	celixThreadRwlock_unlock(&registration->lock);
     celixThreadRwlock_destroy(&registration->lock);
+    celixThreadCondition_destroy(&registration->useCond);
+    celixThreadMutex_destroy(&registration->useMutex);
 	free(registration);
 
 	return CELIX_SUCCESS;
@@ -159,6 +160,60 @@ bool serviceRegistration_isValid(service_registration_pt registration) {
     return isValid;
 }
 
+bool celix_serviceRegistration_markUnregistering(service_registration_pt registration) {
+    bool marked = false;
+    if (registration != NULL) {
+        celixThreadRwlock_writeLock(&registration->lock);
+        marked = registration->svcObj != NULL && !registration->isUnregistering;
+        registration->isUnregistering = true;
+        celixThreadRwlock_unlock(&registration->lock);
+    }
+    return marked;
+}
+
+bool celix_serviceRegistration_isUnregistering(service_registration_pt registration) {
+    bool unregistering = false;
+    if (registration != NULL) {
+        celixThreadRwlock_readLock(&registration->lock);
+        unregistering = registration->isUnregistering || registration->svcObj == NULL;
+        celixThreadRwlock_unlock(&registration->lock);
+    }
+    return unregistering;
+}
+
+bool celix_serviceRegistration_tryUse(service_registration_pt registration) {
+    bool used = false;
+    if (registration != NULL) {
+        //note the unregistering check and the increment are done under the useMutex, so that a
+        //celix_serviceRegistration_waitForUses call after marking the registration as unregistering sees the use.
+        celixThreadMutex_lock(&registration->useMutex);
+        used = !celix_serviceRegistration_isUnregistering(registration);
+        if (used) {
+            registration->useCount += 1;
+        }
+        celixThreadMutex_unlock(&registration->useMutex);
+    }
+    return used;
+}
+
+void celix_serviceRegistration_releaseUse(service_registration_pt registration) {
+    celixThreadMutex_lock(&registration->useMutex);
+    assert(registration->useCount > 0);
+    registration->useCount -= 1;
+    if (registration->useCount == 0) {
+        celixThreadCondition_broadcast(&registration->useCond);
+    }
+    celixThreadMutex_unlock(&registration->useMutex);
+}
+
+void celix_serviceRegistration_waitForUses(service_registration_pt registration) {
+    celixThreadMutex_lock(&registration->useMutex);
+    while (registration->useCount > 0) {
+        celixThreadCondition_wait(&registration->useCond, &registration->useMutex);
+    }
+    celixThreadMutex_unlock(&registration->useMutex);
+}
+
 celix_status_t serviceRegistration_unregister(service_registration_pt registration) {
 	celix_status_t status = CELIX_SUCCESS;
 
@@ -54,9 +54,13 @@ struct serviceRegistration {
 	struct service *services;
 	int nrOfServices;
 
-	size_t refCount; //protected by mutex
+	size_t refCount; //atomic
 
 	celix_thread_rwlock_t lock;
+
+	celix_thread_mutex_t useMutex; //protects useCount
+	celix_thread_cond_t useCond;
+	size_t useCount; //nr of active uses of the service (see celix_serviceRegistration_tryUse)
 };
 
 service_registration_pt serviceRegistration_create(registry_callback_t callback, bundle_pt bundle, const char* serviceName, unsigned long serviceId, const void * serviceObject, properties_pt dictionary);
@@ -66,8 +70,32 @@ void serviceRegistration_retain(service_registration_pt registration);
 void serviceRegistration_release(service_registration_pt registration);
 
 bool serviceRegistration_isValid(service_registration_pt registration);
+
+/**
+ * Marks the registration as unregistering.
+ * @return true if the registration was valid and not already unregistering.
+ */
+bool celix_serviceRegistration_markUnregistering(service_registration_pt registration);
+bool celix_serviceRegistration_isUnregistering(service_registration_pt registration);
 void serviceRegistration_invalidate(service_registration_pt registration);
 
+/**
+ * Marks the start of a use of the service. Unregistration of the service will wait until all uses are released.
+ * @return true if the use is started, false if the registration is not valid or already unregistering.
+ */
+bool celix_serviceRegistration_tryUse(service_registration_pt registration);
+
+/**
+ * Marks the end of a use of the service started with celix_serviceRegistration_tryUse.
+ */
+void celix_serviceRegistration_releaseUse(service_registration_pt registration);
+
+/**
+ * Waits until all uses of the service are released.
+ * Should only be called for a registration which is unregistering, so that no new uses can be started.
+ */
+void celix_serviceRegistration_waitForUses(service_registration_pt registration);
+
 celix_status_t serviceRegistration_getService(service_registration_pt registration, bundle_pt bundle, const void **service);
 celix_status_t serviceRegistration_ungetService(service_registration_pt registration, bundle_pt bundle, const void **service);
 
@@ -17,6 +17,8 @@
  * under the License.
  */
 
+#include <ctype.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -28,6 +30,8 @@
 #include "celix_constants.h"
 #include "service_reference_private.h"
 #include "framework_private.h"
+#include "celix_bundle.h"
+#include "utils.h"
 
 #ifdef DEBUG
 #define CHECK_DELETED_REFERENCES true
@@ -35,6 +39,8 @@
 #define CHECK_DELETED_REFERENCES false
 #endif
 
+#define CELIX_SERVICE_REGISTRY_SNAPSHOT_INITIAL_CAPACITY 64
+
 static celix_status_t serviceRegistry_registerServiceInternal(service_registry_pt registry, bundle_pt bundle, const char* serviceName, const void * serviceObject, properties_pt dictionary, enum celix_service_type svcType, service_registration_pt *registration);
 static celix_status_t serviceRegistry_addHooks(service_registry_pt registry, const char* serviceName, const void *serviceObject, service_registration_pt registration);
 static celix_status_t serviceRegistry_removeHook(service_registry_pt registry, service_registration_pt registration);
@@ -48,6 +54,16 @@ static celix_status_t serviceRegistry_setReferenceStatus(service_registry_pt reg
                                                   bool deleted);
 static celix_status_t serviceRegistry_getUsingBundles(service_registry_pt registry, service_registration_pt reg, array_list_pt *bundles);
 static celix_status_t serviceRegistry_getServiceReference_internal(service_registry_pt registry, bundle_pt owner, service_registration_pt registration, service_reference_pt *out);
+static void serviceRegistry_addToIndices(service_registry_pt registry, service_registration_pt registration);
+static void serviceRegistry_removeFromIndices(service_registry_pt registry, service_registration_pt registration);
+static celix_service_registry_snapshot_t* serviceRegistry_createSnapshot(size_t capacity);
+static void serviceRegistry_publishSnapshot(service_registry_pt registry, celix_array_list_t *serviceNames, celix_array_list_t *retired);
+static void serviceRegistry_reclaimSnapshots(service_registry_pt registry, celix_array_list_t *retired);
+static service_registration_pt serviceRegistry_createRegistration(service_registry_pt registry, const celix_bundle_t *bundle, const char* serviceName, const void * serviceObject, properties_pt dictionary, enum celix_service_type svcType);
+static void serviceRegistry_addRegistrations(service_registry_pt registry, const celix_bundle_t *bundle, celix_array_list_t *registrations);
+static void serviceRegistry_removeRegistrations(service_registry_pt registry, const celix_bundle_t *bundle, celix_array_list_t *registrations);
+static void serviceRegistry_serviceChanged(service_registry_pt registry, celix_service_event_type_t eventType, celix_array_list_t *registrations);
+static void serviceRegistry_addIfMatching(service_registry_pt registry, long ownerId, service_registration_pt registration, const char *serviceName, filter_pt filter, array_list_pt matchingRegistrations);
 
 static celix_service_registry_listener_hook_entry_t* celix_createHookEntry(long svcId, celix_listener_hook_service_t*);
 static void celix_waitAndDestroyHookEntry(celix_service_registry_listener_hook_entry_t *entry);
@@ -72,9 +88,13 @@ celix_status_t serviceRegistry_create(framework_pt framework, serviceChanged_fun
 		reg->framework = framework;
 		reg->currentServiceId = 1UL;
 		reg->serviceReferences = hashMap_create(NULL, NULL, NULL, NULL);
+		reg->registrationsByServiceName = celix_stringHashMap_create();
+		reg->registrationsByServiceId = celix_longHashMap_create();
+		reg->snapshot = serviceRegistry_createSnapshot(CELIX_SERVICE_REGISTRY_SNAPSHOT_INITIAL_CAPACITY);
+		reg->epoch = celix_epoch_create();
 
         reg->checkDeletedReferences = CHECK_DELETED_REFERENCES;
-        reg->deletedServiceReferences = hashMap_create(NULL, NULL, NULL, NULL);
+        reg->deletedServiceReferences = celix_ptrHashMap_create();
 
 		arrayList_create(&reg->listenerHooks);
 
@@ -125,6 +145,23 @@ celix_status_t serviceRegistry_destroy(service_registry_pt registry) {
     //assert(size == 0);
     hashMap_destroy(registry->serviceReferences, false, false);
 
+    //destroy registration indices, entries should already be removed when the registrations are unregistered
+    celix_string_hash_map_iterator_t nameIter = celix_stringHashMap_begin(registry->registrationsByServiceName);
+    for (; !celix_stringHashMapIterator_isEnd(&nameIter); celix_stringHashMapIterator_next(&nameIter)) {
+        celix_arrayList_destroy(nameIter.value);
+    }
+    celix_stringHashMap_destroy(registry->registrationsByServiceName);
+    celix_longHashMap_destroy(registry->registrationsByServiceId);
+    for (size_t i = 0; i < registry->snapshot->capacity; ++i) {
+        celix_service_registry_snapshot_entry_t *entry = registry->snapshot->entries[i];
+        if (entry != NULL) {
+            free(entry->list);
+            free(entry);
+        }
+    }
+    free(registry->snapshot);
+    celix_epoch_destroy(registry->epoch);
+
     //destroy listener hooks
     size = celix_arrayList_size(registry->listenerHooks);
     for (int i = 0; i < celix_arrayList_size(registry->listenerHooks); ++i) {
@@ -133,7 +170,7 @@ celix_status_t serviceRegistry_destroy(service_registry_pt registry) {
     }
     celix_arrayList_destroy(registry->listenerHooks);
 
-    hashMap_destroy(registry->deletedServiceReferences, false, false);
+    celix_ptrHashMap_destroy(registry->deletedServiceReferences);
 
     free(registry);
 
@@ -178,85 +215,165 @@ celix_status_t serviceRegistry_registerServiceFactory(service_registry_pt regist
 }
 
 static celix_status_t serviceRegistry_registerServiceInternal(service_registry_pt registry, bundle_pt bundle, const char* serviceName, const void * serviceObject, properties_pt dictionary, enum celix_service_type svcType, service_registration_pt *registration) {
-	array_list_pt regs;
+    *registration = serviceRegistry_createRegistration(registry, bundle, serviceName, serviceObject, dictionary, svcType);
 
-	if (svcType == CELIX_DEPRECATED_FACTORY_SERVICE) {
-        *registration = serviceRegistration_createServiceFactory(registry->callback, bundle, serviceName,
-                                                                 ++registry->currentServiceId, serviceObject,
-                                                                 dictionary);
-    } else if (svcType == CELIX_FACTORY_SERVICE) {
-        *registration = celix_serviceRegistration_createServiceFactory(registry->callback, bundle, serviceName, ++registry->currentServiceId, (celix_service_factory_t*)serviceObject, dictionary);
-	} else { //plain
-	    *registration = serviceRegistration_create(registry->callback, bundle, serviceName, ++registry->currentServiceId, serviceObject, dictionary);
-	}
+    celix_inline_array_list_t buffer;
+    celix_array_list_t *registrations = celix_arrayList_initInline(&buffer);
+    celix_arrayList_add(registrations, *registration);
+    serviceRegistry_addRegistrations(registry, bundle, registrations);
+    celix_arrayList_destroy(registrations);
 
-    //long id;
-    //bundle_getBundleId(bundle, &id);
-    //fprintf(stderr, "REG: Registering service '%s' for bundle id %li with reg pointer %p\n", serviceName, id, *registration);
+	return CELIX_SUCCESS;
+}
+
+celix_status_t celix_serviceRegistry_registerServices(celix_service_registry_t *registry, const celix_bundle_t *bnd, celix_service_registry_batch_entry_t *entries, size_t nrOfEntries) {
+    celix_array_list_t *registrations = celix_arrayList_create();
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        celix_service_registry_batch_entry_t *entry = &entries[i];
+        if (entry->factory != NULL) {
+            entry->registration = serviceRegistry_createRegistration(registry, bnd, entry->serviceName, entry->factory, entry->properties, CELIX_FACTORY_SERVICE);
+        } else {
+            entry->registration = serviceRegistry_createRegistration(registry, bnd, entry->serviceName, entry->svc, entry->properties, CELIX_PLAIN_SERVICE);
+        }
+        celix_arrayList_add(registrations, entry->registration);
+    }
+    serviceRegistry_addRegistrations(registry, bnd, registrations);
+    celix_arrayList_destroy(registrations);
+    return CELIX_SUCCESS;
+}
 
+static service_registration_pt serviceRegistry_createRegistration(service_registry_pt registry, const celix_bundle_t *bundle, const char* serviceName, const void * serviceObject, properties_pt dictionary, enum celix_service_type svcType) {
+    unsigned long svcId = __atomic_add_fetch(&registry->currentServiceId, 1UL, __ATOMIC_RELAXED);
+    bundle_pt bnd = (bundle_pt)bundle;
+    if (svcType == CELIX_DEPRECATED_FACTORY_SERVICE) {
+        return serviceRegistration_createServiceFactory(registry->callback, bnd, serviceName, svcId, serviceObject, dictionary);
+    } else if (svcType == CELIX_FACTORY_SERVICE) {
+        return celix_serviceRegistration_createServiceFactory(registry->callback, bnd, serviceName, svcId, (celix_service_factory_t*)serviceObject, dictionary);
+    } else { //plain
+        return serviceRegistration_create(registry->callback, bnd, serviceName, svcId, serviceObject, dictionary);
+    }
+}
 
-    serviceRegistry_addHooks(registry, serviceName, serviceObject, *registration);
+/**
+ * Adds the registrations using a single registry write lock and dispatches the REGISTERED events as one batch.
+ */
+static void serviceRegistry_addRegistrations(service_registry_pt registry, const celix_bundle_t *bundle, celix_array_list_t *registrations) {
+    int size = celix_arrayList_size(registrations);
+    celix_array_list_t *serviceNames = celix_arrayList_takeScratch();
+    for (int i = 0; i < size; ++i) {
+        service_registration_pt registration = celix_arrayList_get(registrations, i);
+        const char *serviceName = NULL;
+        serviceRegistration_getServiceName(registration, &serviceName);
+        serviceRegistry_addHooks(registry, serviceName, registration->svcObj, registration);
+        celix_arrayList_add(serviceNames, (void*)serviceName);
+    }
 
 	celixThreadRwlock_writeLock(&registry->lock);
-	regs = (array_list_pt) hashMap_get(registry->serviceRegistrations, bundle);
+	array_list_pt regs = (array_list_pt) hashMap_get(registry->serviceRegistrations, bundle);
 	if (regs == NULL) {
 		regs = NULL;
 		arrayList_create(&regs);
-        hashMap_put(registry->serviceRegistrations, bundle, regs);
+        hashMap_put(registry->serviceRegistrations, (void*)bundle, regs);
+    }
+    for (int i = 0; i < size; ++i) {
+        service_registration_pt registration = celix_arrayList_get(registrations, i);
+        arrayList_add(regs, registration);
+        serviceRegistry_addToIndices(registry, registration);
     }
-	arrayList_add(regs, *registration);
+    celix_array_list_t *retired = celix_arrayList_takeScratch();
+    serviceRegistry_publishSnapshot(registry, serviceNames, retired);
 	celixThreadRwlock_unlock(&registry->lock);
+    serviceRegistry_reclaimSnapshots(registry, retired);
+    celix_arrayList_releaseScratch(serviceNames);
 
-	if (registry->serviceChanged != NULL) {
-		registry->serviceChanged(registry->framework, OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED, *registration, NULL);
-	}
-
-	return CELIX_SUCCESS;
+    serviceRegistry_serviceChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED, registrations);
 }
 
 celix_status_t serviceRegistry_unregisterService(service_registry_pt registry, bundle_pt bundle, service_registration_pt registration) {
-	// array_list_t clients;
-	array_list_pt regs;
+    celix_inline_array_list_t buffer;
+    celix_array_list_t *registrations = celix_arrayList_initInline(&buffer);
+    celix_arrayList_add(registrations, registration);
+    serviceRegistry_removeRegistrations(registry, bundle, registrations);
+    celix_arrayList_destroy(registrations);
+	return CELIX_SUCCESS;
+}
 
-    //fprintf(stderr, "REG: Unregistering service registration with pointer %p\n", registration);
+celix_status_t celix_serviceRegistry_unregisterServices(celix_service_registry_t *registry, const celix_bundle_t *bnd, celix_array_list_t *registrations) {
+    serviceRegistry_removeRegistrations(registry, bnd, registrations);
+    return CELIX_SUCCESS;
+}
 
-	serviceRegistry_removeHook(registry, registration);
+/**
+ * Removes the registrations using a single registry write lock, dispatches the UNREGISTERING events as one batch
+ * and releases the registrations.
+ */
+static void serviceRegistry_removeRegistrations(service_registry_pt registry, const celix_bundle_t *bundle, celix_array_list_t *registrations) {
+    int size = celix_arrayList_size(registrations);
+    celix_array_list_t *serviceNames = celix_arrayList_takeScratch();
+    for (int i = 0; i < size; ++i) {
+        service_registration_pt registration = celix_arrayList_get(registrations, i);
+        const char *serviceName = NULL;
+        serviceRegistration_getServiceName(registration, &serviceName);
+        serviceRegistry_removeHook(registry, registration);
+        celix_arrayList_add(serviceNames, (void*)serviceName);
+    }
 
 	celixThreadRwlock_writeLock(&registry->lock);
-	regs = (array_list_pt) hashMap_get(registry->serviceRegistrations, bundle);
-	if (regs != NULL) {
-		arrayList_removeElement(regs, registration);
-        int size = arrayList_size(regs);
-        if (size == 0) {
-            arrayList_destroy(regs);
-            hashMap_remove(registry->serviceRegistrations, bundle);
+	array_list_pt regs = (array_list_pt) hashMap_get(registry->serviceRegistrations, bundle);
+    for (int i = 0; i < size; ++i) {
+        service_registration_pt registration = celix_arrayList_get(registrations, i);
+        if (regs != NULL) {
+            arrayList_removeElement(regs, registration);
         }
+        serviceRegistry_removeFromIndices(registry, registration);
+    }
+	if (regs != NULL && arrayList_size(regs) == 0) {
+        arrayList_destroy(regs);
+        hashMap_remove(registry->serviceRegistrations, bundle);
 	}
+    celix_array_list_t *retired = celix_arrayList_takeScratch();
+    serviceRegistry_publishSnapshot(registry, serviceNames, retired);
 	celixThreadRwlock_unlock(&registry->lock);
+    //note the unregistered registrations are released after the reclaim, so no lookup can still use them
+    serviceRegistry_reclaimSnapshots(registry, retired);
+    celix_arrayList_releaseScratch(serviceNames);
 
-	if (registry->serviceChanged != NULL) {
-		registry->serviceChanged(registry->framework, OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING, registration, NULL);
-	}
-
+    serviceRegistry_serviceChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING, registrations);
 
 	celixThreadRwlock_readLock(&registry->lock);
     //invalidate service references
     hash_map_iterator_pt iter = hashMapIterator_create(registry->serviceReferences);
     while (hashMapIterator_hasNext(iter)) {
         hash_map_pt refsMap = hashMapIterator_nextValue(iter);
-        service_reference_pt ref = refsMap != NULL ?
-                                   hashMap_get(refsMap, (void*)registration->serviceId) : NULL;
-        if (ref != NULL) {
-            serviceReference_invalidate(ref);
+        for (int i = 0; refsMap != NULL && i < size; ++i) {
+            service_registration_pt registration = celix_arrayList_get(registrations, i);
+            service_reference_pt ref = hashMap_get(refsMap, (void*)registration->serviceId);
+            if (ref != NULL) {
+                serviceReference_invalidate(ref);
+            }
         }
     }
     hashMapIterator_destroy(iter);
 	celixThreadRwlock_unlock(&registry->lock);
 
-	serviceRegistration_invalidate(registration);
-    serviceRegistration_release(registration);
+    for (int i = 0; i < size; ++i) {
+        service_registration_pt registration = celix_arrayList_get(registrations, i);
+        //wait for the uses started before the registration was marked as unregistering (e.g. celix_bundleContext_useService)
+        celix_serviceRegistration_waitForUses(registration);
+        serviceRegistration_invalidate(registration);
+        serviceRegistration_release(registration);
+    }
+}
 
-	return CELIX_SUCCESS;
+static void serviceRegistry_serviceChanged(service_registry_pt registry, celix_service_event_type_t eventType, celix_array_list_t *registrations) {
+    int size = celix_arrayList_size(registrations);
+    if (registry->serviceChangedBatch != NULL && size > 1) {
+        registry->serviceChangedBatch(registry->framework, eventType, registrations);
+    } else if (registry->serviceChanged != NULL) {
+        for (int i = 0; i < size; ++i) {
+            registry->serviceChanged(registry->framework, eventType, celix_arrayList_get(registrations, i), NULL);
+        }
+    }
 }
 
 celix_status_t serviceRegistry_clearServiceRegistrations(service_registry_pt registry, bundle_pt bundle) {
@@ -307,6 +424,23 @@ celix_status_t serviceRegistry_getServiceReference(service_registry_pt registry,
                                                    service_registration_pt registration, service_reference_pt *out) {
 	celix_status_t status = CELIX_SUCCESS;
 
+	//most references already exist and only have to be retained, for that a read lock is enough because references
+	//are only released with the write lock
+	service_reference_pt ref = NULL;
+	celixThreadRwlock_readLock(&registry->lock);
+	hash_map_pt references = hashMap_get(registry->serviceReferences, owner);
+	if (references != NULL) {
+	    ref = hashMap_get(references, (void*)registration->serviceId);
+	    if (ref != NULL) {
+	        serviceReference_retain(ref);
+	    }
+	}
+	celixThreadRwlock_unlock(&registry->lock);
+	if (ref != NULL) {
+	    *out = ref;
+	    return status;
+	}
+
 	if(celixThreadRwlock_writeLock(&registry->lock) == CELIX_SUCCESS) {
 	    status = serviceRegistry_getServiceReference_internal(registry, owner, registration, out);
 	    celixThreadRwlock_unlock(&registry->lock);
@@ -338,7 +472,7 @@ static celix_status_t serviceRegistry_getServiceReference_internal(service_regis
         }
         if (status == CELIX_SUCCESS) {
             hashMap_put(references, (void*)registration->serviceId, ref);
-            hashMap_put(registry->deletedServiceReferences, ref, (void *)false);
+            celix_ptrHashMap_put(registry->deletedServiceReferences, ref, (void *)false);
         }
     } else {
         serviceReference_retain(ref);
@@ -354,56 +488,227 @@ static celix_status_t serviceRegistry_getServiceReference_internal(service_regis
 	return status;
 }
 
+static void serviceRegistry_addToIndices(service_registry_pt registry, service_registration_pt registration) {
+    //only call after write locked registry RWlock
+    const char *serviceName = NULL;
+    long svcId = serviceRegistration_getServiceId(registration);
+    serviceRegistration_getServiceName(registration, &serviceName);
+
+    celix_longHashMap_put(registry->registrationsByServiceId, svcId, registration);
+    celix_array_list_t *regs = celix_stringHashMap_get(registry->registrationsByServiceName, serviceName);
+    if (regs == NULL) {
+        regs = celix_arrayList_create();
+        celix_stringHashMap_put(registry->registrationsByServiceName, serviceName, regs);
+    }
+    celix_arrayList_add(regs, registration);
+}
+
+static void serviceRegistry_removeFromIndices(service_registry_pt registry, service_registration_pt registration) {
+    //only call after write locked registry RWlock
+    const char *serviceName = NULL;
+    long svcId = serviceRegistration_getServiceId(registration);
+    serviceRegistration_getServiceName(registration, &serviceName);
+
+    if (celix_longHashMap_get(registry->registrationsByServiceId, svcId) == registration) {
+        celix_longHashMap_remove(registry->registrationsByServiceId, svcId);
+    }
+    celix_array_list_t *regs = celix_stringHashMap_get(registry->registrationsByServiceName, serviceName);
+    if (regs != NULL) {
+        celix_arrayList_remove(regs, registration);
+        if (celix_arrayList_size(regs) == 0) {
+            celix_stringHashMap_remove(registry->registrationsByServiceName, serviceName);
+            celix_arrayList_destroy(regs);
+        }
+    }
+}
+
+static celix_service_registry_snapshot_t* serviceRegistry_createSnapshot(size_t capacity) {
+    celix_service_registry_snapshot_t *snapshot = calloc(1, sizeof(*snapshot) + sizeof(snapshot->entries[0]) * capacity);
+    snapshot->capacity = capacity;
+    return snapshot;
+}
+
+/**
+ * Returns the slot of the service name entry or the (empty) slot where the entry should be added.
+ */
+static celix_service_registry_snapshot_entry_t** serviceRegistry_findSnapshotSlot(celix_service_registry_snapshot_t *snapshot, const char *serviceName) {
+    size_t mask = snapshot->capacity - 1;
+    size_t index = utils_stringHash(serviceName) & mask;
+    while (true) {
+        celix_service_registry_snapshot_entry_t **slot = &snapshot->entries[index];
+        celix_service_registry_snapshot_entry_t *entry = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+        if (entry == NULL || strcmp(entry->serviceName, serviceName) == 0) {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+/**
+ * Replaces the (half full) snapshot table with a new table without the entries which have no registrations.
+ * The new table is twice as large, unless at most a quarter of the old table is used by entries with registrations.
+ */
+static void serviceRegistry_rehashSnapshot(service_registry_pt registry, celix_array_list_t *retired) {
+    //only call after write locked registry RWlock
+    celix_service_registry_snapshot_t *old = registry->snapshot;
+    size_t nrOfUsedEntries = 0;
+    for (size_t i = 0; i < old->capacity; ++i) {
+        if (old->entries[i] != NULL && old->entries[i]->list != NULL) {
+            nrOfUsedEntries += 1;
+        }
+    }
+    size_t capacity = (nrOfUsedEntries + 1) * 4 > old->capacity ? old->capacity * 2 : old->capacity;
+    celix_service_registry_snapshot_t *snapshot = serviceRegistry_createSnapshot(capacity);
+    for (size_t i = 0; i < old->capacity; ++i) {
+        celix_service_registry_snapshot_entry_t *entry = old->entries[i];
+        if (entry != NULL && entry->list != NULL) {
+            *serviceRegistry_findSnapshotSlot(snapshot, entry->serviceName) = entry;
+            snapshot->size += 1;
+        } else if (entry != NULL) {
+            celix_arrayList_add(retired, entry);
+        }
+    }
+    __atomic_store_n(&registry->snapshot, snapshot, __ATOMIC_RELEASE);
+    celix_arrayList_add(retired, old);
+}
+
+static void serviceRegistry_publishSnapshot(service_registry_pt registry, celix_array_list_t *serviceNames, celix_array_list_t *retired) {
+    //only call after write locked registry RWlock
+    //note only the lists of the changed service names are copied, replaced data is added to retired
+    for (int n = 0; n < celix_arrayList_size(serviceNames); ++n) {
+        const char *serviceName = celix_arrayList_get(serviceNames, n);
+        celix_array_list_t *regs = celix_stringHashMap_get(registry->registrationsByServiceName, serviceName);
+        int size = regs == NULL ? 0 : celix_arrayList_size(regs);
+
+        celix_service_registry_snapshot_entry_t **slot = serviceRegistry_findSnapshotSlot(registry->snapshot, serviceName);
+        celix_service_registry_snapshot_entry_t *entry = *slot;
+        if (entry == NULL && size == 0) {
+            continue;
+        } else if (entry == NULL) {
+            if ((registry->snapshot->size + 1) * 2 > registry->snapshot->capacity) {
+                serviceRegistry_rehashSnapshot(registry, retired);
+                slot = serviceRegistry_findSnapshotSlot(registry->snapshot, serviceName);
+            }
+            size_t len = strlen(serviceName) + 1;
+            entry = calloc(1, sizeof(*entry) + len);
+            memcpy(entry->serviceName, serviceName, len);
+            __atomic_store_n(slot, entry, __ATOMIC_RELEASE);
+            registry->snapshot->size += 1;
+        }
+
+        celix_service_registry_snapshot_list_t *list = NULL;
+        if (size > 0) {
+            list = malloc(sizeof(*list) + sizeof(service_registration_pt) * size);
+            list->size = size;
+            for (int i = 0; i < size; ++i) {
+                list->registrations[i] = celix_arrayList_get(regs, i);
+            }
+        }
+        celix_service_registry_snapshot_list_t *old = entry->list;
+        __atomic_store_n(&entry->list, list, __ATOMIC_RELEASE);
+        if (old != NULL) {
+            celix_arrayList_add(retired, old);
+        }
+    }
+}
+
+static void serviceRegistry_reclaimSnapshots(service_registry_pt registry, celix_array_list_t *retired) {
+    //note called without the registry lock, so that lookups and other writers are not blocked by the synchronize
+    if (celix_arrayList_size(retired) > 0) {
+        celix_epoch_synchronize(registry->epoch);
+        for (int i = 0; i < celix_arrayList_size(retired); ++i) {
+            free(celix_arrayList_get(retired, i));
+        }
+    }
+    celix_arrayList_releaseScratch(retired);
+}
+
+static void serviceRegistry_addIfMatching(service_registry_pt registry, long ownerId, service_registration_pt registration, const char *serviceName, filter_pt filter, array_list_pt matchingRegistrations) {
+    //only call after locked registry RWlock
+    bool matched = true;
+    const char *className = NULL;
+    serviceRegistration_getServiceName(registration, &className);
+    if (serviceName != NULL) {
+        matched = className != NULL && strcmp(className, serviceName) == 0;
+    }
+    if (matched && filter != NULL) {
+        struct timespec start;
+        celix_registryStatistics_startTimer(registry->statistics, &start);
+        properties_pt props = NULL;
+        serviceRegistration_getProperties(registration, &props);
+        filter_match(filter, props, &matched);
+        celix_registryStatistics_record(registry->statistics, CELIX_REGISTRY_STATISTICS_FILTER_MATCH, ownerId, className, &start);
+    }
+    if (matched && serviceRegistration_isValid(registration)) {
+        serviceRegistration_retain(registration);
+        arrayList_add(matchingRegistrations, registration);
+    }
+}
+
 celix_status_t serviceRegistry_getServiceReferences(service_registry_pt registry, bundle_pt owner, const char *serviceName, filter_pt filter, array_list_pt *out) {
 	celix_status_t status;
-	hash_map_iterator_pt iterator;
     array_list_pt references = NULL;
 	array_list_pt matchingRegistrations = NULL;
-    bool matchResult;
+
+    struct timespec start;
+    celix_registryStatistics_startTimer(registry->statistics, &start);
+    long ownerId = registry->statistics == NULL || owner == NULL ? -1L : celix_bundle_getId(owner);
 
     status = arrayList_create(&references);
     status = CELIX_DO_IF(status, arrayList_create(&matchingRegistrations));
 
-    celixThreadRwlock_readLock(&registry->lock);
-	iterator = hashMapIterator_create(registry->serviceRegistrations);
-	while (status == CELIX_SUCCESS && hashMapIterator_hasNext(iterator)) {
-		array_list_pt regs = (array_list_pt) hashMapIterator_nextValue(iterator);
-		unsigned int regIdx;
-		for (regIdx = 0; (regs != NULL) && regIdx < arrayList_size(regs); regIdx++) {
-			service_registration_pt registration = (service_registration_pt) arrayList_get(regs, regIdx);
-			properties_pt props = NULL;
-
-			status = serviceRegistration_getProperties(registration, &props);
-			if (status == CELIX_SUCCESS) {
-				bool matched = false;
-				matchResult = false;
-				if (filter != NULL) {
-					filter_match(filter, props, &matchResult);
-				}
-				if ((serviceName == NULL) && ((filter == NULL) || matchResult)) {
-					matched = true;
-				} else if (serviceName != NULL) {
-					const char *className = NULL;
-					matchResult = false;
-					serviceRegistration_getServiceName(registration, &className);
-					if (filter != NULL) {
-						filter_match(filter, props, &matchResult);
-					}
-					if ((strcmp(className, serviceName) == 0) && ((filter == NULL) || matchResult)) {
-						matched = true;
-					}
-				}
-				if (matched) {
-					if (serviceRegistration_isValid(registration)) {
-                        serviceRegistration_retain(registration);
-                        arrayList_add(matchingRegistrations, registration);
-					}
-				}
-			}
-		}
-	}
-    celixThreadRwlock_unlock(&registry->lock);
-	hashMapIterator_destroy(iterator);
+    //use the indices if the service name or service id is known upfront, otherwise fall back to scanning all registrations
+    //note only a plain decimal service id is used for the index, other values (e.g. "5.0" or "+5") can still match
+    //service ids when compared as numbers and are handled by the service name index or the full scan.
+    bool svcIdIndexed = false;
+    unsigned long svcId = 0;
+    const char *indexedName = serviceName;
+    if (filter != NULL) {
+        const char *svcIdStr = celix_filter_findMandatoryEqualityValue(filter, OSGI_FRAMEWORK_SERVICE_ID);
+        if (svcIdStr != NULL && isdigit((unsigned char)svcIdStr[0])) {
+            char *endptr = NULL;
+            errno = 0;
+            svcId = strtoul(svcIdStr, &endptr, 10);
+            svcIdIndexed = *endptr == '\0' && errno == 0;
+        }
+    }
+    if (indexedName == NULL && filter != NULL) {
+        indexedName = celix_filter_findMandatoryEqualityValue(filter, OSGI_FRAMEWORK_OBJECTCLASS);
+    }
+
+    if (status != CELIX_SUCCESS) {
+        //nop
+    } else if (svcIdIndexed) {
+        celixThreadRwlock_readLock(&registry->lock);
+        service_registration_pt registration = celix_longHashMap_get(registry->registrationsByServiceId, (long)svcId);
+        if (registration != NULL) {
+            serviceRegistry_addIfMatching(registry, ownerId, registration, serviceName, filter, matchingRegistrations);
+        }
+        celixThreadRwlock_unlock(&registry->lock);
+    } else if (indexedName != NULL) {
+        //note no registry lock, the registrations in the snapshot stay valid until the read section is exited
+        int token = celix_epoch_enter(registry->epoch);
+        celix_service_registry_snapshot_t *snapshot = __atomic_load_n(&registry->snapshot, __ATOMIC_SEQ_CST);
+        celix_service_registry_snapshot_entry_t *entry = *serviceRegistry_findSnapshotSlot(snapshot, indexedName);
+        celix_service_registry_snapshot_list_t *list = entry == NULL ? NULL : __atomic_load_n(&entry->list, __ATOMIC_ACQUIRE);
+        size_t size = list == NULL ? 0 : list->size;
+        for (size_t i = 0; i < size; ++i) {
+            serviceRegistry_addIfMatching(registry, ownerId, list->registrations[i], serviceName, filter, matchingRegistrations);
+        }
+        celix_epoch_exit(registry->epoch, token);
+    } else {
+        celixThreadRwlock_readLock(&registry->lock);
+        hash_map_iterator_t iter = hashMapIterator_construct(registry->serviceRegistrations);
+        while (hashMapIterator_hasNext(&iter)) {
+            array_list_pt regs = hashMapIterator_nextValue(&iter);
+            int size = regs == NULL ? 0 : celix_arrayList_size(regs);
+            for (int i = 0; i < size; ++i) {
+                service_registration_pt registration = celix_arrayList_get(regs, i);
+                serviceRegistry_addIfMatching(registry, ownerId, registration, serviceName, filter, matchingRegistrations);
+            }
+        }
+        celixThreadRwlock_unlock(&registry->lock);
+    }
 
     if (status == CELIX_SUCCESS) {
         unsigned int i;
@@ -434,6 +739,8 @@ celix_status_t serviceRegistry_getServiceReferences(service_registry_pt registry
         framework_logIfError(logger, status, NULL, "Cannot get service references");
     }
 
+    celix_registryStatistics_record(registry->statistics, CELIX_REGISTRY_STATISTICS_LOOKUP, ownerId, indexedName, &start);
+
 	return status;
 }
 
@@ -467,10 +774,16 @@ celix_status_t serviceRegistry_ungetServiceReference(service_registry_pt registr
     size_t count = 0;
     reference_status_t refStatus;
 
+    if (reference == NULL) {
+        fw_log(logger, OSGI_FRAMEWORK_LOG_ERROR, "Cannot unget a NULL service reference");
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
     celixThreadRwlock_writeLock(&registry->lock);
     serviceRegistry_checkReference(registry, reference, &refStatus);
     if (refStatus == REF_ACTIVE) {
         serviceReference_getUsageCount(reference, &count);
+        void *refId = (void*)reference->serviceId;
         serviceReference_release(reference, &destroyed);
         if (destroyed) {
 
@@ -479,28 +792,10 @@ celix_status_t serviceRegistry_ungetServiceReference(service_registry_pt registr
             }
 
             hash_map_pt refsMap = hashMap_get(registry->serviceReferences, bundle);
+            service_reference_pt ref = refsMap == NULL ? NULL : hashMap_get(refsMap, refId);
 
-            unsigned long refId = 0UL;
-            service_reference_pt ref = NULL;
-
-            if (refsMap != NULL) {
-                hash_map_iterator_t iter = hashMapIterator_construct(refsMap);
-                while (hashMapIterator_hasNext(&iter)) {
-                    hash_map_entry_pt entry = hashMapIterator_nextEntry(&iter);
-                    refId = (unsigned long) hashMapEntry_getKey(entry); //note could be invalid e.g. freed
-                    ref = hashMapEntry_getValue(entry);
-
-                    if (ref == reference) {
-                        break;
-                    } else {
-                        ref = NULL;
-                        refId = 0UL;
-                    }
-                }
-            }
-
-            if (ref != NULL) {
-                hashMap_remove(refsMap, (void*)refId);
+            if (ref == reference) {
+                hashMap_remove(refsMap, refId);
                 int size = hashMap_size(refsMap);
                 if (size == 0) {
                     hashMap_destroy(refsMap, false, false);
@@ -524,7 +819,7 @@ static celix_status_t serviceRegistry_setReferenceStatus(service_registry_pt reg
                                                   bool deleted) {
     //precondition write locked on registry->lock
     if (registry->checkDeletedReferences) {
-        hashMap_put(registry->deletedServiceReferences, reference, (void *) deleted);
+        celix_ptrHashMap_put(registry->deletedServiceReferences, reference, (void *) deleted);
     }
     return CELIX_SUCCESS;
 }
@@ -543,8 +838,8 @@ static celix_status_t serviceRegistry_checkReference(service_registry_pt registr
     if (registry->checkDeletedReferences) {
         reference_status_t refStatus = REF_UNKNOWN;
 
-        if (hashMap_containsKey(registry->deletedServiceReferences, ref)) {
-            bool deleted = (bool) hashMap_get(registry->deletedServiceReferences, ref);
+        if (celix_ptrHashMap_hasKey(registry->deletedServiceReferences, ref)) {
+            bool deleted = (bool) celix_ptrHashMap_get(registry->deletedServiceReferences, ref);
             refStatus = deleted ? REF_DELETED : REF_ACTIVE;
         }
 
@@ -815,6 +1110,14 @@ void serviceRegistry_callHooksForListenerFilter(service_registry_pt registry, ce
     celix_arrayList_destroy(infos);
 }
 
+void celix_serviceRegistry_setStatistics(service_registry_pt registry, celix_registry_statistics_t *statistics) {
+    registry->statistics = statistics;
+}
+
+void celix_serviceRegistry_setServiceChangedBatchCallback(service_registry_pt registry, celix_serviceRegistry_serviceChangedBatch_fp serviceChangedBatch) {
+    registry->serviceChangedBatch = serviceChangedBatch;
+}
+
 size_t serviceRegistry_nrOfHooks(service_registry_pt registry) {
     celixThreadRwlock_readLock(&registry->lock);
     unsigned size = arrayList_size(registry->listenerHooks);
@@ -31,6 +31,38 @@
 #include "service_registry.h"
 #include "listener_hook_service.h"
 #include "service_reference.h"
+#include "celix_hash_map.h"
+#include "celix_registry_statistics.h"
+#include "celix_epoch.h"
+
+/**
+ * Immutable list of the registrations of a service name, part of a registry snapshot.
+ */
+typedef struct celix_service_registry_snapshot_list {
+	size_t size;
+	service_registration_pt registrations[];
+} celix_service_registry_snapshot_list_t;
+
+/**
+ * Entry of a service name in the registry snapshot. The list is replaced -copy on write- when the registrations of
+ * the service name change.
+ */
+typedef struct celix_service_registry_snapshot_entry {
+	celix_service_registry_snapshot_list_t *list; //atomic pointer, NULL if there are no registrations
+	char serviceName[];
+} celix_service_registry_snapshot_entry_t;
+
+/**
+ * Read-mostly snapshot of the service name index: a open addressing hash table (linear probing) of service name
+ * entries. Entries are only added to a published table, a half full table is replaced by a rehashed -and if needed
+ * twice as large- table. Replaced lists, entries and tables are freed -outside the registry lock- after an epoch
+ * synchronize.
+ */
+typedef struct celix_service_registry_snapshot {
+	size_t capacity; //power of 2
+	size_t size; //nr of used slots, only used by the writers
+	celix_service_registry_snapshot_entry_t *entries[]; //atomic pointers
+} celix_service_registry_snapshot_t;
 
 struct celix_serviceRegistry {
 	framework_pt framework;
@@ -39,17 +71,40 @@ struct celix_serviceRegistry {
 	hash_map_pt serviceRegistrations; //key = bundle (reg owner), value = list ( registration )
 	hash_map_pt serviceReferences; //key = bundle, value = map (key = serviceId, value = reference)
 
+	//indices on serviceRegistrations, used to select lookup candidates without scanning all registrations
+	celix_string_hash_map_t *registrationsByServiceName; //key = service name, value = list ( registration )
+	celix_long_hash_map_t *registrationsByServiceId; //key = serviceId, value = registration
+
+	//lookups with a service name use the published snapshot of registrationsByServiceName and do not take the lock
+	celix_service_registry_snapshot_t *snapshot; //atomic pointer, updated (under the write lock) when registrationsByServiceName changes
+	celix_epoch_t *epoch; //reclamation of replaced snapshot lists, entries and tables
+
 	bool checkDeletedReferences; //If enabled. check if provided service references are still valid
-	hash_map_pt deletedServiceReferences; //key = ref pointer, value = bool
+	celix_ptr_hash_map_t *deletedServiceReferences; //key = ref pointer, value = bool
 
 	serviceChanged_function_pt serviceChanged;
+	celix_serviceRegistry_serviceChangedBatch_fp serviceChangedBatch; //optional, used for batches of more than one registration
 	unsigned long currentServiceId;
 
 	array_list_pt listenerHooks; //celix_service_registry_listener_hook_entry_t*
 
+	celix_registry_statistics_t *statistics; //NULL if not enabled, owned by the framework
+
 	celix_thread_rwlock_t lock;
 };
 
+/**
+ * Sets the callback used to dispatch the service events of a batch (un)registration as one batch.
+ * If not set, the serviceChanged callback is called for every registration of a batch.
+ */
+void celix_serviceRegistry_setServiceChangedBatchCallback(service_registry_pt registry, celix_serviceRegistry_serviceChangedBatch_fp serviceChangedBatch);
+
+/**
+ * Sets the statistics used to record the service registry lookups and filter evaluations.
+ * Should be called before the service registry is used.
+ */
+void celix_serviceRegistry_setStatistics(service_registry_pt registry, celix_registry_statistics_t *statistics);
+
 typedef struct celix_service_registry_listener_hook_entry {
     long svcId;
     celix_listener_hook_service_t *hook;
@@ -32,15 +32,20 @@
 #include "celix_log.h"
 #include "bundle_context_private.h"
 #include "celix_array_list.h"
+#include "celix_bundle.h"
+#include "utils.h"
 
 static celix_status_t serviceTracker_track(celix_service_tracker_instance_t *tracker, service_reference_pt reference, celix_service_event_t *event);
 static celix_status_t serviceTracker_untrack(celix_service_tracker_instance_t *tracker, service_reference_pt reference, celix_service_event_t *event);
 static void serviceTracker_untrackTracked(celix_service_tracker_instance_t *tracker, celix_tracked_entry_t *tracked);
+static void serviceTracker_discardTracked(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked);
 static celix_status_t serviceTracker_invokeAddingService(celix_service_tracker_instance_t *tracker, service_reference_pt ref, void **svcOut);
 static celix_status_t serviceTracker_invokeAddService(celix_service_tracker_instance_t *tracker, celix_tracked_entry_t *tracked);
 static celix_status_t serviceTracker_invokeModifiedService(celix_service_tracker_instance_t *tracker, celix_tracked_entry_t *tracked);
 static celix_status_t serviceTracker_invokeRemovingService(celix_service_tracker_instance_t *tracker, celix_tracked_entry_t *tracked);
 static void serviceTracker_checkAndInvokeSetService(void *handle, void *highestSvc, const properties_t *props, const bundle_t *bnd);
+static bool serviceTracker_deferSetServiceUpdate(celix_service_tracker_instance_t *instance, const char *serviceName, const celix_service_event_t *event);
+static void serviceTracker_updatePendingSetService(celix_service_tracker_instance_t *instance);
 static bool serviceTracker_useHighestRankingServiceInternal(celix_service_tracker_instance_t *instance,
                                                             const char *serviceName /*sanity*/,
                                                             double waitTimeoutInSeconds,
@@ -49,7 +54,11 @@ static bool serviceTracker_useHighestRankingServiceInternal(celix_service_tracke
                                                             void (*useWithProperties)(void *handle, void *svc, const celix_properties_t *props),
                                                             void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner));
 
+static bool serviceTracker_waitForTrackedServiceInternal(celix_service_tracker_instance_t *instance, double waitTimeoutInSeconds);
+
 static void serviceTracker_addInstanceFromShutdownList(celix_service_tracker_instance_t *instance);
+static celix_registry_statistics_t* serviceTracker_getStatistics(celix_service_tracker_instance_t *instance);
+static void serviceTracker_recordCallback(celix_service_tracker_instance_t *instance, celix_registry_statistics_t *stats, const char *serviceName, const struct timespec *start);
 static void serviceTracker_remInstanceFromShutdownList(celix_service_tracker_instance_t *instance);
 
 static celix_thread_once_t g_once = CELIX_THREAD_ONCE_INIT;
@@ -69,6 +78,8 @@ static inline celix_tracked_entry_t* tracked_create(service_reference_pt ref, vo
     tracked->properties = props;
     tracked->serviceOwner = bnd;
     tracked->serviceName = celix_properties_get(props, OSGI_FRAMEWORK_OBJECTCLASS, "Error");
+    tracked->serviceId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1L);
+    tracked->serviceRanking = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, 0L);
 
     tracked->useCount = 1;
     celixThreadMutex_create(&tracked->mutex, NULL);
@@ -92,6 +103,52 @@ static inline void tracked_release(celix_tracked_entry_t *tracked) {
     celixThreadMutex_unlock(&tracked->mutex);
 }
 
+/**
+ * Adds the tracked entry to the trackedServices, keeping the list sorted on service ranking (highest first) and
+ * service id (lowest first). As result the first entry is the highest ranking service.
+ * Should be called with the instance lock write locked.
+ */
+static void serviceTracker_addTrackedSorted(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked) {
+    unsigned int low = 0;
+    unsigned int high = arrayList_size(instance->trackedServices);
+    while (low < high) {
+        unsigned int mid = low + (high - low) / 2;
+        celix_tracked_entry_t *visit = arrayList_get(instance->trackedServices, mid);
+        int compare = utils_compareServiceIdsAndRanking(tracked->serviceId, tracked->serviceRanking, visit->serviceId, visit->serviceRanking);
+        if (compare > 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    arrayList_addIndex(instance->trackedServices, low, tracked);
+    celix_longHashMap_put(instance->trackedServicesById, tracked->serviceId, tracked);
+}
+
+/**
+ * Removes the tracked entry from the trackedServices and the trackedServicesById.
+ * The entry is found with a binary search, so the ranking of the entry should not be updated before it is removed.
+ * Should be called with the instance lock write locked.
+ */
+static void serviceTracker_removeTrackedSorted(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked) {
+    unsigned int low = 0;
+    unsigned int high = arrayList_size(instance->trackedServices);
+    while (low < high) {
+        unsigned int mid = low + (high - low) / 2;
+        celix_tracked_entry_t *visit = arrayList_get(instance->trackedServices, mid);
+        int compare = utils_compareServiceIdsAndRanking(tracked->serviceId, tracked->serviceRanking, visit->serviceId, visit->serviceRanking);
+        if (compare >= 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    if (low < arrayList_size(instance->trackedServices) && arrayList_get(instance->trackedServices, low) == tracked) {
+        arrayList_remove(instance->trackedServices, low);
+    }
+    celix_longHashMap_remove(instance->trackedServicesById, tracked->serviceId);
+}
+
 static inline void tracked_waitAndDestroy(celix_tracked_entry_t *tracked) {
     celixThreadMutex_lock(&tracked->mutex);
     while (tracked->useCount != 0) {
@@ -169,6 +226,10 @@ celix_status_t serviceTracker_open(service_tracker_pt tracker) {
 
         celixThreadRwlock_create(&instance->lock, NULL);
         instance->trackedServices = celix_arrayList_create();
+        instance->trackedServicesById = celix_longHashMap_create();
+
+        celixThreadMutex_create(&instance->waitMutex, NULL);
+        celixThreadCondition_init(&instance->waitCond, NULL);
 
         celixThreadMutex_create(&instance->mutex, NULL);
         instance->currentHighestServiceId = -1;
@@ -232,9 +293,13 @@ static void* shutdownServiceTrackerInstanceHandler(void *data) {
     celixThreadMutex_destroy(&instance->closingLock);
     celixThreadCondition_destroy(&instance->activeServiceChangeCallsCond);
     celixThreadMutex_destroy(&instance->mutex);
+    celixThreadMutex_destroy(&instance->waitMutex);
+    celixThreadCondition_destroy(&instance->waitCond);
     celixThreadRwlock_destroy(&instance->lock);
     celix_arrayList_destroy(instance->trackedServices);
+    celix_longHashMap_destroy(instance->trackedServicesById);
     free(instance->filter);
+    free(instance->pendingSetServiceName);
 
     serviceTracker_remInstanceFromShutdownList(instance);
     free(instance);
@@ -266,6 +331,7 @@ celix_status_t serviceTracker_close(service_tracker_pt tracker) {
             trackedEntries[i] = (celix_tracked_entry_t *) arrayList_get(instance->trackedServices, i);
         }
         arrayList_clear(instance->trackedServices);
+        celix_longHashMap_clear(instance->trackedServicesById);
         celixThreadRwlock_unlock(&instance->lock);
 
         //loop trough tracked entries an untrack
@@ -389,20 +455,14 @@ void *serviceTracker_getServiceByReference(service_tracker_pt tracker, service_r
     //TODO deprecated warning -> not locked
     celix_tracked_entry_t *tracked;
     void *service = NULL;
-	unsigned int i;
 
     celixThreadRwlock_readLock(&tracker->instanceLock);
     celix_service_tracker_instance_t *instance = tracker->instance;
     if (instance != NULL) {
         celixThreadRwlock_readLock(&instance->lock);
-        for (i = 0; i < arrayList_size(instance->trackedServices); i++) {
-            bool equals = false;
-            tracked = (celix_tracked_entry_t *) arrayList_get(instance->trackedServices, i);
-            serviceReference_equals(reference, tracked->reference, &equals);
-            if (equals) {
-                service = tracked->service;
-                break;
-            }
+        tracked = celix_longHashMap_get(instance->trackedServicesById, (long)reference->serviceId);
+        if (tracked != NULL) {
+            service = tracked->service;
         }
         celixThreadRwlock_unlock(&instance->lock);
     }
@@ -436,6 +496,9 @@ void serviceTracker_serviceChanged(celix_service_listener_t *listener, celix_ser
                 //TODO
                 break;
         }
+        if (!event->moreEventsInBatch) {
+            serviceTracker_updatePendingSetService(instance);
+        }
         celixThreadMutex_lock(&instance->closingLock);
         assert(instance->activeServiceChangeCalls > 0);
         instance->activeServiceChangeCalls -= 1;
@@ -450,26 +513,44 @@ static celix_status_t serviceTracker_track(celix_service_tracker_instance_t *ins
 	celix_status_t status = CELIX_SUCCESS;
 
     celix_tracked_entry_t *found = NULL;
-    unsigned int i;
     
     bundleContext_retainServiceReference(instance->context, reference);
 
     celixThreadRwlock_readLock(&instance->lock);
-    for (i = 0; i < arrayList_size(instance->trackedServices); i++) {
-        bool equals = false;
-        celix_tracked_entry_t *visit = (celix_tracked_entry_t*) arrayList_get(instance->trackedServices, i);
-        serviceReference_equals(reference, visit->reference, &equals);
-        if (equals) {
-            found = visit;
-            tracked_retain(found);
-            break;
-        }
+    found = celix_longHashMap_get(instance->trackedServicesById, (long)reference->serviceId);
+    if (found != NULL) {
+        tracked_retain(found);
     }
     celixThreadRwlock_unlock(&instance->lock);
 
     if (found != NULL) {
+        //update the properties and ranking, the service properties of the registration can be replaced
+        service_registration_t *reg = NULL;
+        properties_t *props = NULL;
+        serviceReference_getServiceRegistration(reference, &reg);
+        if (reg != NULL) {
+            serviceRegistration_getProperties(reg, &props);
+        }
+        bool rankingChanged = false;
+        if (props != NULL) {
+            long ranking = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, 0L);
+            celixThreadRwlock_writeLock(&instance->lock);
+            found->properties = props;
+            if (ranking != found->serviceRanking) {
+                rankingChanged = true;
+                serviceTracker_removeTrackedSorted(instance, found);
+                found->serviceRanking = ranking;
+                serviceTracker_addTrackedSorted(instance, found);
+            }
+            celixThreadRwlock_unlock(&instance->lock);
+        }
+
         status = serviceTracker_invokeModifiedService(instance, found);
-        tracked_retain(found);
+        if (rankingChanged) {
+            serviceTracker_useHighestRankingServiceInternal(instance, found->serviceName, 0, instance, NULL, NULL, serviceTracker_checkAndInvokeSetService);
+        }
+        tracked_release(found);
+        bundleContext_ungetServiceReference(instance->context, reference); //already retained by the tracked entry
     } else if (status == CELIX_SUCCESS && found == NULL) {
         //NEW entry
         void *service = NULL;
@@ -490,11 +571,26 @@ static celix_status_t serviceTracker_track(celix_service_tracker_instance_t *ins
             celix_tracked_entry_t *tracked = tracked_create(reference, service, props, bnd);
 
             celixThreadRwlock_writeLock(&instance->lock);
-            arrayList_add(instance->trackedServices, tracked);
+            //note the service can be tracked concurrently, e.g. by the tracker open and a (async) REGISTERED event
+            bool alreadyTracked = celix_longHashMap_get(instance->trackedServicesById, tracked->serviceId) != NULL;
+            if (!alreadyTracked) {
+                serviceTracker_addTrackedSorted(instance, tracked);
+            }
             celixThreadRwlock_unlock(&instance->lock);
 
-            serviceTracker_invokeAddService(instance, tracked);
-            serviceTracker_useHighestRankingServiceInternal(instance, tracked->serviceName, 0, instance, NULL, NULL, serviceTracker_checkAndInvokeSetService);
+            if (alreadyTracked) {
+                serviceTracker_discardTracked(instance, tracked);
+            } else {
+                //wake up threads waiting for a tracked service
+                celixThreadMutex_lock(&instance->waitMutex);
+                celixThreadCondition_broadcast(&instance->waitCond);
+                celixThreadMutex_unlock(&instance->waitMutex);
+
+                serviceTracker_invokeAddService(instance, tracked);
+                if (!serviceTracker_deferSetServiceUpdate(instance, tracked->serviceName, event)) {
+                    serviceTracker_useHighestRankingServiceInternal(instance, tracked->serviceName, 0, instance, NULL, NULL, serviceTracker_checkAndInvokeSetService);
+                }
+            }
         }
     }
 
@@ -510,6 +606,9 @@ static void serviceTracker_checkAndInvokeSetService(void *handle, void *highestS
     if (highestSvc == NULL) {
         //no services available anymore -> unset == call with NULL
         update = true;
+        celixThreadMutex_lock(&instance->mutex);
+        instance->currentHighestServiceId = -1;
+        celixThreadMutex_unlock(&instance->mutex);
     } else {
         svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
     }
@@ -522,7 +621,11 @@ static void serviceTracker_checkAndInvokeSetService(void *handle, void *highestS
         }
         celixThreadMutex_unlock(&instance->mutex);
     }
-    if (update) {
+    bool hasSetCallback = instance->set != NULL || instance->setWithProperties != NULL || instance->setWithOwner != NULL;
+    if (update && hasSetCallback) {
+        celix_registry_statistics_t *stats = serviceTracker_getStatistics(instance);
+        struct timespec start;
+        celix_registryStatistics_startTimer(stats, &start);
         void *h = instance->callbackHandle;
         if (instance->set != NULL) {
             instance->set(h, highestSvc);
@@ -533,12 +636,62 @@ static void serviceTracker_checkAndInvokeSetService(void *handle, void *highestS
         if (instance->setWithOwner != NULL) {
             instance->setWithOwner(h, highestSvc, props, bnd);
         }
+        serviceTracker_recordCallback(instance, stats, props == NULL ? NULL : celix_properties_get(props, OSGI_FRAMEWORK_OBJECTCLASS, NULL), &start);
+    }
+}
+
+/**
+ * Returns true if the set service update for the event is deferred, because more events of the same batch follow.
+ * The service name is remembered and the set service is updated once after the last event of the batch.
+ */
+static bool serviceTracker_deferSetServiceUpdate(celix_service_tracker_instance_t *instance, const char *serviceName, const celix_service_event_t *event) {
+    if (event == NULL || !event->moreEventsInBatch) {
+        return false;
+    }
+    char *previous = NULL;
+    celixThreadMutex_lock(&instance->mutex);
+    if (serviceName != NULL && (instance->pendingSetServiceName == NULL || strcmp(instance->pendingSetServiceName, serviceName) != 0)) {
+        previous = instance->pendingSetServiceName;
+        instance->pendingSetServiceName = strdup(serviceName);
+    }
+    celixThreadMutex_unlock(&instance->mutex);
+    if (previous != NULL) {
+        //batch spans multiple service names, update the set service for the previous name now
+        serviceTracker_useHighestRankingServiceInternal(instance, previous, 0, instance, NULL, NULL, serviceTracker_checkAndInvokeSetService);
+        free(previous);
+    }
+    return true;
+}
+
+static void serviceTracker_updatePendingSetService(celix_service_tracker_instance_t *instance) {
+    celixThreadMutex_lock(&instance->mutex);
+    char *pending = instance->pendingSetServiceName;
+    instance->pendingSetServiceName = NULL;
+    bool hasHighest = instance->currentHighestServiceId != -1;
+    celixThreadMutex_unlock(&instance->mutex);
+    if (pending != NULL) {
+        size_t size;
+        celixThreadRwlock_readLock(&instance->lock);
+        size = arrayList_size(instance->trackedServices);
+        celixThreadRwlock_unlock(&instance->lock);
+        if (size == 0) {
+            if (hasHighest) {
+                serviceTracker_checkAndInvokeSetService(instance, NULL, NULL, NULL);
+            }
+        } else {
+            serviceTracker_useHighestRankingServiceInternal(instance, pending, 0, instance, NULL, NULL, serviceTracker_checkAndInvokeSetService);
+        }
+        free(pending);
     }
 }
 
 static celix_status_t serviceTracker_invokeModifiedService(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked) {
     celix_status_t status = CELIX_SUCCESS;
 
+    celix_registry_statistics_t *stats = serviceTracker_getStatistics(instance);
+    struct timespec start;
+    celix_registryStatistics_startTimer(stats, &start);
+
     void *customizerHandle = NULL;
     modified_callback_pt function = NULL;
     serviceTrackerCustomizer_getHandle(&instance->customizer, &customizerHandle);
@@ -557,6 +710,7 @@ static celix_status_t serviceTracker_invokeModifiedService(celix_service_tracker
     if (instance->modifiedWithOwner != NULL) {
         instance->modifiedWithOwner(handle, tracked->service, tracked->properties, tracked->serviceOwner);
     }
+    serviceTracker_recordCallback(instance, stats, tracked->serviceName, &start);
     return status;
 }
 
@@ -564,6 +718,10 @@ static celix_status_t serviceTracker_invokeModifiedService(celix_service_tracker
 static celix_status_t serviceTracker_invokeAddService(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked) {
     celix_status_t status = CELIX_SUCCESS;
 
+    celix_registry_statistics_t *stats = serviceTracker_getStatistics(instance);
+    struct timespec start;
+    celix_registryStatistics_startTimer(stats, &start);
+
     void *customizerHandle = NULL;
     added_callback_pt function = NULL;
 
@@ -583,6 +741,7 @@ static celix_status_t serviceTracker_invokeAddService(celix_service_tracker_inst
     if (instance->addWithOwner != NULL) {
         instance->addWithOwner(handle, tracked->service, tracked->properties, tracked->serviceOwner);
     }
+    serviceTracker_recordCallback(instance, stats, tracked->serviceName, &start);
     return status;
 }
 
@@ -612,28 +771,22 @@ static celix_status_t serviceTracker_invokeAddingService(celix_service_tracker_i
 static celix_status_t serviceTracker_untrack(celix_service_tracker_instance_t* instance, service_reference_pt reference, celix_service_event_t *event) {
     celix_status_t status = CELIX_SUCCESS;
     celix_tracked_entry_t *remove = NULL;
-    unsigned int i;
     unsigned int size;
     const char *serviceName = NULL;
 
     celixThreadRwlock_writeLock(&instance->lock);
-    size = arrayList_size(instance->trackedServices);
-    for (i = 0; i < size; i++) {
-        bool equals;
-        celix_tracked_entry_t *tracked = (celix_tracked_entry_t*) arrayList_get(instance->trackedServices, i);
-        serviceName = tracked->serviceName;
-        serviceReference_equals(reference, tracked->reference, &equals);
-        if (equals) {
-            remove = tracked;
-            //remove from trackedServices to prevent getting this service, but don't destroy yet, can be in use
-            arrayList_remove(instance->trackedServices, i);
-            break;
-        }
+    remove = celix_longHashMap_get(instance->trackedServicesById, (long)reference->serviceId);
+    if (remove != NULL) {
+        serviceName = remove->serviceName;
+        //remove from trackedServices to prevent getting this service, but don't destroy yet, can be in use
+        serviceTracker_removeTrackedSorted(instance, remove);
     }
     size = arrayList_size(instance->trackedServices); //updated size
     celixThreadRwlock_unlock(&instance->lock);
 
-    if (size == 0) {
+    if (serviceTracker_deferSetServiceUpdate(instance, serviceName, event)) {
+        //nop, set service is updated at the end of the event batch
+    } else if (size == 0) {
         serviceTracker_checkAndInvokeSetService(instance, NULL, NULL, NULL);
     } else {
         serviceTracker_useHighestRankingServiceInternal(instance, serviceName, 0, instance, NULL, NULL, serviceTracker_checkAndInvokeSetService);
@@ -646,6 +799,17 @@ static celix_status_t serviceTracker_untrack(celix_service_tracker_instance_t* i
     return status;
 }
 
+static celix_registry_statistics_t* serviceTracker_getStatistics(celix_service_tracker_instance_t *instance) {
+    celix_framework_t *fw = instance->context->framework;
+    return fw == NULL ? NULL : fw->registryStatistics.statistics;
+}
+
+static void serviceTracker_recordCallback(celix_service_tracker_instance_t *instance, celix_registry_statistics_t *stats, const char *serviceName, const struct timespec *start) {
+    if (stats != NULL) {
+        celix_registryStatistics_record(stats, CELIX_REGISTRY_STATISTICS_TRACKER_CALLBACK, celix_bundle_getId(instance->context->bundle), serviceName, start);
+    }
+}
+
 static void serviceTracker_untrackTracked(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked) {
     if (tracked != NULL) {
         serviceTracker_invokeRemovingService(instance, tracked);
@@ -657,10 +821,35 @@ static void serviceTracker_untrackTracked(celix_service_tracker_instance_t *inst
     }
 }
 
+/**
+ * Discards a tracked entry which was never added to the tracked services, by undoing the adding service.
+ */
+static void serviceTracker_discardTracked(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked) {
+    void *customizerHandle = NULL;
+    removed_callback_pt function = NULL;
+    serviceTrackerCustomizer_getHandle(&instance->customizer, &customizerHandle);
+    serviceTrackerCustomizer_getRemovedFunction(&instance->customizer, &function);
+    celix_status_t status = CELIX_SUCCESS;
+    if (function != NULL) {
+        status = function(customizerHandle, tracked->reference, tracked->service);
+    }
+    if (status == CELIX_SUCCESS) {
+        bool ungetSuccess = true;
+        bundleContext_ungetService(instance->context, tracked->reference, &ungetSuccess);
+    }
+    bundleContext_ungetServiceReference(instance->context, tracked->reference);
+    tracked_release(tracked);
+    tracked_waitAndDestroy(tracked);
+}
+
 static celix_status_t serviceTracker_invokeRemovingService(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked) {
     celix_status_t status = CELIX_SUCCESS;
     bool ungetSuccess = true;
 
+    celix_registry_statistics_t *stats = serviceTracker_getStatistics(instance);
+    struct timespec start;
+    celix_registryStatistics_startTimer(stats, &start);
+
     void *customizerHandle = NULL;
     removed_callback_pt function = NULL;
 
@@ -681,6 +870,7 @@ static celix_status_t serviceTracker_invokeRemovingService(celix_service_tracker
     if (instance->removeWithOwner != NULL) {
         instance->removeWithOwner(handle, tracked->service, tracked->properties, tracked->serviceOwner);
     }
+    serviceTracker_recordCallback(instance, stats, tracked->serviceName, &start);
 
     if (status == CELIX_SUCCESS) {
         status = bundleContext_ungetService(instance->context, tracked->reference, &ungetSuccess);
@@ -714,6 +904,45 @@ celix_service_tracker_t* celix_serviceTracker_create(
     return celix_serviceTracker_createWithOptions(ctx, &opts);
 }
 
+char* celix_serviceTracker_createFilterString(const celix_service_filter_options_t *opts) {
+    char *filter = NULL;
+    if (opts != NULL && opts->serviceName != NULL) {
+        //setting lang
+        const char *lang = opts->serviceLanguage;
+        if (lang == NULL || strncmp("", lang, 1) == 0) {
+            lang = CELIX_FRAMEWORK_SERVICE_C_LANGUAGE;
+        }
+
+        //setting filter
+        if (opts->ignoreServiceLanguage) {
+            if (opts->filter != NULL && opts->versionRange != NULL) {
+                //TODO version range
+                asprintf(&filter, "&((%s=%s)%s)", OSGI_FRAMEWORK_OBJECTCLASS, opts->serviceName, opts->filter);
+            } else if (opts->versionRange != NULL) {
+                //TODO version range
+                asprintf(&filter, "&((%s=%s))", OSGI_FRAMEWORK_OBJECTCLASS, opts->serviceName);
+            } else if (opts->filter != NULL) {
+                asprintf(&filter, "(&(%s=%s)%s)", OSGI_FRAMEWORK_OBJECTCLASS, opts->serviceName, opts->filter);
+            } else {
+                asprintf(&filter, "(&(%s=%s))", OSGI_FRAMEWORK_OBJECTCLASS, opts->serviceName);
+            }
+        } else {
+            if (opts->filter != NULL && opts->versionRange != NULL) {
+                //TODO version range
+                asprintf(&filter, "&((%s=%s)(%s=%s)%s)", OSGI_FRAMEWORK_OBJECTCLASS, opts->serviceName, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang, opts->filter);
+            } else if (opts->versionRange != NULL) {
+                //TODO version range
+                asprintf(&filter, "&((%s=%s)(%s=%s))", OSGI_FRAMEWORK_OBJECTCLASS, opts->serviceName, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang);
+            } else if (opts->filter != NULL) {
+                asprintf(&filter, "(&(%s=%s)(%s=%s)%s)", OSGI_FRAMEWORK_OBJECTCLASS, opts->serviceName, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang, opts->filter);
+            } else {
+                asprintf(&filter, "(&(%s=%s)(%s=%s))", OSGI_FRAMEWORK_OBJECTCLASS, opts->serviceName, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang);
+            }
+        }
+    }
+    return filter;
+}
+
 celix_service_tracker_t* celix_serviceTracker_createWithOptions(
         bundle_context_t *ctx,
         const celix_service_tracking_options_t *opts
@@ -738,39 +967,8 @@ celix_service_tracker_t* celix_serviceTracker_createWithOptions(
 
             celixThreadRwlock_create(&tracker->instanceLock, NULL);
 
-            //setting lang
-            const char *lang = opts->filter.serviceLanguage;
-            if (lang == NULL || strncmp("", lang, 1) == 0) {
-                lang = CELIX_FRAMEWORK_SERVICE_C_LANGUAGE;
-            }
-
             //setting filter
-            if (opts->filter.ignoreServiceLanguage) {
-                if (opts->filter.filter != NULL && opts->filter.versionRange != NULL) {
-                    //TODO version range
-                    asprintf(&tracker->filter, "&((%s=%s)%s)", OSGI_FRAMEWORK_OBJECTCLASS, opts->filter.serviceName, opts->filter.filter);
-                } else if (opts->filter.versionRange != NULL) {
-                    //TODO version range
-                    asprintf(&tracker->filter, "&((%s=%s))", OSGI_FRAMEWORK_OBJECTCLASS, opts->filter.serviceName);
-                } else if (opts->filter.filter != NULL) {
-                    asprintf(&tracker->filter, "(&(%s=%s)%s)", OSGI_FRAMEWORK_OBJECTCLASS, opts->filter.serviceName, opts->filter.filter);
-                } else {
-                    asprintf(&tracker->filter, "(&(%s=%s))", OSGI_FRAMEWORK_OBJECTCLASS, opts->filter.serviceName);
-                }
-            } else {
-                if (opts->filter.filter != NULL && opts->filter.versionRange != NULL) {
-                    //TODO version range
-                    asprintf(&tracker->filter, "&((%s=%s)(%s=%s)%s)", OSGI_FRAMEWORK_OBJECTCLASS, opts->filter.serviceName, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang, opts->filter.filter);
-                } else if (opts->filter.versionRange != NULL) {
-                    //TODO version range
-                    asprintf(&tracker->filter, "&((%s=%s)(%s=%s))", OSGI_FRAMEWORK_OBJECTCLASS, opts->filter.serviceName, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang);
-                } else if (opts->filter.filter != NULL) {
-                    asprintf(&tracker->filter, "(&(%s=%s)(%s=%s)%s)", OSGI_FRAMEWORK_OBJECTCLASS, opts->filter.serviceName, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang, opts->filter.filter);
-                } else {
-                    asprintf(&tracker->filter, "(&(%s=%s)(%s=%s))", OSGI_FRAMEWORK_OBJECTCLASS, opts->filter.serviceName, CELIX_FRAMEWORK_SERVICE_LANGUAGE, lang);
-                }
-            }
-
+            tracker->filter = celix_serviceTracker_createFilterString(&opts->filter);
 
             serviceTracker_open(tracker);
         }
@@ -802,44 +1000,22 @@ static bool serviceTracker_useHighestRankingServiceInternal(celix_service_tracke
     bool called = false;
     celix_tracked_entry_t *tracked = NULL;
     celix_tracked_entry_t *highest = NULL;
-    long highestRank = 0;
     unsigned int i;
 
+    if (waitForSvcTimeoutInSec > 0) {
+        serviceTracker_waitForTrackedServiceInternal(instance, waitForSvcTimeoutInSec);
+    }
+
     //first lock tracker and get highest tracked entry
     celixThreadRwlock_readLock(&instance->lock);
     unsigned int size = arrayList_size(instance->trackedServices);
 
-    if (waitForSvcTimeoutInSec > 0) {
-        struct timespec start;
-        struct timespec now;
-        clock_gettime(CLOCK_MONOTONIC, &start);
-
-        double billion = 1E9;
-        long waitFor = (long)(waitForSvcTimeoutInSec * billion);
-        long diffInNs = 0L;
-
-        while (size == 0 && diffInNs < waitFor) {
-            size = arrayList_size(instance->trackedServices);
-            if (size > 0) {
-                break;
-            } else {
-                celixThreadRwlock_unlock(&instance->lock);
-                usleep(1);
-                celixThreadRwlock_readLock(&instance->lock);
-            };
-            clock_gettime(CLOCK_MONOTONIC, &now);
-            diffInNs = ( now.tv_nsec - start.tv_nsec ) + ( now.tv_sec - start.tv_sec ) * (long)billion;
-        }
-    }
-
+    //note trackedServices is sorted on ranking, so the first entry with a matching service name is the highest
     for (i = 0; i < size; i++) {
         tracked = (celix_tracked_entry_t *) arrayList_get(instance->trackedServices, i);
         if (serviceName != NULL && tracked->serviceName != NULL && strncmp(tracked->serviceName, serviceName, 10*1024) == 0) {
-            const char *val = properties_getWithDefault(tracked->properties, OSGI_FRAMEWORK_SERVICE_RANKING, "0");
-            long rank = strtol(val, NULL, 10);
-            if (highest == NULL || rank > highestRank) {
-                highest = tracked;
-            }
+            highest = tracked;
+            break;
         }
     }
     if (highest != NULL) {
@@ -868,6 +1044,45 @@ static bool serviceTracker_useHighestRankingServiceInternal(celix_service_tracke
 }
 
 
+static bool serviceTracker_waitForTrackedServiceInternal(celix_service_tracker_instance_t *instance, double waitTimeoutInSeconds) {
+    struct timespec start;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    double billion = 1E9;
+    long waitFor = (long)(waitTimeoutInSeconds * billion);
+    long diffInNs = 0L;
+    bool found = false;
+
+    //note the size check is done with waitMutex locked, so a broadcast after adding a service cannot be missed
+    celixThreadMutex_lock(&instance->waitMutex);
+    while (true) {
+        celixThreadRwlock_readLock(&instance->lock);
+        found = arrayList_size(instance->trackedServices) > 0;
+        celixThreadRwlock_unlock(&instance->lock);
+        if (found || diffInNs >= waitFor) {
+            break;
+        }
+        long remaining = waitFor - diffInNs;
+        celixThreadCondition_timedwaitRelative(&instance->waitCond, &instance->waitMutex, remaining / (long)billion, remaining % (long)billion);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        diffInNs = ( now.tv_nsec - start.tv_nsec ) + ( now.tv_sec - start.tv_sec ) * (long)billion;
+    }
+    celixThreadMutex_unlock(&instance->waitMutex);
+
+    return found;
+}
+
+bool celix_serviceTracker_waitForService(celix_service_tracker_t *tracker, double waitTimeoutInSeconds) {
+    celixThreadRwlock_readLock(&tracker->instanceLock);
+    celix_service_tracker_instance_t *instance = tracker->instance;
+    bool found = false;
+    if (instance != NULL) {
+        found = serviceTracker_waitForTrackedServiceInternal(instance, waitTimeoutInSeconds);
+    }
+    celixThreadRwlock_unlock(&tracker->instanceLock);
+    return found;
+}
+
 bool celix_serviceTracker_useHighestRankingService(
         celix_service_tracker_t *tracker,
         const char *serviceName /*sanity*/,
@@ -29,6 +29,7 @@
 
 #include "service_tracker.h"
 #include "celix_types.h"
+#include "celix_hash_map.h"
 
 //instance for an active per open statement and removed per close statement
 typedef struct celix_service_tracker_instance {
@@ -60,11 +61,16 @@ typedef struct celix_service_tracker_instance {
 	void (*removeWithOwner)(void *handle, void *svc, const properties_t *props, const bundle_t *owner);
 	void (*modifiedWithOwner)(void *handle, void *svc, const properties_t *props, const bundle_t *owner);
 
-	celix_thread_rwlock_t lock; //projects trackedServices
+	celix_thread_rwlock_t lock; //projects trackedServices and trackedServicesById
 	array_list_t *trackedServices;
+	celix_long_hash_map_t *trackedServicesById; //key = service id, value = tracked entry (also in trackedServices)
 
-	celix_thread_mutex_t mutex; //protect current highest service id
+	celix_thread_mutex_t waitMutex; //used with waitCond
+	celix_thread_cond_t waitCond; //broadcasted when a service is added to trackedServices
+
+	celix_thread_mutex_t mutex; //protect current highest service id and pending set service name
 	long currentHighestServiceId;
+	char *pendingSetServiceName; //service name for which the set callback update is deferred to the end of an event batch
 
 	celix_thread_t shutdownThread; //will be created when this instance is shutdown
 } celix_service_tracker_instance_t;
@@ -103,11 +109,20 @@ typedef struct celix_tracked_entry {
 	const char *serviceName;
 	properties_t *properties;
 	bundle_t *serviceOwner;
+	long serviceId;
+	long serviceRanking; //parsed service.ranking, trackedServices is sorted on ranking and service id
+
 
     celix_thread_mutex_t mutex; //protects useCount
 	celix_thread_cond_t useCond;
     size_t useCount;
 } celix_tracked_entry_t;
 
+/**
+ * Creates the filter string used by service trackers (and the bundle context use/find functions) for the provided
+ * service filter options. The caller is owner of the returned string.
+ * @return The filter string or NULL if no service name is provided.
+ */
+char* celix_serviceTracker_createFilterString(const celix_service_filter_options_t *opts);
 
 #endif /* SERVICE_TRACKER_PRIVATE_H_ */
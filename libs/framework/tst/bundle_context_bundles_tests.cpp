@@ -22,10 +22,14 @@
 #include <iostream>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
+#include <string>
+#include <algorithm>
 
 #include <zconf.h>
 
 #include "celix_api.h"
+#include "celix_framework_factory.h"
 
 #include <CppUTest/TestHarness.h>
 #include <CppUTest/CommandLineTestRunner.h>
@@ -314,6 +318,34 @@ TEST(CelixBundleContextBundlesTests, trackBundlesTest) {
     celix_bundleContext_stopTracker(ctx, trackerId);
 };
 
+TEST(CelixBundleContextBundlesTests, parallelAutoStartTest) {
+    celix_properties_t *config = properties_create();
+    properties_set(config, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+    properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    properties_set(config, "org.osgi.framework.storage", ".cacheParallelAutoStartTestFramework");
+    properties_set(config, CELIX_AUTO_START_1, "simple_test_bundle1.zip simple_test_bundle2.zip non-existing.zip simple_test_bundle3.zip simple_test_bundle1.zip");
+    properties_set(config, CELIX_AUTO_START_NR_OF_THREADS, "4");
+    framework_t *parallelFw = celix_frameworkFactory_createFramework(config);
+    CHECK(parallelFw != nullptr);
+    bundle_context_t *parallelCtx = framework_getContext(parallelFw);
+
+    std::vector<std::pair<long, std::string>> bundles{};
+    celix_bundleContext_useBundles(parallelCtx, &bundles, [](void *handle, const celix_bundle_t *bnd) {
+        auto *b = static_cast<std::vector<std::pair<long, std::string>>*>(handle);
+        CHECK_EQUAL(OSGI_FRAMEWORK_BUNDLE_ACTIVE, celix_bundle_getState(bnd));
+        b->emplace_back(celix_bundle_getId(bnd), celix_bundle_getSymbolicName(bnd));
+    });
+
+    //bundles ids are assigned in configured order, duplicates and non existing bundles are ignored
+    std::sort(bundles.begin(), bundles.end());
+    CHECK_EQUAL(3, bundles.size());
+    STRCMP_EQUAL("simple_test_bundle1", bundles[0].second.c_str());
+    STRCMP_EQUAL("simple_test_bundle2", bundles[1].second.c_str());
+    STRCMP_EQUAL("simple_test_bundle3", bundles[2].second.c_str());
+
+    celix_frameworkFactory_destroyFramework(parallelFw);
+}
+
 /* IGNORE TODO need to add locks
 TEST(CelixBundleContextBundlesTests, useBundlesConcurrentTest) {
 
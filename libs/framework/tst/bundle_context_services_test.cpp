@@ -25,7 +25,9 @@
 #include <zconf.h>
 #include <string.h>
 #include <map>
+#include <vector>
 #include <future>
+#include <atomic>
 
 #include "celix_api.h"
 #include "celix_framework_factory.h"
@@ -212,6 +214,29 @@ TEST(CelixBundleContextServicesTests, registerAndUseServiceWithTimeout) {
     CHECK(!result2.get());
 }
 
+TEST(CelixBundleContextServicesTests, serviceTrackerWaitForServiceTest) {
+    celix_service_tracking_options_t opts{};
+    opts.filter.serviceName = "calc";
+    celix_service_tracker_t *tracker = celix_serviceTracker_createWithOptions(ctx, &opts);
+    CHECK(tracker != nullptr);
+
+    CHECK(!celix_serviceTracker_waitForService(tracker, 0.01)); //no service, timeout expired
+
+    std::future<bool> result{std::async([&]{
+        return celix_serviceTracker_waitForService(tracker, 5.0);
+    })};
+    auto start = std::chrono::steady_clock::now();
+    long svcId = celix_bundleContext_registerService(ctx, (void*)0x42, "calc", nullptr);
+    CHECK(result.get()); //should return after the service is registered, not after the timeout
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(elapsed < std::chrono::seconds{1});
+
+    CHECK(celix_serviceTracker_waitForService(tracker, 0)); //already tracked
+
+    celix_serviceTracker_destroy(tracker);
+    celix_bundleContext_unregisterService(ctx, svcId);
+}
+
 TEST(CelixBundleContextServicesTests, registerAndUseWithForcedRaceCondition) {
     struct calc {
         int (*calc)(int);
@@ -292,6 +317,64 @@ TEST(CelixBundleContextServicesTests, registerAndUseWithForcedRaceCondition) {
 };
 
 
+TEST(CelixBundleContextServicesTests, unregisterWaitsForSlowUseCallbackTest) {
+    struct calc {
+        int (*calc)(int);
+    };
+
+    const char *calcName = "calc";
+    auto *svc = new calc{};
+    svc->calc = [](int n) -> int {
+        return n * 42;
+    };
+    long svcId = celix_bundleContext_registerService(ctx, svc, calcName, nullptr);
+    CHECK(svcId >= 0);
+
+    struct sync {
+        std::mutex mutex{};
+        std::condition_variable sync{};
+        bool inUseCall{false};
+        std::atomic<bool> useDone{false};
+        std::atomic<bool> unregistered{false};
+        int result{0};
+    };
+    struct sync callInfo{};
+
+    auto use = [](void *handle, void *svc) {
+        auto *h = static_cast<struct sync*>(handle);
+        std::unique_lock<std::mutex> lock(h->mutex);
+        h->inUseCall = true;
+        lock.unlock();
+        h->sync.notify_all();
+
+        //slow use callback, the unregister call should block till the use callback is done
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        CHECK_FALSE(h->unregistered);
+        h->result = static_cast<struct calc*>(svc)->calc(2);
+        h->useDone = true;
+    };
+
+    std::thread useThread{[&] {
+        bool called = celix_bundleContext_useServiceWithId(ctx, svcId, calcName, &callInfo, use);
+        CHECK(called);
+    }};
+
+    std::unique_lock<std::mutex> lock(callInfo.mutex);
+    callInfo.sync.wait(lock, [&]{return callInfo.inUseCall;});
+    lock.unlock();
+    celix_bundleContext_unregisterService(ctx, svcId);
+    callInfo.unregistered = true;
+    CHECK(callInfo.useDone);
+    delete svc; //after unregistration the service must not be used anymore
+
+    useThread.join();
+    CHECK_EQUAL(84, callInfo.result);
+
+    //unregistered, so the service should not be used anymore
+    bool called = celix_bundleContext_useServiceWithId(ctx, svcId, calcName, &callInfo, use);
+    CHECK_FALSE(called);
+}
+
 TEST(CelixBundleContextServicesTests, servicesTrackerTest) {
     int count = 0;
     auto add = [](void *handle, void *svc) {
@@ -625,6 +708,57 @@ TEST(CelixBundleContextServicesTests, servicesTrackerSetTest) {
     CHECK_EQUAL(3, count); //check if the set is called the expected times
 }
 
+TEST(CelixBundleContextServicesTests, servicesTrackerRankingOrderTest) {
+    void *svc1 = (void*)0x100; //no ranking
+    void *svc2 = (void*)0x200; //10 ranking
+    void *svc3 = (void*)0x300; //5 ranking
+    void *svc4 = (void*)0x400; //no ranking
+
+    long svcId1 = celix_bundleContext_registerService(ctx, svc1, "NA", nullptr);
+    properties_t *props2 = celix_properties_create();
+    celix_properties_set(props2, OSGI_FRAMEWORK_SERVICE_RANKING, "10");
+    long svcId2 = celix_bundleContext_registerService(ctx, svc2, "NA", props2);
+
+    celix_service_tracking_options_t opts{};
+    opts.filter.serviceName = "NA";
+    celix_service_tracker_t *tracker = celix_serviceTracker_createWithOptions(ctx, &opts);
+
+    properties_t *props3 = celix_properties_create();
+    celix_properties_set(props3, OSGI_FRAMEWORK_SERVICE_RANKING, "5");
+    long svcId3 = celix_bundleContext_registerService(ctx, svc3, "NA", props3);
+    long svcId4 = celix_bundleContext_registerService(ctx, svc4, "NA", nullptr);
+
+    std::vector<long> used{};
+    auto use = [](void *handle, void *svc) {
+        auto *u = static_cast<std::vector<long>*>(handle);
+        u->push_back((long)svc);
+    };
+
+    //services should be used in ranking order, for equal ranking the oldest service first
+    celix_serviceTracker_useServices(tracker, "NA", &used, use, nullptr, nullptr);
+    CHECK_EQUAL(4, used.size());
+    CHECK_EQUAL(0x200, used[0]);
+    CHECK_EQUAL(0x300, used[1]);
+    CHECK_EQUAL(0x100, used[2]);
+    CHECK_EQUAL(0x400, used[3]);
+
+    used.clear();
+    bool called = celix_serviceTracker_useHighestRankingService(tracker, "NA", 0, &used, use, nullptr, nullptr);
+    CHECK(called);
+    CHECK_EQUAL(1, used.size());
+    CHECK_EQUAL(0x200, used[0]);
+
+    celix_bundleContext_unregisterService(ctx, svcId2);
+    used.clear();
+    celix_serviceTracker_useHighestRankingService(tracker, "NA", 0, &used, use, nullptr, nullptr);
+    CHECK_EQUAL(0x300, used[0]);
+
+    celix_serviceTracker_destroy(tracker);
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    celix_bundleContext_unregisterService(ctx, svcId3);
+    celix_bundleContext_unregisterService(ctx, svcId4);
+}
+
 //TODO test tracker with options for properties & service owners
 
 
@@ -696,6 +830,240 @@ TEST(CelixBundleContextServicesTests, findServicesTest) {
     celix_bundleContext_unregisterService(ctx, svcId2);
 }
 
+TEST(CelixBundleContextServicesTests, findServicesWithIndexedFilterTest) {
+    long svcId1 = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+    long svcId2 = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+    long svcId3 = celix_bundleContext_registerService(ctx, (void*)0x100, "other", nullptr);
+
+    //lookup on service.id
+    celix_service_filter_options_t opts{};
+    char filter[64];
+    snprintf(filter, sizeof(filter), "(service.id=%li)", svcId2);
+    opts.serviceName = "example";
+    opts.filter = filter;
+    long foundId = celix_bundleContext_findServiceWithOptions(ctx, &opts);
+    CHECK_EQUAL(svcId2, foundId);
+
+    opts.serviceName = "other"; //id and service name do not match
+    foundId = celix_bundleContext_findServiceWithOptions(ctx, &opts);
+    CHECK_EQUAL(-1L, foundId);
+
+    //service.id in an OR cannot be used for the index
+    snprintf(filter, sizeof(filter), "(|(service.id=%li)(service.id=%li))", svcId1, svcId2);
+    opts.serviceName = "example";
+    array_list_t *list = celix_bundleContext_findServicesWithOptions(ctx, &opts);
+    CHECK_EQUAL(2, celix_arrayList_size(list));
+    arrayList_destroy(list);
+
+    //unregistered services should be removed from the indices
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    celix_bundleContext_unregisterService(ctx, svcId3);
+    snprintf(filter, sizeof(filter), "(service.id=%li)", svcId1);
+    foundId = celix_bundleContext_findServiceWithOptions(ctx, &opts);
+    CHECK_EQUAL(-1L, foundId);
+    foundId = celix_bundleContext_findService(ctx, "other");
+    CHECK_EQUAL(-1L, foundId);
+    foundId = celix_bundleContext_findService(ctx, "example");
+    CHECK_EQUAL(svcId2, foundId);
+
+    celix_bundleContext_unregisterService(ctx, svcId2);
+}
+
+TEST(CelixBundleContextServicesTests, findServicesWithNotPlainServiceIdFilterTest) {
+    long svcId = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+
+    //service.id values which are not a plain decimal integer, but do match the service id when compared as numbers.
+    //these cannot use the service id index and should give the same result as a full scan.
+    const char *formats[] = {"(service.id=%li.0)", "(service.id=+%li)", "(&(objectClass=example)(service.id=%li.0))"};
+    for (const char *format : formats) {
+        char filter[64];
+        snprintf(filter, sizeof(filter), format, svcId);
+
+        array_list_t *refs = nullptr;
+        CHECK_EQUAL(CELIX_SUCCESS, bundleContext_getServiceReferences(ctx, nullptr, filter, &refs));
+        CHECK_EQUAL(1, celix_arrayList_size(refs));
+        for (int i = 0; i < celix_arrayList_size(refs); ++i) {
+            bundleContext_ungetServiceReference(ctx, (service_reference_pt)celix_arrayList_get(refs, i));
+        }
+        celix_arrayList_destroy(refs);
+
+        celix_service_filter_options_t opts{};
+        opts.serviceName = "example";
+        opts.filter = filter;
+        long foundId = celix_bundleContext_findServiceWithOptions(ctx, &opts);
+        CHECK_EQUAL(svcId, foundId);
+    }
+
+    celix_bundleContext_unregisterService(ctx, svcId);
+}
+
+TEST(CelixBundleContextServicesTests, serviceListenerIndexTest) {
+    struct listener_data {
+        int registered = 0;
+        int unregistering = 0;
+    };
+    auto changed = [](void *handle, celix_service_event_t *event) -> celix_status_t {
+        //note the framework calls the listener with the listener as handle
+        auto *data = static_cast<listener_data*>(static_cast<celix_service_listener_t*>(handle)->handle);
+        if (event->type == OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED) {
+            data->registered += 1;
+        } else if (event->type == OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING) {
+            data->unregistering += 1;
+        }
+        return CELIX_SUCCESS;
+    };
+
+    listener_data exampleData{};
+    celix_service_listener_t exampleListener{&exampleData, changed};
+    bundleContext_addServiceListener(ctx, &exampleListener, "(&(objectClass=example)(service.lang=C))");
+
+    listener_data orData{}; //objectClass in an OR cannot be used for the index
+    celix_service_listener_t orListener{&orData, changed};
+    bundleContext_addServiceListener(ctx, &orListener, "(|(objectClass=example)(objectClass=other))");
+
+    listener_data allData{};
+    celix_service_listener_t allListener{&allData, changed};
+    bundleContext_addServiceListener(ctx, &allListener, nullptr);
+
+    long svcId1 = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+    long svcId2 = celix_bundleContext_registerService(ctx, (void*)0x100, "other", nullptr);
+    long svcId3 = celix_bundleContext_registerService(ctx, (void*)0x100, "unrelated", nullptr);
+
+    CHECK_EQUAL(1, exampleData.registered);
+    CHECK_EQUAL(2, orData.registered);
+    CHECK_EQUAL(3, allData.registered);
+
+    bundleContext_removeServiceListener(ctx, &exampleListener);
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    CHECK_EQUAL(0, exampleData.unregistering);
+    CHECK_EQUAL(1, orData.unregistering);
+    CHECK_EQUAL(1, allData.unregistering);
+
+    bundleContext_removeServiceListener(ctx, &orListener);
+    bundleContext_removeServiceListener(ctx, &allListener);
+    celix_bundleContext_unregisterService(ctx, svcId2);
+    celix_bundleContext_unregisterService(ctx, svcId3);
+    CHECK_EQUAL(1, orData.unregistering);
+    CHECK_EQUAL(1, allData.unregistering);
+}
+
+TEST(CelixBundleContextServicesTests, registerServicesBatchTest) {
+    struct tracker_data {
+        int addCount = 0;
+        int removeCount = 0;
+        int setCount = 0;
+        void *currentSvc = nullptr;
+    };
+    tracker_data data{};
+
+    celix_service_tracking_options_t opts{};
+    opts.callbackHandle = &data;
+    opts.filter.serviceName = "NA";
+    opts.add = [](void *handle, void *) {
+        static_cast<tracker_data*>(handle)->addCount += 1;
+    };
+    opts.remove = [](void *handle, void *) {
+        static_cast<tracker_data*>(handle)->removeCount += 1;
+    };
+    opts.set = [](void *handle, void *svc) {
+        auto *d = static_cast<tracker_data*>(handle);
+        d->setCount += 1;
+        d->currentSvc = svc;
+    };
+    long trackerId = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+    CHECK(trackerId > 0);
+
+    celix_service_registration_options_t regOpts[4]{};
+    for (int i = 0; i < 3; ++i) {
+        regOpts[i].svc = (void*)(long)(0x100 * (i + 1));
+        regOpts[i].serviceName = "NA";
+    }
+    regOpts[1].properties = celix_properties_create();
+    celix_properties_set(regOpts[1].properties, OSGI_FRAMEWORK_SERVICE_RANKING, "10");
+    //note regOpts[3] is invalid, no service name
+
+    long svcIds[4];
+    size_t registered = celix_bundleContext_registerServicesWithOptions(ctx, regOpts, 4, svcIds);
+    CHECK_EQUAL(3, registered);
+    CHECK(svcIds[0] >= 0);
+    CHECK(svcIds[1] > svcIds[0]);
+    CHECK(svcIds[2] > svcIds[1]);
+    CHECK(svcIds[3] < 0);
+
+    CHECK_EQUAL(3, data.addCount);
+    CHECK_EQUAL(1, data.setCount); //set is only updated once for the batch
+    CHECK_EQUAL(0x200, (long)data.currentSvc); //highest ranking
+
+    long found = celix_bundleContext_findService(ctx, "NA");
+    CHECK_EQUAL(svcIds[1], found);
+
+    celix_bundleContext_unregisterServices(ctx, svcIds, 4);
+    CHECK_EQUAL(3, data.removeCount);
+    CHECK_EQUAL(2, data.setCount); //unset once for the batch
+    CHECK(data.currentSvc == nullptr);
+
+    found = celix_bundleContext_findService(ctx, "NA");
+    CHECK_EQUAL(-1L, found);
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+}
+
+TEST(CelixBundleContextServicesTests, registerServicesBatchWithMultipleServiceNamesTest) {
+    int countA = 0;
+    int countB = 0;
+    int countAll = 0; //registered - unregistering events of a listener without service name
+    auto add = [](void *handle, void *) {
+        *static_cast<int*>(handle) += 1;
+    };
+    auto remove = [](void *handle, void *) {
+        *static_cast<int*>(handle) -= 1;
+    };
+
+    celix_service_tracking_options_t opts{};
+    opts.add = add;
+    opts.remove = remove;
+    opts.callbackHandle = &countA;
+    opts.filter.serviceName = "A";
+    long trkA = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+    opts.callbackHandle = &countB;
+    opts.filter.serviceName = "B";
+    long trkB = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+    auto changed = [](void *handle, celix_service_event_t *event) -> celix_status_t {
+        auto *count = static_cast<int*>(static_cast<celix_service_listener_t*>(handle)->handle);
+        if (event->type == OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED) {
+            *count += 1;
+        } else if (event->type == OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING) {
+            *count -= 1;
+        }
+        return CELIX_SUCCESS;
+    };
+    celix_service_listener_t allListener{&countAll, changed};
+    bundleContext_addServiceListener(ctx, &allListener, "(|(objectClass=A)(objectClass=B)(objectClass=C))");
+
+    //note interleaved service names, so that the batch is grouped on service name
+    const char *names[] = {"A", "B", "A", "C", "B", "A"};
+    celix_service_registration_options_t regOpts[6]{};
+    for (int i = 0; i < 6; ++i) {
+        regOpts[i].svc = (void*)(long)(0x100 * (i + 1));
+        regOpts[i].serviceName = names[i];
+    }
+    long svcIds[6];
+    size_t registered = celix_bundleContext_registerServicesWithOptions(ctx, regOpts, 6, svcIds);
+    CHECK_EQUAL(6, registered);
+    CHECK_EQUAL(3, countA);
+    CHECK_EQUAL(2, countB);
+    CHECK_EQUAL(6, countAll);
+
+    celix_bundleContext_unregisterServices(ctx, svcIds, 6);
+    CHECK_EQUAL(0, countA);
+    CHECK_EQUAL(0, countB);
+    CHECK_EQUAL(0, countAll);
+
+    celix_bundleContext_stopTracker(ctx, trkA);
+    celix_bundleContext_stopTracker(ctx, trkB);
+    bundleContext_removeServiceListener(ctx, &allListener);
+}
+
 TEST(CelixBundleContextServicesTests, trackServiceTrackerTest) {
 
     int count = 0;
@@ -739,3 +1107,154 @@ TEST(CelixBundleContextServicesTests, trackServiceTrackerTest) {
     celix_bundleContext_stopTracker(ctx, trackerId);
     celix_bundleContext_stopTracker(ctx, tracker4);
 }
+
+TEST_GROUP(CelixBundleContextAsyncServiceEventsTests) {
+    framework_t* fw = nullptr;
+    bundle_context_t *ctx = nullptr;
+
+    void setup() {
+        properties_t *properties = properties_create();
+        properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        properties_set(properties, "org.osgi.framework.storage.clean", "onFirstInit");
+        properties_set(properties, "org.osgi.framework.storage", ".cacheBundleContextTestFramework");
+        properties_set(properties, CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS, "true");
+
+        fw = celix_frameworkFactory_createFramework(properties);
+        ctx = framework_getContext(fw);
+    }
+
+    void teardown() {
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+};
+
+TEST(CelixBundleContextAsyncServiceEventsTests, trackServicesTest) {
+    std::atomic<int> count{0};
+    auto add = [](void *handle, void *) {
+        static_cast<std::atomic<int>*>(handle)->fetch_add(1);
+    };
+    auto remove = [](void *handle, void *) {
+        static_cast<std::atomic<int>*>(handle)->fetch_sub(1);
+    };
+    long trackerId = celix_bundleContext_trackServices(ctx, "example", &count, add, remove);
+    CHECK(trackerId > 0);
+
+    //registered event is delivered async
+    long svcId = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+    auto start = std::chrono::steady_clock::now();
+    while (count.load() == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds{5}) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    CHECK_EQUAL(1, count.load());
+
+    //unregister should wait until the trackers have removed the service
+    celix_bundleContext_unregisterService(ctx, svcId);
+    CHECK_EQUAL(0, count.load());
+
+    //the REGISTERED event of an unregistering service can be skipped, but add and remove should always be balanced
+    for (int i = 0; i < 100; ++i) {
+        svcId = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+        celix_bundleContext_unregisterService(ctx, svcId);
+        CHECK_EQUAL(0, count.load());
+    }
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+}
+
+TEST(CelixBundleContextAsyncServiceEventsTests, removeListenerFromCallbackTest) {
+    struct listener_data {
+        celix_bundle_context_t *ctx;
+        celix_service_listener_t *other;
+        std::atomic<int> count;
+    };
+    auto changed = [](void *handle, celix_service_event_t *event) -> celix_status_t {
+        //note the framework calls the listener with the listener as handle
+        auto *data = static_cast<listener_data*>(static_cast<celix_service_listener_t*>(handle)->handle);
+        if (event->type == OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED) {
+            data->count.fetch_add(1);
+            if (data->other != nullptr) {
+                //removing a listener, which can be matched for the current event, should not deadlock
+                bundleContext_removeServiceListener(data->ctx, data->other);
+                data->other = nullptr;
+            }
+        }
+        return CELIX_SUCCESS;
+    };
+
+    listener_data data1{ctx, nullptr, {0}};
+    celix_service_listener_t listener1{&data1, changed};
+    listener_data data2{ctx, nullptr, {0}};
+    celix_service_listener_t listener2{&data2, changed};
+    data1.other = &listener2;
+    data2.other = &listener1;
+    bundleContext_addServiceListener(ctx, &listener1, "(objectClass=example)");
+    bundleContext_addServiceListener(ctx, &listener2, "(objectClass=example)");
+
+    long svcId = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+    //wait for the delivery of the REGISTERED event, the REGISTERED event of an unregistering service is skipped
+    for (int i = 0; i < 1000 && data1.count.load() + data2.count.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    celix_bundleContext_unregisterService(ctx, svcId);
+
+    //only the first called listener is called, it removes the other listener
+    CHECK_EQUAL(1, data1.count.load() + data2.count.load());
+    if (data1.count.load() > 0) {
+        bundleContext_removeServiceListener(ctx, &listener1);
+    } else {
+        bundleContext_removeServiceListener(ctx, &listener2);
+    }
+}
+
+TEST(CelixBundleContextAsyncServiceEventsTests, trackerOpenedWhileRegisteredEventQueuedTest) {
+    std::atomic<int> count{0};
+    auto add = [](void *handle, void *) {
+        static_cast<std::atomic<int>*>(handle)->fetch_add(1);
+    };
+    auto remove = [](void *handle, void *) {
+        static_cast<std::atomic<int>*>(handle)->fetch_sub(1);
+    };
+    for (int i = 0; i < 100; ++i) {
+        //the tracker can find the service, while the REGISTERED event is still queued
+        long svcId = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+        long trackerId = celix_bundleContext_trackServices(ctx, "example", &count, add, remove);
+        celix_bundleContext_unregisterService(ctx, svcId);
+        CHECK_EQUAL(0, count.load());
+        celix_bundleContext_stopTracker(ctx, trackerId);
+    }
+}
+
+TEST(CelixBundleContextAsyncServiceEventsTests, unregisterFromListenerCallbackTest) {
+    auto unregister = [](void *, celix_service_event_t *event) -> celix_status_t {
+        if (event->type == OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED) {
+            //unregistered on the service event thread, before the REGISTERED event is delivered to the other listener
+            service_registration_t *reg = nullptr;
+            serviceReference_getServiceRegistration(event->reference, &reg);
+            serviceRegistration_unregister(reg);
+        }
+        return CELIX_SUCCESS;
+    };
+    auto record = [](void *handle, celix_service_event_t *event) -> celix_status_t {
+        //note the framework calls the listener with the listener as handle
+        auto *lastEvent = static_cast<std::atomic<int>*>(static_cast<celix_service_listener_t*>(handle)->handle);
+        lastEvent->store(event->type);
+        return CELIX_SUCCESS;
+    };
+    std::atomic<int> lastEvent{-1};
+    celix_service_listener_t listener1{nullptr, unregister};
+    celix_service_listener_t listener2{&lastEvent, record};
+    bundleContext_addServiceListener(ctx, &listener1, "(objectClass=example)");
+    bundleContext_addServiceListener(ctx, &listener2, "(objectClass=example)");
+
+    service_registration_t *reg = nullptr;
+    bundleContext_registerService(ctx, "example", (void*)0x100, nullptr, &reg);
+    //wait until the service event thread has handled the REGISTERED and the inline UNREGISTERING event
+    long helperId = celix_bundleContext_registerService(ctx, (void*)0x200, "helper", nullptr);
+    celix_bundleContext_unregisterService(ctx, helperId);
+
+    //the UNREGISTERING event should not be overtaken by the REGISTERED event
+    CHECK_EQUAL(OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING, lastEvent.load());
+
+    bundleContext_removeServiceListener(ctx, &listener1);
+    bundleContext_removeServiceListener(ctx, &listener2);
+}
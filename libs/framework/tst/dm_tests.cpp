@@ -17,7 +17,12 @@
  * under the License.
  */
 
+#include <thread>
+#include <chrono>
+#include <atomic>
+
 #include "celix_api.h"
+#include "celix_executor_service.h"
 
 #include <CppUTest/TestHarness.h>
 #include <CppUTest/CommandLineTestRunner.h>
@@ -71,3 +76,246 @@ TEST(DepenencyManagerTests, TestCheckActive) {
     celix_dependencyManager_add(mng, cmp);
     CHECK_FALSE(celix_dependencyManager_areComponentsActive(mng));
 }
+
+TEST(DepenencyManagerTests, RequiredDependencyAvailability) {
+    auto *mng = celix_bundleContext_getDependencyManager(ctx);
+    auto *cmp = celix_dmComponent_create(ctx, "test1");
+
+    auto *dep1 = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(dep1, "svcA", nullptr, nullptr);
+    celix_dmComponent_addServiceDependency(cmp, dep1);
+    celix_dmServiceDependency_setRequired(dep1, true); //note set after adding the dependency
+
+    auto *dep2 = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(dep2, "svcB", nullptr, nullptr);
+    celix_dmServiceDependency_setRequired(dep2, true);
+    celix_dmComponent_addServiceDependency(cmp, dep2);
+
+    celix_dependencyManager_add(mng, cmp);
+    CHECK_FALSE(celix_dependencyManager_areComponentsActive(mng));
+
+    int dummySvc = 0;
+    long svcId1 = celix_bundleContext_registerService(ctx, &dummySvc, "svcA", nullptr);
+    CHECK_FALSE(celix_dependencyManager_areComponentsActive(mng));
+    long svcId2 = celix_bundleContext_registerService(ctx, &dummySvc, "svcB", nullptr);
+    CHECK_TRUE(celix_dependencyManager_areComponentsActive(mng));
+
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    CHECK_FALSE(celix_dependencyManager_areComponentsActive(mng));
+
+    celix_dmServiceDependency_setRequired(dep1, false);
+    celix_dmComponent_removeServiceDependency(cmp, dep2); //triggers a state recalculation
+    CHECK_TRUE(celix_dependencyManager_areComponentsActive(mng));
+
+    celix_bundleContext_unregisterService(ctx, svcId2);
+}
+
+TEST_GROUP(DependencyManagerExecutorTests) {
+    framework_t* fw = nullptr;
+    bundle_context_t *ctx = nullptr;
+    properties_t *properties = nullptr;
+
+    void setup() {
+        properties = properties_create();
+        properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        properties_set(properties, "org.osgi.framework.storage.clean", "onFirstInit");
+        properties_set(properties, "org.osgi.framework.storage", ".cacheBundleContextTestFramework");
+        properties_set(properties, CELIX_DM_COMPONENT_USE_EXECUTOR, "true");
+
+        fw = celix_frameworkFactory_createFramework(properties);
+        ctx = framework_getContext(fw);
+    }
+
+    void teardown() {
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    template<typename F>
+    static bool waitFor(F condition) {
+        for (int i = 0; i < 5000 && !condition(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return condition();
+    }
+};
+
+TEST(DependencyManagerExecutorTests, ComponentStrands) {
+    struct counters {
+        std::atomic<int> nrOfStarts{0};
+        std::atomic<int> nrOfAdds{0};
+    };
+    counters cnt{};
+    int dummySvc = 0;
+    auto *mng = celix_bundleContext_getDependencyManager(ctx);
+
+    //cmp1 requires svcA, provided by cmp2
+    auto *cmp1 = celix_dmComponent_create(ctx, "test1");
+    celix_dmComponent_setImplementation(cmp1, &cnt);
+    celix_dmComponent_setCallbacks(cmp1, nullptr, [](void *handle) -> int {
+        static_cast<counters*>(handle)->nrOfStarts.fetch_add(1);
+        return CELIX_SUCCESS;
+    }, nullptr, nullptr);
+    auto *dep = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(dep, "svcA", nullptr, nullptr);
+    celix_dmServiceDependency_setRequired(dep, true);
+    celix_dm_service_dependency_callback_options_t opts{};
+    opts.add = [](void *handle, void *) -> int {
+        static_cast<counters*>(handle)->nrOfAdds.fetch_add(1);
+        return CELIX_SUCCESS;
+    };
+    celix_dmServiceDependency_setCallbacksWithOptions(dep, &opts);
+    celix_dmComponent_addServiceDependency(cmp1, dep);
+    celix_dependencyManager_add(mng, cmp1);
+
+    auto *cmp2 = celix_dmComponent_create(ctx, "test2");
+    celix_dmComponent_addInterface(cmp2, "svcA", nullptr, &dummySvc, nullptr);
+    celix_dependencyManager_add(mng, cmp2);
+
+    //note the component state is updated before the start callback is called
+    CHECK_TRUE(waitFor([&]{ return celix_dependencyManager_allComponentsActive(mng) && cnt.nrOfStarts.load() == 1; }));
+    CHECK_EQUAL(1, cnt.nrOfAdds.load());
+
+    //a burst of services, handled on the component strand
+    long svcIds[100];
+    for (long &svcId : svcIds) {
+        svcId = celix_bundleContext_registerService(ctx, &dummySvc, "svcA", nullptr);
+    }
+    CHECK_TRUE(waitFor([&]{ return cnt.nrOfAdds.load() == 101; }));
+    CHECK_EQUAL(1, cnt.nrOfStarts.load());
+
+    for (long svcId : svcIds) {
+        celix_bundleContext_unregisterService(ctx, svcId);
+    }
+    CHECK_TRUE(celix_dependencyManager_allComponentsActive(mng));
+
+    celix_dependencyManager_removeAllComponents(mng);
+    CHECK_EQUAL(0, celix_dependencyManager_nrOfComponents(mng));
+}
+
+TEST(DependencyManagerExecutorTests, RemovedServiceIsHandledBeforeUnregisterReturns) {
+    //note a single executor worker, so that the component strand can be kept queued behind a blocking task
+    properties_t *config = properties_create();
+    properties_set(config, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+    properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    properties_set(config, "org.osgi.framework.storage", ".cacheDmSingleWorkerTestFramework");
+    properties_set(config, CELIX_DM_COMPONENT_USE_EXECUTOR, "true");
+    properties_set(config, CELIX_FRAMEWORK_EXECUTOR_NR_OF_THREADS, "1");
+    framework_t *fw1 = celix_frameworkFactory_createFramework(config);
+    bundle_context_t *ctx1 = framework_getContext(fw1);
+
+    struct data {
+        std::atomic<bool> inAdd{false};
+        std::atomic<bool> releaseWorker{false};
+        std::atomic<int> nrOfAdds{0};
+        std::atomic<int> nrOfRemoves{0};
+    };
+    data d{};
+    int dummySvc = 0;
+    auto *mng = celix_bundleContext_getDependencyManager(ctx1);
+
+    auto *cmp = celix_dmComponent_create(ctx1, "test");
+    celix_dmComponent_setImplementation(cmp, &d);
+    auto *dep = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(dep, "svcA", nullptr, nullptr);
+    celix_dmServiceDependency_setRequired(dep, false);
+    celix_dm_service_dependency_callback_options_t opts{};
+    opts.add = [](void *handle, void *) -> int {
+        auto *d = static_cast<data*>(handle);
+        d->inAdd = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds{20}); //slow add, so that the strand is still running
+        d->nrOfAdds.fetch_add(1);
+        return CELIX_SUCCESS;
+    };
+    opts.remove = [](void *handle, void *) -> int {
+        static_cast<data*>(handle)->nrOfRemoves.fetch_add(1);
+        return CELIX_SUCCESS;
+    };
+    celix_dmServiceDependency_setCallbacksWithOptions(dep, &opts);
+    celix_dmComponent_addServiceDependency(cmp, dep);
+    celix_dependencyManager_add(mng, cmp);
+    CHECK_TRUE(waitFor([&]{ return celix_dependencyManager_allComponentsActive(mng); }));
+
+    //the removal must be handled before the unregister call returns, so that the removed service is no longer used.
+    //strand running on the executor worker: unregister waits for the strand
+    long svcId = celix_bundleContext_registerService(ctx1, &dummySvc, "svcA", nullptr);
+    CHECK_TRUE(waitFor([&]{ return d.inAdd.load(); }));
+    celix_bundleContext_unregisterService(ctx1, svcId);
+    CHECK_EQUAL(1, d.nrOfAdds.load());
+    CHECK_EQUAL(1, d.nrOfRemoves.load());
+
+    //strand queued behind a blocking task: unregister runs the strand inline
+    celix_bundleContext_useService(ctx1, CELIX_EXECUTOR_SERVICE_NAME, &d, [](void *handle, void *s) {
+        auto *svc = static_cast<celix_executor_service_t*>(s);
+        svc->submit(svc->handle, nullptr, handle, [](void *taskData) {
+            auto *d = static_cast<data*>(taskData);
+            while (!d->releaseWorker.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        });
+    });
+    svcId = celix_bundleContext_registerService(ctx1, &dummySvc, "svcA", nullptr);
+    CHECK_TRUE(waitFor([&]{
+        //the service is tracked, so the add is queued on the component strand
+        dm_service_dependency_info_t *info = celix_dmServiceDependency_createInfo(dep);
+        bool tracked = info->count == 1;
+        celix_dmServiceDependency_destroyInfo(dep, info);
+        return tracked;
+    }));
+    celix_bundleContext_unregisterService(ctx1, svcId);
+    CHECK_EQUAL(2, d.nrOfAdds.load());
+    CHECK_EQUAL(2, d.nrOfRemoves.load());
+    d.releaseWorker = true;
+
+    celix_dependencyManager_removeAllComponents(mng);
+    celix_frameworkFactory_destroyFramework(fw1);
+}
+
+TEST(DependencyManagerExecutorTests, RemoveComponentFromExecutorTask) {
+    //note a single executor worker, so a strand queued by an executor task is queued behind that task
+    properties_t *config = properties_create();
+    properties_set(config, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+    properties_set(config, "org.osgi.framework.storage.clean", "onFirstInit");
+    properties_set(config, "org.osgi.framework.storage", ".cacheDmSingleWorkerTestFramework");
+    properties_set(config, CELIX_DM_COMPONENT_USE_EXECUTOR, "true");
+    properties_set(config, CELIX_FRAMEWORK_EXECUTOR_NR_OF_THREADS, "1");
+    framework_t *fw1 = celix_frameworkFactory_createFramework(config);
+    bundle_context_t *ctx1 = framework_getContext(fw1);
+
+    struct data {
+        celix_bundle_context_t *ctx;
+        celix_dependency_manager_t *mng;
+        celix_dm_component_t *cmp;
+        int dummySvc;
+        std::atomic<bool> removed;
+    };
+    data d{ctx1, celix_bundleContext_getDependencyManager(ctx1), nullptr, 0, {false}};
+
+    d.cmp = celix_dmComponent_create(ctx1, "test");
+    auto *dep = celix_dmServiceDependency_create();
+    celix_dmServiceDependency_setService(dep, "svcA", nullptr, nullptr);
+    celix_dmServiceDependency_setRequired(dep, false);
+    celix_dm_service_dependency_callback_options_t opts{};
+    opts.add = [](void *, void *) -> int {
+        return CELIX_SUCCESS;
+    };
+    celix_dmServiceDependency_setCallbacksWithOptions(dep, &opts);
+    celix_dmComponent_addServiceDependency(d.cmp, dep);
+    celix_dependencyManager_add(d.mng, d.cmp);
+    CHECK_TRUE(waitFor([&]{ return celix_dependencyManager_allComponentsActive(d.mng); }));
+
+    celix_bundleContext_useService(ctx1, CELIX_EXECUTOR_SERVICE_NAME, &d, [](void *handle, void *s) {
+        auto *svc = static_cast<celix_executor_service_t*>(s);
+        svc->submit(svc->handle, nullptr, handle, [](void *taskData) {
+            auto *d = static_cast<data*>(taskData);
+            //queues the component strand on the executor and removes (stops) the component before the strand runs
+            long svcId = celix_bundleContext_registerService(d->ctx, &d->dummySvc, "svcA", nullptr);
+            celix_dependencyManager_remove(d->mng, d->cmp);
+            celix_bundleContext_unregisterService(d->ctx, svcId);
+            d->removed = true;
+        });
+    });
+    CHECK_TRUE(waitFor([&]{ return d.removed.load(); }));
+    CHECK_EQUAL(0, celix_dependencyManager_nrOfComponents(d.mng));
+
+    celix_frameworkFactory_destroyFramework(fw1);
+}
@@ -0,0 +1,182 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <map>
+
+#include "celix_api.h"
+#include "celix_framework_factory.h"
+#include "celix_executor_service.h"
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+TEST_GROUP(CelixExecutorServiceTests) {
+    framework_t* fw = nullptr;
+    bundle_context_t *ctx = nullptr;
+    properties_t *properties = nullptr;
+
+    void setup() {
+        properties = properties_create();
+        properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        properties_set(properties, "org.osgi.framework.storage.clean", "onFirstInit");
+        properties_set(properties, "org.osgi.framework.storage", ".cacheExecutorServiceTestFramework");
+        properties_set(properties, CELIX_FRAMEWORK_EXECUTOR_NR_OF_THREADS, "4");
+
+        fw = celix_frameworkFactory_createFramework(properties);
+        ctx = framework_getContext(fw);
+    }
+
+    void teardown() {
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    static bool waitFor(std::atomic<int> &count, int expected) {
+        for (int i = 0; i < 5000 && count.load() < expected; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return count.load() >= expected;
+    }
+};
+
+TEST(CelixExecutorServiceTests, submitTasks) {
+    struct data {
+        celix_executor_service_t *svc;
+        std::atomic<int> count;
+        std::atomic<int> nrOfNestedSubmits;
+    };
+    data d{nullptr, {0}, {0}};
+
+    bool called = celix_bundleContext_useService(ctx, CELIX_EXECUTOR_SERVICE_NAME, &d, [](void *handle, void *svc) {
+        auto *d = static_cast<data*>(handle);
+        d->svc = static_cast<celix_executor_service_t*>(svc);
+        for (int i = 0; i < 1000; ++i) {
+            celix_status_t status = d->svc->submit(d->svc->handle, "test", d, [](void *taskData) {
+                auto *d = static_cast<data*>(taskData);
+                d->count.fetch_add(1);
+                if (d->nrOfNestedSubmits.fetch_add(1) < 100) {
+                    //submit from a worker thread, i.e. to the deque of the worker
+                    d->svc->submit(d->svc->handle, "test", d, [](void *taskData) {
+                        static_cast<data*>(taskData)->count.fetch_add(1);
+                    });
+                }
+            });
+            CHECK_EQUAL(CELIX_SUCCESS, status);
+        }
+        CHECK_TRUE(waitFor(d->count, 1100));
+    });
+    CHECK_TRUE(called);
+    CHECK_EQUAL(1100, d.count.load());
+}
+
+TEST(CelixExecutorServiceTests, scheduleTasks) {
+    std::atomic<int> periodicCount{0};
+    std::atomic<int> delayedCount{0};
+    celix_bundleContext_useService(ctx, CELIX_EXECUTOR_SERVICE_NAME, &periodicCount, [](void *handle, void *s) {
+        auto *svc = static_cast<celix_executor_service_t*>(s);
+        auto *count = static_cast<std::atomic<int>*>(handle);
+        long id = svc->schedule(svc->handle, "periodic", 0.0, 0.001, count, [](void *taskData) {
+            static_cast<std::atomic<int>*>(taskData)->fetch_add(1);
+        });
+        CHECK(id >= 0);
+        CHECK_TRUE(waitFor(*count, 10));
+        CHECK_TRUE(svc->cancelScheduledTask(svc->handle, id));
+        CHECK_FALSE(svc->cancelScheduledTask(svc->handle, id));
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        int countAfterCancel = count->load();
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        CHECK_EQUAL(countAfterCancel, count->load());
+    });
+
+    celix_bundleContext_useService(ctx, CELIX_EXECUTOR_SERVICE_NAME, &delayedCount, [](void *handle, void *s) {
+        auto *svc = static_cast<celix_executor_service_t*>(s);
+        auto *count = static_cast<std::atomic<int>*>(handle);
+        auto start = std::chrono::steady_clock::now();
+        long id = svc->schedule(svc->handle, "delayed", 0.02, 0.0, count, [](void *taskData) {
+            static_cast<std::atomic<int>*>(taskData)->fetch_add(1);
+        });
+        CHECK(id >= 0);
+        CHECK_TRUE(waitFor(*count, 1));
+        CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{20});
+        std::this_thread::sleep_for(std::chrono::milliseconds{30});
+        CHECK_EQUAL(1, count->load()); //one shot
+        CHECK_FALSE(svc->cancelScheduledTask(svc->handle, id));
+    });
+}
+
+TEST(CelixExecutorServiceTests, queueMetrics) {
+    std::atomic<int> count{0};
+    celix_bundleContext_useService(ctx, CELIX_EXECUTOR_SERVICE_NAME, &count, [](void *handle, void *s) {
+        auto *svc = static_cast<celix_executor_service_t*>(s);
+        auto *count = static_cast<std::atomic<int>*>(handle);
+        CHECK_EQUAL(CELIX_SUCCESS, svc->setQueuePriority(svc->handle, "high", CELIX_EXECUTOR_PRIORITY_HIGH));
+        for (int i = 0; i < 10; ++i) {
+            svc->submit(svc->handle, "high", count, [](void *taskData) {
+                static_cast<std::atomic<int>*>(taskData)->fetch_add(1);
+            });
+            svc->submit(svc->handle, nullptr, count, [](void *taskData) {
+                static_cast<std::atomic<int>*>(taskData)->fetch_add(1);
+            });
+        }
+        CHECK_TRUE(waitFor(*count, 20));
+        std::this_thread::sleep_for(std::chrono::milliseconds{10}); //metrics are updated after the task is executed
+
+        std::map<std::string, celix_executor_queue_metrics_t> metrics{};
+        svc->useQueueMetrics(svc->handle, &metrics, [](void *handle, const celix_executor_queue_metrics_t *m) {
+            auto *metrics = static_cast<std::map<std::string, celix_executor_queue_metrics_t>*>(handle);
+            (*metrics)[m->queueName] = *m;
+        });
+        CHECK_EQUAL(2, metrics.size());
+        CHECK_EQUAL(CELIX_EXECUTOR_PRIORITY_HIGH, metrics["high"].priority);
+        CHECK_EQUAL(10, metrics["high"].nrOfExecutedTasks);
+        CHECK_EQUAL(0, metrics["high"].queueDepth);
+        CHECK_EQUAL(CELIX_EXECUTOR_PRIORITY_NORMAL, metrics[CELIX_EXECUTOR_DEFAULT_QUEUE_NAME].priority);
+        CHECK_EQUAL(10, metrics[CELIX_EXECUTOR_DEFAULT_QUEUE_NAME].nrOfExecutedTasks);
+        CHECK(metrics["high"].maxLatencyInSeconds >= metrics["high"].averageLatencyInSeconds);
+    });
+}
+
+TEST(CelixExecutorServiceTests, cancelWaitsForRunningTask) {
+    struct data {
+        std::atomic<int> count;
+        std::atomic<bool> running;
+    };
+    data d{{0}, {false}};
+    celix_bundleContext_useService(ctx, CELIX_EXECUTOR_SERVICE_NAME, &d, [](void *handle, void *s) {
+        auto *svc = static_cast<celix_executor_service_t*>(s);
+        auto *d = static_cast<data*>(handle);
+        long id = svc->schedule(svc->handle, "slow", 0.0, 0.001, d, [](void *taskData) {
+            auto *d = static_cast<data*>(taskData);
+            d->running = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            d->count.fetch_add(1);
+            d->running = false;
+        });
+        CHECK(id >= 0);
+        CHECK_TRUE(waitFor(d->count, 1));
+        while (!d->running.load()) {
+            std::this_thread::yield();
+        }
+        CHECK_TRUE(svc->cancelScheduledTask(svc->handle, id));
+        CHECK_FALSE(d->running.load());
+    });
+}
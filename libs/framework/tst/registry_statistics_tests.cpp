@@ -0,0 +1,166 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "celix_api.h"
+#include "celix_framework_factory.h"
+#include "celix_registry_statistics_service.h"
+#include "celix_registry_statistics.h"
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+TEST_GROUP(CelixRegistryStatisticsTests) {
+    framework_t* fw = nullptr;
+    bundle_context_t *ctx = nullptr;
+    properties_t *properties = nullptr;
+
+    void setup() {
+        properties = properties_create();
+        properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        properties_set(properties, "org.osgi.framework.storage.clean", "onFirstInit");
+        properties_set(properties, "org.osgi.framework.storage", ".cacheRegistryStatisticsTestFramework");
+        properties_set(properties, CELIX_FRAMEWORK_REGISTRY_STATISTICS, "true");
+
+        fw = celix_frameworkFactory_createFramework(properties);
+        ctx = framework_getContext(fw);
+    }
+
+    void teardown() {
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    struct statistics {
+        std::map<long, celix_registry_statistics_entry_t> bundles{};
+        std::map<std::string, celix_registry_statistics_entry_t> services{};
+    };
+
+    statistics readStatistics() {
+        statistics stats{};
+        bool called = celix_bundleContext_useService(ctx, CELIX_REGISTRY_STATISTICS_SERVICE_NAME, &stats, [](void *handle, void *s) {
+            auto *stats = static_cast<statistics*>(handle);
+            auto *svc = static_cast<celix_registry_statistics_service_t*>(s);
+            svc->useBundleStatistics(svc->handle, stats, [](void *handle, const celix_registry_statistics_entry_t *entry) {
+                static_cast<statistics*>(handle)->bundles[entry->bundleId] = *entry;
+            });
+            svc->useServiceNameStatistics(svc->handle, stats, [](void *handle, const celix_registry_statistics_entry_t *entry) {
+                auto *e = &static_cast<statistics*>(handle)->services[entry->serviceName];
+                *e = *entry;
+                e->serviceName = nullptr; //only valid during the callback
+            });
+        });
+        CHECK_TRUE(called);
+        return stats;
+    }
+};
+
+TEST(CelixRegistryStatisticsTests, countLookupsListenersAndTrackerCallbacks) {
+    int dummySvc = 42;
+    long svcId = celix_bundleContext_registerService(ctx, &dummySvc, "test_service", nullptr);
+    CHECK(svcId >= 0);
+
+    for (int i = 0; i < 10; ++i) {
+        CHECK_EQUAL(svcId, celix_bundleContext_findService(ctx, "test_service"));
+    }
+
+    int count = 0;
+    long trkId = celix_bundleContext_trackServices(ctx, "test_service", &count, [](void *handle, void *) {
+        *static_cast<int*>(handle) += 1;
+    }, nullptr);
+    CHECK(trkId >= 0);
+    CHECK_EQUAL(1, count);
+
+    //new service registration -> service event for the tracker
+    long svcId2 = celix_bundleContext_registerService(ctx, &dummySvc, "test_service", nullptr);
+    CHECK_EQUAL(2, count);
+
+    statistics stats = readStatistics();
+    auto &fwStats = stats.bundles[0];
+    CHECK(fwStats.calls[CELIX_REGISTRY_STATISTICS_LOOKUP].count >= 10);
+    CHECK(fwStats.calls[CELIX_REGISTRY_STATISTICS_LISTENER_CALL].count >= 1);
+    CHECK(fwStats.calls[CELIX_REGISTRY_STATISTICS_TRACKER_CALLBACK].count >= 2);
+
+    auto &svcStats = stats.services["test_service"];
+    CHECK(svcStats.calls[CELIX_REGISTRY_STATISTICS_LOOKUP].count >= 10);
+    CHECK_EQUAL(2, svcStats.calls[CELIX_REGISTRY_STATISTICS_TRACKER_CALLBACK].count);
+
+    size_t histogramCount = 0;
+    for (size_t c : svcStats.calls[CELIX_REGISTRY_STATISTICS_LOOKUP].histogram) {
+        histogramCount += c;
+    }
+    CHECK_EQUAL(svcStats.calls[CELIX_REGISTRY_STATISTICS_LOOKUP].count, histogramCount);
+    CHECK(svcStats.calls[CELIX_REGISTRY_STATISTICS_LOOKUP].maxTimeInSeconds > 0.0);
+
+    //reset
+    celix_bundleContext_useService(ctx, CELIX_REGISTRY_STATISTICS_SERVICE_NAME, nullptr, [](void *, void *s) {
+        auto *svc = static_cast<celix_registry_statistics_service_t*>(s);
+        svc->reset(svc->handle);
+    });
+    stats = readStatistics();
+    CHECK_EQUAL(0, stats.services["test_service"].calls[CELIX_REGISTRY_STATISTICS_TRACKER_CALLBACK].count);
+
+    celix_bundleContext_stopTracker(ctx, trkId);
+    celix_bundleContext_unregisterService(ctx, svcId);
+    celix_bundleContext_unregisterService(ctx, svcId2);
+}
+
+TEST(CelixRegistryStatisticsTests, concurrentRecords) {
+    constexpr int NR_OF_THREADS = 4;
+    constexpr int NR_OF_NAMES = 100;
+    constexpr int NR_OF_RECORDS = 1000;
+
+    celix_registry_statistics_t *stats = celix_registryStatistics_create();
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < NR_OF_THREADS; ++t) {
+        threads.emplace_back([stats]{
+            struct timespec start{};
+            celix_registryStatistics_startTimer(stats, &start);
+            for (int i = 0; i < NR_OF_RECORDS; ++i) {
+                std::string name = "service" + std::to_string(i % NR_OF_NAMES);
+                celix_registryStatistics_record(stats, CELIX_REGISTRY_STATISTICS_LOOKUP, i % 10, name.c_str(), &start);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    celix_registry_statistics_service_t svc{};
+    celix_registryStatistics_initService(stats, &svc);
+    statistics result{};
+    svc.useBundleStatistics(svc.handle, &result, [](void *handle, const celix_registry_statistics_entry_t *entry) {
+        static_cast<statistics*>(handle)->bundles[entry->bundleId] = *entry;
+    });
+    svc.useServiceNameStatistics(svc.handle, &result, [](void *handle, const celix_registry_statistics_entry_t *entry) {
+        static_cast<statistics*>(handle)->services[entry->serviceName] = *entry;
+    });
+    CHECK_EQUAL(10, result.bundles.size());
+    CHECK_EQUAL(NR_OF_NAMES, result.services.size());
+    for (auto &entry : result.services) {
+        CHECK_EQUAL(NR_OF_THREADS * NR_OF_RECORDS / NR_OF_NAMES, entry.second.calls[CELIX_REGISTRY_STATISTICS_LOOKUP].count);
+    }
+    for (auto &entry : result.bundles) {
+        CHECK_EQUAL(NR_OF_THREADS * NR_OF_RECORDS / 10, entry.second.calls[CELIX_REGISTRY_STATISTICS_LOOKUP].count);
+    }
+    celix_registryStatistics_destroy(stats);
+}
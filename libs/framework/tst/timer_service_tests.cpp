@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+
+#include "celix_api.h"
+#include "celix_framework_factory.h"
+#include "celix_timer_service.h"
+#include "celix_timer_wheel.h"
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTest/CommandLineTestRunner.h>
+
+TEST_GROUP(CelixTimerWheelTests) {
+    celix_timer_wheel_t wheel{};
+
+    void setup() {
+        celix_timerWheel_init(&wheel, 0);
+    }
+
+    void teardown() {
+    }
+};
+
+static void collectExpired(void *handle, celix_timer_wheel_entry_t *entry) {
+    auto *expiredEntries = static_cast<std::vector<celix_timer_wheel_entry_t*>*>(handle);
+    expiredEntries->push_back(entry);
+}
+
+TEST(CelixTimerWheelTests, expireInOrderOverAllLevels) {
+    //expiries on every level of the wheel and beyond the range of the wheel
+    std::vector<uint64_t> expiries{1, 5, 63, 64, 65, 100, 4095, 4096, 5000, 300000, 16777215, 16777216, 20000000};
+    std::vector<celix_timer_wheel_entry_t> entries{expiries.size()};
+    for (size_t i = expiries.size(); i > 0; --i) {
+        celix_timerWheel_initEntry(&entries[i - 1]);
+        celix_timerWheel_add(&wheel, &entries[i - 1], expiries[i - 1]);
+    }
+    CHECK_EQUAL(expiries.size(), celix_timerWheel_size(&wheel));
+
+    std::vector<celix_timer_wheel_entry_t*> expired{};
+    uint64_t tick = 0;
+    while (celix_timerWheel_nextTick(&wheel, &tick)) {
+        size_t before = expired.size();
+        celix_timerWheel_advance(&wheel, tick, &expired, collectExpired);
+        for (size_t i = before; i < expired.size(); ++i) {
+            //never expired early or late
+            CHECK_EQUAL(tick, expired[i]->expiry);
+        }
+    }
+    CHECK_EQUAL(expiries.size(), expired.size());
+    for (size_t i = 0; i < expiries.size(); ++i) {
+        CHECK_EQUAL(expiries[i], expired[i]->expiry);
+    }
+    CHECK_EQUAL(0, celix_timerWheel_size(&wheel));
+}
+
+TEST(CelixTimerWheelTests, advanceOverLongSleep) {
+    celix_timer_wheel_entry_t entry1;
+    celix_timer_wheel_entry_t entry2;
+    celix_timerWheel_initEntry(&entry1);
+    celix_timerWheel_initEntry(&entry2);
+    celix_timerWheel_add(&wheel, &entry1, 10);
+    celix_timerWheel_add(&wheel, &entry2, 100000);
+
+    std::vector<celix_timer_wheel_entry_t*> expired{};
+    CHECK_EQUAL(0, celix_timerWheel_advance(&wheel, 9, &expired, collectExpired));
+    CHECK_EQUAL(2, celix_timerWheel_advance(&wheel, 200000, &expired, collectExpired));
+    CHECK(expired[0] == &entry1);
+    CHECK(expired[1] == &entry2);
+
+    //an expiry in the past expires on the next tick
+    celix_timerWheel_add(&wheel, &entry1, 10);
+    CHECK_EQUAL(1, celix_timerWheel_advance(&wheel, 200001, &expired, collectExpired));
+}
+
+TEST(CelixTimerWheelTests, removeAndMove) {
+    celix_timer_wheel_entry_t entry1;
+    celix_timer_wheel_entry_t entry2;
+    celix_timerWheel_initEntry(&entry1);
+    celix_timerWheel_initEntry(&entry2);
+    CHECK_FALSE(celix_timerWheel_remove(&wheel, &entry1));
+
+    celix_timerWheel_add(&wheel, &entry1, 70);
+    celix_timerWheel_add(&wheel, &entry2, 80);
+    celix_timerWheel_add(&wheel, &entry2, 20); //moved
+    CHECK_EQUAL(2, celix_timerWheel_size(&wheel));
+    CHECK_TRUE(celix_timerWheel_remove(&wheel, &entry1));
+    CHECK_FALSE(celix_timerWheel_remove(&wheel, &entry1));
+
+    uint64_t tick = 0;
+    CHECK_TRUE(celix_timerWheel_nextTick(&wheel, &tick));
+    CHECK_EQUAL(20, tick);
+
+    std::vector<celix_timer_wheel_entry_t*> expired{};
+    CHECK_EQUAL(1, celix_timerWheel_advance(&wheel, 1000, &expired, collectExpired));
+    CHECK_FALSE(celix_timerWheel_nextTick(&wheel, &tick));
+}
+
+TEST_GROUP(CelixTimerServiceTests) {
+    framework_t* fw = nullptr;
+    bundle_context_t *ctx = nullptr;
+    properties_t *properties = nullptr;
+
+    void setup() {
+        properties = properties_create();
+        properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        properties_set(properties, "org.osgi.framework.storage.clean", "onFirstInit");
+        properties_set(properties, "org.osgi.framework.storage", ".cacheTimerServiceTestFramework");
+
+        fw = celix_frameworkFactory_createFramework(properties);
+        ctx = framework_getContext(fw);
+    }
+
+    void teardown() {
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+};
+
+static bool waitForCount(std::atomic<int> &count, int expected) {
+    for (int i = 0; i < 5000 && count.load() < expected; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return count.load() >= expected;
+}
+
+TEST(CelixTimerServiceTests, oneShotAndPeriodicTimers) {
+    bool called = celix_bundleContext_useService(ctx, CELIX_TIMER_SERVICE_NAME, nullptr, [](void *, void *svc) {
+        auto *timerSvc = static_cast<celix_timer_service_t*>(svc);
+        std::atomic<int> oneShotCount{0};
+        std::atomic<int> periodicCount{0};
+
+        auto start = std::chrono::steady_clock::now();
+        long oneShotId = timerSvc->scheduleTimer(timerSvc->handle, 0.02, 0.0, &oneShotCount, [](void *data) {
+            static_cast<std::atomic<int>*>(data)->fetch_add(1);
+        });
+        long periodicId = timerSvc->scheduleTimer(timerSvc->handle, 0.0, 0.002, &periodicCount, [](void *data) {
+            static_cast<std::atomic<int>*>(data)->fetch_add(1);
+        });
+        CHECK(oneShotId >= 0);
+        CHECK(periodicId >= 0);
+
+        CHECK_TRUE(waitForCount(oneShotCount, 1));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        CHECK(elapsed >= std::chrono::milliseconds{20}); //never early
+        CHECK_TRUE(waitForCount(periodicCount, 5));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{5}); //ensure the one-shot timer callback is finished
+        CHECK_FALSE(timerSvc->cancelTimer(timerSvc->handle, oneShotId)); //already fired
+        CHECK_TRUE(timerSvc->cancelTimer(timerSvc->handle, periodicId));
+        int count = periodicCount.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        CHECK_EQUAL(count, periodicCount.load()); //no calls after cancel
+        CHECK_EQUAL(1, oneShotCount.load());
+    });
+    CHECK_TRUE(called);
+}
+
+TEST(CelixTimerServiceTests, cancelBeforeExpiry) {
+    bool called = celix_bundleContext_useService(ctx, CELIX_TIMER_SERVICE_NAME, nullptr, [](void *, void *svc) {
+        auto *timerSvc = static_cast<celix_timer_service_t*>(svc);
+        std::atomic<int> count{0};
+        long id = timerSvc->scheduleTimer(timerSvc->handle, 0.05, 0.0, &count, [](void *data) {
+            static_cast<std::atomic<int>*>(data)->fetch_add(1);
+        });
+        CHECK_TRUE(timerSvc->cancelTimer(timerSvc->handle, id));
+        CHECK_FALSE(timerSvc->cancelTimer(timerSvc->handle, id));
+        std::this_thread::sleep_for(std::chrono::milliseconds{70});
+        CHECK_EQUAL(0, count.load());
+    });
+    CHECK_TRUE(called);
+}
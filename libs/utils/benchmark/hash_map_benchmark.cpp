@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "hash_map.h"
+#include "celix_hash_map.h"
+#include "utils.h"
+
+namespace {
+    std::vector<std::string> createKeys(int nrOfKeys) {
+        std::vector<std::string> keys{};
+        keys.reserve(nrOfKeys);
+        for (int i = 0; i < nrOfKeys; ++i) {
+            keys.push_back("org.apache.celix.example.service.name" + std::to_string(i));
+        }
+        return keys;
+    }
+}
+
+static void BM_HashMapStringGet(benchmark::State &state) {
+    auto keys = createKeys((int)state.range(0));
+    hash_map_t *map = hashMap_create(utils_stringHash, nullptr, utils_stringEquals, nullptr);
+    for (auto &key : keys) {
+        hashMap_put(map, (void*)key.c_str(), (void*)key.c_str());
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        void *val = hashMap_get(map, keys[i++ % keys.size()].c_str());
+        benchmark::DoNotOptimize(val);
+    }
+    hashMap_destroy(map, false, false);
+}
+BENCHMARK(BM_HashMapStringGet)->Arg(10)->Arg(1000)->Arg(100000);
+
+static void BM_CelixStringHashMapGet(benchmark::State &state) {
+    auto keys = createKeys((int)state.range(0));
+    celix_hash_map_create_options_t opts{};
+    opts.storeKeysWeakly = true; //same as the hash_map_t benchmark, which does not copy the keys
+    celix_string_hash_map_t *map = celix_stringHashMap_createWithOptions(&opts);
+    for (auto &key : keys) {
+        celix_stringHashMap_put(map, key.c_str(), (void*)key.c_str());
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        void *val = celix_stringHashMap_get(map, keys[i++ % keys.size()].c_str());
+        benchmark::DoNotOptimize(val);
+    }
+    celix_stringHashMap_destroy(map);
+}
+BENCHMARK(BM_CelixStringHashMapGet)->Arg(10)->Arg(1000)->Arg(100000);
+
+static void BM_HashMapLongGet(benchmark::State &state) {
+    long nrOfKeys = state.range(0);
+    hash_map_t *map = hashMap_create(nullptr, nullptr, nullptr, nullptr);
+    for (long i = 0; i < nrOfKeys; ++i) {
+        hashMap_put(map, (void*)i, (void*)(i + 1));
+    }
+    long i = 0;
+    for (auto _ : state) {
+        void *val = hashMap_get(map, (void*)(i++ % nrOfKeys));
+        benchmark::DoNotOptimize(val);
+    }
+    hashMap_destroy(map, false, false);
+}
+BENCHMARK(BM_HashMapLongGet)->Arg(10)->Arg(1000)->Arg(100000);
+
+static void BM_CelixLongHashMapGet(benchmark::State &state) {
+    long nrOfKeys = state.range(0);
+    celix_long_hash_map_t *map = celix_longHashMap_create();
+    for (long i = 0; i < nrOfKeys; ++i) {
+        celix_longHashMap_put(map, i, (void*)(i + 1));
+    }
+    long i = 0;
+    for (auto _ : state) {
+        void *val = celix_longHashMap_get(map, i++ % nrOfKeys);
+        benchmark::DoNotOptimize(val);
+    }
+    celix_longHashMap_destroy(map);
+}
+BENCHMARK(BM_CelixLongHashMapGet)->Arg(10)->Arg(1000)->Arg(100000);
+
+static void BM_HashMapLongPutRemove(benchmark::State &state) {
+    long nrOfKeys = state.range(0);
+    hash_map_t *map = hashMap_create(nullptr, nullptr, nullptr, nullptr);
+    for (auto _ : state) {
+        for (long i = 0; i < nrOfKeys; ++i) {
+            hashMap_put(map, (void*)i, (void*)(i + 1));
+        }
+        for (long i = 0; i < nrOfKeys; ++i) {
+            hashMap_remove(map, (void*)i);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfKeys);
+    hashMap_destroy(map, false, false);
+}
+BENCHMARK(BM_HashMapLongPutRemove)->Arg(10)->Arg(1000)->Arg(100000);
+
+static void BM_CelixLongHashMapPutRemove(benchmark::State &state) {
+    long nrOfKeys = state.range(0);
+    celix_long_hash_map_t *map = celix_longHashMap_create();
+    for (auto _ : state) {
+        for (long i = 0; i < nrOfKeys; ++i) {
+            celix_longHashMap_put(map, i, (void*)(i + 1));
+        }
+        for (long i = 0; i < nrOfKeys; ++i) {
+            celix_longHashMap_remove(map, i);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * nrOfKeys);
+    celix_longHashMap_destroy(map);
+}
+BENCHMARK(BM_CelixLongHashMapPutRemove)->Arg(10)->Arg(1000)->Arg(100000);
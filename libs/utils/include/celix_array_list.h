@@ -45,11 +45,59 @@ typedef struct celix_array_list celix_array_list_t;
 
 typedef bool (*celix_arrayList_equals_fp)(celix_array_list_entry_t, celix_array_list_entry_t);
 
+#define CELIX_ARRAY_LIST_INLINE_CAPACITY 16
+
+/**
+ * The max capacity a scratch list keeps when it is released, see celix_arrayList_releaseScratch.
+ */
+#define CELIX_ARRAY_LIST_MAX_SCRATCH_CAPACITY 1024
+
+/**
+ * The nr of entries of a celix_inline_array_list_t reserved for the (opaque) array list struct.
+ */
+#define CELIX_ARRAY_LIST_INLINE_RESERVED_SIZE 10
+
+/**
+ * Opaque buffer for an array list with inline storage for the first CELIX_ARRAY_LIST_INLINE_CAPACITY entries,
+ * so that a small array list can be used without heap allocations (e.g. on the stack).
+ * Initialize with celix_arrayList_initInline and do not use the buffer directly.
+ */
+typedef struct celix_inline_array_list {
+    celix_array_list_entry_t buffer[CELIX_ARRAY_LIST_INLINE_RESERVED_SIZE + CELIX_ARRAY_LIST_INLINE_CAPACITY];
+} celix_inline_array_list_t;
+
 
 celix_array_list_t* celix_arrayList_create();
 
 celix_array_list_t* celix_arrayList_createWithEquals(celix_arrayList_equals_fp equals);
 
+/**
+ * Initializes the inline array list and returns the array list. Only if the list grows beyond
+ * CELIX_ARRAY_LIST_INLINE_CAPACITY entries, a element buffer is allocated on the heap.
+ * Note that celix_arrayList_destroy must still be called to free the element buffer (if any), the inline array list
+ * itself is not freed and should outlive the list. E.g.:
+ * celix_inline_array_list_t buf;
+ * celix_array_list_t *list = celix_arrayList_initInline(&buf);
+ * ...
+ * celix_arrayList_destroy(list);
+ */
+celix_array_list_t* celix_arrayList_initInline(celix_inline_array_list_t *inlineList);
+
+/**
+ * Takes a empty array list from the scratch lists of the calling thread, or creates a new array list if there is
+ * no scratch list available. The scratch lists keep their element buffer, so that reusing a scratch list
+ * does not need a heap allocation.
+ * The list is created with the default equals and must be returned with celix_arrayList_releaseScratch.
+ */
+celix_array_list_t* celix_arrayList_takeScratch(void);
+
+/**
+ * Clears and returns the list to the scratch lists of the calling thread.
+ * A element buffer which grew beyond CELIX_ARRAY_LIST_MAX_SCRATCH_CAPACITY entries is freed, so that a single large
+ * use does not keep a large buffer alive for the lifetime of the thread.
+ */
+void celix_arrayList_releaseScratch(celix_array_list_t *list);
+
 void celix_arrayList_destroy(celix_array_list_t *list);
 
 int celix_arrayList_size(const celix_array_list_t *list);
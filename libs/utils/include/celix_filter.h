@@ -73,6 +73,14 @@ const char* celix_filter_getFilterString(const celix_filter_t *filter);
  */
 const char* celix_filter_findAttribute(const celix_filter_t *filter, const char *attribute);
 
+/**
+ * Find the value of a mandatory equality term (attribute=value) for the provided attribute.
+ * Only the filter itself and its AND children are searched, so if a value is found every properties set matching
+ * the filter has that attribute with that value. This can be used to select candidates with an index.
+ * @return The attribute value or NULL if the filter has no mandatory equality term for the attribute.
+ */
+const char* celix_filter_findMandatoryEqualityValue(const celix_filter_t *filter, const char *attribute);
+
 
 #ifdef __cplusplus
 }
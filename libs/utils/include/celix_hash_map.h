@@ -0,0 +1,184 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_HASH_MAP_H_
+#define CELIX_HASH_MAP_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "exports.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Open addressing hash maps with string, long and pointer keys.
+ *
+ * In contrast to the (chained) hash_map_t, the entries are stored inline in a single bucket array (robin hood
+ * hashing with backward shift deletion), so a put does not allocate an entry and a lookup does not need to call
+ * hash and equals functions through function pointers.
+ *
+ * Note that the maps are not thread safe and that a map cannot be changed while iterating over it.
+ * The create functions return NULL if the map could not be allocated.
+ */
+typedef struct celix_string_hash_map celix_string_hash_map_t;
+typedef struct celix_long_hash_map celix_long_hash_map_t;
+typedef struct celix_ptr_hash_map celix_ptr_hash_map_t;
+
+typedef struct celix_hash_map_create_options {
+    /**
+     * The initial nr of entries the map can contain without growing. If 0 a small default is used.
+     */
+    size_t initialCapacity;
+
+    /**
+     * Only used for string hash maps.
+     * If true the keys are not copied and the caller must ensure that a key is valid as long as it is part of the
+     * map. If false (default) the keys are copied and owned by the map.
+     */
+    bool storeKeysWeakly;
+} celix_hash_map_create_options_t;
+
+/**
+ * C Macro to create a empty celix_hash_map_create_options_t type.
+ */
+#ifndef __cplusplus
+#define CELIX_EMPTY_HASH_MAP_CREATE_OPTIONS {.initialCapacity = 0, .storeKeysWeakly = false}
+#endif
+
+typedef struct celix_string_hash_map_iterator {
+    size_t index; //private
+    const celix_string_hash_map_t *map; //private
+    const char *key;
+    void *value;
+} celix_string_hash_map_iterator_t;
+
+typedef struct celix_long_hash_map_iterator {
+    size_t index; //private
+    const celix_long_hash_map_t *map; //private
+    long key;
+    void *value;
+} celix_long_hash_map_iterator_t;
+
+typedef struct celix_ptr_hash_map_iterator {
+    size_t index; //private
+    const celix_ptr_hash_map_t *map; //private
+    const void *key;
+    void *value;
+} celix_ptr_hash_map_iterator_t;
+
+
+UTILS_EXPORT celix_string_hash_map_t* celix_stringHashMap_create(void);
+
+UTILS_EXPORT celix_string_hash_map_t* celix_stringHashMap_createWithOptions(const celix_hash_map_create_options_t *opts);
+
+/**
+ * Destroys the map. The owned keys are freed, the values are not.
+ */
+UTILS_EXPORT void celix_stringHashMap_destroy(celix_string_hash_map_t *map);
+
+UTILS_EXPORT size_t celix_stringHashMap_size(const celix_string_hash_map_t *map);
+
+/**
+ * Returns the value for the provided key or NULL if the key is not part of the map.
+ */
+UTILS_EXPORT void* celix_stringHashMap_get(const celix_string_hash_map_t *map, const char *key);
+
+UTILS_EXPORT bool celix_stringHashMap_hasKey(const celix_string_hash_map_t *map, const char *key);
+
+/**
+ * Adds or replaces the value for the provided key.
+ * Returns the replaced value or NULL if the key was not yet part of the map.
+ * If the map is full and cannot grow (or the key cannot be copied) due to an allocation failure, the entry is not added.
+ */
+UTILS_EXPORT void* celix_stringHashMap_put(celix_string_hash_map_t *map, const char *key, void *value);
+
+/**
+ * Removes the entry for the provided key and returns the removed value (or NULL if the key was not part of the map).
+ */
+UTILS_EXPORT void* celix_stringHashMap_remove(celix_string_hash_map_t *map, const char *key);
+
+UTILS_EXPORT void celix_stringHashMap_clear(celix_string_hash_map_t *map);
+
+/**
+ * Returns an iterator pointing to the first entry of the map or an end iterator if the map is empty.
+ */
+UTILS_EXPORT celix_string_hash_map_iterator_t celix_stringHashMap_begin(const celix_string_hash_map_t *map);
+
+UTILS_EXPORT bool celix_stringHashMapIterator_isEnd(const celix_string_hash_map_iterator_t *iter);
+
+UTILS_EXPORT void celix_stringHashMapIterator_next(celix_string_hash_map_iterator_t *iter);
+
+
+UTILS_EXPORT celix_long_hash_map_t* celix_longHashMap_create(void);
+
+UTILS_EXPORT celix_long_hash_map_t* celix_longHashMap_createWithOptions(const celix_hash_map_create_options_t *opts);
+
+UTILS_EXPORT void celix_longHashMap_destroy(celix_long_hash_map_t *map);
+
+UTILS_EXPORT size_t celix_longHashMap_size(const celix_long_hash_map_t *map);
+
+UTILS_EXPORT void* celix_longHashMap_get(const celix_long_hash_map_t *map, long key);
+
+UTILS_EXPORT bool celix_longHashMap_hasKey(const celix_long_hash_map_t *map, long key);
+
+UTILS_EXPORT void* celix_longHashMap_put(celix_long_hash_map_t *map, long key, void *value);
+
+UTILS_EXPORT void* celix_longHashMap_remove(celix_long_hash_map_t *map, long key);
+
+UTILS_EXPORT void celix_longHashMap_clear(celix_long_hash_map_t *map);
+
+UTILS_EXPORT celix_long_hash_map_iterator_t celix_longHashMap_begin(const celix_long_hash_map_t *map);
+
+UTILS_EXPORT bool celix_longHashMapIterator_isEnd(const celix_long_hash_map_iterator_t *iter);
+
+UTILS_EXPORT void celix_longHashMapIterator_next(celix_long_hash_map_iterator_t *iter);
+
+
+UTILS_EXPORT celix_ptr_hash_map_t* celix_ptrHashMap_create(void);
+
+UTILS_EXPORT celix_ptr_hash_map_t* celix_ptrHashMap_createWithOptions(const celix_hash_map_create_options_t *opts);
+
+UTILS_EXPORT void celix_ptrHashMap_destroy(celix_ptr_hash_map_t *map);
+
+UTILS_EXPORT size_t celix_ptrHashMap_size(const celix_ptr_hash_map_t *map);
+
+UTILS_EXPORT void* celix_ptrHashMap_get(const celix_ptr_hash_map_t *map, const void *key);
+
+UTILS_EXPORT bool celix_ptrHashMap_hasKey(const celix_ptr_hash_map_t *map, const void *key);
+
+UTILS_EXPORT void* celix_ptrHashMap_put(celix_ptr_hash_map_t *map, const void *key, void *value);
+
+UTILS_EXPORT void* celix_ptrHashMap_remove(celix_ptr_hash_map_t *map, const void *key);
+
+UTILS_EXPORT void celix_ptrHashMap_clear(celix_ptr_hash_map_t *map);
+
+UTILS_EXPORT celix_ptr_hash_map_iterator_t celix_ptrHashMap_begin(const celix_ptr_hash_map_t *map);
+
+UTILS_EXPORT bool celix_ptrHashMapIterator_isEnd(const celix_ptr_hash_map_iterator_t *iter);
+
+UTILS_EXPORT void celix_ptrHashMapIterator_next(celix_ptr_hash_map_iterator_t *iter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CELIX_HASH_MAP_H_ */
@@ -30,6 +30,11 @@
 extern "C" {
 #endif
 
+/**
+ * Note the keys are owned by the properties and well-known keys (e.g. objectClass, service.id) are interned static
+ * strings. Entries should be removed with celix_properties_unset; keys obtained through the hash map API must not be
+ * freed.
+ */
 typedef hash_map_t celix_properties_t;
 typedef hash_map_iterator_t celix_properties_iterator_t;
 
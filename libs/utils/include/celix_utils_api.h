@@ -25,6 +25,7 @@
 #include "celix_threads.h"
 #include "array_list.h"
 #include "hash_map.h"
+#include "celix_hash_map.h"
 #include "properties.h"
 #include "utils.h"
 #include "version.h"
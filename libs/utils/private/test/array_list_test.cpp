@@ -116,6 +116,57 @@ TEST(array_list, ensureCapacity) {
     }
 }
 
+TEST(array_list, inlineStorage) {
+    celix_inline_array_list_t buf;
+    celix_array_list_t *inlineList = celix_arrayList_initInline(&buf);
+    LONGS_EQUAL(CELIX_ARRAY_LIST_INLINE_CAPACITY, inlineList->capacity);
+    CHECK(inlineList->elementData > buf.buffer && inlineList->elementData < buf.buffer + sizeof(buf.buffer) / sizeof(buf.buffer[0]));
+    celix_array_list_entry_t *storage = inlineList->elementData;
+
+    for (int i = 0; i < CELIX_ARRAY_LIST_INLINE_CAPACITY; ++i) {
+        celix_arrayList_addInt(inlineList, i);
+    }
+    POINTERS_EQUAL(storage, inlineList->elementData);
+
+    //grow beyond the inline storage
+    for (int i = CELIX_ARRAY_LIST_INLINE_CAPACITY; i < 100; ++i) {
+        celix_arrayList_addInt(inlineList, i);
+    }
+    CHECK(inlineList->elementData != storage);
+    LONGS_EQUAL(100, celix_arrayList_size(inlineList));
+    for (int i = 0; i < 100; ++i) {
+        LONGS_EQUAL(i, celix_arrayList_getInt(inlineList, i));
+    }
+    celix_arrayList_destroy(inlineList);
+}
+
+TEST(array_list, scratchLists) {
+    celix_array_list_t *scratch1 = celix_arrayList_takeScratch();
+    celix_array_list_t *scratch2 = celix_arrayList_takeScratch();
+    CHECK(scratch1 != scratch2);
+    for (int i = 0; i < 20; ++i) {
+        celix_arrayList_addInt(scratch1, i);
+    }
+    celix_arrayList_releaseScratch(scratch2);
+    celix_arrayList_releaseScratch(scratch1);
+
+    //last released scratch list is reused, cleared but with its grown element buffer
+    celix_array_list_t *reused = celix_arrayList_takeScratch();
+    POINTERS_EQUAL(scratch1, reused);
+    LONGS_EQUAL(0, celix_arrayList_size(reused));
+    CHECK(reused->capacity >= 20);
+
+    //a large element buffer is not kept
+    for (int i = 0; i < CELIX_ARRAY_LIST_MAX_SCRATCH_CAPACITY * 2; ++i) {
+        celix_arrayList_addInt(reused, i);
+    }
+    celix_arrayList_releaseScratch(reused);
+    reused = celix_arrayList_takeScratch();
+    POINTERS_EQUAL(scratch1, reused);
+    CHECK(reused->capacity <= CELIX_ARRAY_LIST_MAX_SCRATCH_CAPACITY);
+    celix_arrayList_releaseScratch(reused);
+}
+
 TEST(array_list, clone) {
     int i;
     arrayList_clear(list);
@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+extern "C" {
+#include "celix_hash_map.h"
+}
+
+int main(int argc, char** argv) {
+    return RUN_ALL_TESTS(argc, argv);
+}
+
+TEST_GROUP(celix_hash_map) {
+    void setup() {
+    }
+
+    void teardown() {
+    }
+};
+
+TEST(celix_hash_map, stringHashMapPutGetRemove) {
+    celix_string_hash_map_t *map = celix_stringHashMap_create();
+    CHECK_EQUAL(0, celix_stringHashMap_size(map));
+    POINTERS_EQUAL(NULL, celix_stringHashMap_get(map, "key1"));
+
+    char key[32];
+    snprintf(key, sizeof(key), "key%i", 1);
+    POINTERS_EQUAL(NULL, celix_stringHashMap_put(map, key, (void*)0x1));
+    snprintf(key, sizeof(key), "other"); //keys are copied
+    POINTERS_EQUAL((void*)0x1, celix_stringHashMap_get(map, "key1"));
+    CHECK_TRUE(celix_stringHashMap_hasKey(map, "key1"));
+    CHECK_FALSE(celix_stringHashMap_hasKey(map, "other"));
+
+    //replace
+    POINTERS_EQUAL((void*)0x1, celix_stringHashMap_put(map, "key1", (void*)0x2));
+    CHECK_EQUAL(1, celix_stringHashMap_size(map));
+    POINTERS_EQUAL((void*)0x2, celix_stringHashMap_get(map, "key1"));
+
+    //NULL key
+    celix_stringHashMap_put(map, NULL, (void*)0x3);
+    POINTERS_EQUAL((void*)0x3, celix_stringHashMap_get(map, NULL));
+    CHECK_EQUAL(2, celix_stringHashMap_size(map));
+
+    POINTERS_EQUAL((void*)0x2, celix_stringHashMap_remove(map, "key1"));
+    POINTERS_EQUAL((void*)0x3, celix_stringHashMap_remove(map, NULL));
+    POINTERS_EQUAL(NULL, celix_stringHashMap_remove(map, "key1"));
+    CHECK_EQUAL(0, celix_stringHashMap_size(map));
+
+    celix_stringHashMap_destroy(map);
+}
+
+TEST(celix_hash_map, stringHashMapWeakKeys) {
+    celix_hash_map_create_options_t opts{};
+    opts.storeKeysWeakly = true;
+    opts.initialCapacity = 100;
+    celix_string_hash_map_t *map = celix_stringHashMap_createWithOptions(&opts);
+    const char *key = "key";
+    celix_stringHashMap_put(map, key, (void*)0x1);
+    celix_string_hash_map_iterator_t iter = celix_stringHashMap_begin(map);
+    POINTERS_EQUAL(key, iter.key);
+    celix_stringHashMap_destroy(map);
+}
+
+TEST(celix_hash_map, longHashMapManyEntries) {
+    celix_long_hash_map_t *map = celix_longHashMap_create();
+    const long nrOfEntries = 10000;
+    for (long i = 0; i < nrOfEntries; ++i) {
+        celix_longHashMap_put(map, i * 16, (void*)(uintptr_t)(i + 1));
+    }
+    CHECK_EQUAL(nrOfEntries, celix_longHashMap_size(map));
+    for (long i = 0; i < nrOfEntries; ++i) {
+        POINTERS_EQUAL((void*)(uintptr_t)(i + 1), celix_longHashMap_get(map, i * 16));
+    }
+    CHECK_FALSE(celix_longHashMap_hasKey(map, 1));
+
+    //remove the odd entries, the remaining entries must still be found (backward shift deletion)
+    for (long i = 1; i < nrOfEntries; i += 2) {
+        POINTERS_EQUAL((void*)(uintptr_t)(i + 1), celix_longHashMap_remove(map, i * 16));
+    }
+    CHECK_EQUAL(nrOfEntries / 2, celix_longHashMap_size(map));
+    for (long i = 0; i < nrOfEntries; ++i) {
+        void *expected = i % 2 == 0 ? (void*)(uintptr_t)(i + 1) : NULL;
+        POINTERS_EQUAL(expected, celix_longHashMap_get(map, i * 16));
+    }
+
+    //iterate
+    long count = 0;
+    long sum = 0;
+    for (auto iter = celix_longHashMap_begin(map); !celix_longHashMapIterator_isEnd(&iter); celix_longHashMapIterator_next(&iter)) {
+        count += 1;
+        sum += iter.key / 16;
+        POINTERS_EQUAL((void*)(uintptr_t)(iter.key / 16 + 1), iter.value);
+    }
+    CHECK_EQUAL(nrOfEntries / 2, count);
+    CHECK_EQUAL((nrOfEntries / 2) * (nrOfEntries - 2) / 2, sum);
+
+    celix_longHashMap_clear(map);
+    CHECK_EQUAL(0, celix_longHashMap_size(map));
+    auto iter = celix_longHashMap_begin(map);
+    CHECK_TRUE(celix_longHashMapIterator_isEnd(&iter));
+    celix_longHashMap_destroy(map);
+}
+
+TEST(celix_hash_map, ptrHashMap) {
+    celix_ptr_hash_map_t *map = celix_ptrHashMap_create();
+    int values[100];
+    for (int i = 0; i < 100; ++i) {
+        celix_ptrHashMap_put(map, &values[i], &values[i]);
+    }
+    CHECK_EQUAL(100, celix_ptrHashMap_size(map));
+    for (int i = 0; i < 100; ++i) {
+        POINTERS_EQUAL(&values[i], celix_ptrHashMap_get(map, &values[i]));
+    }
+    POINTERS_EQUAL(NULL, celix_ptrHashMap_get(map, NULL));
+    for (int i = 0; i < 100; ++i) {
+        POINTERS_EQUAL(&values[i], celix_ptrHashMap_remove(map, &values[i]));
+    }
+    CHECK_EQUAL(0, celix_ptrHashMap_size(map));
+    celix_ptrHashMap_destroy(map);
+}
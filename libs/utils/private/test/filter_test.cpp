@@ -543,3 +543,111 @@ TEST(filter, getString){
 }
 
 
+
+TEST(filter, findMandatoryEqualityValue){
+    celix_filter_t * filter = celix_filter_create("(&(objectClass=calc)(|(service.id=2)(service.id=3))(!(lang=C)))");
+    CHECK(filter != NULL);
+    STRCMP_EQUAL("calc", celix_filter_findMandatoryEqualityValue(filter, "objectClass"));
+    POINTERS_EQUAL(NULL, celix_filter_findMandatoryEqualityValue(filter, "service.id")); //only in OR
+    POINTERS_EQUAL(NULL, celix_filter_findMandatoryEqualityValue(filter, "lang")); //only in NOT
+    celix_filter_destroy(filter);
+
+    filter = celix_filter_create("(service.id=42)");
+    STRCMP_EQUAL("42", celix_filter_findMandatoryEqualityValue(filter, "service.id"));
+    celix_filter_destroy(filter);
+
+    filter = celix_filter_create("(service.ranking>=10)");
+    POINTERS_EQUAL(NULL, celix_filter_findMandatoryEqualityValue(filter, "service.ranking"));
+    celix_filter_destroy(filter);
+
+    POINTERS_EQUAL(NULL, celix_filter_findMandatoryEqualityValue(NULL, "objectClass"));
+}
+
+TEST(filter, numericAndVersionCompare){
+    celix_properties_t *props = celix_properties_create();
+    celix_properties_set(props, "service.ranking", "9");
+    celix_properties_set(props, "weight", "2.5");
+    celix_properties_set(props, "version", "1.10.0");
+    celix_properties_set(props, "name", "abc");
+
+    //numeric compare, as string "9" >= "10"
+    celix_filter_t *filter = celix_filter_create("(service.ranking>=10)");
+    CHECK(!celix_filter_match(filter, props));
+    celix_properties_set(props, "service.ranking", "10");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    filter = celix_filter_create("(service.ranking=010)");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    filter = celix_filter_create("(weight<10.25)");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    //version compare, as string "1.10.0" < "1.9.0"
+    filter = celix_filter_create("(version>1.9.0)");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    filter = celix_filter_create("(version<=1.10.0.beta)");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    //non numeric property value falls back to a string compare
+    filter = celix_filter_create("(name>10)");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    celix_properties_destroy(props);
+}
+
+TEST(filter, onlyDecimalValuesCompareAsNumbers){
+    celix_properties_t *props = celix_properties_create();
+    celix_properties_set(props, "version", "1.10.0");
+
+    //a decimal filter value is also converted to a version
+    celix_filter_t *filter = celix_filter_create("(version>=1.2)");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    //hexadecimal and whitespace prefixed values are no numbers (as string "0x20" < "3")
+    filter = celix_filter_create("(size>3)");
+    const char *noNumbers[] = {"0x20", " 20"};
+    for (const char *value : noNumbers) {
+        celix_properties_set(props, "size", value);
+        CHECK_TEXT(!celix_filter_match(filter, props), value);
+    }
+    //nan is no number (as string "nan" > "3")
+    celix_properties_set(props, "size", "nan");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    filter = celix_filter_create("(size<1e3)");
+    celix_properties_set(props, "size", "+20.5");
+    CHECK(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    celix_properties_destroy(props);
+}
+
+TEST(filter, substringMatch){
+    celix_properties_t *props = celix_properties_create();
+    celix_properties_set(props, "name", "abcdefabc");
+
+    const char *matching[] = {"(name=abc*)", "(name=*abc)", "(name=a*f*c)", "(name=*def*)", "(name=abc*def*)", "(name=**abc)", "(name=a*b*c*)"};
+    for (const char *str : matching) {
+        celix_filter_t *filter = celix_filter_create(str);
+        CHECK_TEXT(celix_filter_match(filter, props), str);
+        celix_filter_destroy(filter);
+    }
+
+    const char *notMatching[] = {"(name=bc*)", "(name=*ab)", "(name=a*x*c)", "(name=abcdefabc*abc)", "(name=*fa*fa*)"};
+    for (const char *str : notMatching) {
+        celix_filter_t *filter = celix_filter_create(str);
+        CHECK_TEXT(!celix_filter_match(filter, props), str);
+        celix_filter_destroy(filter);
+    }
+
+    celix_properties_destroy(props);
+}
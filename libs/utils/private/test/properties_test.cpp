@@ -238,4 +238,29 @@ TEST(properties, sizeAndIteratorTest) {
     CHECK_EQUAL(4, count);
 
     celix_properties_destroy(props);
-}
\ No newline at end of file
+}
+
+TEST(properties, wellKnownKeysTest) {
+    //note well known keys (e.g. objectClass) are interned, check that set, unset, copy and destroy handle them
+    celix_properties_t *props = celix_properties_create();
+    char key[] = "objectClass";
+    celix_properties_set(props, key, "example");
+    celix_properties_setLong(props, "service.id", 42);
+    celix_properties_set(props, "service.ranking", "10");
+    key[0] = 'O'; //keys are not owned by the caller
+    STRCMP_EQUAL("example", celix_properties_get(props, "objectClass", NULL));
+
+    celix_properties_t *copy = celix_properties_copy(props);
+    CHECK_EQUAL(42, celix_properties_getAsLong(copy, "service.id", -1));
+
+    celix_properties_unset(props, "service.ranking");
+    CHECK_EQUAL(2, celix_properties_size(props));
+    CHECK(celix_properties_get(props, "service.ranking", NULL) == nullptr);
+    STRCMP_EQUAL("10", celix_properties_get(copy, "service.ranking", NULL));
+
+    celix_properties_unset(props, "not existing");
+    CHECK_EQUAL(2, celix_properties_size(props));
+
+    celix_properties_destroy(props);
+    celix_properties_destroy(copy);
+}
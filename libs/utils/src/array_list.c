@@ -27,10 +27,18 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "array_list.h"
 #include "celix_array_list.h"
 #include "array_list_private.h"
+#include "celix_threads.h"
+
+#define CELIX_ARRAY_LIST_DEFAULT_CAPACITY 10
+#define CELIX_ARRAY_LIST_MAX_NR_OF_SCRATCH_LISTS 8
+
+//note the array list struct must fit in the reserved entries of a celix_inline_array_list_t
+typedef char celix_arrayList_inlineReservedSizeCheck[sizeof(struct celix_array_list) <= CELIX_ARRAY_LIST_INLINE_RESERVED_SIZE * sizeof(celix_array_list_entry_t) ? 1 : -1];
 
 static celix_status_t arrayList_elementEquals(const void *a, const void *b, bool *equals);
 static bool celix_arrayList_defaultEquals(const celix_array_list_entry_t a, const celix_array_list_entry_t b);
@@ -79,9 +87,13 @@ void arrayList_trimToSize(array_list_pt list) {
     list->modCount++;
     size_t oldCapacity = list->capacity;
     if (list->size < oldCapacity) {
-        celix_array_list_entry_t * newList = realloc(list->elementData, sizeof(void *) * list->size);
-        list->capacity = list->size;
-        list->elementData = newList;
+        if (list->elementData == list->storage) {
+            list->capacity = list->size; //note storage cannot be trimmed
+        } else {
+            celix_array_list_entry_t * newList = realloc(list->elementData, sizeof(void *) * list->size);
+            list->capacity = list->size;
+            list->elementData = newList;
+        }
     }
 }
 
@@ -94,9 +106,19 @@ void arrayList_ensureCapacity(array_list_pt list, int capacity) {
         if (newCapacity < capacity) {
             newCapacity = capacity;
         }
-        newList = realloc(list->elementData, sizeof(void *) * newCapacity);
-        list->capacity = newCapacity;
-        list->elementData = newList;
+        if (list->elementData == list->storage && newCapacity <= list->storageCapacity) {
+            list->capacity = newCapacity;
+        } else if (list->elementData == list->storage) {
+            //grow out of the storage
+            newList = malloc(sizeof(void *) * newCapacity);
+            memcpy(newList, list->elementData, sizeof(void *) * list->size);
+            list->capacity = newCapacity;
+            list->elementData = newList;
+        } else {
+            newList = realloc(list->elementData, sizeof(void *) * newCapacity);
+            list->capacity = newCapacity;
+            list->elementData = newList;
+        }
     }
 }
 
@@ -362,19 +384,102 @@ celix_array_list_t* celix_arrayList_create() {
 }
 
 celix_array_list_t* celix_arrayList_createWithEquals(celix_arrayList_equals_fp equals) {
-    array_list_t *list = calloc(1, sizeof(*list));
+    //note the list struct and the initial element data are allocated with a single allocation
+    array_list_t *list = calloc(1, sizeof(*list) + sizeof(celix_array_list_entry_t) * CELIX_ARRAY_LIST_DEFAULT_CAPACITY);
     if (list != NULL) {
-        list->capacity = 10;
-        list->elementData = malloc(sizeof(void*) * list->capacity);
+        list->storage = (celix_array_list_entry_t*)(list + 1);
+        list->storageCapacity = CELIX_ARRAY_LIST_DEFAULT_CAPACITY;
+        list->capacity = CELIX_ARRAY_LIST_DEFAULT_CAPACITY;
+        list->elementData = list->storage;
         list->equals = equals;
+        list->heapAllocated = true;
     }
     return list;
 }
 
+/**
+ * Initializes a array list which uses the provided storage for the first capacity entries.
+ */
+static void celix_arrayList_initWithStorage(celix_array_list_t *list, celix_array_list_entry_t *storage, size_t capacity) {
+    memset(list, 0, sizeof(*list));
+    list->storage = storage;
+    list->storageCapacity = capacity;
+    list->capacity = capacity;
+    list->elementData = storage;
+    list->equals = celix_arrayList_defaultEquals;
+    list->heapAllocated = false;
+}
+
+celix_array_list_t* celix_arrayList_initInline(celix_inline_array_list_t *inlineList) {
+    celix_array_list_t *list = (celix_array_list_t*)inlineList->buffer;
+    celix_arrayList_initWithStorage(list, inlineList->buffer + CELIX_ARRAY_LIST_INLINE_RESERVED_SIZE, CELIX_ARRAY_LIST_INLINE_CAPACITY);
+    return list;
+}
+
 void celix_arrayList_destroy(celix_array_list_t *list) {
     list->size = 0;
-    free(list->elementData);
-    free(list);
+    if (list->elementData != list->storage) {
+        free(list->elementData);
+    }
+    if (list->heapAllocated) {
+        free(list);
+    }
+}
+
+typedef struct celix_array_list_scratch_lists {
+    int size;
+    celix_array_list_t *lists[CELIX_ARRAY_LIST_MAX_NR_OF_SCRATCH_LISTS];
+} celix_array_list_scratch_lists_t;
+
+static celix_thread_once_t celix_arrayList_scratchKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t celix_arrayList_scratchKey;
+
+static void celix_arrayList_destroyScratchLists(void *data) {
+    celix_array_list_scratch_lists_t *scratch = data;
+    for (int i = 0; i < scratch->size; ++i) {
+        celix_arrayList_destroy(scratch->lists[i]);
+    }
+    free(scratch);
+}
+
+static void celix_arrayList_createScratchKey(void) {
+    pthread_key_create(&celix_arrayList_scratchKey, celix_arrayList_destroyScratchLists);
+}
+
+static celix_array_list_scratch_lists_t* celix_arrayList_getScratchLists(void) {
+    celixThread_once(&celix_arrayList_scratchKeyOnce, celix_arrayList_createScratchKey);
+    celix_array_list_scratch_lists_t *scratch = pthread_getspecific(celix_arrayList_scratchKey);
+    if (scratch == NULL) {
+        scratch = calloc(1, sizeof(*scratch));
+        pthread_setspecific(celix_arrayList_scratchKey, scratch);
+    }
+    return scratch;
+}
+
+celix_array_list_t* celix_arrayList_takeScratch(void) {
+    celix_array_list_scratch_lists_t *scratch = celix_arrayList_getScratchLists();
+    if (scratch != NULL && scratch->size > 0) {
+        return scratch->lists[--scratch->size];
+    }
+    return celix_arrayList_create();
+}
+
+void celix_arrayList_releaseScratch(celix_array_list_t *list) {
+    celix_array_list_scratch_lists_t *scratch = celix_arrayList_getScratchLists();
+    if (scratch != NULL && list->heapAllocated && scratch->size < CELIX_ARRAY_LIST_MAX_NR_OF_SCRATCH_LISTS) {
+        celix_arrayList_clear(list);
+        if (list->capacity > CELIX_ARRAY_LIST_MAX_SCRATCH_CAPACITY && list->elementData != list->storage) {
+            //shrink back to the storage allocated with the list struct
+            free(list->elementData);
+            list->elementData = list->storage;
+            list->capacity = list->storageCapacity;
+        }
+        list->equals = celix_arrayList_defaultEquals;
+        list->equalsDeprecated = NULL;
+        scratch->lists[scratch->size++] = list;
+    } else {
+        celix_arrayList_destroy(list);
+    }
 }
 
 int celix_arrayList_size(const celix_array_list_t *list) {
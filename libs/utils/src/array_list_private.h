@@ -38,6 +38,10 @@ struct celix_array_list {
 
     array_list_element_equals_pt equalsDeprecated;
     celix_arrayList_equals_fp  equals;
+
+    celix_array_list_entry_t *storage; //storage not owned by the element data, NULL if not used
+    size_t storageCapacity;
+    bool heapAllocated; //true if the list struct is allocated by celix_arrayList_create
 };
 
 struct celix_array_list_iterator {
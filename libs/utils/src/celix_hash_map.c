@@ -0,0 +1,529 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "celix_hash_map.h"
+
+#define CELIX_HASH_MAP_MIN_CAPACITY 16
+
+typedef enum celix_hash_map_key_type {
+    CELIX_HASH_MAP_STRING_KEY,
+    CELIX_HASH_MAP_LONG_KEY,
+    CELIX_HASH_MAP_PTR_KEY
+} celix_hash_map_key_type_e;
+
+typedef union celix_hash_map_key {
+    const char *strKey;
+    long longKey;
+    const void *ptrKey;
+} celix_hash_map_key_t;
+
+typedef struct celix_hash_map_bucket {
+    celix_hash_map_key_t key;
+    void *value;
+    uint32_t hash;
+    uint32_t dist; //probe distance + 1, 0 means empty bucket
+} celix_hash_map_bucket_t;
+
+typedef struct celix_hash_map {
+    celix_hash_map_key_type_e keyType;
+    bool storeKeysWeakly;
+    celix_hash_map_bucket_t *buckets;
+    size_t capacity; //always a power of 2
+    size_t size;
+} celix_hash_map_t;
+
+struct celix_string_hash_map {
+    celix_hash_map_t genericMap;
+};
+
+struct celix_long_hash_map {
+    celix_hash_map_t genericMap;
+};
+
+struct celix_ptr_hash_map {
+    celix_hash_map_t genericMap;
+};
+
+static inline uint64_t celix_hashMap_mix(uint64_t h) {
+    //finalizer of murmur3
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * String hash which processes 8 bytes per step, instead of the byte per step of utils_stringHash.
+ */
+static uint32_t celix_hashMap_stringHash(const char *str) {
+    if (str == NULL) {
+        return 0;
+    }
+    size_t len = strlen(str);
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ (len * 0xc6a4a7935bd1e995ULL);
+    const char *end = str + (len & ~(size_t)7);
+    for (const char *p = str; p < end; p += 8) {
+        uint64_t w;
+        memcpy(&w, p, sizeof(w));
+        h ^= celix_hashMap_mix(w);
+        h = (h << 27) | (h >> 37);
+        h = h * 5 + 0x52dce729;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, end, len & 7);
+    h ^= tail;
+    return (uint32_t)celix_hashMap_mix(h);
+}
+
+/**
+ * Fibonacci hashing for long and pointer keys, a single multiply which spreads (sequential) keys over the buckets.
+ */
+static inline uint32_t celix_hashMap_intHash(uint64_t key) {
+    return (uint32_t)((key * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+/*
+ * Note the key type is passed as argument to the inline functions, so that the typed map functions are compiled
+ * without key type switches.
+ */
+static inline uint32_t celix_hashMap_hash(celix_hash_map_key_type_e keyType, celix_hash_map_key_t key) {
+    switch (keyType) {
+        case CELIX_HASH_MAP_STRING_KEY:
+            return celix_hashMap_stringHash(key.strKey);
+        case CELIX_HASH_MAP_LONG_KEY:
+            return celix_hashMap_intHash((uint64_t)key.longKey);
+        default:
+            return celix_hashMap_intHash((uint64_t)(uintptr_t)key.ptrKey);
+    }
+}
+
+static inline bool celix_hashMap_keyEquals(celix_hash_map_key_type_e keyType, celix_hash_map_key_t a, celix_hash_map_key_t b) {
+    switch (keyType) {
+        case CELIX_HASH_MAP_STRING_KEY:
+            return a.strKey == b.strKey || (a.strKey != NULL && b.strKey != NULL && strcmp(a.strKey, b.strKey) == 0);
+        case CELIX_HASH_MAP_LONG_KEY:
+            return a.longKey == b.longKey;
+        default:
+            return a.ptrKey == b.ptrKey;
+    }
+}
+
+static bool celix_hashMap_init(celix_hash_map_t *map, celix_hash_map_key_type_e keyType, const celix_hash_map_create_options_t *opts) {
+    size_t capacity = CELIX_HASH_MAP_MIN_CAPACITY;
+    size_t requested = opts != NULL ? opts->initialCapacity : 0;
+    while (capacity * 3 < requested * 4) {
+        capacity *= 2;
+    }
+    map->keyType = keyType;
+    map->storeKeysWeakly = opts != NULL && opts->storeKeysWeakly;
+    map->capacity = capacity;
+    map->size = 0;
+    map->buckets = calloc(capacity, sizeof(*map->buckets));
+    return map->buckets != NULL;
+}
+
+static void celix_hashMap_freeKey(celix_hash_map_t *map, celix_hash_map_bucket_t *bucket) {
+    if (map->keyType == CELIX_HASH_MAP_STRING_KEY && !map->storeKeysWeakly) {
+        free((char*)bucket->key.strKey);
+    }
+}
+
+static void celix_hashMap_clear(celix_hash_map_t *map) {
+    for (size_t i = 0; i < map->capacity; ++i) {
+        if (map->buckets[i].dist != 0) {
+            celix_hashMap_freeKey(map, &map->buckets[i]);
+        }
+    }
+    memset(map->buckets, 0, map->capacity * sizeof(*map->buckets));
+    map->size = 0;
+}
+
+static void celix_hashMap_deinit(celix_hash_map_t *map) {
+    celix_hashMap_clear(map);
+    free(map->buckets);
+}
+
+static inline celix_hash_map_bucket_t* celix_hashMap_findWithHash(const celix_hash_map_t *map, celix_hash_map_key_type_e keyType, celix_hash_map_key_t key, uint32_t hash) {
+    size_t mask = map->capacity - 1;
+    size_t index = hash & mask;
+    for (uint32_t dist = 1; ; ++dist) {
+        celix_hash_map_bucket_t *bucket = &map->buckets[index];
+        if (bucket->dist < dist) {
+            //empty bucket or a bucket "richer" than the key would be, so the key is not part of the map
+            return NULL;
+        }
+        if (bucket->hash == hash && celix_hashMap_keyEquals(keyType, bucket->key, key)) {
+            return bucket;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+static inline celix_hash_map_bucket_t* celix_hashMap_find(const celix_hash_map_t *map, celix_hash_map_key_type_e keyType, celix_hash_map_key_t key) {
+    return celix_hashMap_findWithHash(map, keyType, key, celix_hashMap_hash(keyType, key));
+}
+
+/**
+ * Inserts an entry for a key which is not yet part of the map. The buckets must have room for the entry.
+ */
+static void celix_hashMap_insert(celix_hash_map_t *map, celix_hash_map_bucket_t entry) {
+    size_t mask = map->capacity - 1;
+    size_t index = entry.hash & mask;
+    entry.dist = 1;
+    for (;;) {
+        celix_hash_map_bucket_t *bucket = &map->buckets[index];
+        if (bucket->dist == 0) {
+            *bucket = entry;
+            return;
+        } else if (bucket->dist < entry.dist) {
+            //robin hood: take the bucket from the entry closer to its home bucket and continue inserting that entry
+            celix_hash_map_bucket_t tmp = *bucket;
+            *bucket = entry;
+            entry = tmp;
+        }
+        index = (index + 1) & mask;
+        entry.dist += 1;
+    }
+}
+
+/**
+ * Doubles the number of buckets. Returns false, with the old buckets left in place, if the buckets cannot be allocated.
+ */
+static bool celix_hashMap_grow(celix_hash_map_t *map) {
+    celix_hash_map_bucket_t *buckets = calloc(map->capacity * 2, sizeof(*map->buckets));
+    if (buckets == NULL) {
+        return false;
+    }
+    celix_hash_map_bucket_t *old = map->buckets;
+    size_t oldCapacity = map->capacity;
+    map->capacity = oldCapacity * 2;
+    map->buckets = buckets;
+    for (size_t i = 0; i < oldCapacity; ++i) {
+        if (old[i].dist != 0) {
+            celix_hashMap_insert(map, old[i]);
+        }
+    }
+    free(old);
+    return true;
+}
+
+static inline void* celix_hashMap_put(celix_hash_map_t *map, celix_hash_map_key_type_e keyType, celix_hash_map_key_t key, void *value) {
+    uint32_t hash = celix_hashMap_hash(keyType, key);
+    celix_hash_map_bucket_t *found = celix_hashMap_findWithHash(map, keyType, key, hash);
+    if (found != NULL) {
+        void *replaced = found->value;
+        found->value = value;
+        return replaced;
+    }
+
+    //keep the load factor below 0.75. If growing fails, insert anyway as long as an empty bucket remains.
+    if ((map->size + 1) * 4 > map->capacity * 3 && !celix_hashMap_grow(map) && map->size + 1 >= map->capacity) {
+        return NULL;
+    }
+    celix_hash_map_bucket_t entry;
+    entry.key = key;
+    if (keyType == CELIX_HASH_MAP_STRING_KEY && !map->storeKeysWeakly && key.strKey != NULL) {
+        entry.key.strKey = strdup(key.strKey);
+        if (entry.key.strKey == NULL) {
+            return NULL;
+        }
+    }
+    entry.value = value;
+    entry.hash = hash;
+    entry.dist = 1;
+    celix_hashMap_insert(map, entry);
+    map->size += 1;
+    return NULL;
+}
+
+static inline void* celix_hashMap_remove(celix_hash_map_t *map, celix_hash_map_key_type_e keyType, celix_hash_map_key_t key) {
+    celix_hash_map_bucket_t *found = celix_hashMap_find(map, keyType, key);
+    if (found == NULL) {
+        return NULL;
+    }
+    void *removed = found->value;
+    celix_hashMap_freeKey(map, found);
+
+    //backward shift deletion: move the following entries, which are not in their home bucket, one bucket back
+    size_t mask = map->capacity - 1;
+    size_t index = (size_t)(found - map->buckets);
+    size_t next = (index + 1) & mask;
+    while (map->buckets[next].dist > 1) {
+        map->buckets[index] = map->buckets[next];
+        map->buckets[index].dist -= 1;
+        index = next;
+        next = (next + 1) & mask;
+    }
+    memset(&map->buckets[index], 0, sizeof(map->buckets[index]));
+    map->size -= 1;
+    return removed;
+}
+
+static size_t celix_hashMap_nextIndex(const celix_hash_map_t *map, size_t index) {
+    while (index < map->capacity && map->buckets[index].dist == 0) {
+        ++index;
+    }
+    return index;
+}
+
+celix_string_hash_map_t* celix_stringHashMap_create(void) {
+    return celix_stringHashMap_createWithOptions(NULL);
+}
+
+celix_string_hash_map_t* celix_stringHashMap_createWithOptions(const celix_hash_map_create_options_t *opts) {
+    celix_string_hash_map_t *map = calloc(1, sizeof(*map));
+    if (map != NULL && !celix_hashMap_init(&map->genericMap, CELIX_HASH_MAP_STRING_KEY, opts)) {
+        free(map);
+        map = NULL;
+    }
+    return map;
+}
+
+void celix_stringHashMap_destroy(celix_string_hash_map_t *map) {
+    if (map != NULL) {
+        celix_hashMap_deinit(&map->genericMap);
+        free(map);
+    }
+}
+
+size_t celix_stringHashMap_size(const celix_string_hash_map_t *map) {
+    return map->genericMap.size;
+}
+
+void* celix_stringHashMap_get(const celix_string_hash_map_t *map, const char *key) {
+    celix_hash_map_key_t k = {.strKey = key};
+    celix_hash_map_bucket_t *found = celix_hashMap_find(&map->genericMap, CELIX_HASH_MAP_STRING_KEY, k);
+    return found != NULL ? found->value : NULL;
+}
+
+bool celix_stringHashMap_hasKey(const celix_string_hash_map_t *map, const char *key) {
+    celix_hash_map_key_t k = {.strKey = key};
+    return celix_hashMap_find(&map->genericMap, CELIX_HASH_MAP_STRING_KEY, k) != NULL;
+}
+
+void* celix_stringHashMap_put(celix_string_hash_map_t *map, const char *key, void *value) {
+    celix_hash_map_key_t k = {.strKey = key};
+    return celix_hashMap_put(&map->genericMap, CELIX_HASH_MAP_STRING_KEY, k, value);
+}
+
+void* celix_stringHashMap_remove(celix_string_hash_map_t *map, const char *key) {
+    celix_hash_map_key_t k = {.strKey = key};
+    return celix_hashMap_remove(&map->genericMap, CELIX_HASH_MAP_STRING_KEY, k);
+}
+
+void celix_stringHashMap_clear(celix_string_hash_map_t *map) {
+    celix_hashMap_clear(&map->genericMap);
+}
+
+static void celix_stringHashMapIterator_update(celix_string_hash_map_iterator_t *iter) {
+    const celix_hash_map_t *map = &iter->map->genericMap;
+    iter->index = celix_hashMap_nextIndex(map, iter->index);
+    if (iter->index < map->capacity) {
+        iter->key = map->buckets[iter->index].key.strKey;
+        iter->value = map->buckets[iter->index].value;
+    } else {
+        iter->key = NULL;
+        iter->value = NULL;
+    }
+}
+
+celix_string_hash_map_iterator_t celix_stringHashMap_begin(const celix_string_hash_map_t *map) {
+    celix_string_hash_map_iterator_t iter;
+    iter.index = 0;
+    iter.map = map;
+    celix_stringHashMapIterator_update(&iter);
+    return iter;
+}
+
+bool celix_stringHashMapIterator_isEnd(const celix_string_hash_map_iterator_t *iter) {
+    return iter->index >= iter->map->genericMap.capacity;
+}
+
+void celix_stringHashMapIterator_next(celix_string_hash_map_iterator_t *iter) {
+    if (!celix_stringHashMapIterator_isEnd(iter)) {
+        iter->index += 1;
+        celix_stringHashMapIterator_update(iter);
+    }
+}
+
+celix_long_hash_map_t* celix_longHashMap_create(void) {
+    return celix_longHashMap_createWithOptions(NULL);
+}
+
+celix_long_hash_map_t* celix_longHashMap_createWithOptions(const celix_hash_map_create_options_t *opts) {
+    celix_long_hash_map_t *map = calloc(1, sizeof(*map));
+    if (map != NULL && !celix_hashMap_init(&map->genericMap, CELIX_HASH_MAP_LONG_KEY, opts)) {
+        free(map);
+        map = NULL;
+    }
+    return map;
+}
+
+void celix_longHashMap_destroy(celix_long_hash_map_t *map) {
+    if (map != NULL) {
+        celix_hashMap_deinit(&map->genericMap);
+        free(map);
+    }
+}
+
+size_t celix_longHashMap_size(const celix_long_hash_map_t *map) {
+    return map->genericMap.size;
+}
+
+void* celix_longHashMap_get(const celix_long_hash_map_t *map, long key) {
+    celix_hash_map_key_t k = {.longKey = key};
+    celix_hash_map_bucket_t *found = celix_hashMap_find(&map->genericMap, CELIX_HASH_MAP_LONG_KEY, k);
+    return found != NULL ? found->value : NULL;
+}
+
+bool celix_longHashMap_hasKey(const celix_long_hash_map_t *map, long key) {
+    celix_hash_map_key_t k = {.longKey = key};
+    return celix_hashMap_find(&map->genericMap, CELIX_HASH_MAP_LONG_KEY, k) != NULL;
+}
+
+void* celix_longHashMap_put(celix_long_hash_map_t *map, long key, void *value) {
+    celix_hash_map_key_t k = {.longKey = key};
+    return celix_hashMap_put(&map->genericMap, CELIX_HASH_MAP_LONG_KEY, k, value);
+}
+
+void* celix_longHashMap_remove(celix_long_hash_map_t *map, long key) {
+    celix_hash_map_key_t k = {.longKey = key};
+    return celix_hashMap_remove(&map->genericMap, CELIX_HASH_MAP_LONG_KEY, k);
+}
+
+void celix_longHashMap_clear(celix_long_hash_map_t *map) {
+    celix_hashMap_clear(&map->genericMap);
+}
+
+static void celix_longHashMapIterator_update(celix_long_hash_map_iterator_t *iter) {
+    const celix_hash_map_t *map = &iter->map->genericMap;
+    iter->index = celix_hashMap_nextIndex(map, iter->index);
+    if (iter->index < map->capacity) {
+        iter->key = map->buckets[iter->index].key.longKey;
+        iter->value = map->buckets[iter->index].value;
+    } else {
+        iter->key = 0;
+        iter->value = NULL;
+    }
+}
+
+celix_long_hash_map_iterator_t celix_longHashMap_begin(const celix_long_hash_map_t *map) {
+    celix_long_hash_map_iterator_t iter;
+    iter.index = 0;
+    iter.map = map;
+    celix_longHashMapIterator_update(&iter);
+    return iter;
+}
+
+bool celix_longHashMapIterator_isEnd(const celix_long_hash_map_iterator_t *iter) {
+    return iter->index >= iter->map->genericMap.capacity;
+}
+
+void celix_longHashMapIterator_next(celix_long_hash_map_iterator_t *iter) {
+    if (!celix_longHashMapIterator_isEnd(iter)) {
+        iter->index += 1;
+        celix_longHashMapIterator_update(iter);
+    }
+}
+
+celix_ptr_hash_map_t* celix_ptrHashMap_create(void) {
+    return celix_ptrHashMap_createWithOptions(NULL);
+}
+
+celix_ptr_hash_map_t* celix_ptrHashMap_createWithOptions(const celix_hash_map_create_options_t *opts) {
+    celix_ptr_hash_map_t *map = calloc(1, sizeof(*map));
+    if (map != NULL && !celix_hashMap_init(&map->genericMap, CELIX_HASH_MAP_PTR_KEY, opts)) {
+        free(map);
+        map = NULL;
+    }
+    return map;
+}
+
+void celix_ptrHashMap_destroy(celix_ptr_hash_map_t *map) {
+    if (map != NULL) {
+        celix_hashMap_deinit(&map->genericMap);
+        free(map);
+    }
+}
+
+size_t celix_ptrHashMap_size(const celix_ptr_hash_map_t *map) {
+    return map->genericMap.size;
+}
+
+void* celix_ptrHashMap_get(const celix_ptr_hash_map_t *map, const void *key) {
+    celix_hash_map_key_t k = {.ptrKey = key};
+    celix_hash_map_bucket_t *found = celix_hashMap_find(&map->genericMap, CELIX_HASH_MAP_PTR_KEY, k);
+    return found != NULL ? found->value : NULL;
+}
+
+bool celix_ptrHashMap_hasKey(const celix_ptr_hash_map_t *map, const void *key) {
+    celix_hash_map_key_t k = {.ptrKey = key};
+    return celix_hashMap_find(&map->genericMap, CELIX_HASH_MAP_PTR_KEY, k) != NULL;
+}
+
+void* celix_ptrHashMap_put(celix_ptr_hash_map_t *map, const void *key, void *value) {
+    celix_hash_map_key_t k = {.ptrKey = key};
+    return celix_hashMap_put(&map->genericMap, CELIX_HASH_MAP_PTR_KEY, k, value);
+}
+
+void* celix_ptrHashMap_remove(celix_ptr_hash_map_t *map, const void *key) {
+    celix_hash_map_key_t k = {.ptrKey = key};
+    return celix_hashMap_remove(&map->genericMap, CELIX_HASH_MAP_PTR_KEY, k);
+}
+
+void celix_ptrHashMap_clear(celix_ptr_hash_map_t *map) {
+    celix_hashMap_clear(&map->genericMap);
+}
+
+static void celix_ptrHashMapIterator_update(celix_ptr_hash_map_iterator_t *iter) {
+    const celix_hash_map_t *map = &iter->map->genericMap;
+    iter->index = celix_hashMap_nextIndex(map, iter->index);
+    if (iter->index < map->capacity) {
+        iter->key = map->buckets[iter->index].key.ptrKey;
+        iter->value = map->buckets[iter->index].value;
+    } else {
+        iter->key = NULL;
+        iter->value = NULL;
+    }
+}
+
+celix_ptr_hash_map_iterator_t celix_ptrHashMap_begin(const celix_ptr_hash_map_t *map) {
+    celix_ptr_hash_map_iterator_t iter;
+    iter.index = 0;
+    iter.map = map;
+    celix_ptrHashMapIterator_update(&iter);
+    return iter;
+}
+
+bool celix_ptrHashMapIterator_isEnd(const celix_ptr_hash_map_iterator_t *iter) {
+    return iter->index >= iter->map->genericMap.capacity;
+}
+
+void celix_ptrHashMapIterator_next(celix_ptr_hash_map_iterator_t *iter) {
+    if (!celix_ptrHashMapIterator_isEnd(iter)) {
+        iter->index += 1;
+        celix_ptrHashMapIterator_update(iter);
+    }
+}
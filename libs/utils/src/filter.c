@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <assert.h>
+#include <errno.h>
 #include <utils.h>
 
 #include "celix_filter.h"
@@ -39,6 +40,40 @@ static char * filter_parseValue(char* filterString, int* pos);
 static celix_array_list_t* filter_parseSubstring(char* filterString, int* pos);
 
 static celix_status_t filter_compare(const celix_filter_t* filter, const char *propertyValue, bool *result);
+static void filter_compile(celix_filter_t *filter);
+
+typedef struct celix_filter_version {
+    long major;
+    long minor;
+    long micro;
+    const char *qualifier; //points to the string the version is parsed from
+} celix_filter_version_t;
+
+//value of a filter converted to long, double and/or version when the filter is created
+typedef struct celix_filter_internal {
+    bool convertedToLong;
+    long longValue;
+    bool convertedToDouble;
+    double doubleValue;
+    bool convertedToVersion;
+    celix_filter_version_t versionValue;
+} celix_filter_internal_t;
+
+//Every filter (node) is allocated as celix_filter_node_t, so that the precomputed values are not part of the public
+//celix_filter_t struct.
+typedef struct celix_filter_node {
+    celix_filter_t filter; //note first member, so that a celix_filter_t can be cast to a celix_filter_node_t
+    celix_filter_internal_t internal;
+} celix_filter_node_t;
+
+static celix_filter_t* filter_createNode(void) {
+    celix_filter_node_t *node = calloc(1, sizeof(*node));
+    return &node->filter;
+}
+
+static inline celix_filter_internal_t* filter_internal(const celix_filter_t *filter) {
+    return &((celix_filter_node_t*)filter)->internal;
+}
 
 static void filter_skipWhiteSpace(char * filterString, int * pos) {
     int length;
@@ -134,7 +169,7 @@ static celix_filter_t * filter_parseAndOrOr(char * filterString, celix_filter_op
         children = NULL;
     }
 
-    celix_filter_t * filter = (celix_filter_t *) calloc(1, sizeof(*filter));
+    celix_filter_t * filter = filter_createNode();
     filter->operand = andOrOr;
     filter->children = children;
 
@@ -155,7 +190,7 @@ static celix_filter_t * filter_parseNot(char * filterString, int * pos) {
     celix_array_list_t* children = celix_arrayList_create();
     celix_arrayList_add(children, child);
 
-    celix_filter_t * filter = (celix_filter_t *) calloc(1, sizeof(*filter));
+    celix_filter_t * filter = filter_createNode();
     filter->operand = CELIX_FILTER_OPERAND_NOT;
     filter->children = children;
 
@@ -172,7 +207,7 @@ static celix_filter_t * filter_parseItem(char * filterString, int * pos) {
     switch(filterString[*pos]) {
         case '~': {
             if (filterString[*pos + 1] == '=') {
-                celix_filter_t * filter = (celix_filter_t *) calloc(1, sizeof(*filter));
+                celix_filter_t * filter = filter_createNode();
                 *pos += 2;
                 filter->operand = CELIX_FILTER_OPERAND_APPROX;
                 filter->attribute = attr;
@@ -183,7 +218,7 @@ static celix_filter_t * filter_parseItem(char * filterString, int * pos) {
         }
         case '>': {
             if (filterString[*pos + 1] == '=') {
-                celix_filter_t * filter = (celix_filter_t *) calloc(1, sizeof(*filter));
+                celix_filter_t * filter = filter_createNode();
                 *pos += 2;
                 filter->operand = CELIX_FILTER_OPERAND_GREATEREQUAL;
                 filter->attribute = attr;
@@ -191,7 +226,7 @@ static celix_filter_t * filter_parseItem(char * filterString, int * pos) {
                 return filter;
             }
             else {
-                celix_filter_t * filter = (celix_filter_t *) calloc(1, sizeof(*filter));
+                celix_filter_t * filter = filter_createNode();
                 *pos += 1;
                 filter->operand = CELIX_FILTER_OPERAND_GREATER;
                 filter->attribute = attr;
@@ -202,7 +237,7 @@ static celix_filter_t * filter_parseItem(char * filterString, int * pos) {
         }
         case '<': {
             if (filterString[*pos + 1] == '=') {
-                celix_filter_t * filter = (celix_filter_t *) calloc(1, sizeof(*filter));
+                celix_filter_t * filter = filter_createNode();
                 *pos += 2;
                 filter->operand = CELIX_FILTER_OPERAND_LESSEQUAL;
                 filter->attribute = attr;
@@ -210,7 +245,7 @@ static celix_filter_t * filter_parseItem(char * filterString, int * pos) {
                 return filter;
             }
             else {
-                celix_filter_t * filter = (celix_filter_t *) calloc(1, sizeof(*filter));
+                celix_filter_t * filter = filter_createNode();
                 *pos += 1;
                 filter->operand = CELIX_FILTER_OPERAND_LESS;
                 filter->attribute = attr;
@@ -227,7 +262,7 @@ static celix_filter_t * filter_parseItem(char * filterString, int * pos) {
                 *pos += 2;
                 filter_skipWhiteSpace(filterString, pos);
                 if (filterString[*pos] == ')') {
-                    celix_filter_t * filter = (celix_filter_t *) calloc(1, sizeof(*filter));
+                    celix_filter_t * filter = filter_createNode();
                     filter->operand = CELIX_FILTER_OPERAND_PRESENT;
                     filter->attribute = attr;
                     filter->value = NULL;
@@ -235,7 +270,7 @@ static celix_filter_t * filter_parseItem(char * filterString, int * pos) {
                 }
                 *pos = oldPos;
             }
-            filter = (celix_filter_t *) calloc(1, sizeof(*filter));            
+            filter = filter_createNode();
             (*pos)++;
             subs = filter_parseSubstring(filterString, pos);
             if(subs!=NULL){
@@ -412,6 +447,183 @@ celix_status_t filter_match(celix_filter_t * filter, celix_properties_t *propert
     return CELIX_SUCCESS;
 }
 
+/**
+ * Returns the length of the (optionally signed) decimal digits at the start of str.
+ */
+static size_t filter_digitsLength(const char *str) {
+    size_t len = 0;
+    while (isdigit((unsigned char)str[len])) {
+        ++len;
+    }
+    return len;
+}
+
+/**
+ * Parses a long, the complete string must be a decimal integer: [+-]digits.
+ * Note that strtol also accepts leading whitespace and is therefore not used to validate the string.
+ */
+static bool filter_parseLong(const char *str, long *out) {
+    const char *cur = (*str == '+' || *str == '-') ? str + 1 : str;
+    size_t digits = filter_digitsLength(cur);
+    if (digits == 0 || cur[digits] != '\0') {
+        return false;
+    }
+    char *endptr = NULL;
+    errno = 0;
+    long val = strtol(str, &endptr, 10);
+    if (endptr != str && *endptr == '\0' && errno == 0) {
+        *out = val;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Parses a double, the complete string must be a decimal number: [+-]digits[.digits][(e|E)[+-]digits].
+ * Note that strtod also accepts "inf", "nan", hexadecimal numbers and leading whitespace, these are not numbers for a
+ * filter.
+ */
+static bool filter_parseDouble(const char *str, double *out) {
+    const char *cur = (*str == '+' || *str == '-') ? str + 1 : str;
+    size_t digits = filter_digitsLength(cur);
+    cur += digits;
+    if (*cur == '.') {
+        size_t fraction = filter_digitsLength(cur + 1);
+        digits += fraction;
+        cur += 1 + fraction;
+    }
+    if (digits == 0) {
+        return false;
+    }
+    if (*cur == 'e' || *cur == 'E') {
+        cur += 1;
+        cur = (*cur == '+' || *cur == '-') ? cur + 1 : cur;
+        size_t exponent = filter_digitsLength(cur);
+        if (exponent == 0) {
+            return false;
+        }
+        cur += exponent;
+    }
+    if (*cur != '\0') {
+        return false;
+    }
+    char *endptr = NULL;
+    errno = 0;
+    double val = strtod(str, &endptr);
+    if (endptr != str && *endptr == '\0' && errno == 0) {
+        *out = val;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Parses a version in the form major[.minor[.micro[.qualifier]]] without allocating memory.
+ */
+static bool filter_parseVersion(const char *str, celix_filter_version_t *out) {
+    long parts[3] = {0, 0, 0};
+    const char *qualifier = "";
+    const char *cur = str;
+    for (int i = 0; i < 3; ++i) {
+        if (!isdigit((unsigned char)*cur)) {
+            return false;
+        }
+        char *endptr = NULL;
+        errno = 0;
+        parts[i] = strtol(cur, &endptr, 10);
+        if (errno != 0) {
+            return false;
+        }
+        cur = endptr;
+        if (*cur == '\0') {
+            break;
+        } else if (*cur != '.') {
+            return false;
+        }
+        cur += 1;
+        if (i == 2) {
+            qualifier = cur;
+        }
+    }
+    out->major = parts[0];
+    out->minor = parts[1];
+    out->micro = parts[2];
+    out->qualifier = qualifier;
+    return true;
+}
+
+static int filter_compareVersions(const celix_filter_version_t *v1, const celix_filter_version_t *v2) {
+    if (v1->major != v2->major) {
+        return v1->major < v2->major ? -1 : 1;
+    } else if (v1->minor != v2->minor) {
+        return v1->minor < v2->minor ? -1 : 1;
+    } else if (v1->micro != v2->micro) {
+        return v1->micro < v2->micro ? -1 : 1;
+    }
+    return strcmp(v1->qualifier, v2->qualifier);
+}
+
+/**
+ * Compares the property value with the filter value. If the filter value is converted to a long, double or version
+ * and the property value can be converted to the same type, the values are compared as numbers/versions -in that
+ * order-, otherwise the values are compared as strings.
+ * E.g. "1.2" and "1.10" are compared as doubles, but "1.2" and "1.10.0" as versions.
+ */
+static int filter_compareValues(const celix_filter_t *filter, const char *propertyValue) {
+    const celix_filter_internal_t *internal = filter_internal(filter);
+    if (internal->convertedToLong || internal->convertedToDouble || internal->convertedToVersion) {
+        long longValue;
+        double doubleValue;
+        celix_filter_version_t versionValue;
+        if (internal->convertedToLong && filter_parseLong(propertyValue, &longValue)) {
+            return longValue == internal->longValue ? 0 : (longValue < internal->longValue ? -1 : 1);
+        } else if (internal->convertedToDouble && filter_parseDouble(propertyValue, &doubleValue)) {
+            return doubleValue == internal->doubleValue ? 0 : (doubleValue < internal->doubleValue ? -1 : 1);
+        } else if (internal->convertedToVersion && filter_parseVersion(propertyValue, &versionValue)) {
+            return filter_compareVersions(&versionValue, &internal->versionValue);
+        }
+    }
+    return strcmp(propertyValue, filter->value);
+}
+
+static bool filter_matchSubstring(const celix_filter_t *filter, const char *propertyValue) {
+    //children contains the literal parts and NULL for every '*'
+    const char *cur = propertyValue;
+    bool wildcard = false;
+    int size = celix_arrayList_size(filter->children);
+    for (int i = 0; i < size; i++) {
+        const char *substr = celix_arrayList_get(filter->children, i);
+        if (substr == NULL) {
+            wildcard = true;
+            continue;
+        }
+        size_t len = strlen(substr);
+        bool last = i + 1 == size;
+        if (!wildcard) {
+            //substring should match at current position
+            if (strncmp(cur, substr, len) != 0) {
+                return false;
+            }
+            cur += len;
+            if (last) {
+                return *cur == '\0';
+            }
+        } else if (last) {
+            //substring should match at the end
+            size_t curLen = strlen(cur);
+            return curLen >= len && strcmp(cur + curLen - len, substr) == 0;
+        } else {
+            const char *found = strstr(cur, substr);
+            if (found == NULL) {
+                return false;
+            }
+            cur = found + len;
+        }
+        wildcard = false;
+    }
+    return true; //ends with a '*'
+}
+
 static celix_status_t filter_compare(const celix_filter_t* filter, const char *propertyValue, bool *out) {
     celix_status_t  status = CELIX_SUCCESS;
     bool result = false;
@@ -423,80 +635,32 @@ static celix_status_t filter_compare(const celix_filter_t* filter, const char *p
 
     switch (filter->operand) {
         case CELIX_FILTER_OPERAND_SUBSTRING: {
-            int pos = 0;
-            unsigned int i;
-            int size = celix_arrayList_size(filter->children);
-            for (i = 0; i < size; i++) {
-                char * substr = (char *) celix_arrayList_get(filter->children, i);
-
-                if (i + 1 < size) {
-                    if (substr == NULL) {
-                        unsigned int index;
-                        char * substr2 = (char *) celix_arrayList_get(filter->children, i + 1);
-                        if (substr2 == NULL) {
-                            continue;
-                        }
-                        index = strcspn(propertyValue+pos, substr2);
-                        if (index == strlen(propertyValue+pos)) {
-                            *out = false;
-                            return CELIX_SUCCESS;
-                        }
-
-                        pos = index + strlen(substr2);
-                        if (i + 2 < size) {
-                            i++;
-                        }
-                    } else {
-                        unsigned int len = strlen(substr);
-                        char * region = (char *)calloc(1, len+1);
-                        strncpy(region, propertyValue+pos, len);
-                        region[len]    = '\0';
-                        if (strcmp(region, substr) == 0) {
-                            pos += len;
-                        } else {
-                            free(region);
-                            *out = false;
-                            return CELIX_SUCCESS;
-                        }
-                        free(region);
-                    }
-                } else {
-                    unsigned int len;
-                    int begin;
-
-                    if (substr == NULL) {
-                        *out = true;
-                        return CELIX_SUCCESS;
-                    }
-                    len = strlen(substr);
-                    begin = strlen(propertyValue)-len;
-                    *out = (strcmp(propertyValue+begin, substr) == 0);
-                    return CELIX_SUCCESS;
-                }
-            }
-            *out = true;
-            return CELIX_SUCCESS;
+            result = filter_matchSubstring(filter, propertyValue);
+            break;
+        }
+        case CELIX_FILTER_OPERAND_APPROX: { //TODO: Implement strcmp with ignorecase and ignorespaces
+            result = strcmp(propertyValue, filter->value) == 0;
+            break;
         }
-        case CELIX_FILTER_OPERAND_APPROX: //TODO: Implement strcmp with ignorecase and ignorespaces
         case CELIX_FILTER_OPERAND_EQUAL: {
-            *out = (strcmp(propertyValue, filter->value) == 0);
-            return CELIX_SUCCESS;
+            result = filter_compareValues(filter, propertyValue) == 0;
+            break;
         }
         case CELIX_FILTER_OPERAND_GREATER: {
-            *out = (strcmp(propertyValue, filter->value) > 0);
-            return CELIX_SUCCESS;
+            result = filter_compareValues(filter, propertyValue) > 0;
+            break;
         }
         case CELIX_FILTER_OPERAND_GREATEREQUAL: {
-            *out = (strcmp(propertyValue, filter->value) >= 0);
-            return CELIX_SUCCESS;
+            result = filter_compareValues(filter, propertyValue) >= 0;
+            break;
         }
         case CELIX_FILTER_OPERAND_LESS: {
-            *out = (strcmp(propertyValue, filter->value) < 0);
-            return CELIX_SUCCESS;
+            result = filter_compareValues(filter, propertyValue) < 0;
+            break;
         }
         case CELIX_FILTER_OPERAND_LESSEQUAL: {
-            *out = (strcmp(propertyValue, filter->value) <= 0);
-            return CELIX_SUCCESS;
+            result = filter_compareValues(filter, propertyValue) <= 0;
+            break;
         }
         case CELIX_FILTER_OPERAND_AND:
         case CELIX_FILTER_OPERAND_NOT:
@@ -512,6 +676,37 @@ static celix_status_t filter_compare(const celix_filter_t* filter, const char *p
     return status;
 }
 
+/**
+ * Converts the values of the comparison operands to long, double and version, so that this is only done once and not
+ * for every match.
+ */
+static void filter_compile(celix_filter_t *filter) {
+    switch (filter->operand) {
+        case CELIX_FILTER_OPERAND_AND:
+        case CELIX_FILTER_OPERAND_OR:
+        case CELIX_FILTER_OPERAND_NOT: {
+            int size = celix_arrayList_size(filter->children);
+            for (int i = 0; i < size; ++i) {
+                filter_compile(celix_arrayList_get(filter->children, i));
+            }
+            break;
+        }
+        case CELIX_FILTER_OPERAND_EQUAL:
+        case CELIX_FILTER_OPERAND_GREATER:
+        case CELIX_FILTER_OPERAND_GREATEREQUAL:
+        case CELIX_FILTER_OPERAND_LESS:
+        case CELIX_FILTER_OPERAND_LESSEQUAL: {
+            celix_filter_internal_t *internal = filter_internal(filter);
+            internal->convertedToLong = filter_parseLong(filter->value, &internal->longValue);
+            internal->convertedToDouble = filter_parseDouble(filter->value, &internal->doubleValue);
+            internal->convertedToVersion = filter_parseVersion(filter->value, &internal->versionValue);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
 celix_status_t filter_getString(celix_filter_t * filter, const char **filterStr) {
     if (filter != NULL) {
         *filterStr = filter->filterStr;
@@ -552,6 +747,7 @@ celix_filter_t* celix_filter_create(const char *filterString) {
         free(filterStr);
     } else {
         filter->filterStr = filterStr;
+        filter_compile(filter);
     }
 
     return filter;
@@ -718,4 +914,23 @@ const char* celix_filter_findAttribute(const celix_filter_t *filter, const char
         }
     }
     return result;
-}
\ No newline at end of file
+}
+
+const char* celix_filter_findMandatoryEqualityValue(const celix_filter_t *filter, const char *attribute) {
+    const char *result = NULL;
+    if (filter != NULL && attribute != NULL) {
+        if (filter->operand == CELIX_FILTER_OPERAND_AND) {
+            size_t size = celix_arrayList_size(filter->children);
+            for (unsigned int i = 0; i < size; ++i) {
+                celix_filter_t *child = celix_arrayList_get(filter->children, i);
+                result = celix_filter_findMandatoryEqualityValue(child, attribute);
+                if (result != NULL) {
+                    break;
+                }
+            }
+        } else if (filter->operand == CELIX_FILTER_OPERAND_EQUAL && strncmp(filter->attribute, attribute, 1024 * 1024) == 0) {
+            result = filter->value;
+        }
+    }
+    return result;
+}
@@ -39,6 +39,37 @@
 
 static void parseLine(const char* line, celix_properties_t *props);
 
+/**
+ * Keys which are set for (almost) every service registration. Properties do not copy these keys, but refer to the
+ * strings in this array.
+ */
+static const char * const celix_properties_internedKeys[] = {
+        "objectClass",
+        "service.id",
+        "service.ranking",
+        "service.lang",
+        "service.version",
+        NULL
+};
+
+static char* celix_properties_copyKey(const char *key) {
+    for (int i = 0; celix_properties_internedKeys[i] != NULL; ++i) {
+        if (strcmp(celix_properties_internedKeys[i], key) == 0) {
+            return (char*)celix_properties_internedKeys[i];
+        }
+    }
+    return strdup(key);
+}
+
+static void celix_properties_freeKey(char *key) {
+    for (int i = 0; celix_properties_internedKeys[i] != NULL; ++i) {
+        if (celix_properties_internedKeys[i] == key) {
+            return;
+        }
+    }
+    free(key);
+}
+
 properties_pt properties_create(void) {
     return celix_properties_create();
 }
@@ -225,7 +256,7 @@ void celix_properties_destroy(celix_properties_t *properties) {
         hash_map_iterator_pt iter = hashMapIterator_create(properties);
         while (hashMapIterator_hasNext(iter)) {
             hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
-            free(hashMapEntry_getKey(entry));
+            celix_properties_freeKey(hashMapEntry_getKey(entry));
             free(hashMapEntry_getValue(entry));
         }
         hashMapIterator_destroy(iter);
@@ -370,21 +401,26 @@ void celix_properties_set(celix_properties_t *properties, const char *key, const
     if (properties != NULL) {
         hash_map_entry_pt entry = hashMap_getEntry(properties, key);
         char *oldVal = NULL;
-        char *newVal = value == NULL ? NULL : strndup(value, 1024 * 1024);
+        char *newVal = value == NULL ? NULL : strdup(value);
         if (entry != NULL) {
             char *oldKey = hashMapEntry_getKey(entry);
             oldVal = hashMapEntry_getValue(entry);
             hashMap_put(properties, oldKey, newVal);
         } else {
-            hashMap_put(properties, strndup(key, 1024 * 1024), newVal);
+            hashMap_put(properties, celix_properties_copyKey(key), newVal);
         }
         free(oldVal);
     }
 }
 
 void celix_properties_unset(celix_properties_t *properties, const char *key) {
-    char* oldValue = hashMap_remove(properties, key);
-    free(oldValue);
+    hash_map_entry_pt entry = hashMap_getEntry(properties, key);
+    if (entry != NULL) {
+        char *oldKey = hashMapEntry_getKey(entry);
+        char *oldValue = hashMap_remove(properties, key);
+        celix_properties_freeKey(oldKey);
+        free(oldValue);
+    }
 }
 
 long celix_properties_getAsLong(const celix_properties_t *props, const char *key, long defaultValue) {